@@ -4,6 +4,7 @@
 
 #include "asset_file.h"
 #include "logger.h"
+#include <cstring>
 #include <iostream>
 #ifdef __ANDROID__
 
@@ -2,15 +2,26 @@
 // Created by fcx on 2020/6/5.
 //
 
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include "asset_loader.h"
 #include "logger.h"
 #include "model.h"
-#include "libgen.h"
+#include "program_cache.h"
+#include "stb_image.h"
 #include <sys/stat.h>
 #include <filesystem>
 
+namespace {
+    const int RGBA_CHANNELS = 4;
+
+    uint64_t GetTimestampNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
 namespace lark {
 AssetLoader* AssetLoader::instance_ = nullptr;
 
@@ -31,6 +42,37 @@ AssetLoader::AssetLoader() {
 }
 
 AssetLoader::~AssetLoader() {
+#ifdef __ANDROID__
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cond_.notify_all();
+    for (auto & worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    for (auto & job : decoded_) {
+        stbi_image_free(job->pixels);
+    }
+    decode_queue_.clear();
+    decoded_.clear();
+    parse_queue_.clear();
+    // futures left waiting get nullptr.
+    for (auto & it : loading_textures_) {
+        it.second->promise.set_value(nullptr);
+    }
+    loading_textures_.clear();
+    for (auto & job : model_queue_) {
+        job->promise.set_value(nullptr);
+    }
+    model_queue_.clear();
+    for (auto & job : skybox_jobs_) {
+        AAsset_close(job->asset);
+    }
+    skybox_jobs_.clear();
+#endif
     shader_map_.clear();
     texture_map_.clear();
     model_map_.clear();
@@ -80,7 +122,12 @@ bool CopyAssetToInternalPath(ANativeActivity* nativeActivity, const std::string&
     AAsset_read(asset, &data[0], size);
     AAsset_close(asset);
 
-    std::string dir = dirname(internal_path.c_str());
+    // dirname may write into its argument, cut the copy instead.
+    std::string dir = ".";
+    size_t slash = internal_path.rfind('/');
+    if (slash != std::string::npos) {
+        dir = slash == 0 ? "/" : internal_path.substr(0, slash);
+    }
 
     if (mkpath(dir, S_IRUSR | S_IWUSR | S_IXUSR) == -1) {
         LOGW("make path %s failed.", dir.c_str());
@@ -102,6 +149,7 @@ bool CopyAssetToInternalPath(ANativeActivity* nativeActivity, const std::string&
 
 void AssetLoader::Load(AndroidAssetContext* context, const AssetLists &lists) {
     LOGV("start load assets");
+    InitProgramCache(context->nativeActivity);
     for (auto shaderAsset: lists.sharders) {
         LoadShader(context->nativeActivity->assetManager, shaderAsset);
     }
@@ -114,6 +162,391 @@ void AssetLoader::Load(AndroidAssetContext* context, const AssetLists &lists) {
     LOGV("load assets finished.");
 }
 
+void AssetLoader::LoadAsync(AndroidAssetContext *context, const AssetLists &lists) {
+    LOGV("start load assets async");
+    InitProgramCache(context->nativeActivity);
+    // gl only and needed by every object, compile now.
+    for (auto shaderAsset: lists.sharders) {
+        LoadShader(context->nativeActivity->assetManager, shaderAsset);
+    }
+    for (auto textureAsset : lists.textures) {
+        LoadTextureAsync(context, textureAsset);
+    }
+    for (auto modalAsset: lists.modals) {
+        LoadModelAsync(context, modalAsset);
+    }
+}
+
+TextureFuture AssetLoader::LoadTextureAsync(AndroidAssetContext *androidAssetContext,
+                                            const TextureAsset &textureAsset) {
+    TextureFuture future = FindLoadingTexture(textureAsset.path);
+    if (future.valid()) {
+        return future;
+    }
+    std::shared_ptr<Texture> texture = FindTexture(textureAsset.path);
+    // prebuilt skybox is ready to draw after the small levels uploaded.
+    if (!texture && textureAsset.type == TextureAssetType_Local_Skybox) {
+        texture = LoadPackedSkybox(androidAssetContext->nativeActivity->assetManager, textureAsset.path);
+        if (texture) {
+            texture_map_.insert(TEXTURE_PAIR(textureAsset.path, texture));
+        }
+    }
+    // net textures not supported by workers.
+    if (!texture && textureAsset.type != TextureAssetType_Local_Normal &&
+        textureAsset.type != TextureAssetType_Local_Skybox) {
+        texture = LoadTexture(androidAssetContext, textureAsset);
+    }
+    if (texture || (textureAsset.type != TextureAssetType_Local_Normal &&
+                    textureAsset.type != TextureAssetType_Local_Skybox)) {
+        std::promise<std::shared_ptr<Texture>> promise;
+        promise.set_value(texture);
+        return promise.get_future().share();
+    }
+
+    std::shared_ptr<TextureJob> job = std::make_shared<TextureJob>();
+    job->asset = textureAsset;
+    job->nativeActivity = androidAssetContext->nativeActivity;
+    job->bitmapFactory = androidAssetContext->bitmapFactory;
+    job->pixels = nullptr;
+    job->width = 0;
+    job->height = 0;
+    job->serial = ++texture_serial_;
+    job->future = job->promise.get_future().share();
+    loading_textures_.insert(std::make_pair(textureAsset.path, job));
+
+    StartWorkers();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decode_queue_.push_back(job);
+    }
+    cond_.notify_one();
+    return job->future;
+}
+
+ModelFuture AssetLoader::LoadModelAsync(AndroidAssetContext *context, const ModelAsset &modelAsset) {
+    for (auto & job : model_queue_) {
+        if (job->cached && job->asset.path == modelAsset.path) {
+            return job->future;
+        }
+    }
+    std::shared_ptr<Model> model = FindModel(modelAsset.path);
+    if (model) {
+        std::promise<std::shared_ptr<Model>> promise;
+        promise.set_value(model);
+        return promise.get_future().share();
+    }
+    std::shared_ptr<ModelJob> job = std::make_shared<ModelJob>();
+    job->asset = modelAsset;
+    job->nativeActivity = context->nativeActivity;
+    job->bitmapFactory = context->bitmapFactory;
+    job->model = std::make_shared<Model>(modelAsset.path);
+    job->cached = true;
+    return QueueModel(job);
+}
+
+ModelFuture AssetLoader::LoadModelAsync(AndroidAssetContext *context, const std::shared_ptr<Model> &model) {
+    std::shared_ptr<ModelJob> job = std::make_shared<ModelJob>();
+    job->asset.path = model->model_path();
+    job->nativeActivity = context->nativeActivity;
+    job->bitmapFactory = context->bitmapFactory;
+    job->model = model;
+    job->cached = false;
+    return QueueModel(job);
+}
+
+ModelFuture AssetLoader::QueueModel(const std::shared_ptr<ModelJob> &job) {
+    job->texture_serial = texture_serial_;
+    job->parsed = false;
+    job->parse_result = false;
+    job->future = job->promise.get_future().share();
+    model_queue_.push_back(job);
+
+    StartWorkers();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        parse_queue_.push_back(job);
+    }
+    cond_.notify_one();
+    return job->future;
+}
+
+TextureFuture AssetLoader::FindLoadingTexture(const std::string &path) {
+    auto it = loading_textures_.find(path);
+    if (it != loading_textures_.end()) {
+        return it->second->future;
+    }
+    return TextureFuture();
+}
+
+void AssetLoader::Update() {
+    if (loading_textures_.empty() && model_queue_.empty() && skybox_jobs_.empty()) {
+        return;
+    }
+    uint64_t start = GetTimestampNs();
+    // at least one job every frame.
+    bool finished = false;
+    while (!finished || GetTimestampNs() - start < update_budget_ns_) {
+        std::shared_ptr<TextureJob> textureJob = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!decoded_.empty()) {
+                textureJob = decoded_.front();
+                decoded_.pop_front();
+            }
+        }
+        if (textureJob) {
+            FinishTexture(textureJob.get());
+            loading_textures_.erase(textureJob->asset.path);
+            finished = true;
+            continue;
+        }
+        if (!skybox_jobs_.empty()) {
+            if (!StreamSkybox(skybox_jobs_.front().get())) {
+                AAsset_close(skybox_jobs_.front()->asset);
+                skybox_jobs_.pop_front();
+            }
+            finished = true;
+            continue;
+        }
+        // one mesh a time, models in queue order.
+        if (!model_queue_.empty() && ModelReady(model_queue_.front().get())) {
+            if (FinishModel(model_queue_.front().get())) {
+                model_queue_.pop_front();
+            }
+            finished = true;
+            continue;
+        }
+        break;
+    }
+    if (loading_textures_.empty() && model_queue_.empty() && skybox_jobs_.empty()) {
+        LOGV("load assets async finished.");
+    }
+}
+
+std::shared_ptr<Texture> AssetLoader::LoadPackedSkybox(AAssetManager *assetManager, const std::string &path) {
+    std::string packedPath = SkyboxFile::GetSkyboxPath(path);
+    AAsset* asset = AAssetManager_open(assetManager, packedPath.c_str(), AASSET_MODE_BUFFER);
+    if (asset == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<SkyboxJob> job = std::make_shared<SkyboxJob>();
+    job->path = packedPath;
+    job->asset = asset;
+    job->next_level = 0;
+    job->failed = false;
+    if (!SkyboxFile::Parse(AAsset_getBuffer(asset), static_cast<size_t>(AAsset_getLength(asset)),
+                           &job->header, &job->levels)) {
+        LOGW("parse packed skybox failed %s", packedPath.c_str());
+        AAsset_close(asset);
+        return nullptr;
+    }
+
+    // clear error.
+    glGetError();
+    job->texture.reset(Texture::GenTexture(path));
+    job->texture->BindTextureCubeMap();
+    glTexStorage2D(GL_TEXTURE_CUBE_MAP, job->header.levels, job->header.internal_format,
+                   job->header.face_size, job->header.face_size);
+    if (glGetError() != GL_NO_ERROR) {
+        // compressed format not supported by the driver.
+        LOGW("packed skybox format 0x%x not supported %s", job->header.internal_format, packedPath.c_str());
+        AAsset_close(asset);
+        return nullptr;
+    }
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, job->header.levels - 1);
+
+    bool streaming = true;
+    while (streaming && job->levels[job->next_level].size <= SKYBOX_INITIAL_SIZE) {
+        streaming = StreamSkybox(job.get());
+    }
+    if (job->failed && job->next_level == 0) {
+        // nothing to sample, decode the image instead.
+        AAsset_close(asset);
+        return nullptr;
+    }
+    if (streaming) {
+        skybox_jobs_.push_back(job);
+    } else {
+        AAsset_close(asset);
+    }
+    LOGV("load packed skybox %s size %u levels %u", packedPath.c_str(), job->header.face_size, job->header.levels);
+    return job->texture;
+}
+
+bool AssetLoader::StreamSkybox(SkyboxJob *job) {
+    const SkyboxFile::LevelView& view = job->levels[job->next_level];
+    // clear error.
+    glGetError();
+    job->texture->BindTextureCubeMap();
+    for (int face = 0; face < SkyboxFile::FACE_COUNT; face++) {
+        glCompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, view.level, 0, 0, view.size, view.size,
+                                  job->header.internal_format, view.face_bytes, view.faces[face]);
+    }
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        // keep the base level, stop streaming larger ones.
+        LOGW("upload packed skybox level %u failed 0x%x %s", view.level, error, job->path.c_str());
+        job->texture->UnbindTextureCubeMap();
+        job->failed = true;
+        return false;
+    }
+    // sample only uploaded levels.
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, view.level);
+    job->texture->UnbindTextureCubeMap();
+    job->next_level++;
+    return job->next_level < job->levels.size();
+}
+
+void AssetLoader::StartWorkers() {
+    if (!workers_.empty()) {
+        return;
+    }
+    for (int i = 0; i < WORKER_COUNT; i++) {
+        workers_.emplace_back(&AssetLoader::Run, this);
+    }
+}
+
+void AssetLoader::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cond_.wait(lock, [this] { return !running_ || !decode_queue_.empty() || !parse_queue_.empty(); });
+        if (!running_) {
+            break;
+        }
+        // textures first, models wait for the ones queued before them anyway.
+        if (!decode_queue_.empty()) {
+            std::shared_ptr<TextureJob> job = decode_queue_.front();
+            decode_queue_.pop_front();
+
+            lock.unlock();
+            Decode(job.get());
+            lock.lock();
+
+            decoded_.push_back(job);
+            continue;
+        }
+        std::shared_ptr<ModelJob> job = parse_queue_.front();
+        parse_queue_.pop_front();
+
+        lock.unlock();
+        bool res = job->model->Parse(job->nativeActivity);
+        lock.lock();
+
+        job->parse_result = res;
+        job->parsed = true;
+    }
+}
+
+void AssetLoader::Decode(TextureJob *job) {
+    // asset manager is thread safe, asset is only used in this thread.
+    AAsset* asset = AAssetManager_open(job->nativeActivity->assetManager, job->asset.path.c_str(), AASSET_MODE_BUFFER);
+    if (asset == nullptr) {
+        LOGW("open asset failed %s", job->asset.path.c_str());
+        return;
+    }
+    const void* data = AAsset_getBuffer(asset);
+    if (data != nullptr) {
+        int channels = 0;
+        job->pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data),
+                                            static_cast<int>(AAsset_getLength(asset)),
+                                            &job->width, &job->height, &channels, RGBA_CHANNELS);
+    }
+    AAsset_close(asset);
+}
+
+void AssetLoader::FinishTexture(TextureJob *job) {
+    std::shared_ptr<Texture> texture = nullptr;
+    if (job->pixels != nullptr) {
+        // texture owns the pixels, uploaded by the user like textures from Load.
+        Texture* loaded = Texture::SetupImageData(job->pixels, job->width, job->height, RGBA_CHANNELS, 0);
+        job->pixels = nullptr;
+        if (job->asset.type == TextureAssetType_Local_Skybox) {
+            loaded = Texture::SetupSkyboxTexture(loaded);
+        }
+        if (loaded != nullptr) {
+            texture.reset(loaded);
+            texture_map_.insert(TEXTURE_PAIR(job->asset.path, texture));
+        }
+    } else {
+        // format not supported by stb_image. fall back to android bitmap factory.
+        AndroidAssetContext context = {};
+        if (GetContext(job->nativeActivity, job->bitmapFactory, &context)) {
+            texture = LoadTexture(&context, job->asset);
+        }
+    }
+    if (!texture) {
+        LOGE("load texture async failed %s", job->asset.path.c_str());
+    }
+    job->promise.set_value(texture);
+}
+
+bool AssetLoader::ModelReady(ModelJob *job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!job->parsed) {
+            return false;
+        }
+    }
+    // models search their textures through the texture cache.
+    // textures queued after the model are not waited for.
+    for (auto & it : loading_textures_) {
+        if (it.second->serial <= job->texture_serial) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AssetLoader::FinishModel(ModelJob *job) {
+    bool loaded = job->parse_result;
+    if (loaded && job->model->pending_meshes() > 0) {
+        AndroidAssetContext context = {};
+        loaded = GetContext(job->nativeActivity, job->bitmapFactory, &context);
+        // next mesh in the budget left or the next frame.
+        if (loaded && job->model->UploadNext(&context)) {
+            return false;
+        }
+    }
+    std::shared_ptr<Model> model = nullptr;
+    if (loaded) {
+        model = job->model;
+        if (job->cached) {
+            model_map_.insert(MODEL_PAIR(job->asset.path, model));
+        }
+    } else {
+        LOGE("load model async failed %s", job->asset.path.c_str());
+    }
+    job->promise.set_value(model);
+    return true;
+}
+
+void AssetLoader::InitProgramCache(ANativeActivity *nativeActivity) {
+    if (ProgramCache::instance()->inited() || nativeActivity->internalDataPath == nullptr) {
+        return;
+    }
+    // program binaries kept in 【内部路径】/larkxr/program_cache
+    ProgramCache::instance()->Init(std::string(nativeActivity->internalDataPath) + "/larkxr/program_cache");
+}
+
+bool AssetLoader::GetContext(ANativeActivity *nativeActivity, BitmapFactory *bitmapFactory,
+                             AndroidAssetContext *context) {
+    JNIEnv* env = nullptr;
+    // render thread already attached.
+    if (nativeActivity->vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        LOGW("render thread not attached to jvm");
+        return false;
+    }
+    context->nativeActivity = nativeActivity;
+    context->env = env;
+    context->bitmapFactory = bitmapFactory;
+    return true;
+}
+
 std::shared_ptr<Shader>
 AssetLoader::LoadShader(AAssetManager *assetManager, const ShaderAsset &shaderAsset) {
     std::shared_ptr<Shader> shader = FindShader(shaderAsset.vertexPath, shaderAsset.fragmentPath);
@@ -142,6 +575,13 @@ std::shared_ptr<Texture> AssetLoader::LoadTexture(AndroidAssetContext *androidAs
         return sharedTexture;
     }
     std::string key = textureAsset.path;
+    if (textureAsset.type == TextureAssetType_Local_Skybox) {
+        sharedTexture = LoadPackedSkybox(androidAssetContext->nativeActivity->assetManager, textureAsset.path);
+        if (sharedTexture) {
+            texture_map_.insert(TEXTURE_PAIR(key, sharedTexture));
+            return sharedTexture;
+        }
+    }
     Texture* texture = nullptr;
     switch (textureAsset.type) {
         case TextureAssetType_Local_Normal:
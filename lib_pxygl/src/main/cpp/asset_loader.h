@@ -7,11 +7,17 @@
 
 #include <string>
 #include <map>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #ifdef __ANDROID__
 #include <android/native_activity.h>
 #endif
 #include "texture.h"
 #include "shader.h"
+#include "skybox_file.h"
 #include "pxygl.h"
 
 namespace lark {
@@ -77,13 +83,41 @@ bool CopyAssetToInternalPath(ANativeActivity* nativeActivity, const std::string&
 
 // pre decleare.
 class Model;
+
+// result of an async load, ready after AssetLoader::Update finished it on the render thread.
+// holds nullptr when load failed. never wait on the render thread.
+typedef std::shared_future<std::shared_ptr<Texture>> TextureFuture;
+typedef std::shared_future<std::shared_ptr<Model>> ModelFuture;
+
 class CLOUDLARK_PXYGL_API AssetLoader {
 public:
+    static const int WORKER_COUNT = 2;
+    // render thread time spent finishing loads in one Update.
+    static const uint64_t DEFAULT_UPDATE_BUDGET_NS = 4 * 1000 * 1000;
+    // prebuilt skybox levels up to this size are uploaded at load, larger ones streamed in Update.
+    static const uint32_t SKYBOX_INITIAL_SIZE = 128;
+
     static AssetLoader* instance();
     static void Release();
 
 #ifdef __ANDROID__
     void Load(AndroidAssetContext* androidAssetContext, const AssetLists& lists);
+    // start loading without blocking the render thread.
+    // shaders compiled at once, textures read and decoded on workers, models parsed on workers.
+    // model meshes uploaded after the textures queued before them, so model textures hit the cache.
+    // call Update every frame to finish the loads.
+    void LoadAsync(AndroidAssetContext* androidAssetContext, const AssetLists& lists);
+    TextureFuture LoadTextureAsync(AndroidAssetContext* androidAssetContext, const TextureAsset& textureAsset);
+    ModelFuture LoadModelAsync(AndroidAssetContext* context, const ModelAsset& modelAsset);
+    // model owned by the caller, not cached. future holds the same model when loaded.
+    ModelFuture LoadModelAsync(AndroidAssetContext* context, const std::shared_ptr<Model>& model);
+    // render thread. create gl objects of decoded assets within update_budget.
+    void Update();
+    // render thread. invalid future when path not loading.
+    TextureFuture FindLoadingTexture(const std::string& path);
+    // render thread. async loads not finished.
+    inline size_t pending() const { return loading_textures_.size() + model_queue_.size() + skybox_jobs_.size(); }
+    inline void set_update_budget(uint64_t ns) { update_budget_ns_ = ns; }
     std::shared_ptr<Shader> LoadShader(AAssetManager* assetManager, const ShaderAsset& shaderAsset);
     std::shared_ptr<Texture> LoadTexture(AndroidAssetContext* androidAssetContext, const TextureAsset& textureAsset);
     // TODO catce mesh and texture not model.
@@ -120,6 +154,65 @@ private:
     ~AssetLoader();
 
 #ifdef __ANDROID__
+    struct TextureJob {
+        TextureAsset asset;
+        ANativeActivity* nativeActivity;
+        BitmapFactory* bitmapFactory;
+        // decoded rgba, set by worker.
+        uint8_t* pixels;
+        int width;
+        int height;
+        // queue order, models wait for the textures with a smaller one.
+        uint64_t serial;
+        std::promise<std::shared_ptr<Texture>> promise;
+        TextureFuture future;
+    };
+    struct SkyboxJob {
+        std::string path;
+        // kept open while levels left.
+        AAsset* asset;
+        SkyboxFile::FileHeader header;
+        // from the smallest level.
+        std::vector<SkyboxFile::LevelView> levels;
+        size_t next_level;
+        // a level rejected by the driver, levels before it still sampled.
+        bool failed;
+        std::shared_ptr<Texture> texture;
+    };
+    struct ModelJob {
+        ModelAsset asset;
+        ANativeActivity* nativeActivity;
+        BitmapFactory* bitmapFactory;
+        std::shared_ptr<Model> model;
+        // put in model_map_ when loaded.
+        bool cached;
+        // serial of the last texture queued before the model.
+        uint64_t texture_serial;
+        // set by worker.
+        bool parsed;
+        bool parse_result;
+        std::promise<std::shared_ptr<Model>> promise;
+        ModelFuture future;
+    };
+
+    void StartWorkers();
+    void Run();
+    static void Decode(TextureJob* job);
+    void FinishTexture(TextureJob* job);
+    ModelFuture QueueModel(const std::shared_ptr<ModelJob>& job);
+    // parsed and the textures queued before it finished.
+    bool ModelReady(ModelJob* job);
+    // upload one mesh. return true when the model finished.
+    bool FinishModel(ModelJob* job);
+    // .pxysky next to the skybox image. nullptr when missing or not supported.
+    std::shared_ptr<Texture> LoadPackedSkybox(AAssetManager* assetManager, const std::string& path);
+    // upload the next level. return false when all levels uploaded or the upload failed.
+    static bool StreamSkybox(SkyboxJob* job);
+    // before the first shader compiled.
+    static void InitProgramCache(ANativeActivity* nativeActivity);
+    // render thread env for jobs finished in Update.
+    static bool GetContext(ANativeActivity* nativeActivity, BitmapFactory* bitmapFactory, AndroidAssetContext* context);
+
     bool LoadAssetShaderFile(AAssetManager* assetManager, ShaderAsset& shaderAsset);
 #else
     bool LoadAssetShaderFile(ShaderAsset& shaderAsset);
@@ -131,6 +224,23 @@ private:
     MODEL_MAP model_map_ = {};
 
     std::string assets_base_path_ = "";
+
+#ifdef __ANDROID__
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool running_ = true;
+    std::deque<std::shared_ptr<TextureJob>> decode_queue_;
+    std::deque<std::shared_ptr<TextureJob>> decoded_;
+    std::deque<std::shared_ptr<ModelJob>> parse_queue_;
+
+    // render thread.
+    std::map<std::string, std::shared_ptr<TextureJob>> loading_textures_;
+    std::deque<std::shared_ptr<ModelJob>> model_queue_;
+    std::deque<std::shared_ptr<SkyboxJob>> skybox_jobs_;
+    uint64_t texture_serial_ = 0;
+    uint64_t update_budget_ns_ = DEFAULT_UPDATE_BUDGET_NS;
+#endif
 };
 }
 #endif //CLOUDLARKXR_ASSET_LOADER_H
@@ -4,6 +4,8 @@
 
 #include "bitmap_factory.h"
 #include "logger.h"
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 
 #ifdef __ANDROID__
@@ -33,10 +35,7 @@ void BitmapFactory::Clean(JNIEnv *env) {
 
 uint8_t *BitmapFactory::DecodeByteArray(JNIEnv *env, const void *array, size_t size,
                                         AndroidBitmapInfo &outputInfo) {
-    jbyteArray jarray = env->NewByteArray(size);
-    env->SetByteArrayRegion(jarray, 0, size, (jbyte *) array);
-
-    jobject jBitmap = env->CallStaticObjectMethod(bitmap_factory_class_, id_decord_byte_array_, jarray, 0, size);
+    jobject jBitmap = DecodeJavaBitmap(env, array, size);
     uint8_t * pixels = nullptr;
     if (jBitmap == nullptr) {
         LOGE("Unable to decode");
@@ -45,10 +44,31 @@ uint8_t *BitmapFactory::DecodeByteArray(JNIEnv *env, const void *array, size_t s
         RecycleBitmap(env, jBitmap);
         env->DeleteLocalRef(jBitmap);
     }
-    env->DeleteLocalRef(jarray);
     return pixels;
 }
 
+bool BitmapFactory::DecodeByteArray(JNIEnv *env, const void *array, size_t size,
+                                    const ImageDecoder::Consumer &consumer) {
+    jobject jBitmap = DecodeJavaBitmap(env, array, size);
+    if (jBitmap == nullptr) {
+        LOGE("Unable to decode");
+        return false;
+    }
+    bool res = LockBitmap(env, jBitmap, consumer);
+    RecycleBitmap(env, jBitmap);
+    env->DeleteLocalRef(jBitmap);
+    return res;
+}
+
+jobject BitmapFactory::DecodeJavaBitmap(JNIEnv *env, const void *array, size_t size) {
+    jbyteArray jarray = env->NewByteArray(size);
+    env->SetByteArrayRegion(jarray, 0, size, (jbyte *) array);
+    jobject jBitmap = env->CallStaticObjectMethod(bitmap_factory_class_, id_decord_byte_array_, jarray, 0, size);
+    // java byte array not needed after decode.
+    env->DeleteLocalRef(jarray);
+    return jBitmap;
+}
+
 uint8_t *
 BitmapFactory::DecodeBitmap(JNIEnv *env, jobject jBitmap, AndroidBitmapInfo &outputInfo) {
     uint8_t * pixels = nullptr;
@@ -84,10 +104,67 @@ uint8_t *BitmapFactory::DecodeAndroidBitmap(JNIEnv *env, jobject jBitmap,
     }
     outputInfo = info;
     const size_t bmpSize = info.stride * info.height;
-    auto bitmap = new uint8_t [bmpSize];
+    // freed with stbi_image_free in Texture.
+    auto bitmap = static_cast<uint8_t *>(malloc(bmpSize));
     memcpy(bitmap, bitmapPixels, bmpSize);
     AndroidBitmap_unlockPixels(env, jBitmap);
     return bitmap;
 }
+
+bool BitmapFactory::LockBitmap(JNIEnv *env, jobject jBitmap, const ImageDecoder::Consumer &consumer) {
+    int ret = -1;
+    AndroidBitmapInfo info;
+    if ((ret = AndroidBitmap_getInfo(env, jBitmap, &info)) < 0) {
+        LOGE("AndroidBitmap_getInfo() failed ! error=%d", ret);
+        return false;
+    }
+    ImageDecoder::Pixels pixels = {};
+    pixels.width = info.width;
+    pixels.height = info.height;
+    pixels.stride = info.stride;
+    switch (info.format) {
+        case ANDROID_BITMAP_FORMAT_RGB_565:
+            pixels.format = GL_RGB;
+            pixels.type = GL_UNSIGNED_SHORT_5_6_5;
+            pixels.bytes_per_pixel = 2;
+            break;
+        case ANDROID_BITMAP_FORMAT_RGBA_4444:
+            pixels.format = GL_RGBA;
+            pixels.type = GL_UNSIGNED_SHORT_4_4_4_4;
+            pixels.bytes_per_pixel = 2;
+            break;
+        case ANDROID_BITMAP_FORMAT_A_8:
+            pixels.format = GL_RED;
+            pixels.type = GL_UNSIGNED_BYTE;
+            pixels.bytes_per_pixel = 1;
+            break;
+        default:
+            pixels.format = GL_RGBA;
+            pixels.type = GL_UNSIGNED_BYTE;
+            pixels.bytes_per_pixel = 4;
+            break;
+    }
+    void* bitmapPixels = nullptr;
+    if ((ret = AndroidBitmap_lockPixels(env, jBitmap, &bitmapPixels)) < 0) {
+        LOGE("AndroidBitmap_lockPixels() failed ! error=%d", ret);
+        return false;
+    }
+    pixels.data = static_cast<const uint8_t *>(bitmapPixels);
+    consumer(pixels);
+    AndroidBitmap_unlockPixels(env, jBitmap);
+    return true;
+}
+
+BitmapFactoryDecoder::BitmapFactoryDecoder(BitmapFactory *bitmapFactory, JNIEnv *env):
+    bitmap_factory_(bitmapFactory),
+    env_(env) {
+}
+
+bool BitmapFactoryDecoder::Decode(const void *data, size_t size, const Consumer &consumer) {
+    if (bitmap_factory_ == nullptr || env_ == nullptr) {
+        return false;
+    }
+    return bitmap_factory_->DecodeByteArray(env_, data, size, consumer);
+}
 }
 #endif
@@ -8,6 +8,7 @@
 #ifdef __ANDROID__
 #include <jni.h>
 #include <android/bitmap.h>
+#include "image_decoder.h"
 
 namespace lark {
 class BitmapFactory {
@@ -18,9 +19,13 @@ public:
     /**
      * Put the source file byte array, and its size in byte.  And return the
      * decoded void* bitmap array.  You can retrive bitmap info from outputInfo.
-     * Remember to delete returned array.
+     * Remember to free returned array.
     **/
     uint8_t * DecodeByteArray(JNIEnv * env, const void * array, size_t size, AndroidBitmapInfo & outputInfo);
+    /**
+     * Decode and pass the locked bitmap pixels to consumer, no copy out of the java bitmap.
+     */
+    bool DecodeByteArray(JNIEnv * env, const void * array, size_t size, const ImageDecoder::Consumer & consumer);
     /**
      *
      */
@@ -29,11 +34,24 @@ public:
 private:
     void RecycleBitmap(JNIEnv *env, jobject bitmap);
     uint8_t * DecodeAndroidBitmap(JNIEnv * env, jobject jBitmap, AndroidBitmapInfo & outputInfo);
+    jobject DecodeJavaBitmap(JNIEnv * env, const void * array, size_t size);
+    bool LockBitmap(JNIEnv * env, jobject jBitmap, const ImageDecoder::Consumer & consumer);
 
     jclass bitmap_factory_class_;
     jmethodID id_decord_byte_array_;
 
 };
+
+// BitmapFactory bound to the env of the calling thread.
+class BitmapFactoryDecoder: public ImageDecoder {
+public:
+    BitmapFactoryDecoder(BitmapFactory* bitmapFactory, JNIEnv* env);
+
+    bool Decode(const void* data, size_t size, const Consumer& consumer) override;
+private:
+    BitmapFactory* bitmap_factory_;
+    JNIEnv* env_;
+};
 }
 #endif
 
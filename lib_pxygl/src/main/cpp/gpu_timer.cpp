@@ -0,0 +1,103 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "gpu_timer.h"
+#include "object.h"
+#include "logger.h"
+#ifdef __ANDROID__
+#include <EGL/egl.h>
+#endif
+
+#define LOG_TAG "pxygl_GpuTimer"
+
+#ifndef GL_TIME_ELAPSED_EXT
+#define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace {
+#ifdef __ANDROID__
+    typedef void(*PFNGLGETQUERYOBJECTUI64VEXT)(GLuint, GLenum, GLuint64*);
+    PFNGLGETQUERYOBJECTUI64VEXT glGetQueryObjectui64vEXT = nullptr;
+#endif
+    // -1 not checked.
+    int supported = -1;
+}
+
+namespace lark {
+bool GpuTimer::IsSupported() {
+    if (supported < 0) {
+#ifdef __ANDROID__
+        // ES 3.0 core query functions accept GL_TIME_ELAPSED_EXT, only 64 bit result needs the extension entry.
+        glGetQueryObjectui64vEXT = (PFNGLGETQUERYOBJECTUI64VEXT) eglGetProcAddress("glGetQueryObjectui64vEXT");
+        supported = Object::HasGlExtension("GL_EXT_disjoint_timer_query") && glGetQueryObjectui64vEXT != nullptr ? 1 : 0;
+#else
+        supported = 1;
+#endif
+        LOGV("GL_EXT_disjoint_timer_query supported %d", supported);
+    }
+    return supported == 1;
+}
+
+GpuTimer::GpuTimer() = default;
+
+GpuTimer::~GpuTimer() {
+    if (created_) {
+        glDeleteQueries(QUERY_COUNT, queries_);
+        created_ = false;
+    }
+}
+
+void GpuTimer::Begin() {
+    if (running_ || !IsSupported() || pending_ == QUERY_COUNT) {
+        return;
+    }
+    if (!created_) {
+        glGenQueries(QUERY_COUNT, queries_);
+        created_ = true;
+    }
+    glBeginQuery(GL_TIME_ELAPSED_EXT, queries_[head_]);
+    running_ = true;
+}
+
+void GpuTimer::End() {
+    if (!running_) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    running_ = false;
+    head_ = (head_ + 1) % QUERY_COUNT;
+    pending_++;
+}
+
+bool GpuTimer::Poll(uint64_t *elapsedNs) {
+    bool res = false;
+    while (pending_ > 0) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(queries_[tail_], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        // timer values undefined after a disjoint event like a frequency change.
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        GLuint64 elapsed = 0;
+#ifdef __ANDROID__
+        glGetQueryObjectui64vEXT(queries_[tail_], GL_QUERY_RESULT, &elapsed);
+#else
+        glGetQueryObjectui64v(queries_[tail_], GL_QUERY_RESULT, &elapsed);
+#endif
+        tail_ = (tail_ + 1) % QUERY_COUNT;
+        pending_--;
+        if (!disjoint) {
+            *elapsedNs = elapsed;
+            res = true;
+        }
+    }
+    return res;
+}
+}
@@ -0,0 +1,44 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_GPU_TIMER_H
+#define CLOUDLARKXR_GPU_TIMER_H
+
+#include <cstdint>
+#include "pxygl.h"
+
+namespace lark {
+//
+// gpu time of a range of gl commands with GL_EXT_disjoint_timer_query.
+// results arrive some frames later, several queries are kept in flight so Poll never stalls.
+// only one timer may be running at a time in a context. render thread only.
+//
+class CLOUDLARK_PXYGL_API GpuTimer {
+public:
+    static const int QUERY_COUNT = 4;
+
+    // extension available in current context.
+    static bool IsSupported();
+
+    GpuTimer();
+    ~GpuTimer();
+
+    // range skipped when all queries still in flight.
+    void Begin();
+    void End();
+    // collect finished queries. return true and the newest result when any finished,
+    // results of disjoint ranges are dropped.
+    bool Poll(uint64_t* elapsedNs);
+private:
+    GLuint queries_[QUERY_COUNT] = {};
+    bool created_ = false;
+    bool running_ = false;
+    // next query to begin, oldest query in flight.
+    int head_ = 0;
+    int tail_ = 0;
+    int pending_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_GPU_TIMER_H
@@ -0,0 +1,173 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "image_decoder.h"
+#include "stb_image.h"
+#include "logger.h"
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#include <android/bitmap.h>
+#endif
+
+#define LOG_TAG "pxygl_ImageDecoder"
+
+#ifdef __ANDROID__
+// android/imagedecoder.h hides the api below android 30.
+struct AImageDecoder;
+struct AImageDecoderHeaderInfo;
+
+namespace {
+    const int IMAGE_DECODER_SUCCESS = 0;
+
+    struct NdkImageDecoderApi {
+        int (*createFromBuffer)(const void* buffer, size_t length, AImageDecoder** outDecoder);
+        void (*deleteDecoder)(AImageDecoder* decoder);
+        int (*setAndroidBitmapFormat)(AImageDecoder* decoder, int32_t format);
+        const AImageDecoderHeaderInfo* (*getHeaderInfo)(const AImageDecoder* decoder);
+        int32_t (*getWidth)(const AImageDecoderHeaderInfo* info);
+        int32_t (*getHeight)(const AImageDecoderHeaderInfo* info);
+        size_t (*getMinimumStride)(AImageDecoder* decoder);
+        int (*decodeImage)(AImageDecoder* decoder, void* pixels, size_t stride, size_t size);
+    };
+
+    template<typename T>
+    bool LoadSymbol(void* lib, const char* name, T* func) {
+        *func = reinterpret_cast<T>(dlsym(lib, name));
+        return *func != nullptr;
+    }
+
+    const NdkImageDecoderApi* GetNdkImageDecoderApi() {
+        static NdkImageDecoderApi api = {};
+        static bool loaded = [] {
+            void* lib = dlopen("libjnigraphics.so", RTLD_NOW);
+            if (lib == nullptr) {
+                return false;
+            }
+            bool res = LoadSymbol(lib, "AImageDecoder_createFromBuffer", &api.createFromBuffer) &&
+                    LoadSymbol(lib, "AImageDecoder_delete", &api.deleteDecoder) &&
+                    LoadSymbol(lib, "AImageDecoder_setAndroidBitmapFormat", &api.setAndroidBitmapFormat) &&
+                    LoadSymbol(lib, "AImageDecoder_getHeaderInfo", &api.getHeaderInfo) &&
+                    LoadSymbol(lib, "AImageDecoderHeaderInfo_getWidth", &api.getWidth) &&
+                    LoadSymbol(lib, "AImageDecoderHeaderInfo_getHeight", &api.getHeight) &&
+                    LoadSymbol(lib, "AImageDecoder_getMinimumStride", &api.getMinimumStride) &&
+                    LoadSymbol(lib, "AImageDecoder_decodeImage", &api.decodeImage);
+            LOGV("AImageDecoder %s", res ? "supported" : "not supported");
+            return res;
+        }();
+        return loaded ? &api : nullptr;
+    }
+}
+#endif
+
+namespace lark {
+uint8_t *ImageDecoder::DecodeBuffer(const void *data, size_t size, Pixels *pixels) {
+    uint8_t* buffer = nullptr;
+    Decode(data, size, [&](const Pixels& decoded) {
+        const size_t bufferSize = decoded.stride * decoded.height;
+        buffer = static_cast<uint8_t *>(malloc(bufferSize));
+        if (buffer == nullptr) {
+            return;
+        }
+        memcpy(buffer, decoded.data, bufferSize);
+        *pixels = decoded;
+        pixels->data = buffer;
+    });
+    return buffer;
+}
+
+bool StbImageDecoder::Decode(const void *data, size_t size, const Consumer &consumer) {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(static_cast<const stbi_uc*>(data), static_cast<int>(size),
+                                            &width, &height, &channels, 4);
+    if (pixels == nullptr) {
+        return false;
+    }
+    Pixels res = { pixels, width, height, width * 4, GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+    consumer(res);
+    stbi_image_free(pixels);
+    return true;
+}
+
+uint8_t *StbImageDecoder::DecodeBuffer(const void *data, size_t size, Pixels *pixels) {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    // stbi_image_free is free.
+    stbi_uc* buffer = stbi_load_from_memory(static_cast<const stbi_uc*>(data), static_cast<int>(size),
+                                            &width, &height, &channels, 4);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    *pixels = { buffer, width, height, width * 4, GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+    return buffer;
+}
+
+#ifdef __ANDROID__
+bool NdkImageDecoder::IsSupported() {
+    return GetNdkImageDecoderApi() != nullptr;
+}
+
+bool NdkImageDecoder::Decode(const void *data, size_t size, const Consumer &consumer) {
+    std::unique_ptr<uint8_t[]> buffer;
+    Pixels pixels = {};
+    if (Decode(data, size, &pixels, [&](size_t bufferSize) {
+        buffer.reset(new uint8_t[bufferSize]);
+        return buffer.get();
+    }) == nullptr) {
+        return false;
+    }
+    consumer(pixels);
+    return true;
+}
+
+uint8_t *NdkImageDecoder::DecodeBuffer(const void *data, size_t size, Pixels *pixels) {
+    uint8_t* buffer = nullptr;
+    if (Decode(data, size, pixels, [&](size_t bufferSize) {
+        buffer = static_cast<uint8_t *>(malloc(bufferSize));
+        return buffer;
+    }) == nullptr) {
+        free(buffer);
+        return nullptr;
+    }
+    return buffer;
+}
+
+uint8_t *NdkImageDecoder::Decode(const void *data, size_t size, Pixels *pixels,
+                                 const std::function<uint8_t *(size_t)> &allocator) {
+    const NdkImageDecoderApi* api = GetNdkImageDecoderApi();
+    if (api == nullptr) {
+        return nullptr;
+    }
+    AImageDecoder* decoder = nullptr;
+    if (api->createFromBuffer(data, size, &decoder) != IMAGE_DECODER_SUCCESS) {
+        return nullptr;
+    }
+    std::unique_ptr<AImageDecoder, void (*)(AImageDecoder*)> decoderHolder(decoder, api->deleteDecoder);
+    if (api->setAndroidBitmapFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888) != IMAGE_DECODER_SUCCESS) {
+        return nullptr;
+    }
+    const AImageDecoderHeaderInfo* info = api->getHeaderInfo(decoder);
+    int width = api->getWidth(info);
+    int height = api->getHeight(info);
+    size_t stride = api->getMinimumStride(decoder);
+    uint8_t* buffer = allocator(stride * height);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+    int ret = api->decodeImage(decoder, buffer, stride, stride * height);
+    if (ret != IMAGE_DECODER_SUCCESS) {
+        LOGW("AImageDecoder decode failed %d", ret);
+        return nullptr;
+    }
+    *pixels = { buffer, width, height, static_cast<int>(stride), GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+    return buffer;
+}
+#endif
+}
@@ -0,0 +1,71 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_IMAGE_DECODER_H
+#define CLOUDLARKXR_IMAGE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "pxygl.h"
+
+namespace lark {
+//
+// decode an encoded image and hand the pixels to a consumer, which uploads or copies them.
+// pixels belong to the decoder and are only valid inside the consumer call, so a decoder
+// can pass its locked or mapped memory without an extra copy.
+//
+class CLOUDLARK_PXYGL_API ImageDecoder {
+public:
+    struct Pixels {
+        const uint8_t* data;
+        int width;
+        int height;
+        // bytes per row.
+        int stride;
+        // gl upload format and type.
+        GLenum format;
+        GLenum type;
+        int bytes_per_pixel;
+    };
+    typedef std::function<void(const Pixels& pixels)> Consumer;
+
+    virtual ~ImageDecoder() = default;
+
+    // return false when decode failed, consumer not called.
+    virtual bool Decode(const void* data, size_t size, const Consumer& consumer) = 0;
+    // decode into a malloc buffer kept by the caller and freed once with free, pixels->data points to it.
+    // return nullptr when decode failed. by default a copy of the consumer pixels,
+    // decoders able to write to the caller memory decode into it directly.
+    virtual uint8_t* DecodeBuffer(const void* data, size_t size, Pixels* pixels);
+};
+
+// stb_image, rgba8. all platforms.
+class CLOUDLARK_PXYGL_API StbImageDecoder: public ImageDecoder {
+public:
+    bool Decode(const void* data, size_t size, const Consumer& consumer) override;
+    // the stb_image result itself.
+    uint8_t* DecodeBuffer(const void* data, size_t size, Pixels* pixels) override;
+};
+
+#ifdef __ANDROID__
+//
+// AImageDecoder from libjnigraphics, android 11 (api 30) and later.
+// decodes from the native buffer without java byte array and bitmap.
+// resolved at runtime since min sdk is lower.
+//
+class CLOUDLARK_PXYGL_API NdkImageDecoder: public ImageDecoder {
+public:
+    static bool IsSupported();
+
+    bool Decode(const void* data, size_t size, const Consumer& consumer) override;
+    uint8_t* DecodeBuffer(const void* data, size_t size, Pixels* pixels) override;
+private:
+    // decode to memory from allocator, nullptr when failed.
+    uint8_t* Decode(const void* data, size_t size, Pixels* pixels, const std::function<uint8_t*(size_t)>& allocator);
+};
+#endif
+}
+
+#endif //CLOUDLARKXR_IMAGE_DECODER_H
@@ -36,6 +36,36 @@ namespace {
                                      "    Normal = mat3(transpose(inverse(uModel))) * aNormal;\n"
                                      "    gl_Position = uProjection * uView * vec4(FragPos, 1.0);\n"
                                      "}";
+    // vertex shader for GL_OVR_multiview2, view and projection indexed by view id.
+    const char* multiviewVertexShaderSource =
+#ifdef __ANDROID__
+                                     "#version 300 es\n"
+#else
+                                     "#version 410 core\n"
+#endif
+                                     "#extension GL_OVR_multiview2 : require\n"
+                                     "layout(num_views = 2) in;\n"
+                                     "\n"
+                                     "  layout (location = 0) in vec3 aPos;\n"
+                                     "  layout (location = 1) in vec3 aNormal;\n"
+                                     "  layout (location = 2) in vec2 aTexCoords;\n"
+                                     "\n"
+                                     "  uniform mat4 uModel;\n"
+                                     "  layout(std140) uniform SceneMatrices {\n"
+                                     "      mat4 uViews[2];\n"
+                                     "      mat4 uProjections[2];\n"
+                                     "  };\n"
+                                     "\n"
+                                     "  out vec3 FragPos;\n"
+                                     "  out vec3 Normal;\n"
+                                     "  out vec2 TexCoords;\n"
+                                     "void main()\n"
+                                     "{\n"
+                                     "    TexCoords = aTexCoords;\n"
+                                     "    FragPos = vec3(uModel * vec4(aPos, 1.0));\n"
+                                     "    Normal = mat3(transpose(inverse(uModel))) * aNormal;\n"
+                                     "    gl_Position = uProjections[gl_ViewID_OVR] * uViews[gl_ViewID_OVR] * vec4(FragPos, 1.0);\n"
+                                     "}";
     const char * fragmentShaderSource = 
 #ifdef __ANDROID__
                                         "#version 300 es\n"
@@ -119,17 +149,15 @@ void Mesh::Init() {
 
     LoadShader("shader/vertex/mesh_vertex.glsl", "shader/fragment/mesh_fragment.glsl", vertexShaderSource, fragmentShaderSource);
 
-    model_location_ = shader_->GetUniformLocation("uModel");
-    view_location_ = shader_->GetUniformLocation("uView");
-    projection_location_ = shader_->GetUniformLocation("uProjection");
+    uniforms_ = GetUniforms(shader_.get());
+    uniforms_.view = shader_->GetUniformLocation("uView");
+    uniforms_.projection = shader_->GetUniformLocation("uProjection");
 
-    color_loaction_ = shader_->GetUniformLocation("uColor");
-    light_position_location_ = shader_->GetUniformLocation("uLight.position");
-    light_ambient_location_ = shader_->GetUniformLocation("uLight.ambient");
-    light_diffuse_location_ = shader_->GetUniformLocation("uLight.diffuse");
-    light_specular_location_ = shader_->GetUniformLocation("uLight.specular");
-    view_pos_location_ = shader_->GetUniformLocation("uViewPos");
-    shininess_location_ = shader_->GetUniformLocation("uShininess");
+    LoadMultviewShader("shader/vertex/mesh_multiview_vertex.glsl", "shader/fragment/mesh_fragment.glsl",
+                       multiviewVertexShaderSource, fragmentShaderSource);
+    if (multiview_shader_) {
+        multiview_uniforms_ = GetUniforms(multiview_shader_.get());
+    }
 
     vao_ = std::make_shared<VertexArrayObject>(true, true);
     enable_ = true;
@@ -171,6 +199,45 @@ void Mesh::SetupMesh() {
     vao_->UnbindVAO();
     vao_->UnbindArrayBuffer();
 
+    index_count_ = static_cast<GLsizei>(indices_.size());
+    index_type_ = GL_UNSIGNED_INT;
+
+    if (HasGLError()) {
+        enable_ = false;
+    }
+}
+
+void Mesh::SetupPackedMesh(const MeshFile::MeshView &mesh) {
+    if(!enable_ || vao_ == nullptr) {
+        return;
+    }
+    const MeshFile::MeshHeader* header = mesh.header;
+    vao_->BindVAO();
+    vao_->BindArrayBuffer();
+    glBufferData(GL_ARRAY_BUFFER, header->vertex_data_size, mesh.vertices, GL_STATIC_DRAW);
+    vao_->BindElementArrayBuffer();
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, header->index_data_size, mesh.indices, GL_STATIC_DRAW);
+
+    GLsizei stride = header->vertex_stride;
+    // vertex Positions
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, header->position_format == MeshFile::PositionFormat_Half ? GL_HALF_FLOAT : GL_FLOAT,
+                          GL_FALSE, stride, (void*)nullptr);
+    // vertex normals, normalized to [-1, 1], w ignored by the vec3 input.
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride,
+                          (void*)(uintptr_t)MeshFile::GetNormalOffset(header->position_format));
+    // vertex texture coords
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride,
+                          (void*)(uintptr_t)MeshFile::GetTexCoordOffset(header->position_format));
+
+    vao_->UnbindVAO();
+    vao_->UnbindArrayBuffer();
+
+    index_count_ = static_cast<GLsizei>(header->index_count);
+    index_type_ = header->index_size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
     if (HasGLError()) {
         enable_ = false;
     }
@@ -183,18 +250,86 @@ void Mesh::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView)
     Object::Draw(eye, projection, eyeView);
     shader_->UseProgram();
     // mvp
-    glUniformMatrix4fv(model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
-    glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(eyeView));
-    glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniformMatrix4fv(uniforms_.view, 1, GL_FALSE, glm::value_ptr(eyeView));
+    glUniformMatrix4fv(uniforms_.projection, 1, GL_FALSE, glm::value_ptr(projection));
+    DrawMesh(shader_.get(), uniforms_, eyeView);
+    shader_->UnUseProgram();
+
+    HasGLError();
+}
+
+void Mesh::DrawMultiview(const glm::mat4& projection, const glm::mat4& eyeView)
+{
+    if (!enable_ || vao_ == nullptr || !multiview_shader_)
+        return;
+
+    Object::DrawMultiview(projection, eyeView);
+
+    // view and projection from scene matrices.
+    multiview_shader_->UseProgram();
+    DrawMesh(multiview_shader_.get(), multiview_uniforms_, eyeView);
+    multiview_shader_->UnUseProgram();
+
+    HasGLError();
+}
+
+void Mesh::Submit(RenderQueue *queue, Eye eye, const glm::mat4 &projection, const glm::mat4 &view) {
+    if (!enable_  || vao_ == nullptr || !shader_)
+        return;
+
+    DrawItem item = MakeDrawItem(shader_.get(), view);
+    item.draw = [this, eye, projection, view]() {
+        Draw(eye, projection, view);
+    };
+    queue->Submit(std::move(item));
+}
+
+void Mesh::SubmitMultiview(RenderQueue *queue, const glm::mat4 &projection, const glm::mat4 &view) {
+    if (!enable_ || vao_ == nullptr || !multiview_shader_)
+        return;
+
+    DrawItem item = MakeDrawItem(multiview_shader_.get(), view);
+    item.draw = [this, projection, view]() {
+        DrawMultiview(projection, view);
+    };
+    queue->Submit(std::move(item));
+}
+
+DrawItem Mesh::MakeDrawItem(Shader *shader, const glm::mat4 &view) {
+    DrawItem item = {};
+    item.program = shader->program_id();
+    // DrawMesh binds the first texture only.
+    item.texture = textures_.empty() ? 0 : textures_[0]->texture();
+    item.vertex_array = vao_->vertex_array_object();
+    item.depth = -(view * GetTransforms()[3]).z;
+    item.transparent = color_.a < 1.0F;
+    return item;
+}
+
+Mesh::Uniforms Mesh::GetUniforms(Shader* shader) {
+    Uniforms uniforms = {};
+    uniforms.model = shader->GetUniformLocation("uModel");
+    uniforms.color = shader->GetUniformLocation("uColor");
+    uniforms.light_position = shader->GetUniformLocation("uLight.position");
+    uniforms.light_ambient = shader->GetUniformLocation("uLight.ambient");
+    uniforms.light_diffuse = shader->GetUniformLocation("uLight.diffuse");
+    uniforms.light_specular = shader->GetUniformLocation("uLight.specular");
+    uniforms.view_pos = shader->GetUniformLocation("uViewPos");
+    uniforms.shininess = shader->GetUniformLocation("uShininess");
+    return uniforms;
+}
+
+void Mesh::DrawMesh(Shader* shader, const Uniforms& uniforms, const glm::mat4& eyeView) {
+    glUniformMatrix4fv(uniforms.model, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
     // light properties
-    glUniform4fv(color_loaction_, 1, glm::value_ptr(color_));
-    glUniform3fv(light_position_location_, 1, glm::value_ptr(light_.posotion));
-    glUniform3fv(light_ambient_location_, 1, glm::value_ptr(light_.ambient));
-    glUniform3fv(light_diffuse_location_, 1, glm::value_ptr(light_.diffuse));
-    glUniform3fv(light_specular_location_, 1, glm::value_ptr(light_.specular));
+    glUniform4fv(uniforms.color, 1, glm::value_ptr(color_));
+    glUniform3fv(uniforms.light_position, 1, glm::value_ptr(light_.posotion));
+    glUniform3fv(uniforms.light_ambient, 1, glm::value_ptr(light_.ambient));
+    glUniform3fv(uniforms.light_diffuse, 1, glm::value_ptr(light_.diffuse));
+    glUniform3fv(uniforms.light_specular, 1, glm::value_ptr(light_.specular));
 
-    glUniform3fv(view_pos_location_, 1, glm::value_ptr(glm::vec3(eyeView[3][0], eyeView[3][1], eyeView[3][2])));
-    glUniform1f(shininess_location_, shininess_);
+    glUniform3fv(uniforms.view_pos, 1, glm::value_ptr(glm::vec3(eyeView[3][0], eyeView[3][1], eyeView[3][2])));
+    glUniform1f(uniforms.shininess, shininess_);
 
     // bind appropriate textures
     unsigned int diffuseNr  = 1;
@@ -207,7 +342,7 @@ void Mesh::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView)
         // shader only support 1 texture
         for(unsigned int i = 0; i < 1; i++)
         {
-            glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
+            RenderState::instance()->ActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
             // retrieve texture number (the N in diffuse_textureN)
             std::string number;
             std::string name = textures_[i]->type_name();
@@ -221,7 +356,7 @@ void Mesh::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView)
                 number = std::to_string(heightNr++); // transfer unsigned int to stream
 
             // now set the sampler to the correct texture unit
-            glUniform1i(shader_->GetUniformLocation((name + number).c_str()), i);
+            glUniform1i(shader->GetUniformLocation((name + number).c_str()), i);
             // and finally bind the texture
             textures_[i]->BindTexture();
         }
@@ -229,74 +364,10 @@ void Mesh::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView)
 
     // draw mesh
     vao_->BindVAO();
-    glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, nullptr);
-    vao_->UnbindVAO();
-
-    // always good practice to set everything back to defaults once configured.
-    glActiveTexture(GL_TEXTURE0);
-    shader_->UnUseProgram();
-
-    HasGLError();
-}
-void Mesh::DrawMultiview(const glm::mat4& projection, const glm::mat4& eyeView)
-{
-    if (!enable_ || vao_ == nullptr)
-        return;
-
-    Object::DrawMultiview(projection, eyeView);
-
-    multiview_shader_->UseProgram();
-    // mvp
-    glUniformMatrix4fv(model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
-    glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(eyeView));
-    glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
-    // light properties
-    glUniform4fv(color_loaction_, 1, glm::value_ptr(color_));
-    glUniform3fv(light_position_location_, 1, glm::value_ptr(light_.posotion));
-    glUniform3fv(light_ambient_location_, 1, glm::value_ptr(light_.ambient));
-    glUniform3fv(light_diffuse_location_, 1, glm::value_ptr(light_.diffuse));
-    glUniform3fv(light_specular_location_, 1, glm::value_ptr(light_.specular));
-
-    glUniform3fv(view_pos_location_, 1, glm::value_ptr(glm::vec3(eyeView[3][0], eyeView[3][1], eyeView[3][2])));
-    glUniform1f(shininess_location_, shininess_);
-
-    // bind appropriate textures
-    unsigned int diffuseNr  = 1;
-    unsigned int specularNr = 1;
-    unsigned int normalNr   = 1;
-    unsigned int heightNr   = 1;
-//    for(unsigned int i = 0; i < textures_.size(); i++)
-    // shader only support 1 texture
-    for(unsigned int i = 0; i < 1; i++)
-    {
-        glActiveTexture(GL_TEXTURE0 + i); // active proper texture unit before binding
-        // retrieve texture number (the N in diffuse_textureN)
-        std::string number;
-        std::string name = textures_[i]->type_name();
-        if(name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-        else if(name == "texture_specular")
-            number = std::to_string(specularNr++); // transfer unsigned int to stream
-        else if(name == "texture_normal")
-            number = std::to_string(normalNr++); // transfer unsigned int to stream
-        else if(name == "texture_height")
-            number = std::to_string(heightNr++); // transfer unsigned int to stream
-
-        // now set the sampler to the correct texture unit
-        glUniform1i(shader_->GetUniformLocation((name + number).c_str()), i);
-        // and finally bind the texture
-        textures_[i]->BindTexture();
-    }
-
-    // draw mesh
-    vao_->BindVAO();
-    glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, index_count_, index_type_, nullptr);
     vao_->UnbindVAO();
 
     // always good practice to set everything back to defaults once configured.
-    glActiveTexture(GL_TEXTURE0);
-    multiview_shader_->UnUseProgram();
-
-    HasGLError();
+    RenderState::instance()->ActiveTexture(GL_TEXTURE0);
 }
 }
\ No newline at end of file
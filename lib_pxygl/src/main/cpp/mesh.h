@@ -11,6 +11,8 @@
 #include <vector>
 #include "texture.h"
 #include "object.h"
+#include "render_queue.h"
+#include "mesh_file.h"
 
 namespace lark {
 struct MeshVertex {
@@ -42,9 +44,14 @@ public:
     ~Mesh();
     // call after data setup.
     void SetupMesh();
+    // upload a packed .pxymesh mesh as is, vertices() and indices() stay empty.
+    void SetupPackedMesh(const MeshFile::MeshView& mesh);
 
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view) override;
     void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
+    // queue Draw with the state it binds, meshes sharing program and texture are drawn together.
+    void Submit(RenderQueue* queue, Eye eye, const glm::mat4& projection, const glm::mat4& view);
+    void SubmitMultiview(RenderQueue* queue, const glm::mat4& projection, const glm::mat4& view);
 
     inline void AddVerties(const MeshVertex & vertex) { vertices_.push_back(vertex); }
     inline void AddVerties(const std::vector<MeshVertex> & vertex) {
@@ -73,24 +80,38 @@ public:
     //
     inline void set_shininess(float shininess) { shininess_ = shininess; }
 private:
+    struct Uniforms {
+        int model;
+        int view;
+        int projection;
+        int color;
+        int light_position;
+        int light_ambient;
+        int light_diffuse;
+        int light_specular;
+        int view_pos;
+        int shininess;
+    };
+
+    static Uniforms GetUniforms(Shader* shader);
+
     void Init();
+    // set per mesh uniforms and draw with the program in use.
+    void DrawMesh(Shader* shader, const Uniforms& uniforms, const glm::mat4& eyeView);
+    DrawItem MakeDrawItem(Shader* shader, const glm::mat4& view);
 
     /*  Mesh Data  */
     std::vector<MeshVertex> vertices_ = {};
     std::vector<unsigned int> indices_ = {};
     std::vector<std::shared_ptr<Texture>> textures_ = {};
 
-    int model_location_ = 0;
-    int view_location_ = 0;
-    int projection_location_ = 0;
+    // draw count and type of the uploaded indices.
+    GLsizei index_count_ = 0;
+    GLenum index_type_ = GL_UNSIGNED_INT;
 
-    int color_loaction_ = 0;
-    int light_position_location_ = 0;
-    int light_ambient_location_ = 0;
-    int light_diffuse_location_ = 0;
-    int light_specular_location_ = 0;
-    int view_pos_location_ = 0;
-    int shininess_location_ = 0;
+    Uniforms uniforms_ = {};
+    // multiview shader has no view and projection uniforms.
+    Uniforms multiview_uniforms_ = {};
 
     float shininess_ = 0.5;
     glm::vec4 color_ = { 0.08F, 0.08F, 0.08F, 1.0F };
@@ -0,0 +1,160 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include "mesh_file.h"
+
+namespace {
+    size_t Align4(size_t size) {
+        return (size + 3) & ~static_cast<size_t>(3);
+    }
+
+    template<typename T>
+    void Append(std::vector<uint8_t>* block, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        block->insert(block->end(), bytes, bytes + sizeof(T));
+    }
+
+    void Pad4(std::vector<uint8_t>* block) {
+        block->resize(Align4(block->size()), 0);
+    }
+}
+
+namespace lark {
+const char* MeshFile::EXTENSION = ".pxymesh";
+
+uint32_t MeshFile::GetVertexStride(uint32_t positionFormat) {
+    return GetTexCoordOffset(positionFormat) + 2 * sizeof(uint16_t);
+}
+
+uint32_t MeshFile::GetNormalOffset(uint32_t positionFormat) {
+    return positionFormat == PositionFormat_Float ? 3 * sizeof(float) : 4 * sizeof(uint16_t);
+}
+
+uint32_t MeshFile::GetTexCoordOffset(uint32_t positionFormat) {
+    return GetNormalOffset(positionFormat) + sizeof(uint32_t);
+}
+
+std::string MeshFile::GetMeshPath(const std::string &modelPath) {
+    size_t dot = modelPath.find_last_of('.');
+    size_t slash = modelPath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return modelPath + EXTENSION;
+    }
+    return modelPath.substr(0, dot) + EXTENSION;
+}
+
+bool MeshFile::Parse(const void *data, size_t size, std::vector<MeshView> *meshes) {
+    meshes->clear();
+    if (data == nullptr || size < sizeof(FileHeader)) {
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const FileHeader* fileHeader = reinterpret_cast<const FileHeader*>(bytes);
+    if (fileHeader->magic != MAGIC || fileHeader->version != VERSION) {
+        return false;
+    }
+    size_t offset = sizeof(FileHeader);
+    for (uint32_t i = 0; i < fileHeader->mesh_count; i++) {
+        if (size - offset < sizeof(MeshHeader)) {
+            return false;
+        }
+        const MeshHeader* header = reinterpret_cast<const MeshHeader*>(bytes + offset);
+        offset += sizeof(MeshHeader);
+        if (header->position_format > PositionFormat_Float ||
+            (header->index_size != 2 && header->index_size != 4) ||
+            header->vertex_stride != GetVertexStride(header->position_format) ||
+            header->vertex_data_size != static_cast<uint64_t>(header->vertex_count) * header->vertex_stride ||
+            header->index_data_size != Align4(static_cast<uint64_t>(header->index_count) * header->index_size) ||
+            header->diffuse_texture[TEXTURE_NAME_SIZE - 1] != '\0' ||
+            size - offset < static_cast<uint64_t>(header->vertex_data_size) + header->index_data_size) {
+            return false;
+        }
+        MeshView view = {};
+        view.header = header;
+        view.vertices = bytes + offset;
+        offset += header->vertex_data_size;
+        view.indices = bytes + offset;
+        offset += header->index_data_size;
+        meshes->push_back(view);
+    }
+    return true;
+}
+
+void MeshFile::Pack(const SourceMesh &mesh, float maxPositionError, std::vector<uint8_t> *block) {
+    const size_t vertexCount = mesh.positions.size();
+
+    // half floats have 11 significant bits, keep float positions for large models.
+    uint32_t positionFormat = PositionFormat_Half;
+    for (const auto & p : mesh.positions) {
+        for (int c = 0; c < 3; c++) {
+            if (std::fabs(glm::unpackHalf1x16(glm::packHalf1x16(p[c])) - p[c]) > maxPositionError) {
+                positionFormat = PositionFormat_Float;
+            }
+        }
+    }
+
+    MeshHeader header = {};
+    header.vertex_count = static_cast<uint32_t>(vertexCount);
+    header.index_count = static_cast<uint32_t>(mesh.indices.size());
+    header.position_format = positionFormat;
+    header.index_size = vertexCount <= 65536 ? 2 : 4;
+    header.vertex_stride = GetVertexStride(positionFormat);
+    header.vertex_data_size = static_cast<uint32_t>(vertexCount * header.vertex_stride);
+    header.index_data_size = static_cast<uint32_t>(Align4(mesh.indices.size() * header.index_size));
+    strncpy(header.diffuse_texture, mesh.diffuse_texture.c_str(), TEXTURE_NAME_SIZE - 1);
+
+    block->clear();
+    block->reserve(sizeof(header) + header.vertex_data_size + header.index_data_size);
+    Append(block, header);
+    for (size_t i = 0; i < vertexCount; i++) {
+        const glm::vec3& p = mesh.positions[i];
+        if (positionFormat == PositionFormat_Float) {
+            Append(block, p);
+        } else {
+            Append(block, glm::packHalf4x16(glm::vec4(p, 0.0F)));
+        }
+        glm::vec3 n = i < mesh.normals.size() ? mesh.normals[i] : glm::vec3(0.0F, 0.0F, 1.0F);
+        float len = glm::length(n);
+        n = len > 0.0F ? n / len : glm::vec3(0.0F, 0.0F, 1.0F);
+        Append(block, glm::packSnorm3x10_1x2(glm::vec4(n, 0.0F)));
+        glm::vec2 uv = i < mesh.texcoords.size() ? mesh.texcoords[i] : glm::vec2(0.0F);
+        Append(block, glm::packHalf2x16(uv));
+    }
+    for (auto index : mesh.indices) {
+        if (header.index_size == 2) {
+            Append(block, static_cast<uint16_t>(index));
+        } else {
+            Append(block, index);
+        }
+    }
+    Pad4(block);
+}
+
+bool MeshFile::Write(const std::string &path, const std::vector<SourceMesh> &meshes, float maxPositionError) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    FileHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.mesh_count = static_cast<uint32_t>(meshes.size());
+    bool res = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    std::vector<uint8_t> block;
+    for (const auto & mesh : meshes) {
+        if (!res) {
+            break;
+        }
+        Pack(mesh, maxPositionError, &block);
+        res = fwrite(block.data(), block.size(), 1, file) == 1;
+    }
+    res = fclose(file) == 0 && res;
+    return res;
+}
+}
@@ -0,0 +1,92 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_MESH_FILE_H
+#define CLOUDLARKXR_MESH_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace lark {
+//
+// .pxymesh, prebuilt meshes used in place without parsing.
+// FileHeader followed by one block per mesh: MeshHeader, vertex data, index data,
+// every part 4 byte aligned. vertex layout, interleaved:
+//   position  3 x half float and 2 byte padding, or 3 x float when half floats lose too much
+//   normal    snorm 10:10:10:2, GL_INT_2_10_10_10_REV
+//   texcoord  2 x half float
+// indices are 16 bit when the mesh has no more than 65536 vertices.
+// no gl or log dependency, shared with the host converter in tools/pxymesh.
+//
+class MeshFile {
+public:
+    static const uint32_t MAGIC = 0x4D595850; // PXYM
+    static const uint32_t VERSION = 1;
+    static const int TEXTURE_NAME_SIZE = 64;
+    static const char* EXTENSION;
+    // default max position error of half floats, in model units.
+    static constexpr float DEFAULT_MAX_POSITION_ERROR = 0.0005F;
+
+    enum PositionFormat {
+        PositionFormat_Half = 0,
+        PositionFormat_Float,
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t mesh_count;
+        uint32_t reserved;
+    };
+
+    struct MeshHeader {
+        uint32_t vertex_count;
+        uint32_t index_count;
+        uint32_t position_format;
+        // 2 or 4.
+        uint32_t index_size;
+        uint32_t vertex_stride;
+        uint32_t vertex_data_size;
+        uint32_t index_data_size;
+        // diffuse texture file name, empty when none.
+        char diffuse_texture[TEXTURE_NAME_SIZE];
+    };
+
+    // one mesh inside a parsed buffer, valid while the buffer is.
+    struct MeshView {
+        const MeshHeader* header;
+        const void* vertices;
+        const void* indices;
+    };
+
+    // unpacked mesh, writer input.
+    struct SourceMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> texcoords;
+        std::vector<uint32_t> indices;
+        std::string diffuse_texture;
+    };
+
+    static uint32_t GetVertexStride(uint32_t positionFormat);
+    // byte offsets of normal and texcoord in a vertex.
+    static uint32_t GetNormalOffset(uint32_t positionFormat);
+    static uint32_t GetTexCoordOffset(uint32_t positionFormat);
+
+    // "a/b.obj" -> "a/b.pxymesh".
+    static std::string GetMeshPath(const std::string& modelPath);
+
+    // check and index the buffer in place. return false when broken.
+    static bool Parse(const void* data, size_t size, std::vector<MeshView>* meshes);
+
+    // pack one mesh into a block, header included.
+    static void Pack(const SourceMesh& mesh, float maxPositionError, std::vector<uint8_t>* block);
+    static bool Write(const std::string& path, const std::vector<SourceMesh>& meshes,
+                      float maxPositionError = DEFAULT_MAX_POSITION_ERROR);
+};
+}
+
+#endif //CLOUDLARKXR_MESH_FILE_H
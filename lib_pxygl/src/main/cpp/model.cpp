@@ -8,7 +8,6 @@
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include <android/native_activity.h>
-#include <libgen.h>
 
 #ifdef ENABLE_ASSIMP
 #include <assimp/postprocess.h>
@@ -25,8 +24,11 @@
 #include "tiny_obj_loader.h"
 #endif // ENABLE_ASSIMP
 
+#include <chrono>
+#include <fstream>
 #include "logger.h"
 #include "model.h"
+#include "mesh_file.h"
 
 namespace lark {
 #ifdef __ANDROID__
@@ -48,6 +50,11 @@ Model::Model(const std::string & path):
 #endif
 
 Model::~Model() {
+#ifdef __ANDROID__
+    if (packed_asset_ != nullptr) {
+        AAsset_close(packed_asset_);
+    }
+#endif
     LOGV("release model");
 };
 
@@ -56,8 +63,9 @@ void Model::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view)
     Object::Draw(eye, projection, view);
 
     for (auto mesh = meshes_.begin(); mesh < meshes_.end(); mesh++) {
-        mesh->get()->Draw(eye, projection, view);
+        mesh->get()->Submit(&render_queue_, eye, projection, view);
     }
+    render_queue_.Flush();
 }
 
 void Model::DrawMultiview(const glm::mat4& projection, const glm::mat4& view)
@@ -65,8 +73,9 @@ void Model::DrawMultiview(const glm::mat4& projection, const glm::mat4& view)
     Object::DrawMultiview(projection, view);
 
     for (auto mesh = meshes_.begin(); mesh < meshes_.end(); mesh++) {
-        mesh->get()->DrawMultiview(projection, view);
+        mesh->get()->SubmitMultiview(&render_queue_, projection, view);
     }
+    render_queue_.Flush();
 }
 
 #ifdef  __ANDROID__
@@ -75,12 +84,39 @@ bool Model::Init(AndroidAssetContext* context) {
         LOGV("AndroidAssetContext not ready");
         return false;
     }
-    // catche context.
-    context_ = context;
+    if (!Parse(context->nativeActivity)) {
+        return false;
+    }
+    while (UploadNext(context)) {
+    }
+    return true;
+}
+
+bool Model::Parse(ANativeActivity* nativeActivity) {
+    if (nativeActivity == nullptr) {
+        LOGV("native activity not ready");
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    // prebuilt mesh, mapped from the apk when stored uncompressed.
+    // asset manager is thread safe, the asset is handed to the render thread with the model.
+    std::string packedPath = MeshFile::GetMeshPath(model_path_);
+    AAsset* packed = AAssetManager_open(nativeActivity->assetManager, packedPath.c_str(), AASSET_MODE_BUFFER);
+    if (packed != nullptr) {
+        if (ParsePackedMesh(AAsset_getBuffer(packed), static_cast<size_t>(AAsset_getLength(packed)))) {
+            packed_asset_ = packed;
+            LOGV("parse packed mesh %s %lld ms", packedPath.c_str(),
+                 static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start).count()));
+            return true;
+        }
+        AAsset_close(packed);
+        LOGW("load packed mesh failed %s, fallback to %s", packedPath.c_str(), model_path_.c_str());
+    }
 
 #ifdef ENABLE_ASSIMP
     Assimp::Importer importer;
-    Assimp::AndroidJNIIOSystem* ioSystem = new Assimp::AndroidJNIIOSystem(context->nativeActivity);
+    Assimp::AndroidJNIIOSystem* ioSystem = new Assimp::AndroidJNIIOSystem(nativeActivity);
     importer.SetIOHandler(ioSystem);
     const aiScene* scene = importer.ReadFile(model_path_, aiProcess_Triangulate | aiProcess_FlipUVs);
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
@@ -93,30 +129,35 @@ bool Model::Init(AndroidAssetContext* context) {
     // use tiny obj loader
     LOGV("use tiny obj loader");
 
-    std::string dir = dirname(model_path_.c_str());
+    // dirname may write into its argument.
+    std::string dir = ".";
+    size_t slash = model_path_.rfind('/');
+    if (slash != std::string::npos) {
+        dir = model_path_.substr(0, slash);
+    }
     dir += "/";
     LOGV("load model dir %s", dir.c_str());
 
     std::vector<std::string> files;
 
     // Open file
-    AAssetDir* asset_dir = AAssetManager_openDir(context_->nativeActivity->assetManager, dir.c_str());
+    AAssetDir* asset_dir = AAssetManager_openDir(nativeActivity->assetManager, dir.c_str());
     const char* file_name = AAssetDir_getNextFileName(asset_dir);
-    do {
+    while (file_name != nullptr) {
         files.emplace_back(dir + file_name);
         file_name = AAssetDir_getNextFileName(asset_dir);
-    } while (file_name != nullptr);
+    }
     AAssetDir_close(asset_dir);
 
     for (auto &asset : files) {
         LOGV("content assets %s", asset.c_str() );
-        if (!lark::CopyAssetToInternalPath(context->nativeActivity, asset)) {
+        if (!lark::CopyAssetToInternalPath(nativeActivity, asset)) {
             LOGE("CopyAssetToInternalPath failed %s", asset.c_str());
         }
     }
 
-    std::string inputfile = std::string(context->nativeActivity->internalDataPath) + "/" + model_path_;
-    std::string matpath = std::string(context->nativeActivity->internalDataPath) + "/" + dir;
+    std::string inputfile = std::string(nativeActivity->internalDataPath) + "/" + model_path_;
+    std::string matpath = std::string(nativeActivity->internalDataPath) + "/" + dir;
 
     std::vector<tinyobj::shape_t>       shapes = {};
     std::vector<tinyobj::material_t>    materials = {};
@@ -125,9 +166,13 @@ bool Model::Init(AndroidAssetContext* context) {
     std::string err = tinyobj::LoadObj(shapes, materials, inputfile.c_str(), nullptr);
 
     LOGV("load obj res: %s; shapes %ld; materials %ld", err.c_str(), shapes.size(), materials.size());
+    if (shapes.empty()) {
+        LOGW("load obj failed %s", model_path_.c_str());
+        return false;
+    }
 // Loop over shapes
     for (auto & shape : shapes) {
-        std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+        ParsedMesh mesh = {};
 
         for (size_t j = 0; j < shape.mesh.positions.size() / 3; j++)
         {
@@ -143,23 +188,63 @@ bool Model::Init(AndroidAssetContext* context) {
             vertex.TexCoords.x = shape.mesh.texcoords[2 * j + 0];
             vertex.TexCoords.y = shape.mesh.texcoords[2 * j + 1];
 //            LOGV("vertext coords %f %f", vertex.TexCoords.x, vertex.TexCoords.y);
-            mesh->AddVerties(vertex);
+            mesh.vertices.push_back(vertex);
         }
-        mesh->AddIndices(shape.mesh.indices);
-        mesh->SetupMesh();
-        mesh->set_parent(this);
-        meshes_.push_back(mesh);
+        mesh.indices = std::move(shape.mesh.indices);
+        parsed_meshes_.push_back(std::move(mesh));
     }
 #endif // ENABLE_ASSIMP
 
-    // clear context after init.
-    context_ = nullptr;
+    LOGV("parse model %s %lld ms", model_path_.c_str(),
+         static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start).count()));
     return true;
 }
+
+bool Model::UploadNext(AndroidAssetContext* context) {
+    if (pending_meshes() == 0) {
+        return false;
+    }
+    // catche context for the texture search.
+    context_ = context;
+    UploadMesh(next_mesh_++);
+    context_ = nullptr;
+    if (pending_meshes() > 0) {
+        return true;
+    }
+    // gl buffers hold the data now.
+    packed_views_.clear();
+    parsed_meshes_.clear();
+    next_mesh_ = 0;
+    if (packed_asset_ != nullptr) {
+        AAsset_close(packed_asset_);
+        packed_asset_ = nullptr;
+    }
+    return false;
+}
 #else
 bool Model::Init()
+{
+    if (!Parse()) {
+        return false;
+    }
+    while (UploadNext()) {
+    }
+    return true;
+}
+
+bool Model::Parse()
 {
     Poco::Timestamp timestamp;
+    std::ifstream packed(MeshFile::GetMeshPath(model_path_), std::ios::binary);
+    if (packed) {
+        packed_data_.assign(std::istreambuf_iterator<char>(packed), std::istreambuf_iterator<char>());
+        if (ParsePackedMesh(packed_data_.data(), packed_data_.size())) {
+            LOGV_F("==================Load packed modal %?d ms", timestamp.elapsed() / 1000);
+            return true;
+        }
+        packed_data_.clear();
+    }
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(model_path_, aiProcess_Triangulate | aiProcess_FlipUVs);
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
@@ -169,7 +254,16 @@ bool Model::Init()
     }
     ProcessNode(scene->mRootNode, scene);
     LOGV_F("==================Load modal %?d ms", timestamp.elapsed() / 1000);
-    return false;
+    return true;
+}
+
+bool Model::UploadNext()
+{
+    if (pending_meshes() == 0) {
+        return false;
+    }
+    UploadMesh(next_mesh_++);
+    return pending_meshes() > 0;
 }
 #endif //  __ANDROID__
 
@@ -179,7 +273,7 @@ void Model::ProcessNode(aiNode *node, const aiScene *scene) {
     for(unsigned int i = 0; i < node->mNumMeshes; i++)
     {
         aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-         meshes_.push_back(ProcessMesh(mesh, scene));
+        parsed_meshes_.push_back(ProcessMesh(mesh, scene));
     }
     // 接下来对它的子节点重复这一过程
     for(unsigned int i = 0; i < node->mNumChildren; i++)
@@ -188,8 +282,8 @@ void Model::ProcessNode(aiNode *node, const aiScene *scene) {
     }
 }
 
-std::shared_ptr<Mesh> Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
-    std::shared_ptr<Mesh> res = std::make_shared<Mesh>();
+Model::ParsedMesh Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
+    ParsedMesh res = {};
     for(unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
         MeshVertex vertex = {};
@@ -225,58 +319,90 @@ std::shared_ptr<Mesh> Model::ProcessMesh(aiMesh *mesh, const aiScene *scene) {
             vertex.Bitangent.y = mesh->mBitangents[i].y;
             vertex.Bitangent.z = mesh->mBitangents[i].z;
         }
-        res->AddVerties(vertex);
+        res.vertices.push_back(vertex);
     }
     // 处理索引
     for(unsigned int i = 0; i < mesh->mNumFaces; i++)
     {
         aiFace face = mesh->mFaces[i];
         for(unsigned int j = 0; j < face.mNumIndices; j++) {
-            res->AddIndices(face.mIndices[j]);
+            res.indices.push_back(face.mIndices[j]);
         }
     }
     // 处理材质
     if(mesh->mMaterialIndex >= 0)
     {
         aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
-        LoadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", res);
-        // LoadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", res);
+        GetMaterialTextures(material, aiTextureType_DIFFUSE, MaterialTextureType_DIFFUSE, &res);
+        // GetMaterialTextures(material, aiTextureType_SPECULAR, MaterialTextureType_SPECULAR, &res);
     }
-
-    res->SetupMesh();
-    res->set_parent(this);
     return res;
 }
 
 void
-Model::LoadMaterialTextures(aiMaterial *mat, const aiTextureType &type, const std::string &typeName,
-                            const std::shared_ptr<Mesh> & mesh) {
+Model::GetMaterialTextures(aiMaterial *mat, const aiTextureType &type, MaterialTextureType textureType,
+                           ParsedMesh* mesh) {
     for(unsigned int i = 0; i < mat->GetTextureCount(type); i++)
     {
         aiString ai_fileName;
         mat->GetTexture(type, i, &ai_fileName);
-        std::string fileName(ai_fileName.C_Str());
-
-        std::shared_ptr<Texture> texture = SearchTexture(fileName);
-        if (texture == nullptr)
-            continue;
-
-        texture->set_type_name(typeName);
+        mesh->textures.push_back({ textureType, ai_fileName.C_Str() });
+    }
+}
+#endif // ENABLE_ASSIMP
 
-        // init texture
-        texture->BindTexture();
-        texture->BindBitmap(GL_RGB5_A1);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        texture->UnBindTexture();
-        texture->CleanBitmap();
+bool Model::ParsePackedMesh(const void *data, size_t size) {
+    std::vector<MeshFile::MeshView> views;
+    if (data == nullptr || !MeshFile::Parse(data, size, &views)) {
+        return false;
+    }
+    packed_views_.swap(views);
+    return true;
+}
 
-        mesh->AddTexture(texture);
+void Model::UploadMesh(size_t index) {
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    if (index < packed_views_.size()) {
+        const MeshFile::MeshView& view = packed_views_[index];
+        if (view.header->diffuse_texture[0] != '\0') {
+            LoadMeshTexture(view.header->diffuse_texture, "texture_diffuse", mesh);
+        }
+        mesh->SetupPackedMesh(view);
+    } else {
+        ParsedMesh& parsed = parsed_meshes_[index];
+        for (const auto & texture : parsed.textures) {
+            LoadMeshTexture(texture.path,
+                            texture.type == MaterialTextureType_DIFFUSE ? "texture_diffuse" : "texture_specular", mesh);
+        }
+        // moved, the data is not kept twice.
+        mesh->vertices().swap(parsed.vertices);
+        mesh->indices().swap(parsed.indices);
+        mesh->SetupMesh();
     }
+    mesh->set_parent(this);
+    meshes_.push_back(mesh);
+}
+
+void Model::LoadMeshTexture(const std::string &fileName, const std::string &typeName,
+                            const std::shared_ptr<Mesh> &mesh) {
+    std::shared_ptr<Texture> texture = SearchTexture(fileName);
+    if (texture == nullptr)
+        return;
+
+    texture->set_type_name(typeName);
+
+    // init texture
+    texture->BindTexture();
+    texture->BindBitmap(GL_RGB5_A1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    texture->UnBindTexture();
+    texture->CleanBitmap();
+
+    mesh->AddTexture(texture);
 }
-#endif // ENABLE_ASSIMP
 
 void Model::SetLight(const MeshLight &light) {
     for(auto mesh = meshes_.begin(); mesh < meshes_.end(); mesh++) {
@@ -11,6 +11,7 @@
 #include <vector>
 #include "object.h"
 #include "mesh.h"
+#include "render_queue.h"
 
 #ifdef ENABLE_ASSIMP
 #include <assimp/scene.h>
@@ -40,13 +41,24 @@ public:
     };
 #ifdef __ANDROID__
     Model(const std::string& path);
+    // parse and upload at once. render thread.
     bool Init(AndroidAssetContext* context);
+    // any thread, no gl call. read the prebuilt .pxymesh or parse the model file into cpu side meshes.
+    bool Parse(ANativeActivity* nativeActivity);
+    // render thread. create the next parsed mesh and its textures. return false when all meshes uploaded.
+    bool UploadNext(AndroidAssetContext* context);
 #else
     Model(const std::string & path);
     bool Init();
+    bool Parse();
+    bool UploadNext();
 #endif
     ~Model();
 
+    // parsed meshes not uploaded yet.
+    inline size_t pending_meshes() const { return packed_views_.size() + parsed_meshes_.size() - next_mesh_; }
+    inline const std::string& model_path() const { return model_path_; }
+
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view) override;
     void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 #ifdef __ANDROID__
@@ -57,25 +69,47 @@ public:
     void SetLight(const MeshLight& light);
     void SetColor(const glm::vec4& color);
 private:
+    // cpu side mesh, gl objects created by UploadNext.
+    struct ParsedMesh {
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<MaterialTexture> textures;
+    };
 
 #ifdef ENABLE_ASSIMP
     void ProcessNode(aiNode *node, const aiScene *scene);
-    std::shared_ptr<Mesh> ProcessMesh(aiMesh *mesh, const aiScene *scene);
-    // checks all material textures of a given type and loads the textures if they're not loaded yet.
-    // the required info is returned as a Texture struct.
-    void LoadMaterialTextures(aiMaterial *mat,const aiTextureType& type,const std::string& typeName, const std::shared_ptr<Mesh> & mesh);
-    // search texture in texture search path.
+    ParsedMesh ProcessMesh(aiMesh *mesh, const aiScene *scene);
+    // checks all material textures of a given type and collects their file names, loaded on upload.
+    void GetMaterialTextures(aiMaterial *mat, const aiTextureType& type, MaterialTextureType textureType, ParsedMesh* mesh);
 #endif
 
+    // fast path, meshes from a prebuilt .pxymesh next to the model file. see MeshFile.
+    // data must live until the meshes uploaded.
+    bool ParsePackedMesh(const void* data, size_t size);
+    void UploadMesh(size_t index);
+    // search, upload and add a texture to the mesh.
+    void LoadMeshTexture(const std::string& fileName, const std::string& typeName, const std::shared_ptr<Mesh> & mesh);
+
     std::shared_ptr<Texture> SearchTexture(const std::string & name);
 
     std::vector<std::shared_ptr<Mesh>> meshes_ = {};
+    // meshes sorted by state every draw.
+    RenderQueue render_queue_;
     std::string model_path_ = "";
     std::vector<std::string> texture_search_path_ = {};
 
     std::vector<MaterialTexture> material_textures_ = {};
+
+    // one of them filled by Parse.
+    std::vector<MeshFile::MeshView> packed_views_ = {};
+    std::vector<ParsedMesh> parsed_meshes_ = {};
+    size_t next_mesh_ = 0;
 #ifdef __ANDROID__
+    // .pxymesh mapped from the apk, closed after the meshes uploaded.
+    AAsset* packed_asset_ = nullptr;
     AndroidAssetContext* context_ = nullptr;
+#else
+    std::vector<char> packed_data_ = {};
 #endif
 };
 }
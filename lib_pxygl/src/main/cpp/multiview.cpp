@@ -0,0 +1,86 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/18.
+//
+
+#include <glm/gtc/type_ptr.hpp>
+#include "multiview.h"
+#include "object.h"
+#include "shader.h"
+#include "logger.h"
+
+#define LOG_TAG "pxygl_Multiview"
+
+namespace lark {
+const char* Multiview::SCENE_MATRICES_BLOCK = "SceneMatrices";
+
+Multiview* Multiview::instance_ = nullptr;
+
+Multiview* Multiview::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new Multiview();
+    }
+    return instance_;
+}
+
+void Multiview::Release() {
+    if (instance_ != nullptr) {
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+Multiview::Multiview() = default;
+
+Multiview::~Multiview() {
+    if (scene_matrices_ != 0) {
+        glDeleteBuffers(1, &scene_matrices_);
+        scene_matrices_ = 0;
+    }
+}
+
+bool Multiview::IsSupported() {
+    if (supported_ < 0) {
+        supported_ = Object::HasGlExtension("GL_OVR_multiview2") ? 1 : 0;
+        LOGV("GL_OVR_multiview2 supported %d", supported_);
+    }
+    return supported_ == 1;
+}
+
+bool Multiview::Enable() {
+    enabled_ = IsSupported();
+    return enabled_;
+}
+
+void Multiview::SetSceneMatrices(const glm::mat4 projection[VIEW_COUNT], const glm::mat4 view[VIEW_COUNT]) {
+    // std140, mat4 arrays are tightly packed.
+    glm::mat4 data[VIEW_COUNT * 2];
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        data[i] = view[i];
+        data[VIEW_COUNT + i] = projection[i];
+    }
+    if (scene_matrices_ == 0) {
+        glGenBuffers(1, &scene_matrices_);
+        glBindBuffer(GL_UNIFORM_BUFFER, scene_matrices_);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(data), nullptr, GL_DYNAMIC_DRAW);
+    } else {
+        glBindBuffer(GL_UNIFORM_BUFFER, scene_matrices_);
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), glm::value_ptr(data[0]));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SCENE_MATRICES_BINDING, scene_matrices_);
+}
+
+bool Multiview::BindSceneMatrices(Shader *shader) {
+    if (shader == nullptr) {
+        return false;
+    }
+    GLuint index = glGetUniformBlockIndex(shader->program_id(), SCENE_MATRICES_BLOCK);
+    // screen space shaders need no matrices.
+    if (index == GL_INVALID_INDEX) {
+        LOGV("shader %d has no %s block", shader->program_id(), SCENE_MATRICES_BLOCK);
+        return false;
+    }
+    glUniformBlockBinding(shader->program_id(), index, SCENE_MATRICES_BINDING);
+    return true;
+}
+}
@@ -0,0 +1,61 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/18.
+//
+
+#ifndef CLOUDLARKXR_MULTIVIEW_H
+#define CLOUDLARKXR_MULTIVIEW_H
+
+#include <glm/glm.hpp>
+#include "pxygl.h"
+
+namespace lark {
+class Shader;
+
+//
+// single pass stereo with GL_OVR_multiview2.
+// multiview vertex shaders read view and projection of both eyes from one uniform block,
+// indexed with gl_ViewID_OVR:
+//
+//   layout(std140) uniform SceneMatrices {
+//       mat4 uViews[2];
+//       mat4 uProjections[2];
+//   };
+//
+// the block is uploaded once per frame, objects only set their own uniforms.
+// render thread only.
+//
+class CLOUDLARK_PXYGL_API Multiview {
+public:
+    static const int VIEW_COUNT = 2;
+    static const GLuint SCENE_MATRICES_BINDING = 0;
+    static const char* SCENE_MATRICES_BLOCK;
+
+    static Multiview* instance();
+    // delete gl objects. call in render thread when gl context destroyed.
+    static void Release();
+
+    // GL_OVR_multiview2 available in current context.
+    bool IsSupported();
+    // enable before objects created, objects load multiview shader variants when enabled.
+    // return false when not supported.
+    bool Enable();
+    inline bool enabled() const { return enabled_; }
+
+    // upload matrices of both eyes and bind the block. call once before DrawMultiview.
+    void SetSceneMatrices(const glm::mat4 projection[VIEW_COUNT], const glm::mat4 view[VIEW_COUNT]);
+    // connect the SceneMatrices block of shader to SCENE_MATRICES_BINDING.
+    static bool BindSceneMatrices(Shader* shader);
+private:
+    static Multiview* instance_;
+
+    Multiview();
+    ~Multiview();
+
+    // -1 not checked.
+    int supported_ = -1;
+    bool enabled_ = false;
+    GLuint scene_matrices_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_MULTIVIEW_H
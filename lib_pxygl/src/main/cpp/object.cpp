@@ -1,6 +1,7 @@
 //
 // Created by fcx@pingxingyun.com on 2019/11/7.
 //
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -12,6 +13,7 @@
 #include "object.h"
 #include "vertex_array_object.h"
 #include "asset_loader.h"
+#include "multiview.h"
 
 namespace lark {
 
@@ -30,10 +32,35 @@ Object::Object() :
     multiview_shader_(nullptr), 
     vao_(nullptr), 
     texture_(nullptr), 
-    children_objects_() {
+    children_objects_(),
+    dependents_(),
+    world_(1.0F),
+    world_dirty_(true) {
 }
 
-Object::~Object() = default;
+Object::~Object() {
+    set_parent(nullptr);
+    // children may outlive the parent when shared.
+    for (auto dependent : dependents_) {
+        dependent->parent_ = nullptr;
+        dependent->MarkWorldDirty();
+    }
+}
+
+void Object::set_parent(Object *parent) {
+    if (parent_ == parent) {
+        return;
+    }
+    if (parent_ != nullptr) {
+        auto& dependents = parent_->dependents_;
+        dependents.erase(std::remove(dependents.begin(), dependents.end(), this), dependents.end());
+    }
+    parent_ = parent;
+    if (parent_ != nullptr) {
+        parent_->dependents_.push_back(this);
+    }
+    MarkWorldDirty();
+}
 
 
 void Object::InitVao(const void* vertices, int verticesSize, const void* indices, int indicesSize)
@@ -92,6 +119,9 @@ Object::LoadShaderFromAsset(AAssetManager *assetManager, const char *vpath, cons
 }
 void Object::LoadMultiviewShaderFromAsset(AAssetManager *assetManager, const char *vpath,
                                           const char *fpath) {
+    if (!Multiview::instance()->enabled()) {
+        return;
+    }
     ShaderAsset shaderAsset = {
             ShaderAssetType_File,
             name_,
@@ -100,7 +130,7 @@ void Object::LoadMultiviewShaderFromAsset(AAssetManager *assetManager, const cha
             "", ""
     };
     multiview_shader_ = AssetLoader::instance()->LoadShader(assetManager, shaderAsset);
-    has_error_ = !shader_;
+    Multiview::BindSceneMatrices(multiview_shader_.get());
 }
 #else
 void Object::LoadShaderFromAsset(const char* vpath, const char* fpath) {
@@ -116,6 +146,9 @@ void Object::LoadShaderFromAsset(const char* vpath, const char* fpath) {
 }
 
 void Object::LoadMultiviewShaderFromAsset(const char* vpath, const char* fpath) {
+    if (!Multiview::instance()->enabled()) {
+        return;
+    }
     ShaderAsset shaderAsset = {
             ShaderAssetType_File,
             name_,
@@ -124,7 +157,7 @@ void Object::LoadMultiviewShaderFromAsset(const char* vpath, const char* fpath)
             "", ""
     };
     multiview_shader_ = AssetLoader::instance()->LoadShader(shaderAsset);
-    has_error_ = !shader_;
+    Multiview::BindSceneMatrices(multiview_shader_.get());
 }
 #endif
 
@@ -146,6 +179,9 @@ void Object::LoadShader(const char* vfile, const char* ffile, const char* vstr,
 
 void Object::LoadMultviewShader(const char* vfile, const char* ffile, const char* vstr, const char* fstr)
 {
+    if (!Multiview::instance()->enabled()) {
+        return;
+    }
     ShaderAsset shaderAsset = {
             ShaderAssetType_Source,
             name_,
@@ -157,14 +193,34 @@ void Object::LoadMultviewShader(const char* vfile, const char* ffile, const char
 #else
     multiview_shader_ = AssetLoader::instance()->LoadShader(shaderAsset);
 #endif
-    has_error_ = !multiview_shader_;
+    Multiview::BindSceneMatrices(multiview_shader_.get());
 }
 
-glm::mat4 Object::GetTransforms() const {
-    if (parent_ != nullptr) {
-        return parent_->GetTransforms() * transform_.GetTrans();
-    } else {
-        return transform_.GetTrans();
+const glm::mat4& Object::GetTransforms() const {
+    if (world_dirty_) {
+        if (parent_ != nullptr) {
+            world_ = parent_->GetTransforms() * transform_.GetTrans();
+        } else {
+            world_ = transform_.GetTrans();
+        }
+        world_dirty_ = false;
+    }
+    return world_;
+}
+
+void Object::UpdateWorldTransforms() {
+    GetTransforms();
+    for (auto dependent : dependents_) {
+        dependent->UpdateWorldTransforms();
+    }
+}
+
+void Object::MarkDependentsDirty() {
+    world_dirty_ = true;
+    for (auto dependent : dependents_) {
+        if (!dependent->world_dirty_) {
+            dependent->MarkDependentsDirty();
+        }
     }
 }
 
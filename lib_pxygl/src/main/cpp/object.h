@@ -53,9 +53,8 @@ public:
 
     bool HasGLError() const;
 
-    inline void set_parent(Object * parent) {
-        parent_ = parent;
-    }
+    // keeps the parent's dependents list in sync, marks world transform dirty.
+    void set_parent(Object * parent);
 
     inline Object * parent() {
         return parent_;
@@ -69,30 +68,39 @@ public:
 
     inline Object* Move(float x, float y, float z) {
         transform_.Translate(x, y, z);
+        MarkWorldDirty();
         return this;
     };
 
     inline Object* Move(const glm::vec3 & position) {
         transform_.Translate(position);
+        MarkWorldDirty();
         return this;
     };
 
     Object* Rotate(float radians, const glm::vec3 & rotate) {
         transform_.Rotate(radians, rotate);
+        MarkWorldDirty();
         return this;
     };
 
     Object* Scale(float scale) {
         transform_.Sacle(scale);
+        MarkWorldDirty();
         return this;
     };
-    inline Transform& transform() { return transform_; }
-    inline void set_transform(const glm::mat4& transform) { transform_ = transform; }
-    inline void set_transform(const Transform& transform) { transform_ = transform; }
+    // caller may change the local transform through the reference.
+    inline Transform& transform() { MarkWorldDirty(); return transform_; }
+    inline void set_transform(const glm::mat4& transform) { transform_ = transform; MarkWorldDirty(); }
+    inline void set_transform(const Transform& transform) { transform_ = transform; MarkWorldDirty(); }
 
     inline glm::quat GetRotation() { return transform_.GetRotation(); }
 
-    glm::mat4 GetTransforms() const;
+    // world transform. cached, recomputed only when this object or one of its parents changed.
+    const glm::mat4& GetTransforms() const;
+    // recompute dirty world transforms of the whole subtree top down in one pass.
+    // optional, GetTransforms recomputes lazily anyway.
+    void UpdateWorldTransforms();
 
     glm::mat3 MakeNormalMatrix(const glm::mat4& view) const;
 
@@ -106,6 +114,8 @@ public:
     virtual void Update();
     // draw
     virtual void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view);
+    // single pass stereo, both eyes come from Multiview scene matrices.
+    // projection and view of the left eye for cpu side work.
     virtual void DrawMultiview(const glm::mat4& projection, const glm::mat4& view);
 
     // manange child.
@@ -123,8 +133,17 @@ protected:
 #endif
 
     void LoadShader(const char* vfile, const char* ffile, const char* vstr, const char* fstr);
+    // multiview variants load only when Multiview enabled, failure keeps the stereo path working.
     void LoadMultviewShader(const char* vfile, const char* ffile, const char* vstr, const char* fstr);
 
+    // mark world transform of this object and all dependents dirty.
+    // a dirty object always has dirty dependents, so stop at the first dirty one.
+    inline void MarkWorldDirty() {
+        if (!world_dirty_) {
+            MarkDependentsDirty();
+        }
+    }
+
     bool active_;
 
     const char * name_;
@@ -140,6 +159,13 @@ protected:
 
     // objects.
     std::vector<std::shared_ptr<Object>> children_objects_;
+private:
+    void MarkDependentsDirty();
+
+    // objects whose parent is this, including ones not owned by children_objects_.
+    std::vector<Object*> dependents_;
+    mutable glm::mat4 world_;
+    mutable bool world_dirty_;
 };
 }
 
@@ -0,0 +1,188 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "program_cache.h"
+#include "texture_cache.h"
+#include "logger.h"
+
+#define LOG_TAG "pxygl_ProgramCache"
+
+namespace {
+    const char* FILE_EXT = ".pxyp";
+
+    bool MakeDirs(const std::string& path) {
+        for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+            std::string dir = path.substr(0, pos);
+            if (mkdir(dir.c_str(), 0770) == -1 && errno != EEXIST) {
+                return false;
+            }
+            if (pos == std::string::npos) {
+                return true;
+            }
+        }
+    }
+
+    std::string GetGLString(GLenum name) {
+        const GLubyte* str = glGetString(name);
+        return str == nullptr ? "" : reinterpret_cast<const char*>(str);
+    }
+}
+
+namespace lark {
+ProgramCache* ProgramCache::instance_ = nullptr;
+
+ProgramCache* ProgramCache::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new ProgramCache();
+    }
+    return instance_;
+}
+
+void ProgramCache::Release() {
+    if (instance_ != nullptr) {
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+ProgramCache::ProgramCache() = default;
+
+ProgramCache::~ProgramCache() {
+    LOGV("program cache release. loaded %" PRIu64 " %.2f ms; compiled %" PRIu64 " %.2f ms; rejected %" PRIu64,
+         loaded_, load_ms_, compiled_, compile_ms_, rejected_);
+}
+
+bool ProgramCache::Init(const std::string &dir) {
+    if (inited_) {
+        return true;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        LOGW("program binary not supported");
+        return false;
+    }
+    if (dir.empty() || !MakeDirs(dir)) {
+        LOGW("create program cache dir failed %s", dir.c_str());
+        return false;
+    }
+    dir_ = dir;
+    std::string driver = GetGLString(GL_VENDOR) + "|" + GetGLString(GL_RENDERER) + "|" + GetGLString(GL_VERSION);
+    driver_hash_ = TextureCache::Hash(driver);
+    inited_ = true;
+    LOGV("program cache inited %s; driver %s", dir_.c_str(), driver.c_str());
+    return true;
+}
+
+uint64_t ProgramCache::GetKey(const char *vertex, const char *fragment) const {
+    // sources include version, extensions and defines.
+    std::string source = std::string(vertex) + '\0' + fragment;
+    return TextureCache::Hash(source) ^ driver_hash_;
+}
+
+GLuint ProgramCache::Load(uint64_t key) {
+    if (!inited_) {
+        return 0;
+    }
+    std::string path = GetPath(key);
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+    Header header = {};
+    std::vector<char> binary;
+    bool res = fread(&header, sizeof(header), 1, file) == 1 &&
+               header.magic == MAGIC && header.version == VERSION && header.key == key && header.size > 0;
+    if (res) {
+        binary.resize(header.size);
+        res = fread(binary.data(), binary.size(), 1, file) == 1;
+    }
+    fclose(file);
+
+    GLuint program = 0;
+    if (res) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (program == 0) {
+        // broken file or driver rejected the binary, compile from source and store again.
+        LOGW("program binary rejected %s", path.c_str());
+        rejected_++;
+        unlink(path.c_str());
+        // clear error of glProgramBinary.
+        glGetError();
+    }
+    return program;
+}
+
+bool ProgramCache::Store(uint64_t key, GLuint program) {
+    if (!inited_ || program == 0) {
+        return false;
+    }
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false;
+    }
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei size = 0;
+    glGetProgramBinary(program, length, &size, &format, binary.data());
+    if (size <= 0) {
+        return false;
+    }
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.format = format;
+    header.size = static_cast<uint32_t>(size);
+    header.key = key;
+
+    // write to temp file then rename, a killed process never leaves half written binaries.
+    std::string path = GetPath(key);
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        LOGW("create program cache failed %s", tmpPath.c_str());
+        return false;
+    }
+    bool res = fwrite(&header, sizeof(header), 1, file) == 1 &&
+               fwrite(binary.data(), header.size, 1, file) == 1;
+    res = fclose(file) == 0 && res;
+    if (!res || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGW("write program cache failed %s", path.c_str());
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void ProgramCache::AddLoadTime(double ms) {
+    loaded_++;
+    load_ms_ += ms;
+}
+
+void ProgramCache::AddCompileTime(double ms) {
+    compiled_++;
+    compile_ms_ += ms;
+}
+
+std::string ProgramCache::GetPath(uint64_t key) const {
+    char name[32] = {};
+    snprintf(name, sizeof(name), "%016" PRIx64 "%s", key, FILE_EXT);
+    return dir_ + "/" + name;
+}
+}
@@ -0,0 +1,75 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_PROGRAM_CACHE_H
+#define CLOUDLARKXR_PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include "pxygl.h"
+
+namespace lark {
+//
+// persistent gl program binary cache on disk, skips shader compile on later launches.
+// one file per program, key is hash of the shader sources and the driver strings,
+// so a driver update never loads an old binary. binaries rejected by the driver are removed
+// and the program compiled from source again.
+// render thread.
+//
+class CLOUDLARK_PXYGL_API ProgramCache {
+public:
+    static const uint32_t MAGIC = 0x50595850; // PXYP
+    static const uint32_t VERSION = 1;
+
+    static ProgramCache* instance();
+    static void Release();
+
+    // create dir and read driver strings. call with gl context current.
+    // disabled when the driver has no binary format.
+    bool Init(const std::string& dir);
+    inline bool inited() const { return inited_; }
+
+    uint64_t GetKey(const char* vertex, const char* fragment) const;
+    // new linked program from cache, 0 when missing or rejected.
+    GLuint Load(uint64_t key);
+    // save binary of a linked program created with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    bool Store(uint64_t key, GLuint program);
+
+    // stats
+    inline uint64_t loaded() const { return loaded_; }
+    inline uint64_t compiled() const { return compiled_; }
+    inline uint64_t rejected() const { return rejected_; }
+    inline double load_ms() const { return load_ms_; }
+    inline double compile_ms() const { return compile_ms_; }
+    // called by shader with time spent, cache load or compile from source.
+    void AddLoadTime(double ms);
+    void AddCompileTime(double ms);
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t size;
+        uint64_t key;
+    };
+
+    static ProgramCache* instance_;
+
+    ProgramCache();
+    ~ProgramCache();
+
+    std::string GetPath(uint64_t key) const;
+
+    bool inited_ = false;
+    std::string dir_ = "";
+    uint64_t driver_hash_ = 0;
+    uint64_t loaded_ = 0;
+    uint64_t compiled_ = 0;
+    uint64_t rejected_ = 0;
+    double load_ms_ = 0;
+    double compile_ms_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_PROGRAM_CACHE_H
@@ -0,0 +1,66 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <algorithm>
+#include "render_queue.h"
+#include "render_state.h"
+
+namespace lark {
+RenderQueue::RenderQueue() = default;
+
+RenderQueue::~RenderQueue() = default;
+
+void RenderQueue::Submit(DrawItem &&item) {
+    items_.push_back(std::move(item));
+}
+
+void RenderQueue::Flush() {
+    if (items_.empty()) {
+        return;
+    }
+    sorted_.clear();
+    for (const auto & item : items_) {
+        sorted_.push_back(&item);
+    }
+    std::stable_sort(sorted_.begin(), sorted_.end(), Less);
+
+    RenderState* state = RenderState::instance();
+    for (auto item : sorted_) {
+        state->UseProgram(item->program);
+        if (item->texture != 0) {
+            state->ActiveTexture(GL_TEXTURE0);
+            state->BindTexture(GL_TEXTURE_2D, item->texture);
+        }
+        state->BindVertexArray(item->vertex_array);
+        if (item->draw) {
+            item->draw();
+        }
+    }
+    Clear();
+}
+
+void RenderQueue::Clear() {
+    items_.clear();
+    sorted_.clear();
+}
+
+bool RenderQueue::Less(const DrawItem *a, const DrawItem *b) {
+    if (a->transparent != b->transparent) {
+        return !a->transparent;
+    }
+    if (a->transparent) {
+        return a->depth > b->depth;
+    }
+    if (a->program != b->program) {
+        return a->program < b->program;
+    }
+    if (a->texture != b->texture) {
+        return a->texture < b->texture;
+    }
+    if (a->vertex_array != b->vertex_array) {
+        return a->vertex_array < b->vertex_array;
+    }
+    return a->depth < b->depth;
+}
+}
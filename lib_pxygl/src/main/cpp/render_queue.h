@@ -0,0 +1,57 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_RENDER_QUEUE_H
+#define CLOUDLARKXR_RENDER_QUEUE_H
+
+#include <functional>
+#include <vector>
+#include "pxygl.h"
+
+namespace lark {
+//
+// one draw submitted to RenderQueue. state is bound through RenderState before draw is called,
+// so binds of the same state inside draw are filtered.
+//
+struct CLOUDLARK_PXYGL_API DrawItem {
+    GLuint program;
+    // texture of unit 0, 0 when none.
+    GLuint texture;
+    GLuint vertex_array;
+    // distance to the eye.
+    float depth;
+    // drawn after opaque items. blend state is left to the caller.
+    bool transparent;
+    // set uniforms and issue the draw call.
+    std::function<void()> draw;
+};
+
+//
+// collects draw items of a frame and draws them in an order with fewer state changes.
+// opaque items are grouped by program, texture and vertex array, then front to back.
+// transparent items are drawn back to front, items with the same depth keep submit order.
+// render thread only.
+//
+class CLOUDLARK_PXYGL_API RenderQueue {
+public:
+    RenderQueue();
+    ~RenderQueue();
+
+    void Submit(DrawItem&& item);
+    // sort and draw all items, then clear.
+    void Flush();
+    void Clear();
+
+    inline bool empty() const { return items_.empty(); }
+    inline size_t size() const { return items_.size(); }
+private:
+    static bool Less(const DrawItem* a, const DrawItem* b);
+
+    std::vector<DrawItem> items_;
+    // sorted view of items_, kept to reuse capacity.
+    std::vector<const DrawItem*> sorted_;
+};
+}
+
+#endif //CLOUDLARKXR_RENDER_QUEUE_H
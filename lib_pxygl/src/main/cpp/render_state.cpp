@@ -0,0 +1,177 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "render_state.h"
+
+namespace lark {
+RenderState* RenderState::instance_ = nullptr;
+
+RenderState* RenderState::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new RenderState();
+    }
+    return instance_;
+}
+
+void RenderState::Release() {
+    if (instance_ != nullptr) {
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+int RenderState::GetCap(GLenum cap) {
+    switch (cap) {
+        case GL_BLEND:
+            return Cap_Blend;
+        case GL_DEPTH_TEST:
+            return Cap_DepthTest;
+        case GL_SCISSOR_TEST:
+            return Cap_ScissorTest;
+        case GL_CULL_FACE:
+            return Cap_CullFace;
+        default:
+            return -1;
+    }
+}
+
+int RenderState::GetTextureTarget(GLenum target) {
+    switch (target) {
+        case GL_TEXTURE_2D:
+            return TextureTarget_2D;
+        case GL_TEXTURE_CUBE_MAP:
+            return TextureTarget_CubeMap;
+        default:
+            return -1;
+    }
+}
+
+RenderState::RenderState() {
+    Invalidate();
+}
+
+RenderState::~RenderState() = default;
+
+void RenderState::Invalidate() {
+    program_ = UNKNOWN;
+    vertex_array_ = UNKNOWN;
+    active_texture_ = UNKNOWN;
+    for (auto & unit : textures_) {
+        for (auto & texture : unit) {
+            texture = UNKNOWN;
+        }
+    }
+    for (auto & cap : caps_) {
+        cap = CAP_UNKNOWN;
+    }
+    depth_mask_ = UNKNOWN;
+    blend_src_ = UNKNOWN;
+    blend_dst_ = UNKNOWN;
+}
+
+bool RenderState::Changed(GLuint *tracked, GLuint value) {
+    if (*tracked == value) {
+        skipped_++;
+        return false;
+    }
+    *tracked = value;
+    issued_++;
+    return true;
+}
+
+void RenderState::UseProgram(GLuint program) {
+    if (Changed(&program_, program)) {
+        glUseProgram(program);
+    }
+}
+
+void RenderState::BindVertexArray(GLuint vertexArray) {
+    if (Changed(&vertex_array_, vertexArray)) {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+void RenderState::ActiveTexture(GLenum unit) {
+    if (Changed(&active_texture_, unit)) {
+        glActiveTexture(unit);
+    }
+}
+
+void RenderState::BindTexture(GLenum target, GLuint texture) {
+    int index = GetTextureTarget(target);
+    int unit = active_texture_ == UNKNOWN ? -1 : static_cast<int>(active_texture_ - GL_TEXTURE0);
+    if (index < 0 || unit < 0 || unit >= TEXTURE_UNITS) {
+        issued_++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if (Changed(&textures_[unit][index], texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void RenderState::Enable(GLenum cap) {
+    SetCap(cap, true);
+}
+
+void RenderState::Disable(GLenum cap) {
+    SetCap(cap, false);
+}
+
+void RenderState::SetCap(GLenum cap, bool enable) {
+    int index = GetCap(cap);
+    if (index >= 0 && caps_[index] == (enable ? 1 : 0)) {
+        skipped_++;
+        return;
+    }
+    if (index >= 0) {
+        caps_[index] = enable ? 1 : 0;
+    }
+    issued_++;
+    if (enable) {
+        glEnable(cap);
+    } else {
+        glDisable(cap);
+    }
+}
+
+void RenderState::DepthMask(GLboolean flag) {
+    if (Changed(&depth_mask_, flag ? GL_TRUE : GL_FALSE)) {
+        glDepthMask(flag);
+    }
+}
+
+void RenderState::BlendFunc(GLenum sfactor, GLenum dfactor) {
+    if (blend_src_ == sfactor && blend_dst_ == dfactor) {
+        skipped_++;
+        return;
+    }
+    blend_src_ = sfactor;
+    blend_dst_ = dfactor;
+    issued_++;
+    glBlendFunc(sfactor, dfactor);
+}
+
+void RenderState::ForgetProgram(GLuint program) {
+    if (program_ == program) {
+        program_ = UNKNOWN;
+    }
+}
+
+void RenderState::ForgetVertexArray(GLuint vertexArray) {
+    if (vertex_array_ == vertexArray) {
+        vertex_array_ = UNKNOWN;
+    }
+}
+
+void RenderState::ForgetTexture(GLuint texture) {
+    for (auto & unit : textures_) {
+        for (auto & bound : unit) {
+            if (bound == texture) {
+                bound = UNKNOWN;
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,96 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_RENDER_STATE_H
+#define CLOUDLARKXR_RENDER_STATE_H
+
+#include <cstdint>
+#include "pxygl.h"
+
+namespace lark {
+//
+// shadow copy of the gl state objects change most, calls setting a value already set are skipped.
+// tracked: program, vertex array, active texture unit, 2d and cube map texture of each unit,
+// blend, depth test, scissor test, cull face, depth mask and blend func.
+// state starts unknown, the first call always reaches gl. call Invalidate when gl state was
+// changed without the cache, at frame begin and after third party rendering.
+// unbinding program and textures is lazy, the next bind is filtered instead.
+// render thread only.
+//
+class CLOUDLARK_PXYGL_API RenderState {
+public:
+    static const int TEXTURE_UNITS = 8;
+
+    static RenderState* instance();
+    static void Release();
+
+    // forget all tracked state.
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vertexArray);
+    // GL_TEXTURE0 + n.
+    void ActiveTexture(GLenum unit);
+    // bind to the active unit. other targets than 2d and cube map always reach gl.
+    void BindTexture(GLenum target, GLuint texture);
+
+    void Enable(GLenum cap);
+    void Disable(GLenum cap);
+    inline void SetEnabled(GLenum cap, bool enable) { enable ? Enable(cap) : Disable(cap); }
+    void DepthMask(GLboolean flag);
+    void BlendFunc(GLenum sfactor, GLenum dfactor);
+
+    // gl object deleted, the name may be reused for a new object.
+    void ForgetProgram(GLuint program);
+    void ForgetVertexArray(GLuint vertexArray);
+    void ForgetTexture(GLuint texture);
+
+    // stats
+    inline uint64_t issued() const { return issued_; }
+    inline uint64_t skipped() const { return skipped_; }
+    inline void ResetCounters() { issued_ = 0; skipped_ = 0; }
+private:
+    enum Cap {
+        Cap_Blend = 0,
+        Cap_DepthTest,
+        Cap_ScissorTest,
+        Cap_CullFace,
+        Cap_Count,
+    };
+    enum TextureTarget {
+        TextureTarget_2D = 0,
+        TextureTarget_CubeMap,
+        TextureTarget_Count,
+    };
+    // no gl name uses it.
+    static const GLuint UNKNOWN = 0xFFFFFFFF;
+    // cap value unknown.
+    static const int8_t CAP_UNKNOWN = -1;
+
+    static RenderState* instance_;
+    static int GetCap(GLenum cap);
+    static int GetTextureTarget(GLenum target);
+
+    RenderState();
+    ~RenderState();
+
+    // count and return true when value changed.
+    bool Changed(GLuint* tracked, GLuint value);
+    void SetCap(GLenum cap, bool enable);
+
+    GLuint program_ = UNKNOWN;
+    GLuint vertex_array_ = UNKNOWN;
+    GLuint active_texture_ = UNKNOWN;
+    GLuint textures_[TEXTURE_UNITS][TextureTarget_Count] = {};
+    int8_t caps_[Cap_Count] = {};
+    GLuint depth_mask_ = UNKNOWN;
+    GLuint blend_src_ = UNKNOWN;
+    GLuint blend_dst_ = UNKNOWN;
+
+    uint64_t issued_ = 0;
+    uint64_t skipped_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_RENDER_STATE_H
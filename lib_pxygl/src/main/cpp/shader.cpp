@@ -2,10 +2,18 @@
 // Created by fcx@pingxingyun.com on 2019/11/7.
 //
 
+#include <chrono>
 #include "shader.h"
+#include "program_cache.h"
 #include "logger.h"
 #define LOG_TAG "shader"
 
+namespace {
+    double GetElapsedMs(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
 namespace lark {
 Shader::Shader(const char * name, const char * vname, const char * vertex, const char * fname, const char * fragment) :
         name_(name), vname_(vname), fname_(fname), vertex_shader_(vertex), fragment_shader_(fragment), program_id_(0) {
@@ -14,6 +22,7 @@ Shader::Shader(const char * name, const char * vname, const char * vertex, const
 Shader::~Shader() {
     if (program_id_ == 0)
         return;
+    RenderState::instance()->ForgetProgram(program_id_);
     glDeleteProgram(program_id_);
     program_id_ = 0;
 }
@@ -44,7 +53,27 @@ bool Shader::Compile() {
             return false;
     }
 
+    auto start = std::chrono::steady_clock::now();
+    ProgramCache* cache = ProgramCache::instance();
+    uint64_t key = 0;
+    if (cache->inited()) {
+        key = cache->GetKey(vertex_shader_, fragment_shader_);
+        program_id_ = cache->Load(key);
+        if (program_id_ != 0) {
+            double ms = GetElapsedMs(start);
+            cache->AddLoadTime(ms);
+            vertex_shader_ = nullptr;
+            fragment_shader_ = nullptr;
+            RenderState::instance()->UseProgram(program_id_);
+            LOGD("%s - Program %d loaded from cache %.2f ms", name_, program_id_, ms);
+            return true;
+        }
+    }
+
     program_id_ = glCreateProgram();
+    if (cache->inited()) {
+        glProgramParameteri(program_id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
     int vshader = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vshader, 1, &vertex_shader_, nullptr);
@@ -81,12 +110,17 @@ bool Shader::Compile() {
         return false;
     }
 
+    double ms = GetElapsedMs(start);
+    cache->AddCompileTime(ms);
+    if (cache->inited()) {
+        cache->Store(key, program_id_);
+    }
+
     vertex_shader_ = nullptr;
     fragment_shader_ = nullptr;
-    glUseProgram(program_id_);
-    glUseProgram(0);
+    RenderState::instance()->UseProgram(program_id_);
 
-    LOGD("%s - Program %d Compiled", name_, program_id_);
+    LOGD("%s - Program %d Compiled %.2f ms", name_, program_id_, ms);
     return true;
 }
 
@@ -6,6 +6,7 @@
 #define MY_APPLICATION_SHADER_H
 
 #include "pxygl.h"
+#include "render_state.h"
 
 #include <vector>
 #include <memory>
@@ -19,11 +20,11 @@ public:
     ~Shader();
 
     inline void UseProgram() {
-        glUseProgram(program_id_);
+        RenderState::instance()->UseProgram(program_id_);
     }
 
+    // lazy, program stays bound until another one is used.
     inline void UnUseProgram() {
-        glUseProgram(0);
     }
 
     inline GLuint program_id() {
@@ -106,6 +106,29 @@ namespace  {
                                          //"    FragColor = vec4(1.0, 1.0, 0.0, 1.0);\n"
                                         "}";
 #endif
+    // vertex shader for GL_OVR_multiview2, drop translation of each eye view in shader.
+    const char* multiviewVertexShaderSource =
+#ifdef __ANDROID__
+                                     "#version 300 es\n"
+#else
+                                     "#version 410 core\n"
+#endif
+                                     "#extension GL_OVR_multiview2 : require\n"
+                                     "layout(num_views = 2) in;\n"
+                                     "layout (location = 0) in vec3 position;\n"
+                                     "layout(std140) uniform SceneMatrices {\n"
+                                     "    mat4 uViews[2];\n"
+                                     "    mat4 uProjections[2];\n"
+                                     "};\n"
+                                     "out vec3 v3fCoord;\n"
+                                     "\n"
+                                     "void main()\n"
+                                     "{\n"
+                                     "    mat4 view = mat4(mat3(uViews[gl_ViewID_OVR]));\n"
+                                     "    vec4 WVP_Pos = uProjections[gl_ViewID_OVR] * view * vec4(position, 1.0);\n"
+                                     "    gl_Position = WVP_Pos.xyww;\n"
+                                     "    v3fCoord = position;\n"
+                                     "}";
 }
 namespace lark {
 #ifdef __ANDROID__
@@ -127,11 +150,20 @@ SkyBox::SkyBox(const char* path) :
     projection_location_ = shader_->GetUniformLocation("uProjection");
     texture_location_ = shader_->GetUniformLocation("atexture");
 
+    LoadMultviewShader("shader/vertex/skybox_multiview_vertex.glsl", "shader/fragment/skybox_fragment.glsl",
+                       multiviewVertexShaderSource, fragmentShaderSource);
+    if (multiview_shader_) {
+        multiview_texture_location_ = multiview_shader_->GetUniformLocation("atexture");
+    }
+
     vao_ = std::make_shared<VertexArrayObject>(true, false);
 
     texture_ = AssetLoader::instance()->FindTexture(path);
     light_dir_ = glm::vec4(-0.8F, 0.45F, 0.4F, 0.40F);
     if (!texture_) {
+        texture_future_ = AssetLoader::instance()->FindLoadingTexture(path);
+    }
+    if (!texture_ && !texture_future_.valid()) {
         has_error_ = true;
         return;
     }
@@ -156,6 +188,12 @@ SkyBox::SkyBox(const char* path) :
     projection_location_ = shader_->GetUniformLocation("uProjection");
     texture_location_ = shader_->GetUniformLocation("atexture");
 
+    LoadMultviewShader("shader/vertex/skybox_multiview_vertex.glsl", "shader/fragment/skybox_fragment.glsl",
+                       multiviewVertexShaderSource, fragmentShaderSource);
+    if (multiview_shader_) {
+        multiview_texture_location_ = multiview_shader_->GetUniformLocation("atexture");
+    }
+
     vao_ = std::make_shared<VertexArrayObject>(true, false);
 
     texture_.reset(Texture::LoadSkyboxTexture(path_.c_str())) ;
@@ -200,15 +238,16 @@ void SkyBox::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView
     viewClone[3][2] = 0;
     viewClone[3][3] = 1;
 
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    if (!PrepareTexture() || !vao_) return;
 
-    if (!texture_ || !vao_) return;
+    RenderState* state = RenderState::instance();
+    state->Disable(GL_DEPTH_TEST);
+    state->DepthMask(GL_FALSE);
 
     shader_->UseProgram();
     glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(viewClone));
     glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
-    glActiveTexture(GL_TEXTURE0);
+    state->ActiveTexture(GL_TEXTURE0);
     texture_->BindTextureCubeMap();
     glUniform1i(texture_location_, 0);
     vao_->BindVAO();
@@ -218,8 +257,35 @@ void SkyBox::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView
     texture_->UnbindTextureCubeMap();
     shader_->UnUseProgram();
 
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
+
+    HasGLError();
+}
+
+void SkyBox::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &eyeView) {
+    Object::DrawMultiview(projection, eyeView);
+
+    if (!enable_ || !multiview_shader_ || !PrepareTexture() || !vao_)
+        return;
+
+    RenderState* state = RenderState::instance();
+    state->Disable(GL_DEPTH_TEST);
+    state->DepthMask(GL_FALSE);
+
+    multiview_shader_->UseProgram();
+    state->ActiveTexture(GL_TEXTURE0);
+    texture_->BindTextureCubeMap();
+    glUniform1i(multiview_texture_location_, 0);
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, vertices_);
+
+    vao_->UnbindVAO();
+    texture_->UnbindTextureCubeMap();
+    multiview_shader_->UnUseProgram();
+
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
 
     HasGLError();
 }
@@ -228,8 +294,32 @@ void SkyBox::SetTexture(const char* path) {
     std::shared_ptr<Texture> texture = AssetLoader::instance()->FindTexture(path);
     if (texture) {
         texture_ = texture;
-    } else {
-        LOGW("cant find skybox texture %s", path);
+        texture_future_ = TextureFuture();
+        return;
+    }
+#ifdef __ANDROID__
+    TextureFuture future = AssetLoader::instance()->FindLoadingTexture(path);
+    if (future.valid()) {
+        // keep the current texture until the new one loaded.
+        texture_future_ = future;
+        path_ = path;
+        return;
+    }
+#endif
+    LOGW("cant find skybox texture %s", path);
+}
+
+bool SkyBox::PrepareTexture() {
+    if (texture_future_.valid() &&
+        texture_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        std::shared_ptr<Texture> texture = texture_future_.get();
+        texture_future_ = TextureFuture();
+        if (texture) {
+            texture_ = texture;
+        } else {
+            LOGW("load skybox texture failed %s", path_.c_str());
+        }
     }
+    return texture_ != nullptr;
 }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "object.h"
 #include "bitmap_factory.h"
+#include "asset_loader.h"
 #include "pxygl.h"
 
 namespace lark {
@@ -24,14 +25,17 @@ public:
     inline const glm::vec4& light_dir() { return light_dir_; }
 
     virtual void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView) override;
+    virtual void DrawMultiview(const glm::mat4& projection, const glm::mat4& eyeView) override;
 private:
     void InitVertices();
+    // take the texture when the async load finished. draw nothing until then.
+    bool PrepareTexture();
 
     std::string path_ = "";
+    TextureFuture texture_future_ = {};
     int view_location_ = 0;
     int projection_location_ = 0;
     int texture_location_ = 0;
-    int multiview_matrix_location_ = 0;
     int multiview_texture_location_ = 0;
     glm::vec4 light_dir_;
     const int vertices_ = 36;
@@ -0,0 +1,93 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdio>
+#include "skybox_file.h"
+
+namespace {
+    size_t Align4(size_t size) {
+        return (size + 3) & ~static_cast<size_t>(3);
+    }
+}
+
+namespace lark {
+const char* SkyboxFile::EXTENSION = ".pxysky";
+
+std::string SkyboxFile::GetSkyboxPath(const std::string &imagePath) {
+    size_t dot = imagePath.find_last_of('.');
+    size_t slash = imagePath.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return imagePath + EXTENSION;
+    }
+    return imagePath.substr(0, dot) + EXTENSION;
+}
+
+bool SkyboxFile::Parse(const void *data, size_t size, FileHeader *header, std::vector<LevelView> *levels) {
+    levels->clear();
+    if (data == nullptr || size < sizeof(FileHeader)) {
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    *header = *reinterpret_cast<const FileHeader*>(bytes);
+    if (header->magic != MAGIC || header->version != VERSION ||
+        header->face_size == 0 || header->levels == 0 || header->levels > 16 ||
+        (header->face_size >> (header->levels - 1)) == 0) {
+        return false;
+    }
+    // filled only when the whole buffer is valid.
+    std::vector<LevelView> views;
+    size_t offset = sizeof(FileHeader);
+    for (uint32_t i = 0; i < header->levels; i++) {
+        LevelView view = {};
+        view.level = header->levels - 1 - i;
+        view.size = header->face_size >> view.level;
+        for (int face = 0; face < FACE_COUNT; face++) {
+            if (size - offset < sizeof(uint32_t)) {
+                return false;
+            }
+            uint32_t faceBytes = *reinterpret_cast<const uint32_t*>(bytes + offset);
+            offset += sizeof(uint32_t);
+            if (faceBytes == 0 || (face > 0 && faceBytes != view.face_bytes) ||
+                size - offset < Align4(faceBytes)) {
+                return false;
+            }
+            view.face_bytes = faceBytes;
+            view.faces[face] = bytes + offset;
+            offset += Align4(faceBytes);
+        }
+        views.push_back(view);
+    }
+    levels->swap(views);
+    return true;
+}
+
+bool SkyboxFile::Write(const std::string &path, uint32_t internalFormat, uint32_t faceSize,
+                       const std::vector<LevelData> &levels) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    FileHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.internal_format = internalFormat;
+    header.face_size = faceSize;
+    header.levels = static_cast<uint32_t>(levels.size());
+    bool res = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    const uint8_t padding[4] = {};
+    // smallest level first.
+    for (auto level = levels.rbegin(); res && level != levels.rend(); ++level) {
+        for (const auto & face : *level) {
+            uint32_t faceBytes = static_cast<uint32_t>(face.size());
+            size_t pad = Align4(face.size()) - face.size();
+            res = res && fwrite(&faceBytes, sizeof(faceBytes), 1, file) == 1 &&
+                  fwrite(face.data(), face.size(), 1, file) == 1 &&
+                  (pad == 0 || fwrite(padding, pad, 1, file) == 1);
+        }
+    }
+    res = fclose(file) == 0 && res;
+    return res;
+}
+}
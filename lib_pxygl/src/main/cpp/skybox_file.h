@@ -0,0 +1,62 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_SKYBOX_FILE_H
+#define CLOUDLARKXR_SKYBOX_FILE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lark {
+//
+// .pxysky, prebuilt cubemap with six split faces and all mip levels, uploaded as is.
+// FileHeader followed by the levels from the smallest to level 0, so the low levels
+// can be uploaded first and the large ones streamed in later.
+// each level holds the faces in GL_TEXTURE_CUBE_MAP_POSITIVE_X + i order,
+// every face is a uint32 size and the data, 4 byte aligned.
+// internal_format is a gl compressed format like GL_COMPRESSED_RGB8_ETC2 or ASTC.
+// no gl or log dependency, shared with the host converter in tools/pxysky.
+//
+class SkyboxFile {
+public:
+    static const uint32_t MAGIC = 0x53595850; // PXYS
+    static const uint32_t VERSION = 1;
+    static const int FACE_COUNT = 6;
+    static const char* EXTENSION;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t internal_format;
+        uint32_t face_size;
+        uint32_t levels;
+        uint32_t reserved;
+    };
+
+    // one mip level inside a parsed buffer, valid while the buffer is.
+    struct LevelView {
+        uint32_t level;
+        uint32_t size;
+        uint32_t face_bytes;
+        const void* faces[FACE_COUNT];
+    };
+
+    // faces of one level, writer input.
+    typedef std::array<std::vector<uint8_t>, FACE_COUNT> LevelData;
+
+    // "a/b.jpg" -> "a/b.pxysky".
+    static std::string GetSkyboxPath(const std::string& imagePath);
+
+    // check and index the buffer in place, levels from the smallest. return false when broken.
+    static bool Parse(const void* data, size_t size, FileHeader* header, std::vector<LevelView>* levels);
+
+    // levels[0] is level 0.
+    static bool Write(const std::string& path, uint32_t internalFormat, uint32_t faceSize,
+                      const std::vector<LevelData>& levels);
+};
+}
+
+#endif //CLOUDLARKXR_SKYBOX_FILE_H
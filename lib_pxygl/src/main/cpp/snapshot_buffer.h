@@ -0,0 +1,65 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_SNAPSHOT_BUFFER_H
+#define CLOUDLARKXR_SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace lark {
+//
+// hand immutable snapshots from producer threads to the render thread.
+// three slots: the producer fills back, the consumer reads front, the latest published
+// waits in the middle. Acquire swaps it to front without locking, so a slow producer
+// never stalls a frame. producers are serialized by a mutex.
+//
+template<typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer(): slots_(), latest_(), middle_(1), back_(0), front_(2) {}
+
+    // producer. edit a copy of the last published value and publish it.
+    template<typename Edit>
+    void Modify(Edit&& edit) {
+        std::lock_guard<std::mutex> lock(producer_mutex_);
+        edit(latest_);
+        slots_[back_] = latest_;
+        uint8_t prev = middle_.exchange(back_ | NEW_FLAG, std::memory_order_acq_rel);
+        back_ = prev & INDEX_MASK;
+    }
+
+    inline void Publish(const T& value) {
+        Modify([&value](T& latest) { latest = value; });
+    }
+
+    // consumer. return true when a newer snapshot became front.
+    bool Acquire() {
+        if ((middle_.load(std::memory_order_acquire) & NEW_FLAG) == 0) {
+            return false;
+        }
+        uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & INDEX_MASK;
+        return true;
+    }
+
+    // consumer. valid until next Acquire.
+    inline const T& front() const { return slots_[front_]; }
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t NEW_FLAG = 0x4;
+
+    T slots_[3];
+    // producer side.
+    T latest_;
+    std::mutex producer_mutex_;
+    std::atomic<uint8_t> middle_;
+    uint8_t back_;
+    // consumer side.
+    uint8_t front_;
+};
+}
+
+#endif //CLOUDLARKXR_SNAPSHOT_BUFFER_H
@@ -2,6 +2,8 @@
 // Created by fcx@pingxingyun.com on 2019/11/7.
 //
 
+#include <cstdlib>
+#include <cstring>
 #include "texture.h"
 #ifdef __ANDROID__
 //#include "env_context.h"
@@ -42,6 +44,7 @@ Texture::~Texture() {
 
 void Texture::Clear() {
     if (texture_ != 0) {
+        RenderState::instance()->ForgetTexture(texture_);
         glDeleteTextures(1, &texture_);
         texture_ = 0;
     }
@@ -106,53 +109,97 @@ Texture *Texture::LoadTexture(AAssetManager* assetManager, BitmapFactory* bitmap
 
 Texture *
 Texture::LoadTexture(AAssetManager* assetManager, BitmapFactory* bitmapFactory, JNIEnv *env, const char *assetFile, GLuint textureId) {
-    auto * textureFile = new AssetFile(assetManager, assetFile);
-    if (!textureFile->Open())
+    AssetFile textureFile(assetManager, assetFile);
+    if (!textureFile.Open())
         return nullptr;
-    const void * data = textureFile->GetBuffer();
-    size_t length = textureFile->GetLength();
+    return DecodeBitmap(bitmapFactory, env, textureFile.GetBuffer(), textureFile.GetLength(), assetFile, textureId);
+}
 
-    AndroidBitmapInfo info;
-    uint8_t * bmp = bitmapFactory->DecodeByteArray(env, data, length, info);
-    if (bmp == nullptr)
-        return nullptr;
+Texture *
+Texture::LoadTexture(BitmapFactory *bitmapFactory, JNIEnv *env, const char *buffer, int bufferLen, GLuint textureId) {
+    LOGV("LoadTexture %d", bufferLen);
+    return DecodeBitmap(bitmapFactory, env, buffer, bufferLen, "", textureId);
+}
 
-    Texture * texture = nullptr;
-    if (textureId != 0) {
-        texture = new Texture(assetFile);
-        texture->set_texture(textureId);
-    } else {
-        texture = GenTexture(assetFile);
+Texture *
+Texture::UploadTexture(BitmapFactory *bitmapFactory, JNIEnv *env, const void *data, size_t size, GLuint textureId) {
+    if (NdkImageDecoder::IsSupported()) {
+        NdkImageDecoder decoder;
+        Texture* texture = UploadTexture(&decoder, data, size, "", textureId);
+        if (texture != nullptr) {
+            return texture;
+        }
     }
-    texture->bitmap_ = bmp;
-    SetTextureInfo(texture, info);
-
-    delete textureFile;
-    return texture;
+    BitmapFactoryDecoder decoder(bitmapFactory, env);
+    return UploadTexture(&decoder, data, size, "", textureId);
 }
 
-Texture *
-Texture::LoadTexture(BitmapFactory *bitmapFactory, JNIEnv *env, const char *buffer, int bufferLen, GLuint textureId) {
-    LOGV("LoadTexture1 %d", bufferLen);
-    AndroidBitmapInfo info;
-    uint8_t * bmp = bitmapFactory->DecodeByteArray(env, buffer, bufferLen, info);
-    if (bmp == nullptr)
+Texture *Texture::DecodeBitmap(BitmapFactory *bitmapFactory, JNIEnv *env, const void *data, size_t size,
+                               const std::string &path, GLuint textureId) {
+    // decoded into the bitmap itself, freed with stbi_image_free in CleanBitmap.
+    ImageDecoder::Pixels pixels = {};
+    uint8_t* bmp = nullptr;
+    // no java byte array and bitmap on android 11+.
+    if (NdkImageDecoder::IsSupported()) {
+        NdkImageDecoder decoder;
+        bmp = decoder.DecodeBuffer(data, size, &pixels);
+    }
+    if (bmp == nullptr) {
+        // copied out of the locked java bitmap.
+        BitmapFactoryDecoder decoder(bitmapFactory, env);
+        bmp = decoder.DecodeBuffer(data, size, &pixels);
+    }
+    if (bmp == nullptr) {
         return nullptr;
-    LOGV("LoadTexture2 %d", bufferLen);
-    Texture * texture = nullptr;
-    if (textureId != 0) {
-        texture = new Texture("");
-        texture->set_texture(textureId);
-    } else {
-        texture = GenTexture("");
     }
+    Texture* texture = NewTexture(path, textureId);
     texture->bitmap_ = bmp;
-    SetTextureInfo(texture, info);
-    LOGV("LoadTexture3 %d", bufferLen);
+    texture->width_ = pixels.width;
+    texture->height_ = pixels.height;
+    texture->stride_ = pixels.stride;
+    texture->size_ = pixels.stride * pixels.height;
+    texture->format_ = pixels.format;
+    texture->type_ = pixels.type;
     return texture;
 }
 #endif // __ANDROID__
 
+Texture *Texture::UploadTexture(ImageDecoder *decoder, const void *data, size_t size, const std::string &path,
+                                GLuint textureId) {
+    Texture* texture = nullptr;
+    decoder->Decode(data, size, [&](const ImageDecoder::Pixels& pixels) {
+        texture = NewTexture(path, textureId);
+        texture->width_ = pixels.width;
+        texture->height_ = pixels.height;
+        texture->stride_ = pixels.stride;
+        texture->size_ = pixels.stride * pixels.height;
+        texture->format_ = pixels.format;
+        texture->type_ = pixels.type;
+
+        int rowLength = pixels.stride / pixels.bytes_per_pixel;
+        texture->BindTexture();
+        if (rowLength != pixels.width) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, pixels.format == GL_RED ? GL_R8 : pixels.format, pixels.width, pixels.height,
+                     0, pixels.format, pixels.type, pixels.data);
+        if (rowLength != pixels.width) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        }
+        texture->UnBindTexture();
+    });
+    return texture;
+}
+
+Texture *Texture::NewTexture(const std::string &path, GLuint textureId) {
+    if (textureId == 0) {
+        return GenTexture(path);
+    }
+    auto * texture = new Texture(path);
+    texture->set_texture(textureId);
+    return texture;
+}
+
 Texture* Texture::LoadNetTexture(const char * url) {
     return LoadNetTexture(url, 0);
 }
@@ -6,6 +6,8 @@
 #define MY_APPLICATION_TEXTURE_H
 
 #include "pxygl.h"
+#include "render_state.h"
+#include "image_decoder.h"
 #include <string>
 
 #ifdef __ANDROID__
@@ -39,7 +41,11 @@ public:
     static Texture* LoadTexture(AAssetManager* assetManager, BitmapFactory* bitmapFactory, JNIEnv* env, const char* assetFile, GLuint textureId);
     static Texture* LoadTexture(BitmapFactory* bitmapFactory, JNIEnv* env, const char* buffer, int bufferLen, GLuint textureId);
     static Texture* LoadSkyboxTexture(AAssetManager* assetManager, BitmapFactory* bitmapFactory, JNIEnv* env, const char * assetFile);
+    // AImageDecoder on android 11+, BitmapFactory before. uploaded at once, bitmap() stays empty.
+    static Texture* UploadTexture(BitmapFactory* bitmapFactory, JNIEnv* env, const void* data, size_t size, GLuint textureId);
 #endif
+    // decode and upload straight from the decoder pixels, bitmap() stays empty.
+    static Texture* UploadTexture(ImageDecoder* decoder, const void* data, size_t size, const std::string& path, GLuint textureId);
     static Texture* LoadTextureFromData(const char* data, size_t data_size);
     static Texture* LoadTexture(const char * assetFile);
     static Texture* LoadTexture(const char * assetFile, GLuint textureId);
@@ -62,19 +68,18 @@ public:
     void CleanBitmap();
 
     inline void BindTexture() {
-        glBindTexture(GL_TEXTURE_2D, texture_);
+        RenderState::instance()->BindTexture(GL_TEXTURE_2D, texture_);
     }
 
+    // lazy, texture stays bound until another one is bound to the unit.
     inline void UnBindTexture() {
-        glBindTexture(GL_TEXTURE_2D, 0);
     }
 
     inline void BindTextureCubeMap() {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, texture_);
+        RenderState::instance()->BindTexture(GL_TEXTURE_CUBE_MAP, texture_);
     }
 
     inline void UnbindTextureCubeMap() {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     inline size_t width() {
@@ -117,6 +122,13 @@ public:
 private:
     Texture(const std::string& path);
 
+#ifdef __ANDROID__
+    // decode to a cpu bitmap uploaded later by the user.
+    static Texture* DecodeBitmap(BitmapFactory* bitmapFactory, JNIEnv* env, const void* data, size_t size,
+                                 const std::string& path, GLuint textureId);
+#endif
+    static Texture* NewTexture(const std::string& path, GLuint textureId);
+
     void Clear();
     void set_texture(int texture);
 
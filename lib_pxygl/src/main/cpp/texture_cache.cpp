@@ -0,0 +1,371 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/17.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "texture_cache.h"
+#include "logger.h"
+
+#define LOG_TAG "pxygl_TextureCache"
+
+namespace {
+    const char* FILE_EXT = ".pxyc";
+    const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    bool MakeDirs(const std::string& path) {
+        for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+            std::string dir = path.substr(0, pos);
+            if (mkdir(dir.c_str(), 0770) == -1 && errno != EEXIST) {
+                return false;
+            }
+            if (pos == std::string::npos) {
+                return true;
+            }
+        }
+    }
+
+    bool ParseKey(const char* name, uint64_t* key) {
+        size_t len = strlen(name);
+        size_t extLen = strlen(FILE_EXT);
+        if (len != 16 + extLen || strcmp(name + 16, FILE_EXT) != 0) {
+            return false;
+        }
+        char* end = nullptr;
+        *key = strtoull(std::string(name, 16).c_str(), &end, 16);
+        return end != nullptr && *end == '\0';
+    }
+
+    uint64_t GetMtimeNs(const struct stat& st) {
+        return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000 * 1000 * 1000 + st.st_mtim.tv_nsec;
+    }
+
+    // wall clock, entries outlive the process.
+    int64_t NowS() {
+        return static_cast<int64_t>(time(nullptr));
+    }
+}
+
+namespace lark {
+////////////////////////////////////////////////////////////////////////////////////////////////////
+CachedImage::CachedImage(void *map, size_t mapSize):
+    map_(map),
+    map_size_(mapSize) {
+}
+
+CachedImage::~CachedImage() {
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+TextureCache* TextureCache::instance_ = nullptr;
+
+TextureCache* TextureCache::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new TextureCache();
+    }
+    return instance_;
+}
+
+void TextureCache::Release() {
+    if (instance_ != nullptr) {
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+uint64_t TextureCache::Hash(const void *data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+TextureCache::TextureCache() = default;
+
+TextureCache::~TextureCache() {
+    LOGV("texture cache release. hits %" PRIu64 " misses %" PRIu64 " size %zu",
+         hits_, misses_, total_bytes_);
+}
+
+bool TextureCache::Init(const std::string &dir, size_t maxBytes, int64_t maxAgeS) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inited_) {
+        return true;
+    }
+    if (dir.empty() || !MakeDirs(dir)) {
+        LOGW("create texture cache dir failed %s", dir.c_str());
+        return false;
+    }
+    dir_ = dir;
+    max_bytes_ = maxBytes;
+    max_age_s_ = maxAgeS;
+
+    DIR* d = opendir(dir_.c_str());
+    if (d == nullptr) {
+        LOGW("open texture cache dir failed %s", dir_.c_str());
+        return false;
+    }
+    struct File {
+        uint64_t mtime;
+        uint64_t key;
+        size_t size;
+        uint64_t source_hash;
+        int64_t validated_time;
+        bool operator<(const File& other) const { return mtime < other.mtime; }
+    };
+    // oldest first, then insert to front one by one.
+    std::vector<File> files;
+    struct dirent* ent = nullptr;
+    while ((ent = readdir(d)) != nullptr) {
+        uint64_t key = 0;
+        std::string path = dir_ + "/" + ent->d_name;
+        if (!ParseKey(ent->d_name, &key)) {
+            // temp file left by a killed process.
+            if (strstr(ent->d_name, ".tmp") != nullptr) {
+                unlink(path.c_str());
+            }
+            continue;
+        }
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            continue;
+        }
+        // header only, source hash and validated time go to the index.
+        struct stat st = {};
+        Header header = {};
+        bool valid = fstat(fd, &st) == 0 &&
+                pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                CheckHeader(header, static_cast<size_t>(st.st_size));
+        close(fd);
+        if (!valid) {
+            // broken or written by an older version.
+            unlink(path.c_str());
+            continue;
+        }
+        files.push_back({ GetMtimeNs(st), key, static_cast<size_t>(st.st_size),
+                          header.source_hash, header.validated_time });
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) {
+        Insert(file.key, file.size, file.source_hash, file.validated_time);
+    }
+    Evict();
+    inited_ = true;
+    LOGV("texture cache init %s entries %zu size %zu", dir_.c_str(), entries_.size(), total_bytes_);
+    return true;
+}
+
+bool TextureCache::Contains(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.find(key) != entries_.end();
+}
+
+bool TextureCache::IsStale(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return true;
+    }
+    return NowS() - it->second.validated_time > max_age_s_;
+}
+
+bool TextureCache::Validate(uint64_t key, uint64_t sourceHash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (!inited_ || it == entries_.end() || it->second.source_hash != sourceHash) {
+        return false;
+    }
+    // source unchanged, only the time field is rewritten.
+    int64_t now = NowS();
+    std::string path = GetPath(key);
+    int fd = open(path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        LOGW("open texture cache failed %s", path.c_str());
+        Erase(key);
+        return false;
+    }
+    bool res = pwrite(fd, &now, sizeof(now), offsetof(Header, validated_time)) == static_cast<ssize_t>(sizeof(now));
+    close(fd);
+    if (!res) {
+        LOGW("write texture cache validated time failed %s", path.c_str());
+        return false;
+    }
+    it->second.validated_time = now;
+    Touch(it->second);
+    return true;
+}
+
+std::shared_ptr<CachedImage> TextureCache::Open(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (!inited_ || it == entries_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    std::string path = GetPath(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOGW("open texture cache failed %s", path.c_str());
+        Erase(key);
+        misses_++;
+        return nullptr;
+    }
+    struct stat st = {};
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+        map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // mapping stays valid after close.
+    close(fd);
+    if (map == MAP_FAILED) {
+        LOGW("map texture cache failed %s", path.c_str());
+        unlink(path.c_str());
+        Erase(key);
+        misses_++;
+        return nullptr;
+    }
+
+    std::shared_ptr<CachedImage> image = std::make_shared<CachedImage>(map, static_cast<size_t>(st.st_size));
+    const Header* header = static_cast<const Header*>(map);
+    if (!CheckHeader(*header, static_cast<size_t>(st.st_size))) {
+        LOGW("broken texture cache %s", path.c_str());
+        unlink(path.c_str());
+        Erase(key);
+        misses_++;
+        return nullptr;
+    }
+    image->width_ = header->width;
+    image->height_ = header->height;
+    image->format_ = header->format;
+    image->source_hash_ = header->source_hash;
+    image->pixels_ = static_cast<const uint8_t*>(map) + sizeof(Header);
+    image->pixels_size_ = header->data_size;
+    // read ahead, pixels are copied in render thread later.
+    madvise(map, st.st_size, MADV_WILLNEED);
+
+    Touch(it->second);
+    // keep use order for next launch.
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+    hits_++;
+    return image;
+}
+
+bool TextureCache::Store(uint64_t key, uint64_t sourceHash, int width, int height, const uint8_t *rgba) {
+    if (!inited_ || rgba == nullptr || width <= 0 || height <= 0) {
+        return false;
+    }
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.format = Format_RGBA8;
+    header.levels = 1;
+    header.width = width;
+    header.height = height;
+    header.source_hash = sourceHash;
+    header.data_size = static_cast<uint64_t>(width) * height * 4;
+    header.validated_time = NowS();
+
+    // write to temp file then rename, readers never see half written entries.
+    std::string path = GetPath(key);
+    char tid[32] = {};
+    snprintf(tid, sizeof(tid), ".%d.tmp", static_cast<int>(gettid()));
+    std::string tmpPath = path + tid;
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        LOGW("create texture cache failed %s", tmpPath.c_str());
+        return false;
+    }
+    bool res = fwrite(&header, sizeof(header), 1, file) == 1 &&
+               fwrite(rgba, header.data_size, 1, file) == 1;
+    res = fclose(file) == 0 && res;
+    if (!res || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGW("write texture cache failed %s", path.c_str());
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Erase(key);
+    Insert(key, sizeof(header) + header.data_size, sourceHash, header.validated_time);
+    Evict();
+    return true;
+}
+
+void TextureCache::Remove(uint64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.find(key) == entries_.end()) {
+        return;
+    }
+    unlink(GetPath(key).c_str());
+    Erase(key);
+}
+
+std::string TextureCache::GetPath(uint64_t key) const {
+    char name[32] = {};
+    snprintf(name, sizeof(name), "%016" PRIx64, key);
+    return dir_ + "/" + name + FILE_EXT;
+}
+
+bool TextureCache::CheckHeader(const Header& header, size_t fileSize) {
+    return fileSize >= sizeof(Header) &&
+           header.magic == MAGIC && header.version == VERSION && header.format == Format_RGBA8 &&
+           header.width > 0 && header.height > 0 &&
+           header.data_size == static_cast<uint64_t>(header.width) * header.height * 4 &&
+           header.data_size <= fileSize - sizeof(Header);
+}
+
+void TextureCache::Touch(Entry& entry) {
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+}
+
+void TextureCache::Insert(uint64_t key, size_t size, uint64_t sourceHash, int64_t validatedTime) {
+    lru_.push_front(key);
+    Entry entry = {};
+    entry.size = size;
+    entry.source_hash = sourceHash;
+    entry.validated_time = validatedTime;
+    entry.lru = lru_.begin();
+    entries_[key] = entry;
+    total_bytes_ += size;
+}
+
+void TextureCache::Erase(uint64_t key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return;
+    }
+    total_bytes_ -= it->second.size;
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+void TextureCache::Evict() {
+    // keep the newest entry even if it alone exceeds the limit.
+    while (total_bytes_ > max_bytes_ && lru_.size() > 1) {
+        uint64_t key = lru_.back();
+        unlink(GetPath(key).c_str());
+        Erase(key);
+    }
+}
+}
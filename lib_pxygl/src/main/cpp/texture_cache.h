@@ -0,0 +1,154 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/17.
+//
+
+#ifndef CLOUDLARKXR_TEXTURE_CACHE_H
+#define CLOUDLARKXR_TEXTURE_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "pxygl.h"
+
+namespace lark {
+//
+// one cache entry mapped read only. pixels stay valid while the object is alive,
+// even if the entry is evicted meanwhile.
+//
+class CLOUDLARK_PXYGL_API CachedImage {
+public:
+    CachedImage(void* map, size_t mapSize);
+    ~CachedImage();
+
+    inline int width() const { return width_; }
+    inline int height() const { return height_; }
+    inline uint32_t format() const { return format_; }
+    // hash of the encoded source image.
+    inline uint64_t source_hash() const { return source_hash_; }
+    inline const uint8_t* pixels() const { return pixels_; }
+    inline size_t pixels_size() const { return pixels_size_; }
+private:
+    friend class TextureCache;
+
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+    int width_ = 0;
+    int height_ = 0;
+    uint32_t format_ = 0;
+    uint64_t source_hash_ = 0;
+    const uint8_t* pixels_ = nullptr;
+    size_t pixels_size_ = 0;
+};
+
+//
+// persistent decoded image cache on disk.
+// one file per key, a fixed header followed by level 0 pixels, mapped back with mmap so
+// a hit skips both download and decode. total size is bounded, least recently used
+// entries are evicted first. file mtime keeps the use order across launches.
+// entries older than max age are stale, callers show them and check them against the
+// source again with Validate, which keeps the entry when the source hash is unchanged.
+// thread safe.
+//
+class CLOUDLARK_PXYGL_API TextureCache {
+public:
+    enum Format {
+        Format_RGBA8 = 0,
+        // reserved for pre-transcoded entries.
+        Format_ETC2_RGBA8,
+        Format_ASTC_4x4,
+    };
+
+    static const uint32_t MAGIC = 0x43595850; // PXYC
+    // 2: validated_time added.
+    static const uint32_t VERSION = 2;
+    // about 250 covers of 512x512 rgba.
+    static const size_t DEFAULT_MAX_BYTES = 256 * 1024 * 1024;
+    // check entries against the source once a day.
+    static const int64_t DEFAULT_MAX_AGE_S = 24 * 60 * 60;
+
+    static TextureCache* instance();
+    static void Release();
+
+    // fnv-1a 64.
+    static uint64_t Hash(const void* data, size_t size);
+    static inline uint64_t Hash(const std::string& str) { return Hash(str.data(), str.size()); }
+
+    // create dir and load index from existing file headers. evict when over maxBytes.
+    bool Init(const std::string& dir, size_t maxBytes = DEFAULT_MAX_BYTES,
+              int64_t maxAgeS = DEFAULT_MAX_AGE_S);
+    inline bool inited() const { return inited_; }
+
+    // index lookup only, no disk access.
+    bool Contains(uint64_t key);
+    // index lookup only. true when missing or not validated within max age.
+    bool IsStale(uint64_t key);
+    // compare hash of the freshly downloaded source with the stored one.
+    // same source: mark the entry validated now and return true.
+    // different or missing: return false, caller decodes and stores again.
+    bool Validate(uint64_t key, uint64_t sourceHash);
+    // map entry and mark it recently used. return nullptr when missing or broken,
+    // broken entries are removed.
+    std::shared_ptr<CachedImage> Open(uint64_t key);
+    // write entry, replace old one with the same key. call on worker thread.
+    bool Store(uint64_t key, uint64_t sourceHash, int width, int height, const uint8_t* rgba);
+    void Remove(uint64_t key);
+
+    inline size_t total_bytes() const { return total_bytes_; }
+    inline size_t max_bytes() const { return max_bytes_; }
+    inline int64_t max_age_s() const { return max_age_s_; }
+    // stats
+    inline uint64_t hits() const { return hits_; }
+    inline uint64_t misses() const { return misses_; }
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;
+        uint32_t levels;
+        int32_t width;
+        int32_t height;
+        uint64_t source_hash;
+        uint64_t data_size;
+        // unix time in seconds the entry was last checked against the source.
+        int64_t validated_time;
+    };
+
+    struct Entry {
+        size_t size;
+        uint64_t source_hash;
+        int64_t validated_time;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    static TextureCache* instance_;
+
+    TextureCache();
+    ~TextureCache();
+
+    std::string GetPath(uint64_t key) const;
+    static bool CheckHeader(const Header& header, size_t fileSize);
+    // with lock held.
+    void Touch(Entry& entry);
+    void Insert(uint64_t key, size_t size, uint64_t sourceHash, int64_t validatedTime);
+    void Erase(uint64_t key);
+    void Evict();
+
+    std::mutex mutex_;
+    std::atomic<bool> inited_ = {false};
+    std::string dir_ = "";
+    size_t max_bytes_ = DEFAULT_MAX_BYTES;
+    int64_t max_age_s_ = DEFAULT_MAX_AGE_S;
+    size_t total_bytes_ = 0;
+    // front is most recently used.
+    std::list<uint64_t> lru_;
+    std::unordered_map<uint64_t, Entry> entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_TEXTURE_CACHE_H
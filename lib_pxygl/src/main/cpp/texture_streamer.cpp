@@ -0,0 +1,300 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/16.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "texture_streamer.h"
+#include "stb_image.h"
+#include "logger.h"
+
+#define LOG_TAG "pxygl_TextureStreamer"
+
+namespace {
+    const int RGBA_CHANNELS = 4;
+}
+
+namespace lark {
+////////////////////////////////////////////////////////////////////////////////////////////////////
+TextureRequest::TextureRequest(std::vector<char>&& encoded, uint64_t cacheKey):
+    state_(State_Decoding),
+    encoded_(std::move(encoded)),
+    cache_key_(cacheKey) {
+}
+
+TextureRequest::TextureRequest(uint64_t cacheKey):
+    state_(State_Decoding),
+    cache_key_(cacheKey),
+    from_cache_(true) {
+}
+
+TextureRequest::~TextureRequest() {
+    ReleasePixels();
+    // fence only created in render thread. request released in render thread by streamer or owner.
+    if (fence_ != nullptr) {
+        glDeleteSync(fence_);
+        fence_ = nullptr;
+    }
+}
+
+void TextureRequest::ReleasePixels() {
+    if (cached_) {
+        // pixels point into the mapping.
+        cached_ = nullptr;
+    } else if (pixels_ != nullptr) {
+        stbi_image_free(const_cast<uint8_t*>(pixels_));
+    }
+    pixels_ = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+std::mutex TextureStreamer::instance_mutex_;
+std::shared_ptr<TextureStreamer> TextureStreamer::instance_ = nullptr;
+
+std::shared_ptr<TextureStreamer> TextureStreamer::instance() {
+    // cover loader threads request too.
+    std::lock_guard<std::mutex> lock(instance_mutex_);
+    if (instance_ == nullptr) {
+        instance_ = std::shared_ptr<TextureStreamer>(new TextureStreamer(),
+                                                     [](TextureStreamer* streamer) { delete streamer; });
+    }
+    return instance_;
+}
+
+void TextureStreamer::Release() {
+    std::shared_ptr<TextureStreamer> streamer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(instance_mutex_);
+        streamer.swap(instance_);
+    }
+    if (streamer == nullptr) {
+        return;
+    }
+    // no new owner after the swap. Request only queues, the wait is short.
+    while (streamer.use_count() > 1) {
+        std::this_thread::yield();
+    }
+    // delete gl objects here in render thread.
+    streamer = nullptr;
+}
+
+TextureStreamer::TextureStreamer() {
+    for (int i = 0; i < WORKER_COUNT; i++) {
+        workers_.emplace_back(&TextureStreamer::Run, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cond_.notify_all();
+    for (auto & worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    decode_queue_.clear();
+    decoded_.clear();
+    uploading_.clear();
+    fencing_.clear();
+    if (pixel_buffer_ != 0) {
+        glDeleteBuffers(1, &pixel_buffer_);
+        pixel_buffer_ = 0;
+    }
+}
+
+std::shared_ptr<TextureRequest> TextureStreamer::Request(std::vector<char>&& encoded, uint64_t cacheKey) {
+    std::shared_ptr<TextureRequest> request = std::make_shared<TextureRequest>(std::move(encoded), cacheKey);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decode_queue_.push_back(request);
+    }
+    cond_.notify_one();
+    return request;
+}
+
+std::shared_ptr<TextureRequest> TextureStreamer::RequestCached(uint64_t cacheKey) {
+    std::shared_ptr<TextureRequest> request = std::make_shared<TextureRequest>(cacheKey);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decode_queue_.push_back(request);
+    }
+    cond_.notify_one();
+    return request;
+}
+
+void TextureStreamer::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cond_.wait(lock, [this] { return !running_ || !decode_queue_.empty(); });
+        if (!running_) {
+            break;
+        }
+        std::shared_ptr<TextureRequest> request = decode_queue_.front();
+        decode_queue_.pop_front();
+        // nobody waiting for it.
+        if (request.use_count() == 1) {
+            continue;
+        }
+
+        lock.unlock();
+        if (request->from_cache_) {
+            LoadCached(request.get());
+        } else {
+            Decode(request.get());
+        }
+        lock.lock();
+
+        decoded_.push_back(request);
+    }
+}
+
+void TextureStreamer::Decode(TextureRequest *request) {
+    int channels = 0;
+    request->pixels_ = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(request->encoded_.data()),
+                                             static_cast<int>(request->encoded_.size()),
+                                             &request->width_, &request->height_, &channels, RGBA_CHANNELS);
+    if (request->pixels_ == nullptr) {
+        LOGW("decode texture failed %s size %zu", stbi_failure_reason(), request->encoded_.size());
+        request->state_.store(TextureRequest::State_Failed, std::memory_order_release);
+        return;
+    }
+    if (request->cache_key_ != 0) {
+        TextureCache::instance()->Store(request->cache_key_,
+                                        TextureCache::Hash(request->encoded_.data(), request->encoded_.size()),
+                                        request->width_, request->height_, request->pixels_);
+    }
+    // not needed anymore.
+    std::vector<char>().swap(request->encoded_);
+    request->state_.store(TextureRequest::State_Uploading, std::memory_order_release);
+}
+
+void TextureStreamer::LoadCached(TextureRequest *request) {
+    std::shared_ptr<CachedImage> image = TextureCache::instance()->Open(request->cache_key_);
+    if (!image) {
+        request->state_.store(TextureRequest::State_Failed, std::memory_order_release);
+        return;
+    }
+    request->cached_ = image;
+    request->pixels_ = image->pixels();
+    request->width_ = image->width();
+    request->height_ = image->height();
+    request->state_.store(TextureRequest::State_Uploading, std::memory_order_release);
+}
+
+void TextureStreamer::Update() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!decoded_.empty()) {
+            if (decoded_.front()->state() == TextureRequest::State_Uploading) {
+                uploading_.push_back(decoded_.front());
+            }
+            decoded_.pop_front();
+        }
+    }
+
+    // textures ready when gpu finished the copy.
+    for (auto it = fencing_.begin(); it != fencing_.end();) {
+        TextureRequest* request = it->get();
+        GLenum res = glClientWaitSync(request->fence_, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (res == GL_ALREADY_SIGNALED || res == GL_CONDITION_SATISFIED || res == GL_WAIT_FAILED) {
+            glDeleteSync(request->fence_);
+            request->fence_ = nullptr;
+            request->state_.store(TextureRequest::State_Ready, std::memory_order_release);
+            completed_++;
+            it = fencing_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (uploading_.empty()) {
+        return;
+    }
+
+    size_t budgetLeft = upload_budget_;
+    while (!uploading_.empty() && budgetLeft > 0) {
+        std::shared_ptr<TextureRequest> request = uploading_.front();
+        // owner gone.
+        if (request.use_count() == 2) {
+            uploading_.pop_front();
+            continue;
+        }
+        size_t bytes = Upload(request.get(), budgetLeft);
+        if (bytes == 0) {
+            break;
+        }
+        budgetLeft = bytes < budgetLeft ? budgetLeft - bytes : 0;
+        uploaded_bytes_ += bytes;
+
+        if (request->uploaded_rows_ >= request->height_) {
+            request->ReleasePixels();
+            request->fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            fencing_.push_back(request);
+            uploading_.pop_front();
+        }
+    }
+}
+
+size_t TextureStreamer::Upload(TextureRequest *request, size_t budget) {
+    const size_t rowBytes = static_cast<size_t>(request->width_) * RGBA_CHANNELS;
+    if (request->texture_ == nullptr) {
+        // allocate storage only, rows are uploaded in later frames.
+        request->texture_.reset(Texture::LoadTexture(nullptr, GL_RGBA, request->width_, request->height_,
+                                                     static_cast<int>(rowBytes)));
+    }
+
+    int rows = static_cast<int>(budget / rowBytes);
+    // always make progress on very wide images when whole budget left.
+    if (rows == 0 && budget == upload_budget_) {
+        rows = 1;
+    }
+    rows = std::min(rows, request->height_ - request->uploaded_rows_);
+    if (rows <= 0) {
+        return 0;
+    }
+    size_t size = rowBytes * rows;
+    if (!EnsurePixelBuffer(size)) {
+        return 0;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer_);
+    // invalidate so driver orphans the buffer instead of waiting last copy.
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst == nullptr) {
+        LOGW("map pixel unpack buffer failed");
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return 0;
+    }
+    memcpy(dst, request->pixels_ + rowBytes * request->uploaded_rows_, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    request->texture_->BindTexture();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, request->uploaded_rows_, request->width_, rows,
+                    GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    request->texture_->UnBindTexture();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    request->uploaded_rows_ += rows;
+    return size;
+}
+
+bool TextureStreamer::EnsurePixelBuffer(size_t size) {
+    if (pixel_buffer_ == 0) {
+        glGenBuffers(1, &pixel_buffer_);
+        pixel_buffer_size_ = 0;
+    }
+    if (pixel_buffer_size_ >= size) {
+        return true;
+    }
+    size_t newSize = std::max(size, upload_budget_);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer_);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, newSize, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pixel_buffer_size_ = newSize;
+    return true;
+}
+}
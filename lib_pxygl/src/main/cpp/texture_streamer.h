@@ -0,0 +1,134 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/16.
+//
+
+#ifndef CLOUDLARKXR_TEXTURE_STREAMER_H
+#define CLOUDLARKXR_TEXTURE_STREAMER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <condition_variable>
+#include "pxygl.h"
+#include "texture.h"
+#include "texture_cache.h"
+
+namespace lark {
+class TextureStreamer;
+
+//
+// one async texture load. hold the shared_ptr to keep the load alive,
+// loads without other owner are dropped by the streamer.
+//
+class CLOUDLARK_PXYGL_API TextureRequest {
+public:
+    enum State {
+        State_Decoding = 0,
+        State_Uploading,
+        State_Ready,
+        State_Failed,
+    };
+
+    // cacheKey not 0: store decoded pixels to texture cache.
+    TextureRequest(std::vector<char>&& encoded, uint64_t cacheKey = 0);
+    // load pixels from texture cache entry.
+    explicit TextureRequest(uint64_t cacheKey);
+    ~TextureRequest();
+
+    inline State state() const { return static_cast<State>(state_.load(std::memory_order_acquire)); }
+    inline bool done() const { return state() == State_Ready || state() == State_Failed; }
+    // valid when State_Ready. render thread.
+    inline const std::shared_ptr<Texture>& texture() const { return texture_; }
+    // encoded data kept when decode failed, so caller can fall back to another decoder.
+    inline const std::vector<char>& encoded() const { return encoded_; }
+private:
+    friend class TextureStreamer;
+
+    std::atomic<int> state_;
+    std::vector<char> encoded_;
+
+    void ReleasePixels();
+
+    uint64_t cache_key_ = 0;
+    bool from_cache_ = false;
+
+    // decoded rgba, owned by stb_image or mapped from cache.
+    const uint8_t* pixels_ = nullptr;
+    std::shared_ptr<CachedImage> cached_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+
+    // render thread.
+    int uploaded_rows_ = 0;
+    GLsync fence_ = nullptr;
+    std::shared_ptr<Texture> texture_ = nullptr;
+};
+
+//
+// texture streaming off the render thread.
+// worker threads decode with stb_image or map decoded pixels from texture cache,
+// render thread uploads rows through a pixel unpack buffer with at most upload_budget
+// bytes per frame, a fence marks the texture ready so the first draw never waits for the upload.
+//
+class CLOUDLARK_PXYGL_API TextureStreamer {
+public:
+    static const int WORKER_COUNT = 2;
+    // a 512x512 rgba cover per frame.
+    static const size_t DEFAULT_UPLOAD_BUDGET = 1024 * 1024;
+
+    // any thread. the streamer stays alive while the returned pointer is held.
+    static std::shared_ptr<TextureStreamer> instance();
+    // stop workers and delete gl objects. call in render thread when gl context destroyed.
+    // waits for other threads still inside Request, the next instance() creates a new streamer.
+    static void Release();
+
+    // any thread. data moved into request.
+    // decoded pixels are written to texture cache under cacheKey when not 0.
+    std::shared_ptr<TextureRequest> Request(std::vector<char>&& encoded, uint64_t cacheKey = 0);
+    // any thread. request failed with empty encoded data when entry missing.
+    std::shared_ptr<TextureRequest> RequestCached(uint64_t cacheKey);
+    // render thread. call once per frame from the app render loop.
+    // upload decoded images within upload_budget bytes and check fences.
+    void Update();
+
+    inline void set_upload_budget(size_t bytes) { upload_budget_ = bytes; }
+    inline size_t upload_budget() const { return upload_budget_; }
+    // stats
+    inline uint64_t uploaded_bytes() const { return uploaded_bytes_; }
+    inline uint64_t completed() const { return completed_; }
+private:
+    static std::mutex instance_mutex_;
+    static std::shared_ptr<TextureStreamer> instance_;
+
+    TextureStreamer();
+    ~TextureStreamer();
+
+    void Run();
+    static void Decode(TextureRequest* request);
+    static void LoadCached(TextureRequest* request);
+    // return bytes uploaded.
+    size_t Upload(TextureRequest* request, size_t budget);
+    bool EnsurePixelBuffer(size_t size);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool running_ = true;
+    std::deque<std::shared_ptr<TextureRequest>> decode_queue_;
+    std::deque<std::shared_ptr<TextureRequest>> decoded_;
+
+    // render thread.
+    std::deque<std::shared_ptr<TextureRequest>> uploading_;
+    std::deque<std::shared_ptr<TextureRequest>> fencing_;
+    GLuint pixel_buffer_ = 0;
+    size_t pixel_buffer_size_ = 0;
+    size_t upload_budget_ = DEFAULT_UPLOAD_BUDGET;
+    uint64_t uploaded_bytes_ = 0;
+    uint64_t completed_ = 0;
+};
+}
+
+#endif //CLOUDLARKXR_TEXTURE_STREAMER_H
@@ -11,7 +11,7 @@ VertexArrayObject::VertexArrayObject(bool hasAB, bool hasEAB):
      element_array_buffer_(0) 
 {
     glGenVertexArrays(1, &vertex_array_object_);
-    glBindVertexArray(vertex_array_object_);
+    RenderState::instance()->BindVertexArray(vertex_array_object_);
 
     if (hasAB)
         glGenBuffers(1, &array_buffer_);
@@ -21,6 +21,7 @@ VertexArrayObject::VertexArrayObject(bool hasAB, bool hasEAB):
 }
 
 VertexArrayObject::~VertexArrayObject() {
+    RenderState::instance()->ForgetVertexArray(vertex_array_object_);
     glDeleteVertexArrays(1, &vertex_array_object_);
     glDeleteBuffers(1, &array_buffer_);
     glDeleteBuffers(1, &element_array_buffer_);
@@ -6,6 +6,7 @@
 #define MY_APPLICATION_VERTEX_ARRAY_OBJECT_H
 
 #include "pxygl.h"
+#include "render_state.h"
 
 namespace lark {
 class CLOUDLARK_PXYGL_API VertexArrayObject {
@@ -20,11 +21,12 @@ public:
     inline GLuint element_array_buffer() {return element_array_buffer_;}
 
     inline void BindVAO() {
-        glBindVertexArray(vertex_array_object_);
+        RenderState::instance()->BindVertexArray(vertex_array_object_);
     }
 
+    // not lazy, buffer binds after it must not change this vao.
     inline void UnbindVAO() {
-        glBindVertexArray(0);
+        RenderState::instance()->BindVertexArray(0);
     }
 
     inline void BindArrayBuffer() {
@@ -0,0 +1,17 @@
+#version 300 es
+#extension GL_OVR_multiview2 : require
+layout(num_views = 2) in;
+layout (location = 0) in vec3 aPos;
+
+// uniforms
+uniform mat4 uModel;
+// both eyes, indexed by view id.
+layout(std140) uniform SceneMatrices {
+    mat4 uViews[2];
+    mat4 uProjections[2];
+};
+
+void main()
+{
+    gl_Position = uProjections[gl_ViewID_OVR] * uViews[gl_ViewID_OVR] * uModel * vec4(aPos, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 300 es
+#extension GL_OVR_multiview2 : require
+layout(num_views = 2) in;
+layout (location = 0) in vec3 v3Positon; // <vec3 pos, vec2 tex>
+layout (location = 1) in vec2 v2Cood;   // <vec3 pos, vec2 tex>
+
+// uniforms
+uniform mat4 uModel;
+// both eyes, indexed by view id.
+layout(std140) uniform SceneMatrices {
+    mat4 uViews[2];
+    mat4 uProjections[2];
+};
+
+// out
+out vec2 TexCoord;
+
+void main()
+{
+    gl_Position = uProjections[gl_ViewID_OVR] * uViews[gl_ViewID_OVR] * uModel * vec4(v3Positon.xyz, 1.0);
+    TexCoord = v2Cood;
+}
\ No newline at end of file
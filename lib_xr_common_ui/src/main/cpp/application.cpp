@@ -9,6 +9,7 @@
 #include "env_context.h"
 #include "log.h"
 #include "utils.h"
+#include "telemetry.h"
 
 const uint32_t CXR_AUDIO_CHANNEL_COUNT = 2;             ///< Audio is currently always stereo
 const uint32_t CXR_AUDIO_SAMPLE_SIZE = sizeof(int16_t); ///< Audio is currently signed 16-bit samples (little-endian)
@@ -34,6 +35,8 @@ Application::Application() = default;
 
 Application::~Application() {
     connected_ = false;
+    // stop export thread and flush.
+    Telemetry::Release();
 
     if (recording_stream_) {
         recording_stream_->close();
@@ -157,6 +160,11 @@ void Application::RequestAudioInput() {
 void Application::OnClose(int code) {
     XRClientObserverWrap::OnClose(code);
 
+    // next connection may go to another region.
+    prediction_horizon_.Reset();
+    pose_filter_.Reset();
+    Telemetry::instance()->Stop();
+
     if (recording_stream_) {
         recording_stream_->close();
         recording_stream_.reset();
@@ -181,6 +189,13 @@ Application::onAudioReady(oboe::AudioStream *oboeStream, void *audioData, int32_
 
 void Application::OnConnected() {
     XRClientObserverWrap::OnConnected();
+
+    // reconnect may skip OnClose, don't extrapolate from poses of the last connection.
+    pose_filter_.Reset();
+
+    // export latency histograms to 【外部路径】or【内部路径】/larkxr/telemetry
+    std::string externalPath = Context::instance()->external_data_path();
+    Telemetry::instance()->Start(!externalPath.empty() ? externalPath : Context::instance()->internal_data_path());
     // DEBUG AUDIO INPUT
 //     RequestAudioInput();
 }
@@ -11,6 +11,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "lark_xr/xr_client.h"
+#include "prediction_horizon.h"
+#include "pose_filter.h"
+#include "frame_pacer.h"
 
 #define LARK_SDK_ID "28c2eb1d50e14105b005940dc80588d1"
 
@@ -34,6 +37,17 @@ public:
         // app space -> 使用app设置的地面高度和位置原点
         Space_App   = 1,
     };
+    // 本地交换链的固定注视点渲染等级, 与云端编码的 ffr 无关
+    enum Foveation {
+        Foveation_Off = 0,
+        Foveation_Low,
+        Foveation_Medium,
+        Foveation_High,
+        // 运行时根据 gpu 负载调整等级, 最高 high
+        Foveation_Dynamic,
+        Foveation_Count,
+    };
+    static const Foveation DEFAULT_FOVEATION = Foveation_Medium;
 
     // warning should init in child class
     static Application* instance();
@@ -66,6 +80,13 @@ public:
     virtual void SetupSapce(Space space) {};
     // ui 设置天空盒, 更新场景中的天空盒
     virtual void SetupSkyBox(int index) {};
+    // ui 设置本地注视点渲染等级
+    virtual void SetupFoveation(Foveation foveation) { foveation_ = foveation; };
+    // 运行时是否支持本地注视点渲染, 不支持时设置页不显示该项
+    virtual bool SupportFoveation() { return false; };
+    inline Foveation foveation() const { return foveation_; }
+    // 是否在客户端填充速度并外推发送给云端的姿态, 不支持时设置页不显示姿态滤波项
+    virtual bool SupportPoseFilter() { return false; };
 
     // xr client callback
     virtual void OnConnected() override;
@@ -101,6 +122,12 @@ public:
         appli_id_from_2d_ui_ = appid;
         ui_mode_ = ApplicationUIMode_Android_2D;
     }
+
+    // 云渲染姿态预测时长, 根据实际延时调整
+    inline PredictionHorizon& prediction_horizon() { return prediction_horizon_; }
+    inline const FramePacer& frame_pacer() const { return frame_pacer_; }
+    // 发送给云端的姿态滤波和客户端外推方式
+    inline DevicePairFilter& pose_filter() { return pose_filter_; }
 protected:
     static void RegiseredInstance(Application* instance);
     static void UnRegiseredInstance();
@@ -125,6 +152,12 @@ protected:
     std::string appli_id_from_2d_ui_ = "";
 
     std::shared_ptr<oboe::AudioStream> recording_stream_{};
+
+    PredictionHorizon prediction_horizon_{};
+    DevicePairFilter pose_filter_{};
+    Foveation foveation_ = DEFAULT_FOVEATION;
+    // 渲染线程等待云端新帧
+    FramePacer frame_pacer_{};
 private:
     // static instance
     // WARNING should init in child class
@@ -8,6 +8,8 @@
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include <lark_xr/xr_config.h>
+#include <render_state.h>
+#include "telemetry.h"
 
 #define LOG_TAG "cloudxr_client"
 
@@ -309,6 +311,10 @@ void CloudXRClient::Stats() {
     if (frames_until_stats_ <= 0 &&
         cxrGetConnectionStats(cloudxr_receiver_, &stats_) == cxrError_Success)
     {
+        Telemetry::instance()->Record(Telemetry::Metric_CloudXRRoundTripMs, stats_.roundTripDelayMs);
+        Telemetry::instance()->Record(Telemetry::Metric_CloudXRFramesPerSecond, static_cast<uint64_t>(stats_.framesPerSecond));
+        Telemetry::instance()->Record(Telemetry::Metric_CloudXRBandwidthKbps, stats_.bandwidthUtilizationKbps);
+
         // Capture the key connection statistics
         char statsString[64] = { 0 };
         snprintf(statsString, 64, "FPS: %6.1f    Bitrate (kbps): %5d    Latency (ms): %3d",
@@ -542,15 +548,18 @@ CloudXRClient::Draw(lark::Object::Eye eye, const glm::mat4 &projection, const gl
 
     // WARNING  GL_SCISSOR_TEST NOT SUPPORT IN CLOUDXR
     // enabel GL_SCISSOR_TEST CLOUDXR draw black
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_BLEND);
+    lark::RenderState* state = lark::RenderState::instance();
+    state->Disable(GL_SCISSOR_TEST);
+    state->Disable(GL_BLEND);
 
     Render(eye == lark::Object::EYE_LEFT ? FrameMask_Left : FrameMask_Right);
 
-    glEnable(GL_SCISSOR_TEST);
+    // cloudxr changes gl state behind the cache.
+    state->Invalidate();
+    state->Enable(GL_SCISSOR_TEST);
     // 开启透明同道混合
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state->Enable(GL_BLEND);
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void CloudXRClient::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
@@ -558,15 +567,18 @@ void CloudXRClient::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &
 
     // WARNING  GL_SCISSOR_TEST NOT SUPPORT IN CLOUDXR
     // enabel GL_SCISSOR_TEST CLOUDXR draw black
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_BLEND);
+    lark::RenderState* state = lark::RenderState::instance();
+    state->Disable(GL_SCISSOR_TEST);
+    state->Disable(GL_BLEND);
 
     Render(FrameMask_All);
 
-    glEnable(GL_SCISSOR_TEST);
+    // cloudxr changes gl state behind the cache.
+    state->Invalidate();
+    state->Enable(GL_SCISSOR_TEST);
     // 开启透明同道混合
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state->Enable(GL_BLEND);
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void CloudXRClient::InitRenderParamsWithLarkXRConfig() {
@@ -0,0 +1,125 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/13.
+//
+
+#include <ctime>
+#include <algorithm>
+#include <lark_xr/xr_config.h>
+#include "frame_pacer.h"
+#include "log.h"
+#include "utils.h"
+#include "telemetry.h"
+
+#define LOG_TAG "FramePacer"
+
+namespace {
+    // leave part of the display period for rendering and submit.
+    const float RENDER_BUDGET = 0.5F;
+    // give up when less time left, WaitFroNewFrame is in milliseconds.
+    const uint64_t MIN_WAIT_NS = 1000 * 1000;
+    const uint64_t LOG_INTERVAL_NS = 10ULL * 1000 * 1000 * 1000;
+
+    uint64_t GetThreadCpuTimeNs() {
+        struct timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000 * 1000 * 1000 + now.tv_nsec;
+    }
+}
+
+FramePacer::FramePacer() = default;
+
+void FramePacer::SetDisplayTiming(uint64_t predictedDisplayTimeNs, uint64_t displayPeriodNs) {
+    display_time_ns_ = predictedDisplayTimeNs;
+    display_period_ns_ = displayPeriodNs;
+}
+
+uint64_t FramePacer::GetDeadline(uint64_t now) const {
+    uint64_t period = display_period_ns_;
+    if (period == 0) {
+        int fps = lark::XRConfig::fps > 0 ? lark::XRConfig::fps : 72;
+        period = 1000 * 1000 * 1000 / static_cast<uint64_t>(fps);
+    }
+    uint64_t budget = static_cast<uint64_t>(period * RENDER_BUDGET);
+    if (display_time_ns_ == 0) {
+        return now + period - budget;
+    }
+    // next display time after now.
+    uint64_t next = display_time_ns_;
+    if (next <= now) {
+        next += ((now - next) / period + 1) * period;
+    }
+    uint64_t deadline = next - budget;
+    // too late for this vsync, wait for the next one.
+    if (deadline < now + MIN_WAIT_NS) {
+        deadline += period;
+    }
+    return deadline;
+}
+
+bool FramePacer::WaitForFrame(lark::XRClient *client) {
+    if (client == nullptr) {
+        return false;
+    }
+    uint64_t start = utils::GetTimestampNs();
+    uint64_t deadline = GetDeadline(start);
+    bool ready = client->HasNewFrame();
+    uint64_t now = start;
+    while (!ready && now + MIN_WAIT_NS <= deadline) {
+        int ms = static_cast<int>((deadline - now) / (1000 * 1000));
+        ready = client->WaitFroNewFrame(ms) || client->HasNewFrame();
+        now = utils::GetTimestampNs();
+    }
+
+    uint64_t wait = now - start;
+    Telemetry::instance()->Record(Telemetry::Metric_FrameWait, wait / 1000);
+    stats_.wait_ns_total += wait;
+    stats_.wait_ns_max = std::max(stats_.wait_ns_max, wait);
+    ready_ns_ = ready ? now : 0;
+    if (!ready) {
+        stats_.misses++;
+    }
+    return ready;
+}
+
+void FramePacer::FrameEnd() {
+    uint64_t cpu = GetThreadCpuTimeNs();
+    if (last_cpu_ns_ != 0) {
+        stats_.cpu_ns_total += cpu - last_cpu_ns_;
+        Telemetry::instance()->Record(Telemetry::Metric_FrameCpu, (cpu - last_cpu_ns_) / 1000);
+    }
+    last_cpu_ns_ = cpu;
+    stats_.frames++;
+
+    uint64_t now = utils::GetTimestampNs();
+    if (last_log_ns_ == 0) {
+        last_log_ns_ = now;
+    } else if (now - last_log_ns_ > LOG_INTERVAL_NS) {
+        LogStats();
+        last_log_ns_ = now;
+    }
+}
+
+void FramePacer::LogStats() {
+    uint64_t frames = stats_.frames - last_log_stats_.frames;
+    if (frames == 0) {
+        return;
+    }
+    uint64_t misses = stats_.misses - last_log_stats_.misses;
+    uint64_t wait = stats_.wait_ns_total - last_log_stats_.wait_ns_total;
+    uint64_t cpu = stats_.cpu_ns_total - last_log_stats_.cpu_ns_total;
+    LOGV("frames %llu misses %llu wait avg %.2fms max %.2fms cpu avg %.2fms",
+         (unsigned long long)frames, (unsigned long long)misses,
+         wait / 1e6 / frames, stats_.wait_ns_max / 1e6, cpu / 1e6 / frames);
+    last_log_stats_ = stats_;
+    stats_.wait_ns_max = 0;
+}
+
+void FramePacer::Reset() {
+    display_time_ns_ = 0;
+    display_period_ns_ = 0;
+    ready_ns_ = 0;
+    last_cpu_ns_ = 0;
+    last_log_ns_ = 0;
+    stats_ = {};
+    last_log_stats_ = {};
+}
@@ -0,0 +1,57 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/13.
+//
+
+#ifndef CLOUDLARKXR_FRAME_PACER_H
+#define CLOUDLARKXR_FRAME_PACER_H
+
+#include <cstdint>
+#include "lark_xr/xr_client.h"
+
+//
+// block render thread until a new cloud frame arrives instead of polling with usleep.
+// wait deadline is the next predicted display time of the compositor minus render budget.
+// when deadline passed without new frame the app should submit nothing new and
+// let compositor reproject the last frame.
+// render thread only.
+//
+class FramePacer {
+public:
+    struct Stats {
+        uint64_t frames;
+        uint64_t misses;
+        uint64_t wait_ns_total;
+        uint64_t wait_ns_max;
+        uint64_t cpu_ns_total;
+    };
+
+    FramePacer();
+
+    // compositor timing of last frame. monotonic nanoseconds.
+    // without timing, display period from XRConfig::fps is used.
+    void SetDisplayTiming(uint64_t predictedDisplayTimeNs, uint64_t displayPeriodNs);
+    // return true when a new frame is ready before deadline.
+    bool WaitForFrame(lark::XRClient* client);
+    // call after frame submitted to compositor.
+    void FrameEnd();
+
+    // monotonic time the last WaitForFrame saw the new frame, 0 when it missed.
+    // the decoded frame was ready at or a little before.
+    inline uint64_t ready_ns() const { return ready_ns_; }
+    inline const Stats& stats() const { return stats_; }
+    void LogStats();
+    void Reset();
+private:
+    uint64_t GetDeadline(uint64_t now) const;
+
+    uint64_t display_time_ns_ = 0;
+    uint64_t display_period_ns_ = 0;
+
+    uint64_t ready_ns_ = 0;
+    uint64_t last_cpu_ns_ = 0;
+    uint64_t last_log_ns_ = 0;
+    Stats stats_{};
+    Stats last_log_stats_{};
+};
+
+#endif //CLOUDLARKXR_FRAME_PACER_H
@@ -2,6 +2,7 @@
 // Created by fcx on 2020/5/6.
 //
 
+#include <chrono>
 #include "input.h"
 
 // default ray cast type.
@@ -10,6 +11,13 @@ Input::InputState Input::s_input_state_[Input::RayCast_Count] = {
         {false, false, false},
         {false, false, false}
 };
+bool Input::s_button_down_[Input::RayCast_Count][Input::Button_Count] = {};
+bool Input::s_long_pressed_[Input::RayCast_Count][Input::Button_Count] = {};
+uint64_t Input::s_press_timestamp_[Input::RayCast_Count][Input::Button_Count] = {};
+std::atomic<uint64_t> Input::s_update_timestamp_[Input::RayCast_Count] = {};
+std::atomic<uint64_t> Input::s_events_[Input::EVENT_QUEUE_SIZE] = {};
+std::atomic<uint32_t> Input::s_event_head_(0);
+std::atomic<uint32_t> Input::s_event_tail_(0);
 
 void Input::ResetInput() {
     s_currrent_ray_ = RayCast_Right;
@@ -21,4 +29,96 @@ void Input::ResetInput() {
         state.enterButtonDown = false;
         state.triggerButtonDown = false;
     }
+    for (int ray = 0; ray < RayCast_Count; ray++) {
+        for (int button = 0; button < Button_Count; button++) {
+            s_button_down_[ray][button] = false;
+            s_long_pressed_[ray][button] = false;
+        }
+    }
+    ClearEvents();
+}
+
+void Input::UpdateButtons(RayCastType ray, bool backDown, bool enterDown, bool triggerDown) {
+    uint64_t timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    UpdateButtons(ray, backDown, enterDown, triggerDown, timestamp);
+}
+
+void Input::UpdateButtons(RayCastType ray, bool backDown, bool enterDown, bool triggerDown, uint64_t timestamp) {
+    const bool down[Button_Count] = { backDown, enterDown, triggerDown };
+    // events are packed with 56 bits of timestamp.
+    timestamp &= 0x00FFFFFFFFFFFFFFULL;
+    s_update_timestamp_[ray].store(timestamp, std::memory_order_relaxed);
+    bool released[Button_Count] = {};
+    for (int i = 0; i < Button_Count; i++) {
+        Button button = static_cast<Button>(i);
+        bool downLastFrame = s_button_down_[ray][i];
+        s_button_down_[ray][i] = down[i];
+        if (down[i] && !downLastFrame) {
+            s_press_timestamp_[ray][i] = timestamp;
+            s_long_pressed_[ray][i] = false;
+            PushEvent(ray, button, Event_Down, timestamp);
+        } else if (down[i] && !s_long_pressed_[ray][i] &&
+                   timestamp - s_press_timestamp_[ray][i] >= LONG_PRESS_US) {
+            s_long_pressed_[ray][i] = true;
+            PushEvent(ray, button, Event_LongPress, timestamp);
+        } else if (!down[i] && downLastFrame) {
+            released[i] = true;
+            PushEvent(ray, button, Event_Up, timestamp);
+            if (!s_long_pressed_[ray][i]) {
+                PushEvent(ray, button, Event_Click, timestamp);
+            }
+        }
+    }
+
+    // short pressed is set on every release, long press included.
+    InputState& state = s_input_state_[ray];
+    state.backShortPressed = released[Button_Back];
+    state.enterShortPressed = released[Button_Enter];
+    state.triggerShortPressed = released[Button_Trigger];
+    state.backButtonDown = backDown;
+    state.enterButtonDown = enterDown;
+    state.triggerButtonDown = triggerDown;
+}
+
+bool Input::PollEvent(Event *event) {
+    uint32_t tail = s_event_tail_.load();
+    while (tail != s_event_head_.load()) {
+        uint64_t packed = s_events_[tail % EVENT_QUEUE_SIZE].load();
+        // producer dropped this one and may have reused the slot when tail moved.
+        if (!s_event_tail_.compare_exchange_strong(tail, tail + 1)) {
+            continue;
+        }
+        tail++;
+        event->ray = static_cast<RayCastType>(packed & 0x3);
+        event->button = static_cast<Button>((packed >> 2) & 0x3);
+        event->type = static_cast<EventType>((packed >> 4) & 0x3);
+        event->timestamp = packed >> 8;
+        // queued in an earlier frame nobody drained.
+        if (event->ray < RayCast_Count &&
+            event->timestamp == s_update_timestamp_[event->ray].load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Input::ClearEvents() {
+    uint32_t tail = s_event_tail_.load();
+    // producer may drop the oldest at the same time, then tail is reloaded.
+    while (!s_event_tail_.compare_exchange_weak(tail, s_event_head_.load())) {
+    }
+}
+
+void Input::PushEvent(RayCastType ray, Button button, EventType type, uint64_t timestamp) {
+    uint32_t head = s_event_head_.load(std::memory_order_relaxed);
+    uint32_t tail = s_event_tail_.load();
+    if (head - tail == EVENT_QUEUE_SIZE) {
+        // full, drop the oldest. fails only when the consumer just took it.
+        s_event_tail_.compare_exchange_strong(tail, tail + 1);
+    }
+    uint64_t packed = timestamp << 8 | static_cast<uint64_t>(type) << 4 |
+            static_cast<uint64_t>(button) << 2 | static_cast<uint64_t>(ray);
+    s_events_[head % EVENT_QUEUE_SIZE].store(packed, std::memory_order_relaxed);
+    s_event_head_.store(head + 1, std::memory_order_release);
 }
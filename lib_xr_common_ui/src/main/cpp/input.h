@@ -5,6 +5,8 @@
 #ifndef CLOUDLARKXR_INPUT_H
 #define CLOUDLARKXR_INPUT_H
 
+#include <atomic>
+#include <cstdint>
 
 class Input {
 public:
@@ -14,6 +16,27 @@ public:
         RayCast_Hmd   = 2,
         RayCast_Count = 3,
     };
+    enum Button {
+        Button_Back    = 0,
+        Button_Enter   = 1,
+        Button_Trigger = 2,
+        Button_Count   = 3,
+    };
+    enum EventType {
+        Event_Down      = 0,
+        Event_Up        = 1,
+        // up before long press.
+        Event_Click     = 2,
+        // once when held longer than LONG_PRESS_US.
+        Event_LongPress = 3,
+    };
+    struct Event {
+        RayCastType ray;
+        Button      button;
+        EventType   type;
+        // us, timestamp passed to UpdateButtons.
+        uint64_t    timestamp;
+    };
     struct InputState {
         bool backShortPressed;
         bool enterShortPressed;
@@ -22,6 +45,8 @@ public:
         bool enterButtonDown;
         bool triggerButtonDown;
     };
+    static const uint64_t LONG_PRESS_US = 800 * 1000;
+
     // statics
     static inline RayCastType GetCurrentRayCastType() { return s_currrent_ray_; }
     static inline InputState GetCurrentInputState() { return s_input_state_[s_currrent_ray_]; }
@@ -34,10 +59,34 @@ public:
     static inline InputState* GetInputState() { return s_input_state_; };
     static inline int GetInputStateCount() { return RayCast_Count; };
 
+    // raw button state of one device, call once per frame for each device.
+    // update short pressed and down state of the ray, queue the edges as events.
+    static void UpdateButtons(RayCastType ray, bool backDown, bool enterDown, bool triggerDown);
+    static void UpdateButtons(RayCastType ray, bool backDown, bool enterDown, bool triggerDown, uint64_t timestamp);
+    // pop the oldest event of this frame, lock free. single consumer, views drain it in View::HandleInput.
+    // events not from the last UpdateButtons of their ray are dropped, so the ones queued while
+    // no view drained (cloud scene, view switch) never replay. the oldest are overwritten when full.
+    static bool PollEvent(Event* event);
+    // drop all queued events.
+    static void ClearEvents();
 private:
+    static const uint32_t EVENT_QUEUE_SIZE = 64;
+
+    static void PushEvent(RayCastType ray, Button button, EventType type, uint64_t timestamp);
+
     // static failed.
     static RayCastType s_currrent_ray_;
     static InputState  s_input_state_[RayCast_Count];
+    // edge detection.
+    static bool        s_button_down_[RayCast_Count][Button_Count];
+    static bool        s_long_pressed_[RayCast_Count][Button_Count];
+    static uint64_t    s_press_timestamp_[RayCast_Count][Button_Count];
+    // timestamp of the last UpdateButtons, events with other timestamps are stale.
+    static std::atomic<uint64_t> s_update_timestamp_[RayCast_Count];
+    // events packed as timestamp << 8 | type << 4 | button << 2 | ray.
+    static std::atomic<uint64_t> s_events_[EVENT_QUEUE_SIZE];
+    static std::atomic<uint32_t> s_event_head_;
+    static std::atomic<uint32_t> s_event_tail_;
 };
 
 
@@ -0,0 +1,201 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/10.
+//
+
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include "pose_filter.h"
+
+namespace {
+    // drop history when samples too far apart, eg. app paused.
+    const float MAX_SAMPLE_GAP_S = 0.2F;
+    // low pass cutoff for acceleration, hz.
+    const float ACCELERATION_CUTOFF = 5.0F;
+    // one euro default params, hz.
+    const float ONE_EURO_MIN_CUTOFF = 1.0F;
+    const float ONE_EURO_BETA = 0.5F;
+    const float ONE_EURO_D_CUTOFF = 1.0F;
+    const float EPSILON = 1e-6F;
+
+    float SmoothingFactor(float cutoff, float dt) {
+        float tau = 1.0F / (glm::two_pi<float>() * cutoff);
+        return 1.0F / (1.0F + tau / dt);
+    }
+
+    // shortest rotation vector of quaternion.
+    glm::vec3 ToRotationVector(glm::quat q) {
+        if (q.w < 0) {
+            q = -q;
+        }
+        // glm::angle is acos(w), nan when rounding puts w above 1.
+        glm::vec3 v(q.x, q.y, q.z);
+        float sinHalf = glm::length(v);
+        if (sinHalf < EPSILON) {
+            return glm::vec3(0);
+        }
+        return v / sinHalf * (2.0F * std::atan2(sinHalf, q.w));
+    }
+
+    glm::quat FromRotationVector(const glm::vec3& v) {
+        float angle = glm::length(v);
+        if (angle < EPSILON) {
+            return glm::quat(1, 0, 0, 0);
+        }
+        return glm::angleAxis(angle, v / angle);
+    }
+}
+
+PoseFilter::PoseFilter(Mode mode):
+    mode_(mode),
+    min_cutoff_(ONE_EURO_MIN_CUTOFF),
+    beta_(ONE_EURO_BETA) {
+}
+
+void PoseFilter::Update(larkxrTrackedPose *pose, int64_t timeNs, bool hasVelocity) {
+    glm::vec3 position = pose->position.toGlm();
+    glm::quat rotation = pose->rotation.toGlm();
+    float dt = static_cast<float>(timeNs - last_time_) / 1e9F;
+
+    if (!has_last_ || dt <= 0 || dt > MAX_SAMPLE_GAP_S) {
+        if (!hasVelocity) {
+            pose->velocity = glm::vec3(0);
+            pose->angularVelocity = glm::vec3(0);
+        }
+        pose->acceleration = glm::vec3(0);
+        pose->angularAcceleration = glm::vec3(0);
+
+        has_last_ = true;
+        last_time_ = timeNs;
+        last_position_ = position;
+        last_rotation_ = rotation;
+        last_velocity_ = pose->velocity.toGlm();
+        last_angular_velocity_ = pose->angularVelocity.toGlm();
+        last_acceleration_ = glm::vec3(0);
+        last_angular_acceleration_ = glm::vec3(0);
+        return;
+    }
+
+    glm::vec3 velocity;
+    glm::vec3 angularVelocity;
+    if (hasVelocity) {
+        velocity = pose->velocity.toGlm();
+        angularVelocity = pose->angularVelocity.toGlm();
+    } else {
+        velocity = (position - last_position_) / dt;
+        // angular velocity in base space.
+        angularVelocity = ToRotationVector(rotation * glm::inverse(last_rotation_)) / dt;
+    }
+
+    float accelerationFactor = SmoothingFactor(ACCELERATION_CUTOFF, dt);
+    glm::vec3 acceleration = (velocity - last_velocity_) / dt;
+    glm::vec3 angularAcceleration = (angularVelocity - last_angular_velocity_) / dt;
+
+    if (mode_ == Mode_OneEuro) {
+        // filter velocity. cutoff goes up with acceleration to reduce lag of fast motion.
+        float dFactor = SmoothingFactor(ONE_EURO_D_CUTOFF, dt);
+        glm::vec3 da = glm::mix(last_acceleration_, acceleration, dFactor);
+        glm::vec3 dw = glm::mix(last_angular_acceleration_, angularAcceleration, dFactor);
+        velocity = glm::mix(last_velocity_, velocity,
+                            SmoothingFactor(min_cutoff_ + beta_ * glm::length(da), dt));
+        angularVelocity = glm::mix(last_angular_velocity_, angularVelocity,
+                            SmoothingFactor(min_cutoff_ + beta_ * glm::length(dw), dt));
+        acceleration = da;
+        angularAcceleration = dw;
+    } else {
+        acceleration = glm::mix(last_acceleration_, acceleration, accelerationFactor);
+        angularAcceleration = glm::mix(last_angular_acceleration_, angularAcceleration, accelerationFactor);
+    }
+
+    pose->velocity = velocity;
+    pose->angularVelocity = angularVelocity;
+    pose->acceleration = acceleration;
+    pose->angularAcceleration = angularAcceleration;
+
+    last_time_ = timeNs;
+    last_position_ = position;
+    last_rotation_ = rotation;
+    last_velocity_ = velocity;
+    last_angular_velocity_ = angularVelocity;
+    last_acceleration_ = acceleration;
+    last_angular_acceleration_ = angularAcceleration;
+}
+
+void PoseFilter::Predict(larkxrTrackedPose *pose, float seconds) const {
+    Extrapolate(pose, mode_, seconds);
+}
+
+void PoseFilter::Extrapolate(larkxrTrackedPose *pose, Mode mode, float seconds) {
+    if (mode == Mode_Runtime || seconds <= 0) {
+        return;
+    }
+    glm::vec3 position = pose->position.toGlm();
+    glm::quat rotation = pose->rotation.toGlm();
+
+    glm::vec3 deltaPosition = pose->velocity.toGlm() * seconds;
+    glm::vec3 deltaAngle = pose->angularVelocity.toGlm() * seconds;
+    if (mode == Mode_ConstantAcceleration) {
+        float t2 = 0.5F * seconds * seconds;
+        deltaPosition += pose->acceleration.toGlm() * t2;
+        deltaAngle += pose->angularAcceleration.toGlm() * t2;
+    }
+
+    glm::quat deltaRotation = FromRotationVector(deltaAngle);
+    glm::vec3 newPosition = position + deltaPosition;
+    glm::quat newRotation = glm::normalize(deltaRotation * rotation);
+
+    pose->position = newPosition;
+    pose->rotation = newRotation;
+
+    // eyes are rigid with the head.
+    for (auto & eye : pose->eye) {
+        glm::vec3 eyePosition = eye.viewPosition.toGlm();
+        glm::quat eyeRotation = eye.viewRotation.toGlm();
+        eye.viewPosition = newPosition + deltaRotation * (eyePosition - position);
+        eye.viewRotation = glm::normalize(deltaRotation * eyeRotation);
+    }
+}
+
+void PoseFilter::Reset() {
+    has_last_ = false;
+    last_time_ = 0;
+}
+
+DevicePairFilter::DevicePairFilter(PoseFilter::Mode mode):
+    hmd_(mode),
+    controller_{PoseFilter(mode), PoseFilter(mode)},
+    mode_(mode),
+    reset_(false) {
+}
+
+void DevicePairFilter::set_mode(PoseFilter::Mode mode) {
+    mode_.store(mode, std::memory_order_relaxed);
+    reset_.store(true, std::memory_order_release);
+}
+
+void DevicePairFilter::Apply(larkxrDevicePair *devicePair, int64_t sampleTimeNs, int64_t displayTimeNs,
+                             bool hmdHasVelocity) {
+    if (reset_.exchange(false, std::memory_order_acq_rel)) {
+        // set_mode resets the filter too.
+        PoseFilter::Mode mode = this->mode();
+        hmd_.set_mode(mode);
+        for (auto & controller : controller_) {
+            controller.set_mode(mode);
+        }
+    }
+
+    hmd_.Update(&devicePair->hmdPose, sampleTimeNs, hmdHasVelocity);
+    hmd_.Predict(&devicePair->hmdPose, static_cast<float>(displayTimeNs - sampleTimeNs) / 1e9F);
+
+    for (int i = 0; i < LARKVR_TOTAL_CONTROLLER_COUNT; i++) {
+        larkxrTrackedPose& pose = devicePair->controllerState[i].pose;
+        if (!pose.isConnected || !pose.isValidPose) {
+            controller_[i].Reset();
+            continue;
+        }
+        controller_[i].Update(&pose, sampleTimeNs, false);
+    }
+}
+
+void DevicePairFilter::Reset() {
+    reset_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,93 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/10.
+//
+
+#ifndef CLOUDLARKXR_POSE_FILTER_H
+#define CLOUDLARKXR_POSE_FILTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "lark_xr/types.h"
+
+//
+// client side pose extrapolation.
+// fill velocity, angularVelocity, acceleration and angularAcceleration of larkxrTrackedPose
+// so the server can re-predict, and optionally move the pose to the display time.
+// velocity is in base space. missing velocity is calculated from the last sample.
+//
+class PoseFilter {
+public:
+    enum Mode {
+        // runtime locates pose at the display time. only fill velocity.
+        Mode_Runtime              = 0,
+        // sample pose now and extrapolate with velocity.
+        Mode_ConstantVelocity     = 1,
+        // sample pose now and extrapolate with velocity and acceleration.
+        Mode_ConstantAcceleration = 2,
+        // like constant velocity, velocity smoothed by one euro filter.
+        Mode_OneEuro              = 3,
+    };
+
+    explicit PoseFilter(Mode mode = Mode_Runtime);
+
+    // pose position and rotation sampled at timeNs.
+    // hasVelocity true when velocity and angularVelocity already filled by runtime.
+    void Update(larkxrTrackedPose* pose, int64_t timeNs, bool hasVelocity);
+    // move pose forward. eye views move with the head.
+    void Predict(larkxrTrackedPose* pose, float seconds) const;
+
+    // extrapolate without filter state. use for offline replay.
+    static void Extrapolate(larkxrTrackedPose* pose, Mode mode, float seconds);
+
+    void Reset();
+
+    inline Mode mode() const { return mode_; }
+    inline void set_mode(Mode mode) { mode_ = mode; Reset(); }
+    // one euro params. smaller min cutoff less jitter, bigger beta less lag.
+    inline void set_one_euro(float minCutoff, float beta) { min_cutoff_ = minCutoff; beta_ = beta; }
+private:
+    Mode mode_;
+    float min_cutoff_;
+    float beta_;
+
+    bool has_last_ = false;
+    int64_t last_time_ = 0;
+    glm::vec3 last_position_{};
+    glm::quat last_rotation_{};
+    glm::vec3 last_velocity_{};
+    glm::vec3 last_angular_velocity_{};
+    glm::vec3 last_acceleration_{};
+    glm::vec3 last_angular_acceleration_{};
+};
+
+//
+// filters for hmd and controllers of one device pair.
+// Apply runs on the tracking thread. set_mode and Reset may be called from any thread,
+// they take effect on the next Apply.
+//
+class DevicePairFilter {
+public:
+    explicit DevicePairFilter(PoseFilter::Mode mode = PoseFilter::Mode_Runtime);
+
+    // runtime should locate at display time only in Mode_Runtime.
+    inline bool sample_at_display_time() const { return mode() == PoseFilter::Mode_Runtime; }
+    inline PoseFilter::Mode mode() const { return static_cast<PoseFilter::Mode>(mode_.load(std::memory_order_relaxed)); }
+    // set by ui advance setup.
+    void set_mode(PoseFilter::Mode mode);
+
+    // poses in device pair sampled at sampleTimeNs. predict hmd to displayTimeNs.
+    // controller poses only get velocity, they are located by input state.
+    void Apply(larkxrDevicePair* devicePair, int64_t sampleTimeNs, int64_t displayTimeNs, bool hmdHasVelocity);
+
+    // drop history. call when connection closed.
+    void Reset();
+private:
+    PoseFilter hmd_;
+    PoseFilter controller_[LARKVR_TOTAL_CONTROLLER_COUNT];
+    std::atomic<int> mode_;
+    std::atomic<bool> reset_;
+};
+
+#endif //CLOUDLARKXR_POSE_FILTER_H
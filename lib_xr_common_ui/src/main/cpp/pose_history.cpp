@@ -0,0 +1,64 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/8.
+//
+
+#include <cstring>
+#include "pose_history.h"
+
+namespace {
+    // producer writes one slot per frame. reader should success after a few retries.
+    const int MAX_READ_RETRY = 4;
+}
+
+PoseHistory::PoseHistory(): write_count_(0), latest_index_(0) {
+    for (auto & slot : slots_) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+        slot.frame = larkxrTrackingFrame();
+    }
+}
+
+void PoseHistory::Push(const larkxrTrackingFrame &frame) {
+    Slot& slot = slots_[frame.frameIndex & (CAPACITY - 1)];
+    uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+    // odd sequence means writing.
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.frame, &frame, sizeof(larkxrTrackingFrame));
+    slot.sequence.store(seq + 2, std::memory_order_release);
+
+    latest_index_.store(frame.frameIndex, std::memory_order_release);
+    write_count_.fetch_add(1, std::memory_order_release);
+}
+
+bool PoseHistory::ReadSlot(uint32_t index, larkxrTrackingFrame *frame) const {
+    const Slot& slot = slots_[index];
+    for (int i = 0; i < MAX_READ_RETRY; i++) {
+        uint32_t seq1 = slot.sequence.load(std::memory_order_acquire);
+        if (seq1 == 0) {
+            // never written.
+            return false;
+        }
+        if (seq1 & 1) {
+            continue;
+        }
+        memcpy(frame, &slot.frame, sizeof(larkxrTrackingFrame));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t seq2 = slot.sequence.load(std::memory_order_relaxed);
+        if (seq1 == seq2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PoseHistory::Find(uint64_t frameIndex, larkxrTrackingFrame *frame) const {
+    // slot may hold an older or newer frame with the same remainder.
+    return ReadSlot(frameIndex & (CAPACITY - 1), frame) && frame->frameIndex == frameIndex;
+}
+
+bool PoseHistory::Latest(larkxrTrackingFrame *frame) const {
+    if (empty()) {
+        return false;
+    }
+    return Find(latest_index_.load(std::memory_order_acquire), frame);
+}
@@ -0,0 +1,52 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/8.
+//
+
+#ifndef CLOUDLARKXR_POSE_HISTORY_H
+#define CLOUDLARKXR_POSE_HISTORY_H
+
+#include <atomic>
+#include <cstdint>
+#include "lark_xr/types.h"
+
+//
+// fixed capacity tracking frame history.
+// single producer (tracking callback thread) and single consumer (render thread), no lock.
+// frames are stored in slot frameIndex % CAPACITY, every slot is guarded by a sequence counter.
+// consumer retries when the slot is being written.
+//
+class PoseHistory {
+public:
+    // must be power of 2.
+    static const uint32_t CAPACITY = 64;
+    static const size_t CACHE_LINE_SIZE = 64;
+
+    PoseHistory();
+
+    // producer thread.
+    void Push(const larkxrTrackingFrame& frame);
+
+    // consumer thread. frame is overwritten even when not found.
+    // find the frame with the same frame index.
+    bool Find(uint64_t frameIndex, larkxrTrackingFrame* frame) const;
+    // the last pushed frame.
+    bool Latest(larkxrTrackingFrame* frame) const;
+
+    // frames pushed since created.
+    inline uint64_t count() const { return write_count_.load(std::memory_order_acquire); }
+    inline bool empty() const { return count() == 0; }
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint32_t> sequence;
+        larkxrTrackingFrame frame;
+    };
+
+    // copy slot. return false when the slot is empty or being written too often.
+    bool ReadSlot(uint32_t slot, larkxrTrackingFrame* frame) const;
+
+    Slot slots_[CAPACITY];
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_count_;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> latest_index_;
+};
+
+#endif //CLOUDLARKXR_POSE_HISTORY_H
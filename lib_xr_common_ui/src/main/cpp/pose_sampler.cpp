@@ -0,0 +1,80 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <chrono>
+#include "pose_sampler.h"
+#include "log.h"
+
+#define LOG_TAG "pose_sampler"
+
+namespace {
+    uint64_t NowUs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+PoseSampler::~PoseSampler() {
+    Stop();
+}
+
+void PoseSampler::Start(Source *source, uint32_t rateHz) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || source == nullptr) {
+        return;
+    }
+    source_ = source;
+    set_rate_hz(rateHz);
+    sent_.store(0, std::memory_order_relaxed);
+    send_latency_us_.store(0, std::memory_order_relaxed);
+    running_ = true;
+    thread_ = std::thread(&PoseSampler::Run, this);
+    LOGV("pose sampler start at %d hz", rate_hz());
+}
+
+void PoseSampler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    source_ = nullptr;
+    LOGV("pose sampler stop. sent %llu", (unsigned long long)sent());
+}
+
+void PoseSampler::set_rate_hz(uint32_t rateHz) {
+    rateHz = rateHz < MIN_RATE_HZ ? MIN_RATE_HZ : rateHz;
+    rateHz = rateHz > MAX_RATE_HZ ? MAX_RATE_HZ : rateHz;
+    rate_hz_.store(rateHz, std::memory_order_relaxed);
+}
+
+void PoseSampler::Run() {
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        lock.unlock();
+        larkxrTrackingDevicePairFrame devicePairFrame = {};
+        uint64_t sampled = NowUs();
+        if (source_->SamplePose(&devicePairFrame)) {
+            source_->SendPose(devicePairFrame);
+            send_latency_us_.store(NowUs() - sampled, std::memory_order_relaxed);
+            sent_.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock.lock();
+
+        // fixed rate. after a stall start over from now instead of sending a burst.
+        next += std::chrono::microseconds(1000000 / rate_hz());
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        cond_.wait_until(lock, next, [this] { return !running_; });
+    }
+}
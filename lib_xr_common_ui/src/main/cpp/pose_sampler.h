@@ -0,0 +1,63 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_POSE_SAMPLER_H
+#define CLOUDLARKXR_POSE_SAMPLER_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "lark_xr/types.h"
+
+//
+// sample the tracking pose on its own thread and send it to the cloud at a fixed rate,
+// so upload rate and pose freshness no longer follow the render loop and survive render stalls.
+// the source must be safe to call from the sampler thread.
+//
+class PoseSampler {
+public:
+    class Source {
+    public:
+        // sampler thread. fill the latest pose, return false to skip this tick.
+        virtual bool SamplePose(larkxrTrackingDevicePairFrame* devicePairFrame) = 0;
+        // sampler thread. upload the sampled pose. usually XRClient::SendDevicePair.
+        virtual void SendPose(const larkxrTrackingDevicePairFrame& devicePairFrame) = 0;
+    };
+
+    static const uint32_t DEFAULT_RATE_HZ = 120;
+    static const uint32_t MIN_RATE_HZ = 30;
+    static const uint32_t MAX_RATE_HZ = 1000;
+
+    PoseSampler() = default;
+    ~PoseSampler();
+
+    void Start(Source* source, uint32_t rateHz = DEFAULT_RATE_HZ);
+    // block until the sampler thread exits. no Source call after return.
+    void Stop();
+
+    inline bool running() const { return running_.load(std::memory_order_relaxed); }
+    // any thread. takes effect on the next tick.
+    void set_rate_hz(uint32_t rateHz);
+    inline uint32_t rate_hz() const { return rate_hz_.load(std::memory_order_relaxed); }
+
+    // stats. sent poses and sample -> send latency of the last one.
+    inline uint64_t sent() const { return sent_.load(std::memory_order_relaxed); }
+    inline uint64_t send_latency_us() const { return send_latency_us_.load(std::memory_order_relaxed); }
+private:
+    void Run();
+
+    Source* source_ = nullptr;
+    std::atomic<uint32_t> rate_hz_ = {DEFAULT_RATE_HZ};
+    std::atomic<uint64_t> sent_ = {0};
+    std::atomic<uint64_t> send_latency_us_ = {0};
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::atomic<bool> running_ = {false};
+};
+
+#endif //CLOUDLARKXR_POSE_SAMPLER_H
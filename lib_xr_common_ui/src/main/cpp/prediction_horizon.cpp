@@ -0,0 +1,138 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/9.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <lark_xr/xr_config.h>
+#include "prediction_horizon.h"
+#include "log.h"
+#include "telemetry.h"
+
+#define LOG_TAG "PredictionHorizon"
+
+namespace {
+    // use default horizon until collected enough samples.
+    const uint64_t MIN_SAMPLES = 30;
+    // ewma weight of new sample, 1/16.
+    const int SMOOTH_SHIFT = 4;
+    // skip samples from paused or stalled stream.
+    const uint64_t MAX_SAMPLE_NS = 500 * 1000 * 1000;
+    // log about every 10 seconds at 90 fps.
+    const uint64_t LOG_INTERVAL_SAMPLES = 900;
+
+    uint64_t NowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+// odr-used by std::min and std::max.
+const uint64_t PredictionHorizon::MIN_HORIZON_NS;
+const uint64_t PredictionHorizon::MAX_HORIZON_NS;
+
+PredictionHorizon::PredictionHorizon(uint64_t defaultHorizonNs):
+    default_horizon_ns_(defaultHorizonNs),
+    horizon_ns_(defaultHorizonNs),
+    latency_ns_(0),
+    error_ns_(0),
+    samples_(0),
+    reset_(false) {
+    for (auto & slot : slots_) {
+        slot.frameIndex.store(0, std::memory_order_relaxed);
+        slot.trackingTime.store(0, std::memory_order_relaxed);
+        slot.horizon.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t PredictionHorizon::TimestampId(uint64_t timestampNs) {
+    // fibonacci hashing, odd multiplier keeps it one to one. the mixed high bits become the slot bits.
+    uint64_t hash = timestampNs * 0x9E3779B97F4A7C15ULL;
+    return (hash << CAPACITY_BITS) | (hash >> (64 - CAPACITY_BITS));
+}
+
+void PredictionHorizon::OnTracking(uint64_t frameIndex) {
+    if (frameIndex == 0) {
+        return;
+    }
+    Slot& slot = slots_[frameIndex & (CAPACITY - 1)];
+    slot.frameIndex.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.trackingTime.store(NowNs(), std::memory_order_relaxed);
+    slot.horizon.store(horizon_ns(), std::memory_order_relaxed);
+    slot.frameIndex.store(frameIndex, std::memory_order_release);
+}
+
+void PredictionHorizon::OnSubmit(uint64_t frameIndex, uint64_t readyNs) {
+    if (reset_.exchange(false, std::memory_order_acq_rel)) {
+        latency_ns_.store(0, std::memory_order_relaxed);
+        error_ns_.store(0, std::memory_order_relaxed);
+        samples_.store(0, std::memory_order_relaxed);
+        horizon_ns_.store(default_horizon_ns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    if (frameIndex == 0) {
+        return;
+    }
+
+    const Slot& slot = slots_[frameIndex & (CAPACITY - 1)];
+    uint64_t index1 = slot.frameIndex.load(std::memory_order_acquire);
+    uint64_t trackingTime = slot.trackingTime.load(std::memory_order_relaxed);
+    uint64_t usedHorizon = slot.horizon.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t index2 = slot.frameIndex.load(std::memory_order_relaxed);
+    // slot overwritten by newer pose or being written.
+    if (index1 != frameIndex || index2 != frameIndex) {
+        return;
+    }
+
+    uint64_t now = NowNs();
+    if (now <= trackingTime || now - trackingTime > MAX_SAMPLE_NS) {
+        return;
+    }
+    uint64_t sample = now - trackingTime;
+    Telemetry::instance()->Record(Telemetry::Metric_TrackingToSubmit, sample / 1000);
+    if (readyNs > trackingTime && readyNs <= now) {
+        Telemetry::instance()->Record(Telemetry::Metric_TrackingToFrameReady, (readyNs - trackingTime) / 1000);
+    }
+
+    // submitted frame shows on next vsync.
+    int fps = lark::XRConfig::fps > 0 ? lark::XRConfig::fps : 72;
+    uint64_t displayOffset = 1000 * 1000 * 1000 / static_cast<uint64_t>(fps);
+    int64_t error = static_cast<int64_t>(usedHorizon) - static_cast<int64_t>(sample + displayOffset);
+
+    uint64_t samples = samples_.load(std::memory_order_relaxed) + 1;
+    uint64_t latency = latency_ns_.load(std::memory_order_relaxed);
+    int64_t smoothError = error_ns_.load(std::memory_order_relaxed);
+    if (samples == 1) {
+        latency = sample;
+        smoothError = error;
+    } else {
+        latency = latency - (latency >> SMOOTH_SHIFT) + (sample >> SMOOTH_SHIFT);
+        smoothError = smoothError + (error - smoothError) / (1 << SMOOTH_SHIFT);
+    }
+    latency_ns_.store(latency, std::memory_order_relaxed);
+    error_ns_.store(smoothError, std::memory_order_relaxed);
+    samples_.store(samples, std::memory_order_relaxed);
+
+    if (samples >= MIN_SAMPLES) {
+        uint64_t horizon = std::min(std::max(latency + displayOffset, MIN_HORIZON_NS), MAX_HORIZON_NS);
+        horizon_ns_.store(horizon, std::memory_order_relaxed);
+    }
+
+    if (samples % LOG_INTERVAL_SAMPLES == 0) {
+        LOGV("prediction horizon %.2fms latency %.2fms error %.2fms samples %llu",
+             horizon_ms(), latency / 1e6, smoothError / 1e6, (unsigned long long)samples);
+    }
+}
+
+void PredictionHorizon::set_default_horizon_ns(uint64_t horizonNs) {
+    default_horizon_ns_.store(horizonNs, std::memory_order_relaxed);
+    if (samples() < MIN_SAMPLES) {
+        horizon_ns_.store(horizonNs, std::memory_order_relaxed);
+    }
+}
+
+void PredictionHorizon::Reset() {
+    horizon_ns_.store(default_horizon_ns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    reset_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,74 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/9.
+//
+
+#ifndef CLOUDLARKXR_PREDICTION_HORIZON_H
+#define CLOUDLARKXR_PREDICTION_HORIZON_H
+
+#include <atomic>
+#include <cstdint>
+
+//
+// pose prediction horizon learned from the measured latency.
+// the tracking thread records the time a pose is sampled and sent with OnTracking,
+// the render thread reports the frame index of the submitted cloud frame with OnSubmit.
+// tracking -> submit latency plus one display refresh is the time the pose should be predicted ahead.
+// same points as XRLatencyCollector Tracking/Submit.
+// frameIndex may be any non zero id sent with the pose and echoed back with the rendered frame.
+//
+class PredictionHorizon {
+public:
+    static const uint64_t DEFAULT_HORIZON_NS = 40 * 1000 * 1000;
+    static const uint64_t MIN_HORIZON_NS = 10 * 1000 * 1000;
+    static const uint64_t MAX_HORIZON_NS = 120 * 1000 * 1000;
+
+    explicit PredictionHorizon(uint64_t defaultHorizonNs = DEFAULT_HORIZON_NS);
+
+    // frame id from a pose timestamp, for platforms that can't send their own frame index.
+    // low bits of a coarse clock are constant and would put every pose into a few slots.
+    // distinct timestamps give distinct ids, 0 stays 0.
+    static uint64_t TimestampId(uint64_t timestampNs);
+
+    // tracking thread. call when the pose of frameIndex is sampled.
+    void OnTracking(uint64_t frameIndex);
+    // render thread. call when the cloud frame rendered with the pose of frameIndex is submitted.
+    // readyNs: monotonic time the decoded frame was ready, see FramePacer::ready_ns. 0 when unknown.
+    void OnSubmit(uint64_t frameIndex, uint64_t readyNs = 0);
+
+    // predict pose at now + horizon.
+    inline uint64_t horizon_ns() const { return horizon_ns_.load(std::memory_order_relaxed); }
+    inline float horizon_ms() const { return static_cast<float>(horizon_ns()) / 1e6F; }
+    inline double horizon_s() const { return static_cast<double>(horizon_ns()) / 1e9; }
+
+    // stats. smoothed tracking -> submit latency and prediction error (positive means predict too far).
+    inline uint64_t latency_ns() const { return latency_ns_.load(std::memory_order_relaxed); }
+    inline int64_t error_ns() const { return error_ns_.load(std::memory_order_relaxed); }
+    inline uint64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+
+    // horizon used before enough samples collected.
+    void set_default_horizon_ns(uint64_t horizonNs);
+    // drop learned latency. any thread. call when connection closed.
+    void Reset();
+private:
+    // tracking callback may run faster than render and skip frame index.
+    static const uint32_t CAPACITY_BITS = 7;
+    static const uint32_t CAPACITY = 1 << CAPACITY_BITS;
+
+    struct Slot {
+        // 0 while writing.
+        std::atomic<uint64_t> frameIndex;
+        std::atomic<uint64_t> trackingTime;
+        std::atomic<uint64_t> horizon;
+    };
+
+    Slot slots_[CAPACITY];
+
+    std::atomic<uint64_t> default_horizon_ns_;
+    std::atomic<uint64_t> horizon_ns_;
+    std::atomic<uint64_t> latency_ns_;
+    std::atomic<int64_t> error_ns_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<bool> reset_;
+};
+
+#endif //CLOUDLARKXR_PREDICTION_HORIZON_H
@@ -4,6 +4,7 @@
 //
 #include "rect_texture.h"
 #include "env_context.h"
+#include <render_state.h>
 #include "log.h"
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
@@ -11,12 +12,12 @@
 #include <GLES3/gl3ext.h>
 #define LOG_TAG "rect_texture"
 namespace  {
-    float verticesTexture[] = {
-            // 位置              // 颜色           - 纹理坐标 -
-            -1.0F, -1.0F, -1.0F, 1.0F, 0.0F, 0.0F,  0.0F, 0.0F,  // 左下角
-            1.0F, -1.0F, -1.0F,  0.0F, 1.0F, 0.0F,  1.0F, 0.0F,  // 右下角
-            1.0F, 1.0F, -1.0F,   0.0F, 0.0F, 1.0F,  1.0F, 1.0F,  // 右上角
-            -1.0F, 1.0F, -1.0F,  0.0F, 0.0F, 1.0F,  0.0F, 1.0F  // 左上角
+    // full screen triangle, clipped to the viewport by gpu.
+    // no index buffer and no diagonal edge where fragments shade twice.
+    float verticesTriangle[] = {
+            -1.0F, -1.0F,
+            3.0F, -1.0F,
+            -1.0F, 3.0F,
     };
 
     // uv
@@ -25,55 +26,22 @@ namespace  {
     //  |        |        |
     // (0,1)---(0.5,1)---(1,1)
     //  左下角           右下角
-    //  double mode
-    float verticesLeft[] = {
-            // 位置              // 颜色           - 纹理坐标 -
-            -1.0F, -1.0F, -1.0F, 1.0F, 0.0F, 0.0F,  0.0F, 1.0F,  // 左下角
-            1.0F, -1.0F, -1.0F,  0.0F, 1.0F, 0.0F,  0.5F, 1.0F,  // 右下角
-            1.0F, 1.0F, -1.0F,   0.0F, 0.0F, 1.0F,  0.5F, 0.0F,  // 右上角
-            -1.0F, 1.0F, -1.0F,  0.0F, 0.0F, 1.0F,  0.0F, 0.0F   // 左上角
-    };
-
-    float verticesRight[] = {
-            // 位置              // 颜色           - 纹理坐标 -
-            -1.0F, -1.0F, -1.0F, 1.0F, 0.0F, 0.0F,  0.5F, 1.0F,  // 左下角
-            1.0F, -1.0F, -1.0F,  0.0F, 1.0F, 0.0F,  1.0F, 1.0F,  // 右下角
-            1.0F, 1.0F, -1.0F,   0.0F, 0.0F, 1.0F,  1.0F, 0.0F,  // 右上角
-            -1.0F, 1.0F, -1.0F,  0.0F, 0.0F, 1.0F,  0.5F, 0.0F   // 左上角
-    };
-
-    float verticesAll[] = {
-            // 位置              // 颜色           - 纹理坐标 -
-            -1.0F, -1.0F, -1.0F, 1.0F, 0.0F, 0.0F,  0.0F, 1.0F,  // 左下角
-            1.0F, -1.0F, -1.0F,  0.0F, 1.0F, 0.0F,  1.0F, 1.0F,  // 右下角
-            1.0F, 1.0F, -1.0F,   0.0F, 0.0F, 1.0F,  1.0F, 0.0F,  // 右上角
-            -1.0F, 1.0F, -1.0F,  0.0F, 0.0F, 1.0F,  0.0F, 0.0F   // 左上角
-    };
-
-    GLushort indicesAll[] = { // 注意索引从0开始!
-            0, 1, 3, // 第一个三角形
-            1, 2, 3  // 第二个三角形
-    };
-    //
+    //  double mode, left eye scale 0.5 offset 0, right eye scale 0.5 offset 0.5.
     const char* vertexShaderSource = "#version 300 es\n"
-                                     "layout (location = 0) in vec3 aPos;\n"
-                                     "layout (location = 1) in vec3 aColor;\n"
-                                     "layout (location = 2) in vec2 aTexCoord;\n"
+                                     "layout (location = 0) in vec2 aPos;\n"
                                      "\n"
-                                     "out vec3 ourColor;\n"
+                                     "uniform vec2 uUvScaleOffset;\n"
                                      "out vec2 TexCoord;\n"
                                      "\n"
                                      "void main()\n"
                                      "{\n"
-                                     "    gl_Position = vec4(aPos, 1.0);\n"
-                                     "    ourColor = aColor;\n"
-                                     "    TexCoord = aTexCoord;\n"
+                                     "    gl_Position = vec4(aPos, -1.0, 1.0);\n"
+                                     "    TexCoord = vec2((aPos.x * 0.5 + 0.5) * uUvScaleOffset.x + uUvScaleOffset.y, 0.5 - aPos.y * 0.5);\n"
                                      "}";
 
     const char * fragmentShaderSource = "#version 300 es\n"
                                         "precision highp float;\n"
                                         "\n"
-                                        "in vec3 ourColor;\n"
                                         "in vec2 TexCoord;\n"
                                         "out vec4 FragColor;\n"
                                         "\n"
@@ -83,6 +51,45 @@ namespace  {
                                         "{\n"
                                         "    FragColor = texture(ourTexture, TexCoord);\n"
                                         "}";
+
+    // both eyes in one pass. side by side texture offset u by view id,
+    // stereo textures pick the sampler by view id.
+    const char* multiviewVertexShaderSource = "#version 300 es\n"
+                                     "#extension GL_OVR_multiview2 : require\n"
+                                     "layout(num_views = 2) in;\n"
+                                     "layout (location = 0) in vec2 aPos;\n"
+                                     "\n"
+                                     "uniform int uSideBySide;\n"
+                                     "out vec2 TexCoord;\n"
+                                     "flat out int ViewId;\n"
+                                     "\n"
+                                     "void main()\n"
+                                     "{\n"
+                                     "    gl_Position = vec4(aPos, -1.0, 1.0);\n"
+                                     "    ViewId = int(gl_ViewID_OVR);\n"
+                                     "    vec2 uv = vec2(aPos.x * 0.5 + 0.5, 0.5 - aPos.y * 0.5);\n"
+                                     "    TexCoord = uSideBySide == 1 ?\n"
+                                     "        vec2(uv.x * 0.5 + 0.5 * float(ViewId), uv.y) : uv;\n"
+                                     "}";
+
+    const char * multiviewFragmentShaderSource = "#version 300 es\n"
+                                        "precision highp float;\n"
+                                        "\n"
+                                        "in vec2 TexCoord;\n"
+                                        "flat in int ViewId;\n"
+                                        "out vec4 FragColor;\n"
+                                        "\n"
+                                        "uniform sampler2D uTextureLeft;\n"
+                                        "uniform sampler2D uTextureRight;\n"
+                                        "\n"
+                                        "void main()\n"
+                                        "{\n"
+                                        "    if (ViewId == 0) {\n"
+                                        "        FragColor = texture(uTextureLeft, TexCoord);\n"
+                                        "    } else {\n"
+                                        "        FragColor = texture(uTextureRight, TexCoord);\n"
+                                        "    }\n"
+                                        "}";
 }
 
 RectTexture::RectTexture() {
@@ -101,24 +108,19 @@ void RectTexture::InitGL() {
         LOGW("loadShaderFromAsset rect texture has error");
         return;
     }
+    uv_scale_offset_location_ = shader_->GetUniformLocation("uUvScaleOffset");
+
+    LoadMultviewShader("shader/vertex/rect_multiview_vertex.glsl", "shader/fragment/rect_multiview_fragment.glsl",
+                       multiviewVertexShaderSource, multiviewFragmentShaderSource);
+    if (multiview_shader_) {
+        multiview_side_by_side_location_ = multiview_shader_->GetUniformLocation("uSideBySide");
+        multiview_texture_left_location_ = multiview_shader_->GetUniformLocation("uTextureLeft");
+        multiview_texture_right_location_ = multiview_shader_->GetUniformLocation("uTextureRight");
+    }
 
-    vao_ = std::make_shared<lark::VertexArrayObject>(true, true);
+    vao_ = std::make_shared<lark::VertexArrayObject>(true, false);
     if (!vao_) return;
-    // init texture vao
-    InitVao(verticesTexture, sizeof(verticesTexture), indicesAll, sizeof(indicesAll), vao_.get());
-
-    vao_left_ = std::make_shared<lark::VertexArrayObject>(true, true);
-    if (!vao_left_) return;
-    // init left vao
-    InitVao(verticesLeft, sizeof(verticesLeft), indicesAll, sizeof(indicesAll), vao_left_.get());
-
-    vao_right_ = std::make_shared<lark::VertexArrayObject>(true, true);
-    if (!vao_right_) return;
-    InitVao(verticesRight, sizeof(verticesRight), indicesAll, sizeof(indicesAll), vao_right_.get());
-
-    vao_all_ =std::make_shared<lark::VertexArrayObject>(true, true);
-    if (!vao_all_) return;
-    InitVao(verticesAll, sizeof(verticesAll), indicesAll, sizeof(indicesAll), vao_all_.get());
+    InitVao();
 
     enable_ = true;
 }
@@ -136,65 +138,80 @@ void RectTexture::Draw(lark::Object::Eye eye, const glm::mat4 &projection, const
     if (!enable_ || has_error_ || !frame_texture_)
         return;
 
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    DrawTexture(frame_texture_, 0.5F, eye == EYE_LEFT ? 0.0F : 0.5F);
+}
 
-    lark::VertexArrayObject * vao = eye == EYE_LEFT ? vao_left_.get() : vao_right_.get();
-    shader_->UseProgram();
+void RectTexture::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+    Object::DrawMultiview(projection, view);
 
-    glBindTexture(GL_TEXTURE_2D, frame_texture_);
-    vao->BindVAO();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
-    shader_->UnUseProgram();
-    vao->UnbindVAO();
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (!enable_ || has_error_ || !multiview_shader_)
+        return;
+
+    int left = multiview_mode_ ? frame_texture_ : frame_texture_left_;
+    int right = multiview_mode_ ? frame_texture_ : frame_texture_right_;
+    if (!left || !right)
+        return;
 
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
+    lark::RenderState* state = lark::RenderState::instance();
+    state->Disable(GL_DEPTH_TEST);
+    state->DepthMask(GL_FALSE);
+
+    multiview_shader_->UseProgram();
+    glUniform1i(multiview_side_by_side_location_, multiview_mode_ ? 1 : 0);
+    glUniform1i(multiview_texture_left_location_, 0);
+    glUniform1i(multiview_texture_right_location_, 1);
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, left);
+    state->ActiveTexture(GL_TEXTURE1);
+    state->BindTexture(GL_TEXTURE_2D, right);
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    multiview_shader_->UnUseProgram();
+    vao_->UnbindVAO();
+    state->ActiveTexture(GL_TEXTURE0);
+
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
 
     if (HasGLError()) {
         LOGD("render cloudtexturehas error. %d", frame_texture_);
     }
 }
 
-void RectTexture::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
-    Object::DrawMultiview(projection, view);
-    lark::VertexArrayObject * vao = vao_all_.get();
-    shader_->UseProgram();
+void RectTexture::InitVao() {
+    vao_->BindVAO();
+    vao_->BindArrayBuffer();
+    glBufferData(GL_ARRAY_BUFFER, sizeof(verticesTriangle), verticesTriangle, GL_STATIC_DRAW);
+    // 位置属性
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    vao_->UnbindVAO();
+    vao_->UnbindArrayBuffer();
+}
 
-    glBindTexture(GL_TEXTURE_2D, frame_texture_);
-    vao->BindVAO();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+void RectTexture::DrawTexture(int texture, float uvScale, float uvOffset) {
+    lark::RenderState* state = lark::RenderState::instance();
+    state->Disable(GL_DEPTH_TEST);
+    state->DepthMask(GL_FALSE);
+
+    shader_->UseProgram();
+    glUniform2f(uv_scale_offset_location_, uvScale, uvOffset);
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, texture);
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 3);
     shader_->UnUseProgram();
-    vao->UnbindVAO();
-    glBindTexture(GL_TEXTURE_2D, 0);
+    vao_->UnbindVAO();
+
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
 
     if (HasGLError()) {
-        LOGD("render cloudtexturehas error. %d", frame_texture_);
+        LOGD("render cloudtexturehas error. %d", texture);
     }
 }
 
-void RectTexture::InitVao(void *vertices, int verticesSize, void *indices, int indicesSize,
-                         lark::VertexArrayObject *vao) {
-    vao->BindVAO();
-    vao->BindArrayBuffer();
-    glBufferData(GL_ARRAY_BUFFER, verticesSize, vertices, GL_STREAM_DRAW);
-    vao->BindElementArrayBuffer();
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices, GL_STATIC_DRAW);
-    // 位置属性
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // 颜色属性
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3* sizeof(float)));
-    glEnableVertexAttribArray(1);
-    // 纹理坐标
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    vao->UnbindVAO();
-    vao->UnbindArrayBuffer();
-}
-
 void RectTexture::DrawStereo(lark::Object::Eye eye, const glm::mat4 &projection, const glm::mat4 &view) {
     // LOGV("draw stereo %d %d %d %d %d", frame_texture_left_, frame_texture_right_, multiview_mode_, enable_, has_error_);
 
@@ -205,24 +222,5 @@ void RectTexture::DrawStereo(lark::Object::Eye eye, const glm::mat4 &projection,
     if (!enable_ || has_error_ || !frame_texture_left_ || !frame_texture_right_)
         return;
 
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
-
-    Object::DrawMultiview(projection, view);
-    lark::VertexArrayObject * vao = vao_all_.get();
-    shader_->UseProgram();
-    glBindTexture(GL_TEXTURE_2D, eye == EYE_LEFT ? frame_texture_left_ : frame_texture_right_);
-    vao->BindVAO();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
-    shader_->UnUseProgram();
-    vao->UnbindVAO();
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
-
-    if (HasGLError()) {
-        LOGD("render cloudtexturehas error. %d", frame_texture_);
-    }
+    DrawTexture(eye == EYE_LEFT ? frame_texture_left_ : frame_texture_right_, 1.0F, 0.0F);
 }
-
@@ -22,6 +22,11 @@ public:
     virtual void DrawStereo(Eye eye, const glm::mat4& projection, const glm::mat4& view);
     virtual void DrawMultiview(const glm::mat4& projection, const glm::mat4& view);
 
+    // has a frame to show.
+    inline bool HasTexture() const {
+        return multiview_mode_ ? frame_texture_ != 0 : frame_texture_left_ != 0 && frame_texture_right_ != 0;
+    }
+
     inline void SetStereoTexture(int texture_left, int texture_right) {
         multiview_mode_ = false;
         frame_texture_left_ = texture_left;
@@ -40,16 +45,19 @@ public:
     inline void set_frame_texture_(int texture) { frame_texture_ = texture; }
     inline void set_multiview_mode(bool multiview) { multiview_mode_ = multiview; }
 private:
-    void InitVao(void* vertices, int verticesSize, void* indices, int indicesSize, lark::VertexArrayObject * vao);
-
-    std::shared_ptr<lark::VertexArrayObject> vao_left_;
-    std::shared_ptr<lark::VertexArrayObject> vao_right_;
-    std::shared_ptr<lark::VertexArrayObject> vao_all_;
+    // one triangle covers the whole viewport, uv is computed in vertex shader.
+    void InitVao();
+    void DrawTexture(int texture, float uvScale, float uvOffset);
 
     int frame_texture_ = 0;
     int frame_texture_left_ = 0;
     int frame_texture_right_ = 0;
     bool multiview_mode_ = true;
 
+    int uv_scale_offset_location_ = 0;
+    int multiview_side_by_side_location_ = 0;
+    int multiview_texture_left_location_ = 0;
+    int multiview_texture_right_location_ = 0;
+
 };
 #endif // RECT_TEXTURE_INCLUDE
\ No newline at end of file
@@ -0,0 +1,301 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/14.
+//
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <lark_xr/xr_config.h>
+#include <lark_xr/xr_latency_collector.h>
+#include "telemetry.h"
+#include "log.h"
+
+#define LOG_TAG "Telemetry"
+
+namespace {
+    const char EXPORT_PREFIX[] = "telemetry_";
+    const char EXPORT_SUFFIX[] = ".json";
+
+    // wall clock, export windows are merged from many devices.
+    uint64_t NowMs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram(): count_(0), max_(0) {
+    for (auto & bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::ToIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - 4;
+    int index = (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+uint64_t LatencyHistogram::FromIndex(int index) {
+    if (index < SUB_BUCKETS) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+    // middle of bucket.
+    return ((SUB_BUCKETS + sub) << shift) + ((1ULL << shift) >> 1);
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+    buckets_[ToIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+    uint64_t total = 0;
+    uint32_t counts[BUCKET_COUNT];
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // bucket middle may above the recorded max.
+            return std::min(FromIndex(i), max());
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::ToJson(std::string *json) const {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "{\"count\":%llu,\"max\":%llu,\"p50\":%llu,\"p95\":%llu,\"p99\":%llu,\"buckets\":[",
+             (unsigned long long)count(), (unsigned long long)max(),
+             (unsigned long long)Percentile(50), (unsigned long long)Percentile(95),
+             (unsigned long long)Percentile(99));
+    json->append(buf);
+    bool first = true;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        uint32_t c = buckets_[i].load(std::memory_order_relaxed);
+        if (c == 0) {
+            continue;
+        }
+        snprintf(buf, sizeof(buf), "%s[%d,%u]", first ? "" : ",", i, c);
+        json->append(buf);
+        first = false;
+    }
+    json->append("]}");
+}
+
+void LatencyHistogram::Reset() {
+    for (auto & bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+Telemetry* Telemetry::instance_ = nullptr;
+
+Telemetry* Telemetry::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new Telemetry();
+    }
+    return instance_;
+}
+
+void Telemetry::Release() {
+    if (instance_ != nullptr) {
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+Telemetry::Telemetry() = default;
+
+Telemetry::~Telemetry() {
+    Stop();
+}
+
+const char* Telemetry::MetricName(Metric metric) {
+    switch (metric) {
+        case Metric_TrackingToSubmit:       return "tracking_to_submit_us";
+        case Metric_TrackingToFrameReady:   return "tracking_to_frame_ready_us";
+        case Metric_FrameWait:              return "frame_wait_us";
+        case Metric_FrameCpu:               return "frame_cpu_us";
+        case Metric_FramesPerSecond:        return "frames_per_second";
+        case Metric_PacketsLostPerSecond:   return "packets_lost_per_second";
+        case Metric_FecFailurePerSecond:    return "fec_failure_per_second";
+        case Metric_CloudXRRoundTripMs:     return "cloudxr_round_trip_ms";
+        case Metric_CloudXRFramesPerSecond: return "cloudxr_frames_per_second";
+        case Metric_CloudXRBandwidthKbps:   return "cloudxr_bandwidth_kbps";
+        case Metric_GpuScenePass:           return "gpu_scene_pass_us";
+        case Metric_GpuStreamPass:          return "gpu_stream_pass_us";
+        default:                            return "unknown";
+    }
+}
+
+void Telemetry::Start(const std::string &dataPath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || dataPath.empty()) {
+        return;
+    }
+    path_ = dataPath + "/larkxr/telemetry";
+    std::string parent = dataPath + "/larkxr";
+    mkdir(parent.c_str(), 0770);
+    mkdir(path_.c_str(), 0770);
+
+    for (auto & histogram : histograms_) {
+        histogram.Reset();
+    }
+    for (auto & last : last_) {
+        last.store(0, std::memory_order_relaxed);
+    }
+    window_start_ = NowMs();
+    running_ = true;
+    thread_ = std::thread(&Telemetry::Run, this);
+    LOGV("telemetry start. export to %s", path_.c_str());
+}
+
+void Telemetry::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    Export();
+}
+
+void Telemetry::Run() {
+    int seconds = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cond_.wait_for(lock, std::chrono::seconds(1));
+        if (!running_) {
+            break;
+        }
+        Sample();
+        if (++seconds >= EXPORT_INTERVAL_SECONDS) {
+            seconds = 0;
+            lock.unlock();
+            Export();
+            lock.lock();
+        }
+    }
+}
+
+void Telemetry::Sample() {
+    lark::XRLatencyCollector& collector = lark::XRLatencyCollector::Instance();
+    uint32_t fps = collector.frames_in_second();
+    // nothing received. not in cloud app.
+    if (fps == 0) {
+        return;
+    }
+    Record(Metric_FramesPerSecond, fps);
+    Record(Metric_PacketsLostPerSecond, collector.packets_lost_in_second());
+    Record(Metric_FecFailurePerSecond, collector.fec_failure_in_second());
+}
+
+bool Telemetry::Export() {
+    if (path_.empty()) {
+        return false;
+    }
+    bool hasData = false;
+    for (auto & histogram : histograms_) {
+        hasData |= histogram.count() > 0;
+    }
+    if (!hasData) {
+        return false;
+    }
+
+    uint64_t windowEnd = NowMs();
+    std::string json;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "{\"version\":1,\"headset\":%d,\"start_ms\":%llu,\"end_ms\":%llu,\"metrics\":{",
+             static_cast<int>(lark::XRConfig::headset_desc.type),
+             (unsigned long long)window_start_, (unsigned long long)windowEnd);
+    json.append(buf);
+    for (int i = 0; i < Metric_Count; i++) {
+        json.append(i == 0 ? "\"" : ",\"");
+        json.append(MetricName(static_cast<Metric>(i)));
+        json.append("\":");
+        histograms_[i].ToJson(&json);
+        histograms_[i].Reset();
+    }
+    json.append("}}\n");
+
+    std::string fileName = path_ + "/" + EXPORT_PREFIX + std::to_string(window_start_) + EXPORT_SUFFIX;
+    window_start_ = windowEnd;
+
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) {
+        LOGW("open telemetry file %s failed", fileName.c_str());
+        return false;
+    }
+    fwrite(json.data(), 1, json.size(), file);
+    fclose(file);
+    LOGV("export telemetry %s size %zu", fileName.c_str(), json.size());
+    RemoveOldExports();
+    return true;
+}
+
+void Telemetry::RemoveOldExports() {
+    DIR* d = opendir(path_.c_str());
+    if (d == nullptr) {
+        return;
+    }
+    // window start ms in the name.
+    std::vector<std::pair<uint64_t, std::string>> files;
+    struct dirent* ent = nullptr;
+    while ((ent = readdir(d)) != nullptr) {
+        size_t len = strlen(ent->d_name);
+        if (len <= sizeof(EXPORT_PREFIX) - 1 + sizeof(EXPORT_SUFFIX) - 1 ||
+            strncmp(ent->d_name, EXPORT_PREFIX, sizeof(EXPORT_PREFIX) - 1) != 0 ||
+            strcmp(ent->d_name + len - (sizeof(EXPORT_SUFFIX) - 1), EXPORT_SUFFIX) != 0) {
+            continue;
+        }
+        uint64_t start = strtoull(ent->d_name + sizeof(EXPORT_PREFIX) - 1, nullptr, 10);
+        files.emplace_back(start, ent->d_name);
+    }
+    closedir(d);
+    size_t keep = static_cast<size_t>(MAX_EXPORT_FILES);
+    if (files.size() <= keep) {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+    size_t remove = files.size() - keep;
+    for (size_t i = 0; i < remove; i++) {
+        std::string path = path_ + "/" + files[i].second;
+        unlink(path.c_str());
+    }
+    LOGV("removed %zu old telemetry files", remove);
+}
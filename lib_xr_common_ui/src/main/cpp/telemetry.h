@@ -0,0 +1,121 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/14.
+//
+
+#ifndef CLOUDLARKXR_TELEMETRY_H
+#define CLOUDLARKXR_TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//
+// log-linear histogram. 16 linear sub buckets per power of 2, relative error < 6.25%.
+// Record is lock free and can be called from any thread.
+//
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKET_COUNT = SUB_BUCKETS * 40;
+
+    LatencyHistogram();
+
+    void Record(uint64_t value);
+
+    // value at percentile 0 - 100. 0 when empty.
+    uint64_t Percentile(double percentile) const;
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // append {"count":..,"p50":..,"buckets":[[index,count],..]} to json.
+    void ToJson(std::string* json) const;
+    // not atomic with Record, samples recorded during reset may lost.
+    void Reset();
+
+    static int ToIndex(uint64_t value);
+    static uint64_t FromIndex(int index);
+private:
+    std::atomic<uint32_t> buckets_[BUCKET_COUNT];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> max_;
+};
+
+//
+// frame timing and latency telemetry. histograms are exported as json files to
+// data path/larkxr/telemetry every EXPORT_INTERVAL_SECONDS and reset after export.
+// only the last MAX_EXPORT_FILES files are kept.
+// merge files from many devices with tools/telemetry/merge_telemetry.py.
+//
+class Telemetry {
+public:
+    enum Metric {
+        // latency of the same frame index, microseconds.
+        Metric_TrackingToSubmit = 0,
+        // pose sent to the decoded frame ready on the client. network, cloud render, encode and decode.
+        Metric_TrackingToFrameReady,
+        // render thread, microseconds.
+        Metric_FrameWait,
+        Metric_FrameCpu,
+        // sampled from XRLatencyCollector every second.
+        Metric_FramesPerSecond,
+        Metric_PacketsLostPerSecond,
+        Metric_FecFailurePerSecond,
+        // cloudxr connection stats.
+        Metric_CloudXRRoundTripMs,
+        Metric_CloudXRFramesPerSecond,
+        Metric_CloudXRBandwidthKbps,
+        // gpu time of render passes, microseconds. needs GL_EXT_disjoint_timer_query.
+        Metric_GpuScenePass,
+        Metric_GpuStreamPass,
+        Metric_Count,
+    };
+    static const int EXPORT_INTERVAL_SECONDS = 60;
+    // two hours of windows.
+    static const int MAX_EXPORT_FILES = 120;
+
+    static Telemetry* instance();
+    static void Release();
+
+    // start sampling and export thread. dataPath same as InitCertificate.
+    void Start(const std::string& dataPath);
+    // stop thread and export the rest.
+    void Stop();
+
+    inline void Record(Metric metric, uint64_t value) {
+        if (metric >= 0 && metric < Metric_Count) {
+            histograms_[metric].Record(value);
+            last_[metric].store(value, std::memory_order_relaxed);
+        }
+    }
+    inline const LatencyHistogram& histogram(Metric metric) const { return histograms_[metric]; }
+    // last recorded value. 0 when not recorded since Start.
+    inline uint64_t last(Metric metric) const { return last_[metric].load(std::memory_order_relaxed); }
+
+    bool Export();
+    static const char* MetricName(Metric metric);
+private:
+    static Telemetry* instance_;
+
+    Telemetry();
+    ~Telemetry();
+
+    void Run();
+    void Sample();
+    // delete the oldest export files over MAX_EXPORT_FILES.
+    void RemoveOldExports();
+
+    LatencyHistogram histograms_[Metric_Count];
+    std::atomic<uint64_t> last_[Metric_Count] = {};
+
+    std::string path_ = "";
+    uint64_t window_start_ = 0;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool running_ = false;
+};
+
+#endif //CLOUDLARKXR_TELEMETRY_H
@@ -4,6 +4,8 @@
 
 #include "aa_bb.h"
 
+uint64_t AABB::layout_version_ = 0;
+
 AABB::AABB(uint64_t id): id_(id), size_(), center_(), position_() {
 }
 
@@ -35,16 +37,19 @@ bool AABB::CheckPointIn(const glm::vec2 &point) {
 
 void AABB::SetAABBSize(const glm::vec2 & size) {
     size_ = size;
+    layout_version_++;
 }
 
 void AABB::SetAABBBCenter(const glm::vec2 & center) {
     center_ = center;
     position_.x = center.x - size_.x / 2;
     position_.y = center.y - size_.y / 2;
+    layout_version_++;
 }
 
 void AABB::SetAABBPositon(const glm::vec2 & position) {
     position_ = position;
     center_.x = position.x + size_.x / 2;
     center_.y = position.y + size_.y / 2;
+    layout_version_++;
 }
@@ -37,11 +37,21 @@ public:
     // TODO object active
     // set active
     inline bool aabb_active() { return active_; }
-    inline void set_aabb_active(bool active) { active_ = active; }
+    inline void set_aabb_active(bool active) {
+        if (active_ != active) {
+            layout_version_++;
+        }
+        active_ = active;
+    }
+
+    // changed when any aabb moved, resized or actived. views rebuild hit grid on change.
+    static inline uint64_t layout_version() { return layout_version_; }
 
     // check input.
     virtual void HandleInput(glm::vec2 * point, int pointCount) = 0;
 private:
+    static uint64_t layout_version_;
+
     bool active_ = true;
     uint64_t  id_;
     glm::vec2 size_;
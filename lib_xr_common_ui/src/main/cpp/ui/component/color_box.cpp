@@ -36,6 +36,12 @@ void ColorBox::Init() {
 
     color_loaction_ = shader_->GetUniformLocation("uColor");
 
+    LoadMultiviewShaderFromAsset(Context::instance()->asset_manager(), "shader/vertex/color_multiview_vertex.glsl", "shader/fragment/color_fragment.glsl");
+    if (multiview_shader_) {
+        multiview_model_location_ = multiview_shader_->GetUniformLocation("uModel");
+        multiview_color_location_ = multiview_shader_->GetUniformLocation("uColor");
+    }
+
     vao_ = std::make_shared<lark::VertexArrayObject>(true, false);
     if (!vao_) return;
     vao_->BindVAO();
@@ -137,4 +143,21 @@ void ColorBox::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeVi
     glDrawArrays(GL_TRIANGLES, 0, 6);
     shader_->UnUseProgram();
     vao_->UnbindVAO();
+}
+
+void ColorBox::DrawMultiview(const glm::mat4& projection, const glm::mat4& view) {
+    Object::DrawMultiview(projection, view);
+
+    if (!enable_ || !vao_ || !multiview_shader_)
+        return;
+
+    multiview_shader_->UseProgram();
+    glUniformMatrix4fv(multiview_model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+    // color
+    glUniform4fv(multiview_color_location_, 1, glm::value_ptr(color_));
+
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    multiview_shader_->UnUseProgram();
+    vao_->UnbindVAO();
 }
\ No newline at end of file
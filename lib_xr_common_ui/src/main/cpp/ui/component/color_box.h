@@ -19,6 +19,7 @@ public:
     ~ColorBox() override = default;
 
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView) override;
+    void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 
     void set_size(const component::size& size) override;
     void set_position(const component::position& position) override;
@@ -36,6 +37,9 @@ private:
     int projection_location_ = 0;
 
     int color_loaction_ = 0;
+
+    int multiview_model_location_ = 0;
+    int multiview_color_location_ = 0;
 };
 
 
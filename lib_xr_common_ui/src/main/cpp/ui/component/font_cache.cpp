@@ -0,0 +1,343 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/6.
+//
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "log.h"
+#include "font_cache.h"
+#include <render_state.h>
+
+#define LOG_TAG "FontCache"
+
+namespace {
+    // glyph cells keep 1 pixel empty border to avoid bleeding with linear filter.
+    const int ATLAS_CELL_PADDING = 1;
+    // try to keep at least this count of glyphs in one atlas.
+    const int ATLAS_MIN_GLYPHS = 256;
+    const int ATLAS_MIN_SIZE = 512;
+    const int ATLAS_MAX_SIZE = 2048;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+FontFace::FontFace(const std::shared_ptr<FT_LibraryRec_>& ft, const std::string& path, FT_UInt pixelSize):
+    ft_(ft),
+    pixel_size_(pixelSize) {
+    FT_Face face = nullptr;
+    int res = FT_New_Face(ft_.get(), path.c_str(), 0, &face);
+    if (res != 0) {
+        LOGW("load font face %s failed: %d", path.c_str(), res);
+        return;
+    }
+    /* 设定为 UNICODE，默认也是 */
+    FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+    // 尺寸中的任一个为0意味着“与另一个尺寸值相等”
+    res = FT_Set_Pixel_Sizes(face, 0, pixel_size_);
+    if (res != 0) {
+        LOGW("set font %s pixel size %d failed: %d", path.c_str(), pixel_size_, res);
+        FT_Done_Face(face);
+        return;
+    }
+    face_ = face;
+}
+
+FontFace::~FontFace() {
+    if (texture_ != 0) {
+        lark::RenderState::instance()->ForgetTexture(texture_);
+        glDeleteTextures(1, &texture_);
+        texture_ = 0;
+    }
+    if (face_ != nullptr) {
+        FT_Done_Face(face_);
+        face_ = nullptr;
+    }
+}
+
+void FontFace::BeginString() {
+    pin_epoch_++;
+    pinning_ = true;
+}
+
+void FontFace::EndString() {
+    pinning_ = false;
+}
+
+const FontFace::Glyph* FontFace::GetGlyph(wchar_t c) {
+    auto it = glyphs_.find(c);
+    if (it != glyphs_.end()) {
+        hits_++;
+        it->second.pin = pin_epoch_;
+        if (it->second.slot >= 0) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+        }
+        return &it->second.glyph;
+    }
+    misses_++;
+
+    if (face_ == nullptr) {
+        return nullptr;
+    }
+
+    // Load character glyph
+    if (FT_Load_Char(face_, static_cast<FT_ULong>(c), FT_LOAD_RENDER)) {
+        LOGW("ERROR::FREETYTPE: Failed to load Glyph %d", c);
+        return nullptr;
+    }
+
+    FT_GlyphSlot slot = face_->glyph;
+    Entry entry = {};
+    entry.glyph.bearing = glm::ivec2(slot->bitmap_left, slot->bitmap_top);
+    entry.glyph.advance = slot->advance.x;
+    entry.slot = -1;
+    entry.pin = pin_epoch_;
+
+    if (slot->bitmap.buffer == nullptr || slot->bitmap.width == 0 || slot->bitmap.rows == 0) {
+        // 空格等不可见字符只保留 advance
+        entry.glyph.size = glm::ivec2(0, 0);
+        entry.glyph.visible = false;
+    } else {
+        if (texture_ == 0 && !InitAtlas()) {
+            return nullptr;
+        }
+        uint64_t layout = layout_version_;
+        int cell = AllocSlot();
+        if (cell < 0) {
+            if (dropped_++ == 0) {
+                LOGW("glyph atlas %d full of one string, drop glyph %d", atlas_size_, c);
+            }
+            return nullptr;
+        }
+        // growing the atlas rendered other glyphs into the glyph slot.
+        if (layout != layout_version_ && FT_Load_Char(face_, static_cast<FT_ULong>(c), FT_LOAD_RENDER)) {
+            LOGW("ERROR::FREETYTPE: Failed to load Glyph %d", c);
+            return nullptr;
+        }
+        if (!UploadGlyph(cell, slot->bitmap)) {
+            return nullptr;
+        }
+        entry.glyph.visible = true;
+        entry.slot = cell;
+        SetGlyphUv(&entry, static_cast<int>(slot->bitmap.width), static_cast<int>(slot->bitmap.rows));
+        lru_.push_front(c);
+        entry.lru = lru_.begin();
+    }
+
+    auto res = glyphs_.insert(std::make_pair(c, entry));
+    return &res.first->second.glyph;
+}
+
+void FontFace::SetGlyphUv(Entry* entry, int width, int height) {
+    int inner = cell_size_ - ATLAS_CELL_PADDING * 2;
+    int w = std::min(width, inner);
+    int h = std::min(height, inner);
+    float x0 = static_cast<float>((entry->slot % cols_) * cell_size_ + ATLAS_CELL_PADDING);
+    float y0 = static_cast<float>((entry->slot / cols_) * cell_size_ + ATLAS_CELL_PADDING);
+    float atlas = static_cast<float>(atlas_size_);
+
+    entry->glyph.size = glm::ivec2(w, h);
+    entry->glyph.uv = glm::vec4(x0 / atlas, y0 / atlas, (x0 + w) / atlas, (y0 + h) / atlas);
+}
+
+bool FontFace::InitAtlas() {
+    FT_Size_Metrics& metrics = face_->size->metrics;
+    int lineHeight = static_cast<int>(metrics.height >> 6);
+    int maxAdvance = static_cast<int>(metrics.max_advance >> 6);
+    // some cjk fonts report very big max advance. glyphs bigger than cell will be clipped.
+    cell_size_ = std::max(static_cast<int>(pixel_size_), std::min(lineHeight, maxAdvance > 0 ? maxAdvance : lineHeight))
+            + ATLAS_CELL_PADDING * 2;
+
+    atlas_size_ = ATLAS_MIN_SIZE;
+    while (atlas_size_ < ATLAS_MAX_SIZE && (atlas_size_ / cell_size_) * (atlas_size_ / cell_size_) < ATLAS_MIN_GLYPHS) {
+        atlas_size_ *= 2;
+    }
+    if (atlas_size_ / cell_size_ <= 0) {
+        LOGW("font size %d too big for glyph atlas", pixel_size_);
+        return false;
+    }
+    cell_buffer_.resize(static_cast<size_t>(cell_size_ * cell_size_));
+
+    texture_ = CreateAtlasTexture(atlas_size_);
+    if (texture_ == 0) {
+        return false;
+    }
+    cols_ = atlas_size_ / cell_size_;
+    capacity_ = cols_ * cols_;
+    LOGV("create glyph atlas size %d cell %d capacity %d", atlas_size_, cell_size_, capacity_);
+    return true;
+}
+
+GLuint FontFace::CreateAtlasTexture(int size) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    lark::RenderState::instance()->BindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_LUMINANCE , //  **文字渲染使用** GL_LUMINANCE
+            size,
+            size,
+            0,
+            GL_LUMINANCE , //  **文字渲染使用** GL_LUMINANCE
+            GL_UNSIGNED_BYTE,
+            nullptr
+    );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("create glyph atlas %dx%d failed %u", size, size, err);
+        lark::RenderState::instance()->ForgetTexture(texture);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+    return texture;
+}
+
+bool FontFace::GrowAtlas() {
+    if (atlas_size_ >= ATLAS_MAX_SIZE) {
+        return false;
+    }
+    GLuint texture = CreateAtlasTexture(atlas_size_ * 2);
+    if (texture == 0) {
+        return false;
+    }
+    lark::RenderState::instance()->ForgetTexture(texture_);
+    glDeleteTextures(1, &texture_);
+    texture_ = texture;
+    atlas_size_ *= 2;
+    cols_ = atlas_size_ / cell_size_;
+    capacity_ = cols_ * cols_;
+
+    // slots stay the same, only their position in the atlas moves.
+    for (auto & it : glyphs_) {
+        Entry& entry = it.second;
+        if (entry.slot < 0) {
+            continue;
+        }
+        if (FT_Load_Char(face_, static_cast<FT_ULong>(it.first), FT_LOAD_RENDER) == 0) {
+            UploadGlyph(entry.slot, face_->glyph->bitmap);
+        }
+        SetGlyphUv(&entry, entry.glyph.size.x, entry.glyph.size.y);
+    }
+    layout_version_++;
+    generation_++;
+    LOGV("grow glyph atlas size %d capacity %d", atlas_size_, capacity_);
+    return true;
+}
+
+int FontFace::AllocSlot() {
+    if (next_slot_ < capacity_) {
+        return next_slot_++;
+    }
+    // lru back is pinned only when every glyph in atlas belongs to the string being built.
+    auto it = glyphs_.find(lru_.back());
+    if (pinning_ && it->second.pin == pin_epoch_) {
+        return GrowAtlas() ? next_slot_++ : -1;
+    }
+    // evict least recently used glyph.
+    lru_.pop_back();
+    int slot = it->second.slot;
+    glyphs_.erase(it);
+    evictions_++;
+    // texts referencing the old slot must rebuild.
+    generation_++;
+    return slot;
+}
+
+bool FontFace::UploadGlyph(int slot, const FT_Bitmap& bitmap) {
+    int inner = cell_size_ - ATLAS_CELL_PADDING * 2;
+    int w = std::min(static_cast<int>(bitmap.width), inner);
+    int h = std::min(static_cast<int>(bitmap.rows), inner);
+    int pitch = std::abs(bitmap.pitch);
+
+    // upload the whole cell include padding to clear the evicted glyph.
+    std::fill(cell_buffer_.begin(), cell_buffer_.end(), 0);
+    for (int row = 0; row < h; row++) {
+        memcpy(&cell_buffer_[(row + ATLAS_CELL_PADDING) * cell_size_ + ATLAS_CELL_PADDING],
+               bitmap.buffer + row * pitch, static_cast<size_t>(w));
+    }
+
+    lark::RenderState::instance()->BindTexture(GL_TEXTURE_2D, texture_);
+    // Disable byte-alignment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0,
+                    (slot % cols_) * cell_size_, (slot / cols_) * cell_size_,
+                    cell_size_, cell_size_,
+                    GL_LUMINANCE, GL_UNSIGNED_BYTE, cell_buffer_.data());
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("upload glyph to atlas failed %u", err);
+        return false;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+FontCache* FontCache::instance_ = nullptr;
+
+FontCache* FontCache::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new FontCache();
+    }
+    return instance_;
+}
+
+void FontCache::Release() {
+    if (instance_ != nullptr) {
+        instance_->LogStats();
+        delete instance_;
+        instance_ = nullptr;
+    }
+}
+
+FontCache::FontCache() {
+    FT_Library ft = nullptr;
+    /* 初始化 FreeType 库 */
+    int res = FT_Init_FreeType(&ft);
+    if (res != 0) {
+        LOGW("Init free type failed: %d;", res);
+        return;
+    }
+    ft_ = std::shared_ptr<FT_LibraryRec_>(ft, FT_Done_FreeType);
+}
+
+FontCache::~FontCache() {
+    // faces hold the library. release faces first.
+    faces_.clear();
+    ft_.reset();
+}
+
+std::shared_ptr<FontFace> FontCache::GetFace(const std::string &fontName, FT_UInt pixelSize) {
+    if (!ft_) {
+        return nullptr;
+    }
+    std::string key = fontName + "#" + std::to_string(pixelSize);
+    auto it = faces_.find(key);
+    if (it != faces_.end()) {
+        return it->second;
+    }
+    std::shared_ptr<FontFace> face = std::make_shared<FontFace>(ft_, ANDROID_FONT_BASE + fontName, pixelSize);
+    if (!face->is_valid()) {
+        return nullptr;
+    }
+    faces_.insert(std::make_pair(key, face));
+    return face;
+}
+
+void FontCache::LogStats() {
+    for (auto & it : faces_) {
+        const std::shared_ptr<FontFace>& face = it.second;
+        uint64_t total = face->hits() + face->misses();
+        LOGV("font %s glyphs %zu/%d hits %llu misses %llu evictions %llu dropped %llu hit rate %.2f%%",
+             it.first.c_str(), face->glyph_count(), face->capacity(),
+             (unsigned long long)face->hits(), (unsigned long long)face->misses(),
+             (unsigned long long)face->evictions(), (unsigned long long)face->dropped(),
+             total > 0 ? face->hits() * 100.0 / total : 0.0);
+    }
+}
@@ -0,0 +1,131 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/6.
+//
+
+#ifndef CLOUDLARKXR_FONT_CACHE_H
+#define CLOUDLARKXR_FONT_CACHE_H
+
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+// GLM
+#include <glm/glm.hpp>
+// free type
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "pxygl.h"
+
+const static std::string ANDROID_FONT_BASE = "/system/fonts/";
+
+//
+// one FT_Face per font/size and one glyph atlas texture per face.
+// glyphs are packed into fixed size cells of the atlas. when the atlas is full the
+// least recently used glyph is evicted and generation() is increased, so texts
+// built against the old atlas layout know they must rebuild their mesh.
+// glyphs of the string between BeginString and EndString are never evicted by that string,
+// when they fill the whole atlas it grows up to the max size, glyphs over that are dropped.
+// must be used in render thread.
+//
+class FontFace {
+public:
+    struct Glyph {
+        glm::ivec2 size;     // Size of glyph
+        glm::ivec2 bearing;  // Offset from baseline to left/top of glyph
+        FT_Pos advance;      // Horizontal offset to advance to next glyph. 1/64 pixels.
+        glm::vec4 uv;        // u0 v0 u1 v1 in atlas.
+        bool visible;
+    };
+
+    FontFace(const std::shared_ptr<FT_LibraryRec_>& ft, const std::string& path, FT_UInt pixelSize);
+    ~FontFace();
+
+    inline bool is_valid() const { return face_ != nullptr; }
+    inline GLuint texture() const { return texture_; }
+    inline uint64_t generation() const { return generation_; }
+    inline FT_UInt pixel_size() const { return pixel_size_; }
+    // stats
+    inline uint64_t hits() const { return hits_; }
+    inline uint64_t misses() const { return misses_; }
+    inline uint64_t evictions() const { return evictions_; }
+    inline uint64_t dropped() const { return dropped_; }
+    inline size_t glyph_count() const { return glyphs_.size(); }
+    inline int capacity() const { return capacity_; }
+    // increased when the atlas grows. uv of every glyph got before is invalid.
+    inline uint64_t layout_version() const { return layout_version_; }
+
+    // pin glyphs got until EndString.
+    void BeginString();
+    void EndString();
+    // return nullptr when glyph load failed or atlas is full of pinned glyphs.
+    // pointer is valid until next GetGlyph call.
+    const Glyph* GetGlyph(wchar_t c);
+private:
+    struct Entry {
+        Glyph glyph;
+        int slot;                             // -1 for invisible glyph, not in atlas.
+        uint64_t pin;                         // pin_epoch_ of the last string used it.
+        std::list<wchar_t>::iterator lru;
+    };
+
+    bool InitAtlas();
+    // create empty atlas texture and update cols and capacity.
+    GLuint CreateAtlasTexture(int size);
+    // double the atlas and upload all glyphs again. slots are kept.
+    bool GrowAtlas();
+    // -1 when every glyph in atlas is pinned and atlas can not grow.
+    int AllocSlot();
+    bool UploadGlyph(int slot, const FT_Bitmap& bitmap);
+    void SetGlyphUv(Entry* entry, int width, int height);
+
+    std::shared_ptr<FT_LibraryRec_> ft_;
+    FT_Face face_ = nullptr;
+    FT_UInt pixel_size_;
+
+    GLuint texture_ = 0;
+    int atlas_size_ = 0;
+    int cell_size_ = 0;
+    int cols_ = 0;
+    int capacity_ = 0;
+    int next_slot_ = 0;
+    uint64_t generation_ = 0;
+    uint64_t layout_version_ = 0;
+    uint64_t pin_epoch_ = 0;
+    bool pinning_ = false;
+
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+    uint64_t dropped_ = 0;
+
+    std::unordered_map<wchar_t, Entry> glyphs_;
+    // front is the most recently used glyph.
+    std::list<wchar_t> lru_;
+    std::vector<uint8_t> cell_buffer_;
+};
+
+class FontCache {
+public:
+    static FontCache* instance();
+    // release all faces and atlas textures.
+    // call in render thread when gl context destroyed.
+    static void Release();
+
+    // font name relative to ANDROID_FONT_BASE.
+    std::shared_ptr<FontFace> GetFace(const std::string& fontName, FT_UInt pixelSize);
+
+    // log glyph cache hit rate of every face.
+    void LogStats();
+private:
+    static FontCache* instance_;
+
+    FontCache();
+    ~FontCache();
+
+    std::shared_ptr<FT_LibraryRec_> ft_ = nullptr;
+    std::map<std::string, std::shared_ptr<FontFace>> faces_ = {};
+};
+
+#endif //CLOUDLARKXR_FONT_CACHE_H
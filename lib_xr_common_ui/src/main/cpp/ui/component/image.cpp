@@ -36,16 +36,33 @@ Image::Image(): load_mutex_()
     view_location_ = shader_->GetUniformLocation("uView");
     projection_location_ = shader_->GetUniformLocation("uProjection");
 
+    LoadMultiviewShaderFromAsset(Context::instance()->asset_manager(),
+            "shader/vertex/image_multiview_vertex.glsl", "shader/fragment/image_fragment.glsl");
+    if (multiview_shader_) {
+        multiview_model_location_ = multiview_shader_->GetUniformLocation("uModel");
+    }
+
     enable_ = true;
 }
 
 Image::~Image() = default;
 
 
-void Image::LoadTexture(const char *buffer, int len) {
+void Image::LoadTexture(const char *buffer, int len, uint64_t cacheKey) {
+    std::shared_ptr<lark::TextureRequest> request =
+            lark::TextureStreamer::instance()->Request(std::vector<char>(buffer, buffer + len), cacheKey);
     std::lock_guard<std::mutex> lock(load_mutex_);
-    image_buffer_ = std::vector<char>(buffer, buffer + len);
-    need_load_ = true;
+    // drop the old request if still loading.
+    texture_request_ = request;
+    // clear loclpath.
+    path_ = "";
+}
+
+void Image::LoadCachedTexture(uint64_t cacheKey) {
+    std::shared_ptr<lark::TextureRequest> request = lark::TextureStreamer::instance()->RequestCached(cacheKey);
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    // drop the old request if still loading.
+    texture_request_ = request;
     // clear loclpath.
     path_ = "";
 }
@@ -54,6 +71,11 @@ void Image::SetPath(const std::string & path, bool isLocal) {
     if (path != path_) {
         LOGV("update image url %s; old %s; isLocal %d;", path.c_str(), path_.c_str(), (int)isLocal);
         path_ = path;
+        texture_future_ = lark::AssetLoader::instance()->FindLoadingTexture(path);
+        if (texture_future_.valid()) {
+            // finished in PrepareDraw.
+            return;
+        }
         lark::BitmapFactory* bitmapFactory = Context::instance()->bitmap_factory();
         EnvWrapper envWrapper = Context::instance()->GetEnv();
         lark::TextureAsset asset = {
@@ -113,13 +135,92 @@ void Image::SetPositionZ(float z) {
 
 void Image::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView) {
     Object::Draw(eye, projection, eyeView);
-    //
+
+    if (!PrepareDraw()) {
+        return;
+    }
+
+    shader_->UseProgram();
+    // mvp
+    glUniformMatrix4fv(model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+    glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(eyeView));
+    glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
+
+    lark::RenderState::instance()->ActiveTexture(GL_TEXTURE0);
+    texture_->BindTexture();
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    shader_->UnUseProgram();
+    vao_->UnbindVAO();
+    texture_->UnBindTexture();
+}
+
+void Image::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+    Object::DrawMultiview(projection, view);
+
+    if (!multiview_shader_ || !PrepareDraw()) {
+        return;
+    }
+
+    multiview_shader_->UseProgram();
+    // view and projection from scene matrices.
+    glUniformMatrix4fv(multiview_model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+
+    lark::RenderState::instance()->ActiveTexture(GL_TEXTURE0);
+    texture_->BindTexture();
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    multiview_shader_->UnUseProgram();
+    vao_->UnbindVAO();
+    texture_->UnBindTexture();
+}
+
+bool Image::PrepareDraw() {
+    std::shared_ptr<lark::TextureRequest> request = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(load_mutex_);
+        if (texture_request_ && texture_request_->done()) {
+            request = texture_request_;
+            texture_request_ = nullptr;
+        }
+    }
+    if (texture_future_.valid() &&
+        texture_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        std::shared_ptr<lark::Texture> texture = texture_future_.get();
+        texture_future_ = lark::TextureFuture();
+        if (texture) {
+            texture_ = texture;
+            need_update_cover_ = true;
+            if (callback_ != nullptr) {
+                callback_->OnImageInited(this);
+            }
+        }
+    }
+
+    if (request && request->state() == lark::TextureRequest::State_Ready) {
+        texture_ = request->texture();
+        need_update_cover_ = true;
+        if (callback_ != nullptr) {
+            callback_->OnImageInited(this);
+        }
+    } else if (request && request->encoded().empty()) {
+        LOGW("texture cache missed");
+        if (callback_ != nullptr) {
+            callback_->OnImageCacheMissed(this);
+        }
+    } else if (request) {
+        // format not supported by stb_image, like webp. fall back to android bitmap factory.
+        image_buffer_ = request->encoded();
+        need_load_ = true;
+    }
+
     if (need_load_) {
         LOGV("LoadTexture cover need load url");
         lark::BitmapFactory* bitmapFactory = Context::instance()->bitmap_factory();
         EnvWrapper envWrapper = Context::instance()->GetEnv();
 
-        lark::Texture* texture = lark::Texture::LoadTexture(bitmapFactory, envWrapper.get(),
+        // uploaded straight from the decoded pixels.
+        lark::Texture* texture = lark::Texture::UploadTexture(bitmapFactory, envWrapper.get(),
                 &image_buffer_[0], image_buffer_.size(), 0);
         if (texture != nullptr) {
             texture_.reset(texture);
@@ -128,17 +229,21 @@ void Image::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView)
                 callback_->OnImageInited(this);
             }
         }
-        image_buffer_.clear();
+        // release the encoded bytes too.
+        std::vector<char>().swap(image_buffer_);
         need_load_ = false;
     }
 
     if (has_error_ || texture_ == nullptr || !enable_)
-        return;
+        return false;
 
     if (need_update_cover_) {
         texture_->BindTexture();
 //        mCover->bindBitmap(GL_RGB5_A1);
-        texture_->BindBitmap();
+        // streamed textures have no cpu bitmap, storage already uploaded.
+        if (texture_->bitmap() != nullptr) {
+            texture_->BindBitmap();
+        }
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -191,20 +296,7 @@ void Image::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView)
         // update done
         need_update_cover_ = false;
     }
-
-    shader_->UseProgram();
-    // mvp
-    glUniformMatrix4fv(model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
-    glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(eyeView));
-    glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
-
-    glActiveTexture(GL_TEXTURE0);
-    texture_->BindTexture();
-    vao_->BindVAO();
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    shader_->UnUseProgram();
-    vao_->UnbindVAO();
-    texture_->UnBindTexture();
+    return true;
 }
 
 glm::vec2 Image::GetScaledSize() {
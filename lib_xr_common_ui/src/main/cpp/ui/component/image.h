@@ -12,6 +12,8 @@
 #include "object.h"
 #include "vertex_array_object.h"
 #include "base.h"
+#include "texture_streamer.h"
+#include "asset_loader.h"
 #include <mutex>
 #include <thread>
 
@@ -20,6 +22,8 @@ public:
     class ImageChangeCallback {
     public:
         virtual void OnImageInited(Image* image) = 0;
+        // texture cache entry gone, load the image again.
+        virtual void OnImageCacheMissed(Image* image) {}
     };
 
     enum ImageScaleType {
@@ -31,12 +35,17 @@ public:
     ~Image() override;
 
     // call on any thread.
-    // init after render.
-    void LoadTexture(const char* buffer, int len);
+    // decode on texture streamer workers, upload in render thread.
+    // decoded pixels saved to texture cache when cacheKey not 0.
+    void LoadTexture(const char* buffer, int len, uint64_t cacheKey = 0);
+    // call on any thread.
+    // load decoded pixels from texture cache, skip decode.
+    void LoadCachedTexture(uint64_t cacheKey);
     // call on render thread.
     // reload the image
     void SetPath(const std::string & path, bool isLocal = false);
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView) override;
+    void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 
     void set_size(const glm::vec2& size) override;
     void set_position(const glm::vec3& position ) override;
@@ -50,10 +59,13 @@ public:
     inline void set_callback(ImageChangeCallback* callback) { callback_ = callback; }
 private:
     glm::vec2 GetScaledSize();
+    // finish pending loads and update vertices. return false when nothing to draw.
+    bool PrepareDraw();
 
     int model_location_ = 0;
     int view_location_ = 0;
     int projection_location_ = 0;
+    int multiview_model_location_ = 0;
 
     std::string path_ = "";
     bool need_update_cover_ = false;
@@ -62,6 +74,9 @@ private:
 
     std::vector<char> image_buffer_ = {};
     bool need_load_ = false;
+    std::shared_ptr<lark::TextureRequest> texture_request_ = nullptr;
+    // local texture still loading in asset loader. render thread.
+    lark::TextureFuture texture_future_ = {};
     ImageChangeCallback* callback_ = nullptr;
     std::mutex load_mutex_;
 };
@@ -10,10 +10,10 @@
 #include <utility>
 #include <utils.h>
 #include <env_context.h>
+#include <render_state.h>
 #include "text.h"
 
 #define LOG_TAG "Text"
-using namespace std;
 
 Text::Text(std::wstring  text) :
     Object(),
@@ -23,11 +23,14 @@ Text::Text(std::wstring  text) :
     total_width_(0.0F),
     need_update_(false),
     overflow_mode_(TEXT_OVERFLOW_MODE_HIDEN),
-    limit_charsize_(0),
-    ft_(),
-    face_(),
+    face_(nullptr),
     t_vao_(0),
-    t_vbo_(0) {
+    t_vbo_(0),
+    vertices_(),
+    vertex_count_(0),
+    mesh_generation_(0),
+    mesh_position_(),
+    mesh_scale_(0.0F) {
     name_ = LOG_TAG;
     Init();
 }
@@ -44,11 +47,14 @@ Text::Text(std::wstring  text,
     font_name_(std::move(fontName)),
     total_width_(0.0F),
     overflow_mode_(TEXT_OVERFLOW_MODE_HIDEN),
-    ft_(),
-    limit_charsize_(0),
-    face_(),
+    face_(nullptr),
     t_vao_(0),
-    t_vbo_(0) {
+    t_vbo_(0),
+    vertices_(),
+    vertex_count_(0),
+    mesh_generation_(0),
+    mesh_position_(),
+    mesh_scale_(0.0F) {
     name_ = LOG_TAG;
     color_ = color;
     position_ = position;
@@ -62,33 +68,26 @@ Text::~Text() {
 }
 
 void Text::Release() {
-    if (face_ != nullptr) {
-        FT_Done_Face(face_);
+    if (t_vbo_ != 0) {
+        glDeleteBuffers(1, &t_vbo_);
+        t_vbo_ = 0;
     }
-    if (ft_ != nullptr) {
-        FT_Done_FreeType(ft_);
+    if (t_vao_ != 0) {
+        lark::RenderState::instance()->ForgetVertexArray(t_vao_);
+        glDeleteVertexArrays(1, &t_vao_);
+        t_vao_ = 0;
     }
-    ClearCharacters();
+    vertex_count_ = 0;
+    face_.reset();
 }
 
 void Text::Init() {
     enable_ = false;
-    int res;
 
-    /* 初始化 FreeType 库 */
-    res = FT_Init_FreeType(&ft_);
-    /* 加载字体 */
-    string fontPath = ANDROID_FONT_BASE + font_name_;
-    res = FT_New_Face(ft_, fontPath.c_str(), 0, &face_);
-//    res = FT_New_Face(ft_, "/system/fonts/Roboto-Black.ttf", 0, &face_);
-    /* 设定为 UNICODE，默认也是 */
-    res = FT_Select_Charmap(face_, FT_ENCODING_UNICODE);
-    /* 定义字体大小 */
-    // 尺寸中的任一个为0意味着“与另一个尺寸值相等”
-    res = FT_Set_Pixel_Sizes(face_, 0, font_size_);
-
-    if (res != 0) {
-        LOGW("Init free type font err: %d;", res);
+    // faces and glyph textures are shared by all texts.
+    face_ = FontCache::instance()->GetFace(font_name_, font_size_);
+    if (!face_) {
+        LOGW("Init free type font %s size %d failed", font_name_.c_str(), font_size_);
         return;
     }
 
@@ -105,14 +104,21 @@ void Text::Init() {
 
     color_loaction_ = shader_->GetUniformLocation("uColor");
 
-    if (!UpdateChar()) {
-        LOGW("texture render loadchar failed");
-        return;
+    LoadMultiviewShaderFromAsset(Context::instance()->asset_manager(),
+            "shader/vertex/text_multiview_vertex.glsl", "shader/fragment/text_fragment.glsl");
+    if (multiview_shader_) {
+        multiview_model_location_ = multiview_shader_->GetUniformLocation("uModel");
+        multiview_color_location_ = multiview_shader_->GetUniformLocation("uColor");
     }
+
     if (!InitVao()) {
         LOGW("texture render Init vao failed");
         return;
     }
+    if (!UpdateMesh()) {
+        LOGW("texture render update mesh failed");
+        return;
+    }
     enable_ = true;
 }
 
@@ -120,9 +126,8 @@ bool Text::InitVao() {
     // Configure VAO/VBO for texture quads
     glGenVertexArrays(1, &t_vao_);
     glGenBuffers(1, &t_vbo_);
-    glBindVertexArray(t_vao_);
+    lark::RenderState::instance()->BindVertexArray(t_vao_);
     glBindBuffer(GL_ARRAY_BUFFER, t_vbo_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 5, nullptr, GL_DYNAMIC_DRAW);
 
     int stride = (2 + 3) * sizeof(GLfloat);
     GLuint offset = 0;
@@ -135,7 +140,7 @@ bool Text::InitVao() {
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (const void*) offset);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glBindVertexArray(0);
+    lark::RenderState::instance()->BindVertexArray(0);
 
     return !HasGLError();
 
@@ -150,7 +155,7 @@ int Text::SetText(const std::wstring &text, bool updateNow) {
         // update
         text_.assign(text);
         if (updateNow) {
-            UpdateChar();
+            UpdateMesh();
         } else {
             need_update_ = true;
         }
@@ -161,119 +166,123 @@ int Text::SetText(const std::wstring &text, bool updateNow) {
 int Text::SetFontName(const std::string & fontName) {
     font_name_.assign(fontName);
     /* 加载字体 */
-    string fontPath = ANDROID_FONT_BASE + fontName;
-    return FT_New_Face(ft_, fontPath.c_str(), 0, &face_);
+    std::shared_ptr<FontFace> face = FontCache::instance()->GetFace(font_name_, font_size_);
+    if (!face) {
+        LOGW("load font %s failed", font_name_.c_str());
+        return -1;
+    }
+    face_ = face;
+    need_update_ = true;
+    return 0;
 }
 
 int Text::SetFontSize(uint fontSize) {
     /* 定义字体大小 */
-    // 尺寸中的任一个为0意味着“与另一个尺寸值相等”
     font_size_ = fontSize;
-    FT_Set_Pixel_Sizes(face_, 0, font_size_);
-//    UpdateChar();
+    std::shared_ptr<FontFace> face = FontCache::instance()->GetFace(font_name_, font_size_);
+    if (!face) {
+        LOGW("load font %s size %d failed", font_name_.c_str(), font_size_);
+        return -1;
+    }
+    face_ = face;
+//    UpdateMesh();
     need_update_ = true;
     return 0;
 }
 
-void Text::ClearCharacters() {
-    if (characters_.empty())
-        return;
-    for(auto & mCharacter : characters_) {
-        glDeleteTextures(1, &mCharacter.second.TextureID);
-    }
-    characters_.clear();
+bool Text::NeedRebuildMesh() {
+    return need_update_ ||
+           face_->generation() != mesh_generation_ ||
+           position_ != mesh_position_ ||
+           scale_ != mesh_scale_;
 }
 
-bool Text::UpdateChar() {
+bool Text::UpdateMesh() {
     need_update_ = false;
-    ClearCharacters();
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (!face_ || t_vbo_ == 0) {
+        return false;
+    }
+
+    // the atlas may grow while the string adds its glyphs, build again with the new uv.
+    uint64_t layout = face_->layout_version();
+    BuildMesh();
+    if (layout != face_->layout_version()) {
+        BuildMesh();
+    }
+    // glyphs added above may evict others. record generation after build.
+    mesh_generation_ = face_->generation();
+    mesh_position_ = position_;
+    mesh_scale_ = scale_;
+
+    if (vertex_count_ == 0) {
+        return true;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, t_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(GLfloat), vertices_.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (HasGLError()) {
+        LOGW("render text has error");
+        return false;
+    }
+    return true;
+}
+
+void Text::BuildMesh() {
+    vertices_.clear();
+    vertex_count_ = 0;
+
+    // glyphs of this string must not evict each other.
+    face_->BeginString();
+    GLfloat x = position_.x;
+    GLfloat y = position_.y;
+    GLfloat z = position_.z;
+    GLfloat scale = scale_;
     // Iterate through all characters
     float totalW = 0.0F;
-    int charNum = 0;
     for (wchar_t c : text_)
     {
-        charNum ++;
-        // Load character glyph
-        if (FT_Load_Char(face_, static_cast<FT_ULong>(c), FT_LOAD_RENDER))
-        {
-            LOGW("ERROR::FREETYTPE: Failed to load Glyph %d", c);
-            continue;
-        }
-        if (face_->glyph->bitmap.buffer == nullptr) {
-            if (c == 0x20) { // 空格
-                FT_Pos advanceX = face_->glyph->advance.x;
-                totalW += (advanceX >> 6) * scale_ * component::UNIT_PIXEL_SCALE;
-
-                // Now store character for later use
-                Character character = {
-                        0,
-                        glm::ivec2(advanceX, advanceX),
-                        glm::ivec2(advanceX, advanceX),
-                        static_cast<GLuint>(advanceX),
-                        false,
-                };
-                characters_.insert(pair<wchar_t , Character>(c, character));
-            } else {
-                LOGW("font face error %d, %ld", c, face_->glyph->advance.x >> 6);
-            }
+        const FontFace::Glyph* ch = face_->GetGlyph(c);
+        if (ch == nullptr) {
             continue;
         }
         // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-        totalW += (face_->glyph->advance.x >> 6) * scale_ * component::UNIT_PIXEL_SCALE;
+        totalW += (ch->advance >> 6) * scale_ * component::UNIT_PIXEL_SCALE;
         if (overflow_mode_ == TEXT_OVERFLOW_MODE_HIDEN && container_size_.x > 0 && totalW > container_size_.x) {
             break;
         }
-        // Generate texture
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        if (HasGLError()) {
-            return false;
-        }
-        glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_LUMINANCE , //  **文字渲染使用** GL_LUMINANCE
-                face_->glyph->bitmap.width,
-                face_->glyph->bitmap.rows,
-                0,
-                GL_LUMINANCE , //  **文字渲染使用** GL_LUMINANCE
-                GL_UNSIGNED_BYTE,
-                face_->glyph->bitmap.buffer
-        );
-        if (HasGLError()) {
-            return false;
-        }
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        if (HasGLError()) {
-            return false;
+
+        if (ch->visible) { // 去掉不可见字符。
+            GLfloat xpos = (x + ch->bearing.x * component::UNIT_PIXEL_SCALE) * scale;
+            GLfloat ypos = (y - component::UNIT_PIXEL_SCALE * (ch->size.y - ch->bearing.y)) * scale;
+
+            GLfloat w = ch->size.x * scale * component::UNIT_PIXEL_SCALE;
+            GLfloat h = ch->size.y * scale * component::UNIT_PIXEL_SCALE;
+
+            GLfloat u0 = ch->uv.x;
+            GLfloat v0 = ch->uv.y;
+            GLfloat u1 = ch->uv.z;
+            GLfloat v1 = ch->uv.w;
+
+            GLfloat quad[] = {
+                    xpos,     ypos + h, z, u0, v0,
+                    xpos,     ypos,     z, u0, v1,
+                    xpos + w, ypos,     z, u1, v1,
+
+                    xpos,     ypos + h, z, u0, v0,
+                    xpos + w, ypos,     z, u1, v1,
+                    xpos + w, ypos + h, z, u1, v0
+            };
+            vertices_.insert(vertices_.end(), quad, quad + sizeof(quad) / sizeof(GLfloat));
+            vertex_count_ += 6;
         }
-        // Now store character for later use
-        Character character = {
-                texture,
-                glm::ivec2(face_->glyph->bitmap.width, face_->glyph->bitmap.rows),
-                glm::ivec2(face_->glyph->bitmap_left, face_->glyph->bitmap_top),
-                static_cast<GLuint>(face_->glyph->advance.x),
-                true // 可见字符
-        };
-        characters_.insert(pair<wchar_t , Character>(c, character));
+        // Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+        x += (ch->advance >> 6) * scale * component::UNIT_PIXEL_SCALE;
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+    face_->EndString();
 
     total_width_ = totalW;
-    limit_charsize_ = charNum;
-
-    if (HasGLError()) {
-        LOGW("render text has error");
-        return false;
-    }
-    return true;
 }
 
 void Text::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view)  {
@@ -285,8 +294,11 @@ void Text::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view)  {
     if (text_.empty())
         return;
 
-    if (need_update_)
-        UpdateChar();
+    if (NeedRebuildMesh())
+        UpdateMesh();
+
+    if (vertex_count_ == 0)
+        return;
 
     // Activate corresponding render state
     shader_->UseProgram();
@@ -296,70 +308,51 @@ void Text::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view)  {
     glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
     // color
     glUniform4fv(color_loaction_, 1, glm::value_ptr(color_));
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(t_vao_);
+    lark::RenderState* state = lark::RenderState::instance();
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, face_->texture());
+    state->BindVertexArray(t_vao_);
 
-    GLfloat x = position_.x;
-    GLfloat y = position_.y;
-    GLfloat scale = scale_;
-    int charNum = 0;
-    // Iterate through all characters
-    for (wchar_t & c : text_)
-    {
-        charNum++;
-        if (overflow_mode_ == TEXT_OVERFLOW_MODE_HIDEN && limit_charsize_ > 0 && charNum > limit_charsize_) {
-            break;
-        }
-        auto cit = characters_.find(c);
-        if (cit == characters_.end()) {
-            continue;
-        }
-        Character ch = cit->second;
-
-        GLfloat xpos = (x + ch.Bearing.x * component::UNIT_PIXEL_SCALE) * scale;
-        GLfloat ypos = (y - component::UNIT_PIXEL_SCALE * (ch.Size.y - ch.Bearing.y)) * scale;
-//        GLfloat ypos = y * scale;
-
-        GLfloat w = ch.Size.x * scale * component::UNIT_PIXEL_SCALE;
-        GLfloat h = ch.Size.y * scale * component::UNIT_PIXEL_SCALE;
-        GLfloat z = position_.z;
-
-        // Update VBO for each character
-        GLfloat vertices[] = {
-                xpos,     ypos + h, z, 0.0, 0.0,
-                xpos,     ypos,     z, 0.0, 1.0,
-                xpos + w, ypos,     z, 1.0, 1.0,
-
-                xpos,     ypos + h, z, 0.0, 0.0,
-                xpos + w, ypos,     z, 1.0, 1.0,
-                xpos + w, ypos + h, z, 1.0, 0.0
-        };
-
-        if (ch.visible) { // 去掉不可见字符。
-            // Render glyph texture over quad
-            glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-            // Update content of VBO memory
-            glBindBuffer(GL_ARRAY_BUFFER, t_vbo_);
-            // Be sure to use glBufferSubData and not glBufferData
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            // Render quad
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        }
-        // Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-        x += (ch.Advance >> 6) * scale * component::UNIT_PIXEL_SCALE;
-//        x += w;
-    }
+    // all glyphs in one draw call.
+    glDrawArrays(GL_TRIANGLES, 0, vertex_count_);
 
     shader_->UnUseProgram();
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    state->BindVertexArray(0);
 
 //    HasGLError();
 }
 
+void Text::DrawMultiview(const glm::mat4& projection, const glm::mat4& view) {
+    Object::DrawMultiview(projection, view);
+
+    if (!enable_ || !multiview_shader_)
+        return;
+
+    if (text_.empty())
+        return;
+
+    if (NeedRebuildMesh())
+        UpdateMesh();
+
+    if (vertex_count_ == 0)
+        return;
+
+    multiview_shader_->UseProgram();
+    glUniformMatrix4fv(multiview_model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+    // color
+    glUniform4fv(multiview_color_location_, 1, glm::value_ptr(color_));
+    lark::RenderState* state = lark::RenderState::instance();
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, face_->texture());
+    state->BindVertexArray(t_vao_);
+
+    // all glyphs of both eyes in one draw call.
+    glDrawArrays(GL_TRIANGLES, 0, vertex_count_);
+
+    multiview_shader_->UnUseProgram();
+    state->BindVertexArray(0);
+}
+
 glm::vec2 Text::GetSize() {
     return glm::vec2(total_width_, font_size_ * component::UNIT_PIXEL_SCALE * scale_);
 }
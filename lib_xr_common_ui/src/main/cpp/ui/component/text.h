@@ -6,18 +6,20 @@
 #define MY_APPLICATION_TEXT_H
 
 #include <string>
-#include <map>
+#include <vector>
+#include <memory>
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-// free type
-#include <ft2build.h>
-#include FT_FREETYPE_H
 #include "object.h"
 #include "base.h"
+#include "font_cache.h"
 
-const static std::string ANDROID_FONT_BASE = "/system/fonts/";
+//
+// glyphs come from the shared FontCache atlas.
+// whole string is built into one vertex buffer and drawn with one draw call.
+//
 class Text: public lark::Object, public component::Base {
 public:
     enum OverflowMode {
@@ -25,15 +27,6 @@ public:
         TEXT_OVERLOW_MODE_SHOW,
     };
 
-    /// Holds all state information relevant to a character as loaded using FreeType
-    struct Character {
-        GLuint TextureID;    // ID handle of the glyph texture
-        glm::ivec2 Size;     // Size of glyph
-        glm::ivec2 Bearing;  // Offset from baseline to left/top of glyph
-        GLuint Advance;      // Horizontal offset to advance to next glyph
-        bool visible;
-    };
-
     explicit Text(std::wstring  text);
     Text(std::wstring  text,
          uint size,
@@ -64,19 +57,26 @@ public:
 
     // render
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view) override;
+    void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 private:
     void Init();
     bool InitVao();
-    void ClearCharacters();
-    bool UpdateChar();
+    bool UpdateMesh();
+    // fill vertices_ with glyph quads of the string.
+    void BuildMesh();
+    bool NeedRebuildMesh();
 private:
-    std::map<wchar_t , Character> characters_;
-
-    FT_Library ft_;
-    FT_Face face_;
+    std::shared_ptr<FontFace> face_;
     GLuint t_vao_;
     GLuint t_vbo_;
 
+    // mesh state. rebuild when text, position, scale or atlas changed.
+    std::vector<GLfloat> vertices_;
+    GLsizei vertex_count_;
+    uint64_t mesh_generation_;
+    glm::vec3 mesh_position_;
+    float mesh_scale_;
+
     FT_UInt font_size_;
     std::wstring text_;
     std::string font_name_;
@@ -85,13 +85,15 @@ private:
     bool need_update_;
 
     OverflowMode overflow_mode_;
-    int limit_charsize_;
 
     int model_location_ = 0;
     int view_location_ = 0;
     int projection_location_ = 0;
 
     int color_loaction_ = 0;
+
+    int multiview_model_location_ = 0;
+    int multiview_color_location_ = 0;
 };
 
 
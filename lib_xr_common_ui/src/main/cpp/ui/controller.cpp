@@ -11,6 +11,7 @@
 
 namespace lark {
 Controller::Controller(bool isLeft, const ControllerConfig& config):
+    config_(config),
     model_(nullptr),
     raycast_(nullptr),
     is_left(isLeft),
@@ -22,26 +23,15 @@ Controller::Controller(bool isLeft, const ControllerConfig& config):
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::ModelAsset modelAsset = {
-            isLeft ? config.modelLeft : config.modelRight,
-    };
     LOGV("model load start");
 //    model_ = lark::AssetLoader::instance()->LoadModel(&context, modelAsset);
     model_ = std::make_shared<lark::Model>(isLeft ? config.modelLeft : config.modelRight);
-    model_->Init(&context);
-    model_->SetColor(config.color);
-    if (config.diffuse.path != "") {
-        model_->AddMeterailTexture(&context, config.diffuse);
-    }
-    if (config.specular.path != "") {
-        model_->AddMeterailTexture(&context, config.specular);
-    }
+    // 模型在加载线程解析，不阻塞渲染线程。
+    model_future_ = lark::AssetLoader::instance()->LoadModelAsync(&context, model_);
     model_->Scale(config.modelScale);
     if (config.modelRotate != 0) {
         model_->Rotate(config.modelRotate, config.modelRotateAxis);
     }
-    AddChild(model_);
-    LOGV("model load finish %d", model_ == nullptr);
 
     raycast_ = std::make_shared<Raycast>();
     raycast_->Rotate(glm::half_pi<float>(), glm::vec3(-1, 0, 0));
@@ -51,6 +41,11 @@ Controller::Controller(bool isLeft, const ControllerConfig& config):
 
 void Controller::Update() {
     Object::Update();
+    if (model_future_.valid() &&
+        model_future_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        OnModelLoaded();
+        model_future_ = lark::ModelFuture();
+    }
     if (ray_cast_type_ == Input::GetCurrentRayCastType() && !is_main_) {
         // active controller.
         raycast_->set_color(glm::vec4(0, 0, 1, 1));
@@ -62,4 +57,26 @@ void Controller::Update() {
     }
 }
 
+void Controller::OnModelLoaded() {
+    if (!model_future_.get()) {
+        LOGW("model load failed %s", is_left ? config_.modelLeft.c_str() : config_.modelRight.c_str());
+        return;
+    }
+    auto env = Context::instance()->GetEnv();
+    lark::AndroidAssetContext context = {
+            Context::instance()->native_activity(),
+            env.get(),
+            Context::instance()->bitmap_factory(),
+    };
+    model_->SetColor(config_.color);
+    if (config_.diffuse.path != "") {
+        model_->AddMeterailTexture(&context, config_.diffuse);
+    }
+    if (config_.specular.path != "") {
+        model_->AddMeterailTexture(&context, config_.specular);
+    }
+    AddChild(model_);
+    LOGV("model load finish");
+}
+
 }
\ No newline at end of file
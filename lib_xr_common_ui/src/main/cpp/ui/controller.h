@@ -142,7 +142,13 @@ public:
 
     virtual void Update();
 private:
+    // color and textures set on the meshes, added to the scene.
+    void OnModelLoaded();
+
+    ControllerConfig config_;
     std::shared_ptr<lark::Model> model_;
+    // parsed on asset loader workers, meshes uploaded by AssetLoader::Update.
+    lark::ModelFuture model_future_;
     std::shared_ptr<Raycast> raycast_ = nullptr;
     bool is_left = false;
     bool is_main_ = false;
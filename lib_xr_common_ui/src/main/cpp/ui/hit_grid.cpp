@@ -0,0 +1,110 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "hit_grid.h"
+
+// odr-used by std::min.
+const int HitGrid::MAX_CELLS;
+
+HitGrid::HitGrid():
+    items_(),
+    min_(),
+    max_(),
+    cell_size_(),
+    cols_(0),
+    rows_(0),
+    cell_start_(),
+    cell_items_()
+{
+}
+
+HitGrid::~HitGrid() = default;
+
+void HitGrid::Build(const std::vector<AABB*> &items) {
+    Clear();
+    items_ = items;
+
+    int count = 0;
+    min_ = glm::vec2(INFINITY);
+    max_ = glm::vec2(-INFINITY);
+    for (auto aabb : items_) {
+        if (!aabb->aabb_active()) {
+            continue;
+        }
+        min_ = glm::min(min_, aabb->GetAABBPosition());
+        max_ = glm::max(max_, aabb->GetAABBPosition() + aabb->GetAABBSize());
+        count++;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // about one box a cell.
+    cols_ = rows_ = std::min(std::max(static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count)))), 1), MAX_CELLS);
+    cell_size_ = glm::max((max_ - min_) / glm::vec2(cols_, rows_), glm::vec2(1e-6F));
+
+    // count then fill, cells keep the item order.
+    cell_start_.assign(cols_ * rows_ + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+        for (uint32_t i = 0; i < items_.size(); i++) {
+            AABB* aabb = items_[i];
+            if (!aabb->aabb_active()) {
+                continue;
+            }
+            glm::vec2 position = aabb->GetAABBPosition();
+            glm::vec2 end = position + aabb->GetAABBSize();
+            int x0 = Cell(position.x, min_.x, cell_size_.x, cols_);
+            int x1 = Cell(end.x, min_.x, cell_size_.x, cols_);
+            int y0 = Cell(position.y, min_.y, cell_size_.y, rows_);
+            int y1 = Cell(end.y, min_.y, cell_size_.y, rows_);
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    int cell = y * cols_ + x;
+                    if (pass == 0) {
+                        cell_start_[cell + 1]++;
+                    } else {
+                        cell_items_[fill[cell]++] = i;
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            for (size_t cell = 1; cell < cell_start_.size(); cell++) {
+                cell_start_[cell] += cell_start_[cell - 1];
+            }
+            cell_items_.resize(cell_start_.back());
+        }
+    }
+}
+
+void HitGrid::Clear() {
+    items_.clear();
+    cell_start_.clear();
+    cell_items_.clear();
+    cols_ = 0;
+    rows_ = 0;
+}
+
+void HitGrid::Query(const glm::vec2 &point, std::vector<uint32_t> *hits) const {
+    hits->clear();
+    if (cols_ == 0 || point.x < min_.x || point.y < min_.y || point.x > max_.x || point.y > max_.y) {
+        return;
+    }
+    int cell = Cell(point.y, min_.y, cell_size_.y, rows_) * cols_ + Cell(point.x, min_.x, cell_size_.x, cols_);
+    for (uint32_t i = cell_start_[cell]; i < cell_start_[cell + 1]; i++) {
+        AABB* aabb = items_[cell_items_[i]];
+        glm::vec2 d = point - aabb->GetAABBPosition();
+        glm::vec2 size = aabb->GetAABBSize();
+        if (d.x >= 0 && d.y >= 0 && d.x <= size.x && d.y <= size.y) {
+            hits->push_back(cell_items_[i]);
+        }
+    }
+}
+
+int HitGrid::Cell(float value, float min, float cellSize, int count) const {
+    return std::min(std::max(static_cast<int>((value - min) / cellSize), 0), count - 1);
+}
@@ -0,0 +1,46 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_HIT_GRID_H
+#define CLOUDLARKXR_HIT_GRID_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "ui/aa_bb.h"
+
+//
+// uniform grid over the aabb of a view, so a ray point only checks the boxes of one cell.
+// rebuild after aabb added, moved or actived. see AABB::layout_version.
+//
+class HitGrid {
+public:
+    // cells per axis limit.
+    static const int MAX_CELLS = 32;
+
+    HitGrid();
+    ~HitGrid();
+
+    // index active items.
+    void Build(const std::vector<AABB*>& items);
+    void Clear();
+    // indices in items() of boxes contain the point, ascending.
+    // edges included, items check the point themself in HandleInput.
+    void Query(const glm::vec2& point, std::vector<uint32_t>* hits) const;
+
+    inline const std::vector<AABB*>& items() const { return items_; }
+private:
+    int Cell(float value, float min, float cellSize, int count) const;
+
+    std::vector<AABB*> items_;
+    glm::vec2 min_;
+    glm::vec2 max_;
+    glm::vec2 cell_size_;
+    int cols_;
+    int rows_;
+    // items of cell i are cell_items_[cell_start_[i], cell_start_[i + 1]).
+    std::vector<uint32_t> cell_start_;
+    std::vector<uint32_t> cell_items_;
+};
+
+#endif //CLOUDLARKXR_HIT_GRID_H
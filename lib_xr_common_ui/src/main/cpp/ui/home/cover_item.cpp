@@ -2,6 +2,7 @@
 // Created by fcx@pingixngyun.com on 2019/11/15.
 //
 
+#include <algorithm>
 #include <env_context.h>
 #include <ui/localization.h>
 #include <utils.h>
@@ -11,11 +12,30 @@
 #include "ui/navigation.h"
 #include "application.h"
 #include "input.h"
+#include "texture_cache.h"
 #define LOG_TAG "cover_item"
 
 using namespace glm;
 using namespace std;
 
+namespace {
+    // decoded covers kept in 【内部路径】/larkxr/cover_cache
+    bool InitCoverCache() {
+        lark::TextureCache* cache = lark::TextureCache::instance();
+        if (cache->inited()) {
+            return true;
+        }
+        if (!Context::instance()) {
+            return false;
+        }
+        std::string internalPath = Context::instance()->internal_data_path();
+        if (internalPath.empty()) {
+            return false;
+        }
+        return cache->Init(internalPath + "/larkxr/cover_cache");
+    }
+}
+
 CoverItem::CoverItem(Navigation * navigation, const std::wstring& title):
     Object(),
     AABB(id()), // init aabb after object
@@ -33,8 +53,7 @@ CoverItem::CoverItem(Navigation * navigation, const std::wstring& title):
     size_(),
     bg_color_dark_(0.0, 0.019, 0.117, 0.2),
     bg_color_active_(0.0, 0.7, 0.0, 0.8),
-    is_empty_(true),
-    cover_loader_(this)
+    is_empty_(true)
 {
     name_ = LOG_TAG;
 
@@ -80,6 +99,7 @@ CoverItem::CoverItem(Navigation * navigation, const std::wstring& title):
     cover_->set_parent(this);
     cover_->set_position(vec3(0.0, titleH, 0.0));
     cover_->set_size(vec2(coverW, coverH));
+    cover_->set_callback(this);
 //    cover_->set_scale(0.1);
 
     border_ = std::make_shared<Image>();
@@ -124,14 +144,66 @@ void CoverItem::SetCoverUrl(const std::string & coverUrl, bool isLocal) {
         return;
     }
     LOGV("set cover url %s %d", coverUrl.c_str(), isLocal);
-    cover_url_ = coverUrl;
+    {
+        // downloads of the old url are dropped from now on.
+        std::lock_guard<std::mutex> lock(cover_mutex_);
+        cover_url_ = coverUrl;
+    }
     if (isLocal) {
         if (cover_ != nullptr) {
             cover_->SetPath(coverUrl, isLocal);
         }
+    } else if (InitCoverCache()) {
+        lark::TextureCache* cache = lark::TextureCache::instance();
+        uint64_t key = lark::TextureCache::Hash(coverUrl);
+        if (cover_ != nullptr && cache->Contains(key)) {
+            // skip download and decode.
+            cover_->LoadCachedTexture(key);
+            // same url may point to a new image. download again when old, keep showing
+            // the cached one meanwhile. see OnCoverLoaded.
+            if (cache->IsStale(key)) {
+                RequestCover(key, true);
+            }
+        } else {
+            RequestCover(key, false);
+        }
     } else {
-        cover_loader_.GetCoverAsync(coverUrl);
+        RequestCover(0, false);
+    }
+}
+
+void CoverItem::RequestCover(uint64_t cacheKey, bool revalidating) {
+    // render thread only, release the finished ones.
+    cover_requests_.erase(std::remove_if(cover_requests_.begin(), cover_requests_.end(),
+                                         [](const std::shared_ptr<CoverRequest>& request) { return request->done(); }),
+                          cover_requests_.end());
+    std::shared_ptr<CoverRequest> request = std::make_shared<CoverRequest>(this, cover_url_, cacheKey, revalidating);
+    cover_requests_.push_back(request);
+    request->Load();
+}
+
+void CoverItem::OnCoverLoaded(const CoverRequest *request, const char *data, int size) {
+    if (cover_ == nullptr) {
+        return;
+    }
+    uint64_t key = request->cache_key();
+    uint64_t contentHash = key != 0 ? lark::TextureCache::Hash(data, size) : 0;
+    // hold the lock till the texture is requested, so SetCoverUrl can't switch in between.
+    std::lock_guard<std::mutex> lock(cover_mutex_);
+    if (request->url() != cover_url_) {
+        LOGV("drop cover of old url %s", request->url().c_str());
+        return;
+    }
+    LOGV("load iamge success size %d", size);
+    if (key != 0 && lark::TextureCache::instance()->Validate(key, contentHash)) {
+        // source unchanged.
+        if (!request->revalidating()) {
+            cover_->LoadCachedTexture(key);
+        }
+        return;
     }
+    // new image or cold cache. decode and replace the cache entry.
+    cover_->LoadTexture(data, size, key);
 }
 
 void CoverItem::SetNormalBgColor(const glm::vec4& normalColor) {
@@ -149,33 +221,12 @@ void CoverItem::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeV
 //        border_->draw(projection, eye, view, lightDir);
         test_border_->Draw(eye, projection, eyeView);
     } else {
-        float z = 0.0F;
+        UpdateDepth();
         if (picked_) {
-            z = 0.05F;
-            auto ap = active_border_->GetPosition();
-            ap.z = z - 0.002F;
-            active_border_->set_position(ap);
             active_border_->Draw(eye, projection, eyeView);
 //            test_border_->set_position(ap);
 //            test_border_->Draw(eye, projection, eyeView);
         }
-        auto cp = cover_->GetPosition();
-        cp.z = z;
-        cover_->set_position(cp);
-
-        auto bp = bg_color_.GetPosition();
-        bp.z = z - 0.001F;
-        bg_color_.set_position(bp);
-
-        auto tp = title_.GetPosition();
-        tp.z = z;
-        title_.set_position(tp);
-
-        auto ap = app_type_icon_.GetPosition();
-        ap.z = z;
-        ap.z += 0.1;
-        app_type_icon_.set_position(ap);
-
         bg_color_.Draw(eye, projection, eyeView);
         title_.Draw(eye, projection, eyeView);
         cover_->Draw(eye, projection, eyeView);
@@ -183,6 +234,49 @@ void CoverItem::Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeV
     }
 }
 
+void CoverItem::DrawMultiview(const glm::mat4& projection, const glm::mat4& view) {
+    Object::DrawMultiview(projection, view);
+
+    if (is_empty_) {
+        test_border_->DrawMultiview(projection, view);
+    } else {
+        UpdateDepth();
+        if (picked_) {
+            active_border_->DrawMultiview(projection, view);
+        }
+        bg_color_.DrawMultiview(projection, view);
+        title_.DrawMultiview(projection, view);
+        cover_->DrawMultiview(projection, view);
+        app_type_icon_.DrawMultiview(projection, view);
+    }
+}
+
+void CoverItem::UpdateDepth() {
+    float z = 0.0F;
+    if (picked_) {
+        z = 0.05F;
+        auto ap = active_border_->GetPosition();
+        ap.z = z - 0.002F;
+        active_border_->set_position(ap);
+    }
+    auto cp = cover_->GetPosition();
+    cp.z = z;
+    cover_->set_position(cp);
+
+    auto bp = bg_color_.GetPosition();
+    bp.z = z - 0.001F;
+    bg_color_.set_position(bp);
+
+    auto tp = title_.GetPosition();
+    tp.z = z;
+    title_.set_position(tp);
+
+    auto ip = app_type_icon_.GetPosition();
+    ip.z = z;
+    ip.z += 0.1;
+    app_type_icon_.set_position(ip);
+}
+
 void CoverItem::HandleInput(glm::vec2 *point, int pointCount) {
     if (!Object::active()) {
         return;
@@ -226,17 +320,12 @@ void CoverItem::HandleInput(glm::vec2 *point, int pointCount) {
     }
 }
 
-void CoverItem::OnImageLoadSuccess(const char *data, int size) {
-    if (cover_ != nullptr) {
-        LOGV("load iamge success size %d", size);
-        cover_->LoadTexture(data, size);
+void CoverItem::OnImageCacheMissed(Image *image) {
+    if (!cover_url_.empty()) {
+        RequestCover(InitCoverCache() ? lark::TextureCache::Hash(cover_url_) : 0, false);
     }
 }
 
-void CoverItem::OnImageLoadFailed(const std::string &err) {
-    LOGW("load image failde %s", err.c_str());
-}
-
 void CoverItem::SetAppliType(larkAppliType type) {
     if (type == appli_type_) {
         return;
@@ -250,3 +339,31 @@ void CoverItem::SetAppliType(larkAppliType type) {
     }
     appli_type_ = type;
 }
+
+//
+// cover request
+//
+CoverItem::CoverRequest::CoverRequest(CoverItem *item, const std::string &url, uint64_t cacheKey, bool revalidating):
+    item_(item),
+    url_(url),
+    cache_key_(cacheKey),
+    revalidating_(revalidating),
+    loader_(this)
+{
+}
+
+CoverItem::CoverRequest::~CoverRequest() = default;
+
+void CoverItem::CoverRequest::Load() {
+    loader_.GetCoverAsync(url_);
+}
+
+void CoverItem::CoverRequest::OnImageLoadSuccess(const char *data, int size) {
+    item_->OnCoverLoaded(this, data, size);
+    done_ = true;
+}
+
+void CoverItem::CoverRequest::OnImageLoadFailed(const std::string &err) {
+    LOGW("load image failde %s %s", err.c_str(), url_.c_str());
+    done_ = true;
+}
@@ -6,6 +6,10 @@
 #define CLOUDLARK_OCULUS_DEMO_COVER_ITEM_H
 
 #include <string.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <object.h>
 #include <ui/component/border.h>
 #include <ui/component/image.h>
@@ -16,7 +20,7 @@
 #include "lark_xr/lk_common_types.h"
 
 class Navigation;
-class CoverItem: public lark::Object, public AABB, public lark::CoverLoader::CoverLoaderCallback {
+class CoverItem: public lark::Object, public AABB, public Image::ImageChangeCallback {
 public:
     static const int PICKED_NONE = -1;
 
@@ -37,6 +41,7 @@ public:
 
     // object
     void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView) override;
+    void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
     // aabb check
     virtual void HandleInput(glm::vec2 * point, int pointCount) override;
 
@@ -44,10 +49,43 @@ public:
     inline bool is_empty() { return is_empty_; }
     inline void set_is_empty(bool empty) { is_empty_ = empty; };
 
-    // cover loader
-    virtual void OnImageLoadSuccess(const char* data, int size) override;
-    virtual void OnImageLoadFailed(const std::string& err) override;
+    // image
+    virtual void OnImageInited(Image* image) override {}
+    virtual void OnImageCacheMissed(Image* image) override;
 private:
+    // one cover download, bound to the url and cache key it was requested for.
+    class CoverRequest: public lark::CoverLoader::CoverLoaderCallback {
+    public:
+        CoverRequest(CoverItem* item, const std::string& url, uint64_t cacheKey, bool revalidating);
+        ~CoverRequest();
+
+        void Load();
+
+        inline const std::string& url() const { return url_; }
+        inline uint64_t cache_key() const { return cache_key_; }
+        inline bool revalidating() const { return revalidating_; }
+        inline bool done() const { return done_; }
+
+        virtual void OnImageLoadSuccess(const char* data, int size) override;
+        virtual void OnImageLoadFailed(const std::string& err) override;
+    private:
+        CoverItem* item_;
+        std::string url_;
+        uint64_t cache_key_;
+        // cached cover shown, download checks it against the source.
+        bool revalidating_;
+        std::atomic<bool> done_ = {false};
+        lark::CoverLoader loader_;
+    };
+
+    // download the cover of cover_url_.
+    void RequestCover(uint64_t cacheKey, bool revalidating);
+    // loader thread. drops downloads of an old url.
+    void OnCoverLoaded(const CoverRequest* request, const char* data, int size);
+
+    // lift the picked item towards the viewer.
+    void UpdateDepth();
+
     Navigation* navigation_;
 
     glm::vec4 bg_color_dark_;
@@ -63,6 +101,11 @@ private:
     Text tail_;
     Text app_type_icon_;
     std::string cover_url_;
+    // guards cover_url_ against the loader threads.
+    std::mutex cover_mutex_;
+    // the item is reused across pages, a download may finish after the url changed.
+    // kept until finished, the sdk loader calls back on its own thread.
+    std::vector<std::shared_ptr<CoverRequest>> cover_requests_ = {};
     ColorBox bg_color_;
     std::shared_ptr<Image> cover_;
     std::shared_ptr<Image> border_;
@@ -73,7 +116,6 @@ private:
     GLuint cover_texture_id_;
 
     bool is_empty_;
-    lark::CoverLoader cover_loader_;
 
     int appli_type_ = larkAppliType::AppliType_VR;
 };
@@ -296,14 +296,15 @@ void Home::HandleInput(lark::Ray * rays, int rayCount) {
 }
 
 void Home::ChangePage(bool isDown) {
+    const lark::AppliPageInfo& pageInfo = app_list_.front().info;
     // already ended or first.
-    if ((isDown && !app_page_info_.hasNextPage) || (!isDown && !app_page_info_.hasPreviousPage))
+    if ((isDown && !pageInfo.hasNextPage) || (!isDown && !pageInfo.hasPreviousPage))
         return;
     if (isDown) {
-        app_list_task_.SetPage(app_page_info_.nextPage);
+        app_list_task_.SetPage(pageInfo.nextPage);
         UpdateAppList(1);
     } else {
-        app_list_task_.SetPage(app_page_info_.prePage);
+        app_list_task_.SetPage(pageInfo.prePage);
         UpdateAppList(-1);
     }
 }
@@ -321,11 +322,11 @@ void Home::Update() {
         }
         pre_check_app_item_change_ = now;
     }
-    {
-//        Poco::ScopedLock<Poco::Mutex> lock(update_applist_mutex_);
-        if (has_new_data_) {
-            UpdateAppList(0);
+    if (app_list_.Acquire()) {
+        if (empty_list_) {
+            empty_list_->set_active(app_list_.front().show_empty);
         }
+        UpdateAppList(0);
     }
     {
         if (need_update_region_info_ && setup_server_button_) {
@@ -360,6 +361,8 @@ void Home::Update() {
         std::lock_guard<std::mutex> lock(run_mode_change_mutex_);
         if (run_mode_change_) {
             UpdateRunMode();
+            // list may changed in teacher mode.
+            UpdateAppList(0);
             run_mode_change_ = false;
         }
     }
@@ -374,12 +377,13 @@ void Home::UpdateAppList(int page) {
     if (run_mode_ == VrRunMode_Teacher) {
         return;
     }
+    const lark::AppliPageInfo& pageInfo = app_list_.front().info;
     // self run mode.
 
-    total_page_num_ = app_page_info_.pages;
-    current_page_ = app_page_info_.pageNum - 1 + page;
+    total_page_num_ = pageInfo.pages;
+    current_page_ = pageInfo.pageNum - 1 + page;
     // clear app num when update page.
-    app_num_ = page == 0 ? app_page_info_.list.size() : 0;
+    app_num_ = page == 0 ? pageInfo.list.size() : 0;
 
     // update item
     for (int i = 0; i < MAX_PAGE_ITEM_NUM; i++) {
@@ -389,7 +393,7 @@ void Home::UpdateAppList(int page) {
             continue;
         }
 
-        lark::AppliInfo *item = &app_page_info_.list[i];
+        const lark::AppliInfo *item = &pageInfo.list[i];
         if (coverItem != nullptr) {
             coverItem->set_app_id(item->appliId);
             coverItem->set_is_empty(false);
@@ -428,10 +432,8 @@ void Home::UpdateAppList(int page) {
         }
     }
     // update page
-    page_down_button_->set_active(app_page_info_.hasNextPage);
-    page_up_button_->set_active(app_page_info_.hasPreviousPage);
-    // pullall data.
-    has_new_data_ = false;
+    page_down_button_->set_active(pageInfo.hasNextPage);
+    page_up_button_->set_active(pageInfo.hasPreviousPage);
 }
 
 void Home::UpdateClientId() {
@@ -460,14 +462,10 @@ void Home::OnAppListInfo(const std::vector<lark::AppliInfo> &appliInfo) {
 void Home::OnAppListPageInfo(const lark::AppliPageInfo& appliPageInfo) {
     // SetAppPageInfo(appliPageInfo);
 
-    {
-//        Poco::ScopedLock<Poco::Mutex> lock(update_applist_mutex_);
-        has_new_data_ = true;
-        app_page_info_ = appliPageInfo;
-    }
-    if (empty_list_) {
-        empty_list_->set_active(appliPageInfo.list.size() == 0);
-    }
+    app_list_.Modify([&appliPageInfo](AppListSnapshot& snapshot) {
+        snapshot.info = appliPageInfo;
+        snapshot.show_empty = appliPageInfo.list.empty();
+    });
     if (first_load_) {
         logo_loader_.SendAsync();
         first_load_ = false;
@@ -477,15 +475,11 @@ void Home::OnAppListPageInfo(const lark::AppliPageInfo& appliPageInfo) {
 void Home::OnFailed(const std::string &msg) {
     LOGV("============applist OnFailed %s", msg.c_str());
     Navigation::ShowToast(msg);
-    {
-//        Poco::ScopedLock<Poco::Mutex> lock(update_applist_mutex_);
-        has_new_data_ = true;
+    app_list_.Modify([](AppListSnapshot& snapshot) {
         // clear list
-        app_page_info_.list.clear();
-    }
-    if (empty_list_) {
-        empty_list_->set_active(false);
-    }
+        snapshot.info.list.clear();
+        snapshot.show_empty = false;
+    });
 }
 
 void Home::OnRunMode(lark::GetVrClientRunMode::ClientRunMode runMode) {
@@ -511,10 +505,10 @@ void Home::OnImageLoadFailed(const std::string &err) {
 }
 
 void Home::ResetAppPageInfo() {
-//    Poco::ScopedLock<Poco::Mutex> lock(update_applist_mutex_);
-    has_new_data_ = true;
-    // clear list
-    app_page_info_ = {};
+    app_list_.Modify([](AppListSnapshot& snapshot) {
+        // clear list
+        snapshot.info = {};
+    });
 
     app_list_task_.SetPage(1);
 }
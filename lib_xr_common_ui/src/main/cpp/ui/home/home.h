@@ -6,6 +6,7 @@
 #define CLOUDLARK_OCULUS_DEMO_HOME_H
 
 #include <object.h>
+#include <snapshot_buffer.h>
 #include <ui/component/button.h>
 #include <ui/setup_server/setup_server_addr.h>
 #include "ui/view.h"
@@ -117,9 +118,12 @@ private:
     bool first_load_ = true;
     bool load_success_ = false;
 
-//    Poco::Mutex update_applist_mutex_ = {};
-    bool has_new_data_ = false;
-    lark::AppliPageInfo app_page_info_ = {};
+    struct AppListSnapshot {
+        lark::AppliPageInfo info;
+        bool show_empty;
+    };
+    // written by app list task callbacks, read in Update on render thread.
+    lark::SnapshotBuffer<AppListSnapshot> app_list_;
 
     bool support_2d_ui_ = false;
 
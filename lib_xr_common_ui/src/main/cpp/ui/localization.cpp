@@ -82,6 +82,17 @@ namespace localization {
             ui_setup_advance: L"Advance Setup",
             ui_setup_normal: L"Normal Setup",
             ui_setup_advance_ffr_title: L"Fixed foveated rendering?",
+            ui_setup_advance_foveation_title: L"Local foveation",
+            ui_setup_advance_foveation_off: L"Off",
+            ui_setup_advance_foveation_low: L"Low",
+            ui_setup_advance_foveation_medium: L"Medium",
+            ui_setup_advance_foveation_high: L"High",
+            ui_setup_advance_foveation_dynamic: L"Dynamic",
+            ui_setup_advance_pose_filter_title: L"Pose extrapolation",
+            ui_setup_advance_pose_filter_runtime: L"Runtime",
+            ui_setup_advance_pose_filter_velocity: L"Velocity",
+            ui_setup_advance_pose_filter_acceleration: L"Acceleration",
+            ui_setup_advance_pose_filter_one_euro: L"One Euro",
             ui_setup_advance_report_fec_title: L"Report fec fail?",
             ui_setup_advance_use_h265_title: L"Enable H265?",
             ui_setup_advance_haptics_feedback_title: L"Enable haptics feedback?",
@@ -110,6 +121,7 @@ namespace localization {
             ui_menu_view_title: L"Quit CloudApp Now?",
             ui_menu_view_submit: L"Quit",
             ui_menu_view_cancle: L"Containue",
+            ui_menu_view_hud: L"Stats",
 
             ui_loading_tips_3d_quest: L"Press trigger and short press B/Y back to applist.",
             ui_loading_tips_3d: L"Press trigger and short press APP button back to applist.",
@@ -189,6 +201,17 @@ namespace localization {
             ui_setup_advance: L"高级设置",
             ui_setup_normal: L"普通设置",
             ui_setup_advance_ffr_title: L"是否开启固定注视点渲染？",
+            ui_setup_advance_foveation_title: L"本地注视点渲染",
+            ui_setup_advance_foveation_off: L"关闭",
+            ui_setup_advance_foveation_low: L"低",
+            ui_setup_advance_foveation_medium: L"中",
+            ui_setup_advance_foveation_high: L"高",
+            ui_setup_advance_foveation_dynamic: L"动态",
+            ui_setup_advance_pose_filter_title: L"姿态外推",
+            ui_setup_advance_pose_filter_runtime: L"运行时",
+            ui_setup_advance_pose_filter_velocity: L"匀速",
+            ui_setup_advance_pose_filter_acceleration: L"匀加速",
+            ui_setup_advance_pose_filter_one_euro: L"One Euro 滤波",
             ui_setup_advance_report_fec_title: L"开启FEC报告？",
             ui_setup_advance_use_h265_title: L"是否使用H265协议？",
             ui_setup_advance_haptics_feedback_title: L"是否开启手柄震动？",
@@ -217,6 +240,7 @@ namespace localization {
             ui_menu_view_title: L"确定退出当前云端应用？",
             ui_menu_view_submit: L"退出",
             ui_menu_view_cancle: L"继续",
+            ui_menu_view_hud: L"性能面板",
 
             ui_loading_tips_3d_quest: L"按住手柄扳机键并短按B或Y键可退出云端应用返回列表",
             ui_loading_tips_3d: L"按住手柄扳机键并短按APP键可退出云端应用返回列表",
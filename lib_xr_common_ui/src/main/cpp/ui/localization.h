@@ -165,6 +165,17 @@ namespace localization {
         std::wstring ui_setup_advance;
         std::wstring ui_setup_normal;
         std::wstring ui_setup_advance_ffr_title;
+        std::wstring ui_setup_advance_foveation_title;
+        std::wstring ui_setup_advance_foveation_off;
+        std::wstring ui_setup_advance_foveation_low;
+        std::wstring ui_setup_advance_foveation_medium;
+        std::wstring ui_setup_advance_foveation_high;
+        std::wstring ui_setup_advance_foveation_dynamic;
+        std::wstring ui_setup_advance_pose_filter_title;
+        std::wstring ui_setup_advance_pose_filter_runtime;
+        std::wstring ui_setup_advance_pose_filter_velocity;
+        std::wstring ui_setup_advance_pose_filter_acceleration;
+        std::wstring ui_setup_advance_pose_filter_one_euro;
         std::wstring ui_setup_advance_report_fec_title;
         std::wstring ui_setup_advance_use_h265_title;
         std::wstring ui_setup_advance_haptics_feedback_title;
@@ -193,6 +204,7 @@ namespace localization {
         std::wstring ui_menu_view_title;
         std::wstring ui_menu_view_submit;
         std::wstring ui_menu_view_cancle;
+        std::wstring ui_menu_view_hud;
 
         std::wstring ui_loading_tips_3d_quest;
         std::wstring ui_loading_tips_3d;
@@ -53,6 +53,18 @@ void MenuView::Init() {
         AddChild(btn_cancle_);
     }
 
+#ifdef ENABLE_PERF_HUD
+    {
+        glm::vec3 p(0.1,0.5,0);
+        btn_hud_ = std::make_shared<TextButton>(localization::Loader::getResource().ui_menu_view_hud);
+        btn_hud_->Move(p);
+        btn_hud_->SetFontSize(24);
+        btn_hud_->SetAABBPositon(glm::vec2(p.x, p.y));
+        PushAABB(btn_hud_.get());
+        AddChild(btn_hud_);
+    }
+#endif
+
     // advance btn
 //    {
 //        glm::vec3 p(0, 0, 0);
@@ -97,5 +109,12 @@ void MenuView::Update() {
         }
     }
 
+    if (btn_hud_ && btn_hud_->picked() && Input::IsInputEnter()) {
+        LOGV("Menu view on toggle hud");
+        if (callback_ != nullptr && !update_active_this_frame_) {
+            callback_->OnMenuViewToggleHud();
+        }
+    }
+
     update_active_this_frame_ = false;
 }
\ No newline at end of file
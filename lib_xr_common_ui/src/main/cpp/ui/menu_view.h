@@ -14,6 +14,8 @@ public:
     class Callback {
     public:
         virtual void OnMenuViewSelect(bool submit) = 0;
+        // show or hide performance hud. only when built with ENABLE_PERF_HUD.
+        virtual void OnMenuViewToggleHud() {};
     };
 
     MenuView(Callback* callback);
@@ -36,6 +38,7 @@ private:
     std::shared_ptr<TextButton> advance_btn_;
     std::shared_ptr<TextButton> btn_cancle_;
     std::shared_ptr<TextButton> btn_submit_;
+    std::shared_ptr<TextButton> btn_hud_;
     std::shared_ptr<ColorBox> bg_;
     Callback* callback_;
     bool update_active_this_frame_ = false;
@@ -0,0 +1,338 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/15.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <lark_xr/xr_config.h>
+#include <lark_xr/xr_latency_collector.h>
+#include "perf_hud.h"
+#include "vertex_array_object.h"
+#include "texture.h"
+#include "env_context.h"
+#include "telemetry.h"
+#include "log.h"
+#include "utils.h"
+
+#define LOG_TAG "perf_hud"
+
+namespace {
+    const int GLYPH_WIDTH = 5;
+    const int GLYPH_HEIGHT = 7;
+    const int GLYPH_SCALE = 2;
+    const int GLYPH_ADVANCE = (GLYPH_WIDTH + 1) * GLYPH_SCALE;
+
+    const int TEXT_X = 6;
+    const int GRAPH_X = 128;
+    const int GRAPH_WIDTH = 120;
+    const int GRAPH_PADDING = 4;
+
+    // rgba in memory order.
+    inline uint32_t Rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+        return (a << 24) | (b << 16) | (g << 8) | r;
+    }
+    const uint32_t COLOR_BACKGROUND = Rgba(0x00, 0x05, 0x30, 0xC0);
+    const uint32_t COLOR_GRID = Rgba(0x30, 0x38, 0x70, 0xFF);
+    const uint32_t COLOR_TEXT = Rgba(0xD7, 0xE1, 0xFF, 0xFF);
+    const uint32_t COLOR_GRAPH = Rgba(0x40, 0xE0, 0x80, 0xFF);
+    const uint32_t COLOR_WARNING = Rgba(0xFF, 0x50, 0x40, 0xFF);
+
+    // 5x7 bitmap font, one byte per row, low 5 bits.
+    struct Glyph {
+        char c;
+        uint8_t rows[GLYPH_HEIGHT];
+    };
+    const Glyph FONT[] = {
+        {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+        {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+        {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+        {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+        {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+        {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+        {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+        {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+        {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+        {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+        {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+        {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+        {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+        {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+        {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+        {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+        {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+        {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+        {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+        {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+        {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+        {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+        {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+        {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+        {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+        {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+        {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+        {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+        {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+        {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+        {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+        {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+        {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+        {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+        {'Y', {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04}},
+        {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+        {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+        {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+        {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+        {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+        {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    };
+
+    const Glyph* FindGlyph(char c) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        for (const auto & glyph : FONT) {
+            if (glyph.c == c) {
+                return &glyph;
+            }
+        }
+        return nullptr;
+    }
+}
+
+PerfHud::PerfHud() {
+    name_ = LOG_TAG;
+    enable_ = false;
+    active_ = false;
+
+    LoadShaderFromAsset(Context::instance()->asset_manager(),
+                        "shader/vertex/image_vertex.glsl", "shader/fragment/image_fragment.glsl");
+    if (has_error_) {
+        LOGW("loadShaderFromAsset perf hud has error");
+        return;
+    }
+    model_location_ = shader_->GetUniformLocation("uModel");
+    view_location_ = shader_->GetUniformLocation("uView");
+    projection_location_ = shader_->GetUniformLocation("uProjection");
+
+    LoadMultiviewShaderFromAsset(Context::instance()->asset_manager(),
+                                 "shader/vertex/image_multiview_vertex.glsl", "shader/fragment/image_fragment.glsl");
+    if (multiview_shader_) {
+        multiview_model_location_ = multiview_shader_->GetUniformLocation("uModel");
+    }
+
+    // quad never changes, only texture content.
+    const float w = WIDTH;
+    const float h = WIDTH * TEXTURE_HEIGHT / TEXTURE_WIDTH;
+    const GLfloat vertices[] = {
+            0, h, 0, 0.0, 0.0,
+            0, 0, 0, 0.0, 1.0,
+            w, 0, 0, 1.0, 1.0,
+
+            0, h, 0, 0.0, 0.0,
+            w, 0, 0, 1.0, 1.0,
+            w, h, 0, 1.0, 0.0
+    };
+    vao_ = std::make_shared<lark::VertexArrayObject>(true, false);
+    vao_->BindVAO();
+    vao_->BindArrayBuffer();
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    int stride = (2 + 3) * sizeof(float);
+    GLuint offset = 0;
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (const void*) offset);
+    offset += sizeof(float) * 3;
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (const void*) offset);
+    vao_->UnbindVAO();
+    vao_->UnbindArrayBuffer();
+
+    pixels_.resize(TEXTURE_WIDTH * TEXTURE_HEIGHT);
+    Redraw();
+    enable_ = true;
+}
+
+PerfHud::~PerfHud() = default;
+
+void PerfHud::Update() {
+    Object::Update();
+    uint64_t now = utils::GetTimestampNs();
+    if (now - last_sample_ns_ < UPDATE_INTERVAL_NS) {
+        return;
+    }
+    last_sample_ns_ = now;
+    Sample();
+    Redraw();
+}
+
+void PerfHud::Sample() {
+    lark::XRLatencyCollector& collector = lark::XRLatencyCollector::Instance();
+    Telemetry* telemetry = Telemetry::instance();
+
+    float values[Row_Count] = {};
+    // lark stream first, then cloudxr stats.
+    uint32_t fps = collector.frames_in_second();
+    values[Row_Fps] = fps > 0 ? fps : telemetry->last(Telemetry::Metric_CloudXRFramesPerSecond);
+    uint64_t kbps = telemetry->last(Telemetry::Metric_CloudXRBandwidthKbps);
+    // lark sdk does not report received bitrate, show the configured one.
+    values[Row_Bitrate] = kbps > 0 ? kbps : lark::XRConfig::bitrate;
+    uint64_t rtt = telemetry->last(Telemetry::Metric_CloudXRRoundTripMs);
+    rtt_from_cloudxr_ = rtt > 0;
+    // lark sdk has no stage breakdown, show the measured pose sent to decoded frame ready.
+    values[Row_Rtt] = rtt_from_cloudxr_ ? rtt : telemetry->last(Telemetry::Metric_TrackingToFrameReady) / 1000.0F;
+    values[Row_PacketsLost] = collector.packets_lost_in_second();
+    values[Row_FecFailure] = collector.fec_failure_in_second();
+    values[Row_Submit] = telemetry->last(Telemetry::Metric_TrackingToSubmit) / 1000.0F;
+
+    for (int i = 0; i < Row_Count; i++) {
+        Series& series = series_[i];
+        series.values[series.head] = values[i];
+        series.head = (series.head + 1) % HISTORY;
+        series.count = std::min(series.count + 1, HISTORY);
+    }
+}
+
+float PerfHud::LastValue(const Series &series) {
+    if (series.count == 0) {
+        return 0;
+    }
+    return series.values[(series.head - 1 + HISTORY) % HISTORY];
+}
+
+void PerfHud::Redraw() {
+    std::fill(pixels_.begin(), pixels_.end(), COLOR_BACKGROUND);
+
+    char buf[32];
+    for (int i = 0; i < Row_Count; i++) {
+        const Series& series = series_[i];
+        float value = LastValue(series);
+        const char* label = "";
+        bool warning = false;
+        switch (i) {
+            case Row_Fps:         label = "FPS"; break;
+            case Row_Bitrate:     label = "KBPS"; break;
+            case Row_Rtt:         label = rtt_from_cloudxr_ ? "RTT" : "RECV"; break;
+            case Row_PacketsLost: label = "LOSS"; warning = value > 0; break;
+            case Row_FecFailure:  label = "FEC"; warning = value > 0; break;
+            case Row_Submit:      label = "SUB"; break;
+            default: break;
+        }
+        if (i == Row_Rtt || i == Row_Submit) {
+            snprintf(buf, sizeof(buf), value < 100 ? "%-4s %.1f" : "%-4s %.0f", label, value);
+        } else {
+            snprintf(buf, sizeof(buf), "%-4s %.0f", label, value);
+        }
+
+        int y = i * ROW_HEIGHT;
+        if (i > 0) {
+            FillRect(0, y, TEXTURE_WIDTH, 1, COLOR_GRID);
+        }
+        DrawText(TEXT_X, y + (ROW_HEIGHT - GLYPH_HEIGHT * GLYPH_SCALE) / 2, buf,
+                 warning ? COLOR_WARNING : COLOR_TEXT);
+        DrawSparkline(GRAPH_X, y + GRAPH_PADDING, GRAPH_WIDTH, ROW_HEIGHT - GRAPH_PADDING * 2,
+                      series, warning ? COLOR_WARNING : COLOR_GRAPH);
+    }
+    need_upload_ = true;
+}
+
+void PerfHud::FillRect(int x, int y, int w, int h, uint32_t color) {
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + w, TEXTURE_WIDTH);
+    int y1 = std::min(y + h, TEXTURE_HEIGHT);
+    for (int row = y0; row < y1; row++) {
+        uint32_t* line = &pixels_[row * TEXTURE_WIDTH];
+        std::fill(line + x0, line + std::max(x0, x1), color);
+    }
+}
+
+void PerfHud::DrawText(int x, int y, const char *text, uint32_t color) {
+    for (const char* c = text; *c != '\0'; c++, x += GLYPH_ADVANCE) {
+        const Glyph* glyph = FindGlyph(*c);
+        if (glyph == nullptr) {
+            continue;
+        }
+        for (int row = 0; row < GLYPH_HEIGHT; row++) {
+            for (int col = 0; col < GLYPH_WIDTH; col++) {
+                if (glyph->rows[row] & (1 << (GLYPH_WIDTH - 1 - col))) {
+                    FillRect(x + col * GLYPH_SCALE, y + row * GLYPH_SCALE, GLYPH_SCALE, GLYPH_SCALE, color);
+                }
+            }
+        }
+    }
+}
+
+void PerfHud::DrawSparkline(int x, int y, int w, int h, const Series &series, uint32_t color) {
+    if (series.count == 0) {
+        return;
+    }
+    float max = 1.0F;
+    for (int i = 0; i < series.count; i++) {
+        max = std::max(max, series.values[i]);
+    }
+    int step = std::max(w / HISTORY, 1);
+    int start = (series.head - series.count + HISTORY) % HISTORY;
+    int lastY = -1;
+    for (int i = 0; i < series.count; i++) {
+        float value = series.values[(start + i) % HISTORY];
+        int py = y + h - 1 - static_cast<int>(value / max * static_cast<float>(h - 1));
+        int px = x + w - (series.count - i) * step;
+        // connect to last point with a vertical span.
+        int top = lastY < 0 ? py : std::min(py, lastY);
+        int bottom = lastY < 0 ? py : std::max(py, lastY);
+        FillRect(px, top, step, bottom - top + 1, color);
+        lastY = py;
+    }
+}
+
+void PerfHud::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &view) {
+    Object::Draw(eye, projection, view);
+    if (has_error_ || !enable_ || !UploadTexture()) {
+        return;
+    }
+
+    shader_->UseProgram();
+    glUniformMatrix4fv(model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+    glUniformMatrix4fv(view_location_, 1, GL_FALSE, glm::value_ptr(view));
+    glUniformMatrix4fv(projection_location_, 1, GL_FALSE, glm::value_ptr(projection));
+
+    lark::RenderState::instance()->ActiveTexture(GL_TEXTURE0);
+    texture_->BindTexture();
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    shader_->UnUseProgram();
+    vao_->UnbindVAO();
+    texture_->UnBindTexture();
+}
+
+void PerfHud::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+    Object::DrawMultiview(projection, view);
+    if (has_error_ || !enable_ || !multiview_shader_ || !UploadTexture()) {
+        return;
+    }
+
+    multiview_shader_->UseProgram();
+    glUniformMatrix4fv(multiview_model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+
+    lark::RenderState::instance()->ActiveTexture(GL_TEXTURE0);
+    texture_->BindTexture();
+    vao_->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    multiview_shader_->UnUseProgram();
+    vao_->UnbindVAO();
+    texture_->UnBindTexture();
+}
+
+bool PerfHud::UploadTexture() {
+    if (need_upload_) {
+        if (!texture_) {
+            texture_.reset(lark::Texture::LoadTexture(reinterpret_cast<const uint8_t*>(pixels_.data()), GL_RGBA,
+                                                      TEXTURE_WIDTH, TEXTURE_HEIGHT, TEXTURE_WIDTH * 4));
+        } else {
+            texture_->BindTexture();
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TEXTURE_WIDTH, TEXTURE_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels_.data());
+            texture_->UnBindTexture();
+        }
+        need_upload_ = false;
+    }
+    return texture_ != nullptr;
+}
@@ -0,0 +1,80 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/15.
+//
+
+#ifndef CLOUDLARKXR_PERF_HUD_H
+#define CLOUDLARKXR_PERF_HUD_H
+
+#include <vector>
+#include "object.h"
+
+//
+// in-headset performance hud. counters and sparkline graphs are drawn on cpu into one
+// rgba texture which is uploaded at most every UPDATE_INTERVAL_NS, the whole hud is a
+// single textured quad per eye, or one quad for both eyes with multiview.
+// only built with ENABLE_PERF_HUD. render thread only.
+//
+class PerfHud: public lark::Object {
+public:
+    enum Row {
+        Row_Fps = 0,
+        Row_Bitrate,
+        Row_Rtt,
+        Row_PacketsLost,
+        Row_FecFailure,
+        // pose sent to cloud frame submitted, ms.
+        Row_Submit,
+        Row_Count,
+    };
+
+    static const int TEXTURE_WIDTH = 256;
+    static const int ROW_HEIGHT = 32;
+    static const int TEXTURE_HEIGHT = ROW_HEIGHT * Row_Count;
+    // samples in sparkline. 30 seconds.
+    static const int HISTORY = 60;
+    static const uint64_t UPDATE_INTERVAL_NS = 500ULL * 1000 * 1000;
+    // quad width in meters.
+    static constexpr float WIDTH = 0.48F;
+
+    PerfHud();
+    ~PerfHud() override;
+
+    inline void Toggle() { set_active(!active()); }
+
+    // sample stats and redraw texture when interval passed.
+    void Update() override;
+    void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& view) override;
+    void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
+private:
+    struct Series {
+        float values[HISTORY];
+        int head;
+        int count;
+    };
+
+    static float LastValue(const Series& series);
+
+    void Sample();
+    void Redraw();
+    // upload pending pixels. return false when no texture yet.
+    bool UploadTexture();
+
+    void FillRect(int x, int y, int w, int h, uint32_t color);
+    void DrawText(int x, int y, const char* text, uint32_t color);
+    void DrawSparkline(int x, int y, int w, int h, const Series& series, uint32_t color);
+
+    int model_location_ = 0;
+    int view_location_ = 0;
+    int projection_location_ = 0;
+    int multiview_model_location_ = 0;
+
+    Series series_[Row_Count] = {};
+    // pose sent to decoded frame ready when no cloudxr rtt.
+    bool rtt_from_cloudxr_ = false;
+
+    std::vector<uint32_t> pixels_;
+    bool need_upload_ = false;
+    uint64_t last_sample_ns_ = 0;
+};
+
+#endif //CLOUDLARKXR_PERF_HUD_H
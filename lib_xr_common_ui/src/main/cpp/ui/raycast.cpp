@@ -74,6 +74,12 @@ void Raycast::Init() {
 
     color_loaction_ = shader_->GetUniformLocation("uColor");
 
+    LoadMultiviewShaderFromAsset(Context::instance()->asset_manager(), "shader/vertex/color_multiview_vertex.glsl", "shader/fragment/color_fragment.glsl");
+    if (multiview_shader_) {
+        multiview_model_location_ = multiview_shader_->GetUniformLocation("uModel");
+        multiview_color_location_ = multiview_shader_->GetUniformLocation("uColor");
+    }
+
     auto* vao = new lark::VertexArrayObject(true, true);
     vao_.reset(vao);
     // init texture vao
@@ -116,3 +122,21 @@ Raycast::Draw(Eye eye, const glm::mat4 &projection, const glm::mat4 &eyeView) {
     shader_->UnUseProgram();
     vao->UnbindVAO();
 }
+
+void
+Raycast::DrawMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+    Object::DrawMultiview(projection, view);
+
+    if (!enable_ || !multiview_shader_)
+        return;
+
+    lark::VertexArrayObject * vao = vao_.get();
+    multiview_shader_->UseProgram();
+    glUniformMatrix4fv(multiview_model_location_, 1, GL_FALSE, glm::value_ptr(GetTransforms()));
+    // color
+    glUniform4fv(multiview_color_location_, 1, glm::value_ptr(color_));
+    vao->BindVAO();
+    glDrawArrays(GL_TRIANGLES, 0, 12);
+    multiview_shader_->UnUseProgram();
+    vao->UnbindVAO();
+}
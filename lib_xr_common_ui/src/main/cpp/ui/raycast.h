@@ -13,6 +13,7 @@ public:
 
     inline void set_color(const glm::vec4& color) { color_ = color; };
     virtual void Draw(Eye eye, const glm::mat4& projection, const glm::mat4& eyeView) override;
+    virtual void DrawMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 private:
     void Init();
     void InitVAO(void *vertices, int verticesSize, lark::VertexArrayObject *vao);
@@ -24,6 +25,9 @@ private:
     int projection_location_ = 0;
 
     int color_loaction_ = 0;
+
+    int multiview_model_location_ = 0;
+    int multiview_color_location_ = 0;
 };
 
 
@@ -0,0 +1,40 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_FOVEATION_SETUP_H
+#define CLOUDLARKXR_FOVEATION_SETUP_H
+
+#include <ui/component/button.h>
+#include "item_base.h"
+
+//
+// local fixed foveated rendering level of the eye swapchains.
+// only added when Application::SupportFoveation.
+//
+class FoveationSetup: public ItemBase {
+public:
+    FoveationSetup(int group);
+    ~FoveationSetup();
+
+    virtual void Reset() override;
+
+    // handle set postion.
+    virtual void SetAABBPositon(const glm::vec2 & position) override;
+    // handle input
+    virtual void HandleInput(glm::vec2 * point, int pointCount) override;
+
+    virtual void Enter() override;
+    virtual void Leave() override;
+    virtual void FreshData() override;
+private:
+    void OnChange(int index);
+    void Set(int index);
+    void UpdateColor();
+
+    std::vector<std::shared_ptr<TextButton>> buttons_ = {};
+    int current_index_ = 0;
+};
+
+
+#endif //CLOUDLARKXR_FOVEATION_SETUP_H
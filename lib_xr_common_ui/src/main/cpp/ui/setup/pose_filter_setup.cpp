@@ -0,0 +1,110 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "pose_filter_setup.h"
+#include <log.h>
+#include <input.h>
+#include <ui/localization.h>
+#include "application.h"
+
+#define LOG_TAG "pose_filter_setup"
+
+namespace {
+    const glm::vec4 COLOR_ACTIVE = glm::vec4(1.0F, 1.0F, 1.0F, 1.0F);
+    const glm::vec4 COLOR_UN_ACTIVE = glm::vec4(0.843, 0.882, 1.0, 0.5);
+
+    constexpr float RES_POSITION_X = 0.13F;
+    constexpr float RES_POSITION_Y = 1.0F;
+    constexpr float RES_POSITION_Z = 0.01F;
+    constexpr float RES_SKIP = 0.22;
+
+    const int MODE_COUNT = 4;
+}
+
+PoseFilterSetup::PoseFilterSetup(int group): ItemBase(group) {
+    const localization::LocalResource& res = localization::Loader::getResource();
+    setTitle(res.ui_setup_advance_pose_filter_title);
+
+    // same order as PoseFilter::Mode.
+    const std::wstring tags[MODE_COUNT] = {
+            res.ui_setup_advance_pose_filter_runtime,
+            res.ui_setup_advance_pose_filter_velocity,
+            res.ui_setup_advance_pose_filter_acceleration,
+            res.ui_setup_advance_pose_filter_one_euro,
+    };
+    for (int i = 0; i < MODE_COUNT; i++) {
+        std::shared_ptr<TextButton> btn = std::make_shared<TextButton>(tags[i]);
+        btn->SetFontSize(26);
+        btn->Move(Base::position_.x + RES_POSITION_X, RES_POSITION_Y - i * RES_SKIP, RES_POSITION_Z);
+        PushAABB(btn.get());
+        AddChild(btn);
+        buttons_.push_back(btn);
+    }
+}
+
+PoseFilterSetup::~PoseFilterSetup() = default;
+
+void PoseFilterSetup::Reset() {
+    Set(PoseFilter::Mode_Runtime);
+}
+
+void PoseFilterSetup::SetAABBPositon(const glm::vec2 &position) {
+    AABB::SetAABBPositon(position);
+    for (int i = 0; i < buttons_.size(); i++) {
+        buttons_[i]->SetAABBPositon(glm::vec2(position.x + RES_POSITION_X, position.y + RES_POSITION_Y - i * RES_SKIP));
+    }
+}
+
+void PoseFilterSetup::HandleInput(glm::vec2 *point, int pointCount) {
+    ItemBase::HandleInput(point, pointCount);
+
+    // sync z.
+    float z = Base::position_.z + 0.01F;
+
+    for (int i = 0; i < buttons_.size(); i++) {
+        buttons_[i]->SetPositionZ(z);
+        if (buttons_[i]->picked() && Input::IsInputEnter()) {
+            OnChange(i);
+        }
+    }
+}
+
+void PoseFilterSetup::Enter() {
+    FreshData();
+}
+
+void PoseFilterSetup::Leave() {
+
+}
+
+void PoseFilterSetup::FreshData() {
+    if (Application::instance()) {
+        current_index_ = Application::instance()->pose_filter().mode();
+    }
+    UpdateColor();
+}
+
+void PoseFilterSetup::OnChange(int index) {
+    if (index != current_index_) {
+        Set(index);
+    }
+}
+
+void PoseFilterSetup::Set(int index) {
+    if (index < 0 || index >= buttons_.size()) {
+        LOGW("set pose filter failed. outsize index %d", index);
+        return;
+    }
+    current_index_ = index;
+    if (Application::instance()) {
+        Application::instance()->pose_filter().set_mode(static_cast<PoseFilter::Mode>(index));
+    }
+    UpdateColor();
+}
+
+void PoseFilterSetup::UpdateColor() {
+    for (int i = 0; i < buttons_.size(); i++) {
+        buttons_[i]->set_color(i == current_index_ ? COLOR_ACTIVE : COLOR_UN_ACTIVE);
+    }
+}
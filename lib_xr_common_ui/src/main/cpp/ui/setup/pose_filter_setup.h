@@ -0,0 +1,40 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_POSE_FILTER_SETUP_H
+#define CLOUDLARKXR_POSE_FILTER_SETUP_H
+
+#include <ui/component/button.h>
+#include "item_base.h"
+
+//
+// client side extrapolation of the poses sent to the cloud. see PoseFilter::Mode.
+// only added when Application::SupportPoseFilter.
+//
+class PoseFilterSetup: public ItemBase {
+public:
+    PoseFilterSetup(int group);
+    ~PoseFilterSetup();
+
+    virtual void Reset() override;
+
+    // handle set postion.
+    virtual void SetAABBPositon(const glm::vec2 & position) override;
+    // handle input
+    virtual void HandleInput(glm::vec2 * point, int pointCount) override;
+
+    virtual void Enter() override;
+    virtual void Leave() override;
+    virtual void FreshData() override;
+private:
+    void OnChange(int index);
+    void Set(int index);
+    void UpdateColor();
+
+    std::vector<std::shared_ptr<TextButton>> buttons_ = {};
+    int current_index_ = 0;
+};
+
+
+#endif //CLOUDLARKXR_POSE_FILTER_SETUP_H
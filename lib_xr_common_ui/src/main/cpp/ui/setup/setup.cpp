@@ -3,6 +3,7 @@
 //
 
 #include <ui/localization.h>
+#include "application.h"
 #include "setup.h"
 
 using namespace lark;
@@ -173,6 +174,30 @@ void Setup::Init() {
         AddChild(use_10bitencoder_);
         items_.push_back(use_10bitencoder_);
     }
+    // row3 below ffr, runtime may not support local foveation.
+    if (Application::instance() && Application::instance()->SupportFoveation()) {
+        glm::vec3 p(0.075F - 0.8, -0.4F - 1.7F * 2, 0);
+        foveation_setup_ = std::make_shared<FoveationSetup>(SetupGroup_Advance);
+        foveation_setup_->Move(p);
+        // add to aabb.
+        foveation_setup_->SetAABBPositon(glm::vec2(p.x, p.y));
+        foveation_setup_->set_active(false);
+        PushAABB(foveation_setup_.get());
+        AddChild(foveation_setup_);
+        items_.push_back(foveation_setup_);
+    }
+    // row3 below fps, only apps that extrapolate the sent poses.
+    if (Application::instance() && Application::instance()->SupportPoseFilter()) {
+        glm::vec3 p(-2.425F - 0.8, -0.4F - 1.7F * 2, 0);
+        pose_filter_setup_ = std::make_shared<PoseFilterSetup>(SetupGroup_Advance);
+        pose_filter_setup_->Move(p);
+        // add to aabb.
+        pose_filter_setup_->SetAABBPositon(glm::vec2(p.x, p.y));
+        pose_filter_setup_->set_active(false);
+        PushAABB(pose_filter_setup_.get());
+        AddChild(pose_filter_setup_);
+        items_.push_back(pose_filter_setup_);
+    }
 
     // reset btn.
     {
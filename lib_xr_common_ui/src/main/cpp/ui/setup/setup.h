@@ -15,6 +15,8 @@
 #include "fps.h"
 #include "haptics_feedback.h"
 #include "ffr_setup.h"
+#include "foveation_setup.h"
+#include "pose_filter_setup.h"
 #include "fec_report.h"
 #include "use_10bitencode.h"
 #include "quick_config_setup.h"
@@ -57,6 +59,8 @@ private:
     std::shared_ptr<KCPSetup> kcp_setup_;
     std::shared_ptr<H265Setup> h265_setup_;
     std::shared_ptr<FFRSetup> ffr_setup_;
+    std::shared_ptr<FoveationSetup> foveation_setup_;
+    std::shared_ptr<PoseFilterSetup> pose_filter_setup_;
     std::shared_ptr<Fps> fps_;
     std::shared_ptr<FECReport> fec_;
     std::shared_ptr<Use10BitEncode> use_10bitencoder_;
@@ -0,0 +1,272 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <log.h>
+#include "lark_xr/xr_client.h"
+#include "region_prober.h"
+
+#define LOG_TAG "region_prober"
+
+namespace {
+    std::string GetCachePath(const std::string& dataPath) {
+        return dataPath + "/larkxr/region_cache";
+    }
+}
+
+RegionProber::RegionProber(Callback *callback): callback_(callback) {
+}
+
+RegionProber::~RegionProber() {
+    Stop();
+}
+
+void RegionProber::Start(const std::vector<lark::RegionInfo> &regions) {
+    Stop();
+    std::vector<std::shared_ptr<Attempt>> attempts;
+    uint32_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = ++generation_;
+        done_ = regions.empty();
+        regions_ = regions;
+        samples_.assign(regions.size(), {});
+        lost_.assign(regions.size(), 0);
+        for (size_t i = 0; i < regions.size(); i++) {
+            attempts.push_back(std::make_shared<Attempt>(this, generation_, i));
+        }
+        attempts_ = attempts;
+    }
+    // all regions at once, next sample of a region starts when the last one answered.
+    for (size_t i = 0; i < attempts.size(); i++) {
+        if (!attempts[i]->Connect(regions[i])) {
+            OnSample(generation, i, 0);
+        }
+    }
+}
+
+void RegionProber::Stop() {
+    std::vector<std::shared_ptr<Attempt>> attempts;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+        done_ = true;
+        attempts.swap(attempts_);
+    }
+    // close without lock, rtt test threads may wait for it in OnSample.
+    for (auto & attempt : attempts) {
+        attempt->Close();
+    }
+}
+
+void RegionProber::OnSample(uint32_t generation, size_t region, uint64_t rtt) {
+    std::shared_ptr<Attempt> next = {};
+    lark::RegionInfo info = {};
+    std::vector<Result> results = {};
+    int best = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_ || done_ || region >= regions_.size()) {
+            return;
+        }
+        if (rtt != 0) {
+            samples_[region].push_back(rtt);
+        } else {
+            lost_[region]++;
+        }
+
+        if (IsFinished()) {
+            done_ = true;
+            for (size_t i = 0; i < regions_.size(); i++) {
+                results.push_back(GetResult(regions_[i], samples_[i], lost_[i]));
+                const Result& res = results.back();
+                LOGV("region %s median %ld jitter %ld samples %d lost %d", res.info.regionName.c_str(),
+                     res.median, res.jitter, res.samples, res.lost);
+                if (res.samples > 0 && (best < 0 || res.median < results[best].median)) {
+                    best = static_cast<int>(i);
+                }
+            }
+        } else if (samples_[region].size() + lost_[region] < SAMPLES) {
+            next = std::make_shared<Attempt>(this, generation_, region);
+            info = regions_[region];
+            attempts_.push_back(next);
+        }
+    }
+    if (next && !next->Connect(info)) {
+        OnSample(generation, region, 0);
+    }
+    if (!results.empty() && callback_) {
+        callback_->OnRegionProbeDone(results, best);
+    }
+}
+
+bool RegionProber::IsFinished() const {
+    bool allDone = true;
+    for (size_t i = 0; i < regions_.size(); i++) {
+        allDone &= samples_[i].size() + lost_[i] >= SAMPLES;
+    }
+    if (allDone) {
+        return true;
+    }
+
+    // clear winner, the slowest sample of the leader beats the fastest of every other region.
+    int leader = -1;
+    uint64_t leaderMedian = 0;
+    for (size_t i = 0; i < regions_.size(); i++) {
+        if (samples_[i].size() < MIN_SAMPLES) {
+            continue;
+        }
+        uint64_t median = GetResult(regions_[i], samples_[i], lost_[i]).median;
+        if (leader < 0 || median < leaderMedian) {
+            leader = static_cast<int>(i);
+            leaderMedian = median;
+        }
+    }
+    if (leader < 0) {
+        return false;
+    }
+    uint64_t leaderMax = *std::max_element(samples_[leader].begin(), samples_[leader].end());
+    for (size_t i = 0; i < regions_.size(); i++) {
+        if (static_cast<int>(i) == leader) {
+            continue;
+        }
+        if (samples_[i].empty()) {
+            // no answer yet, only lost ones can be given up.
+            if (lost_[i] < SAMPLES) {
+                return false;
+            }
+            continue;
+        }
+        if (*std::min_element(samples_[i].begin(), samples_[i].end()) <= leaderMax) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RegionProber::Result RegionProber::GetResult(const lark::RegionInfo &info, const std::vector<uint64_t> &samples,
+                                             uint32_t lost) {
+    Result result = {};
+    result.info = info;
+    result.lost = lost;
+    std::vector<uint64_t> sorted;
+    for (auto rtt : samples) {
+        if (rtt != 0) {
+            sorted.push_back(rtt);
+        } else {
+            result.lost++;
+        }
+    }
+    result.samples = static_cast<uint32_t>(sorted.size());
+    if (sorted.empty()) {
+        result.median = RTT_FAILED;
+        return result;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    result.median = sorted[sorted.size() / 2];
+    uint64_t deviation = 0;
+    for (auto rtt : sorted) {
+        deviation += rtt > result.median ? rtt - result.median : result.median - rtt;
+    }
+    result.jitter = deviation / sorted.size();
+    return result;
+}
+
+bool RegionProber::LoadCache(const std::string &dataPath, const std::string &server, CacheEntry *entry) {
+    FILE* file = fopen(GetCachePath(dataPath).c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char cachedServer[256] = {};
+    char regionId[128] = {};
+    unsigned long long rtt = 0;
+    long long timestamp = 0;
+    int count = fscanf(file, "%255s %127s %llu %lld", cachedServer, regionId, &rtt, &timestamp);
+    fclose(file);
+    if (count != 4 || server != cachedServer) {
+        return false;
+    }
+    long long age = static_cast<long long>(time(nullptr)) - timestamp;
+    if (age < 0 || age > static_cast<long long>(CACHE_TTL_SECONDS)) {
+        return false;
+    }
+    entry->server = cachedServer;
+    entry->regionId = regionId;
+    entry->rtt = rtt;
+    return true;
+}
+
+bool RegionProber::SaveCache(const std::string &dataPath, const CacheEntry &entry) {
+    if (dataPath.empty() || entry.server.empty() || entry.regionId.empty()) {
+        return false;
+    }
+    std::string parent = dataPath + "/larkxr";
+    mkdir(parent.c_str(), 0770);
+    FILE* file = fopen(GetCachePath(dataPath).c_str(), "w");
+    if (file == nullptr) {
+        LOGW("save region cache failed %s", GetCachePath(dataPath).c_str());
+        return false;
+    }
+    int res = fprintf(file, "%s %s %llu %lld\n", entry.server.c_str(), entry.regionId.c_str(),
+                      (unsigned long long)entry.rtt, (long long)time(nullptr));
+    return fclose(file) == 0 && res > 0;
+}
+
+//
+// attempt
+//
+RegionProber::Attempt::Attempt(RegionProber *prober, uint32_t generation, size_t region):
+    prober_(prober),
+    generation_(generation),
+    region_(region)
+{
+    test_.set_listener(this);
+}
+
+RegionProber::Attempt::~Attempt() = default;
+
+bool RegionProber::Attempt::Connect(const lark::RegionInfo &region) {
+    if (!region.publicIp.empty()) {
+        int port = 0;
+        std::istringstream (region.serverPort) >> port;
+        return test_.Connect(region.publicIp, port, "", region.regionId);
+    } else if (!region.preferPublicIp.empty()) {
+        std::string ip = lark::XRClient::GetServerHost();
+        int port = lark::XRClient::GetServerPort();
+        return test_.Connect(ip, port, "/websocket/" + region.serverIp + "/" + region.serverPort, region.regionId);
+    } else {
+        int port = 0;
+        std::istringstream (region.serverPort) >> port;
+        return test_.Connect(region.serverIp, port, "", region.regionId);
+    }
+}
+
+void RegionProber::Attempt::Close() {
+    test_.Close();
+}
+
+void RegionProber::Attempt::Answer(uint64_t rtt) {
+    if (!answered_.exchange(true)) {
+        prober_->OnSample(generation_, region_, rtt);
+    }
+}
+
+void RegionProber::Attempt::OnRegionRttTestResult(uint64_t rtt, const std::string &regionId) {
+    // 0 ms on loopback, still an answer.
+    Answer(rtt == 0 ? 1 : rtt);
+}
+
+void RegionProber::Attempt::OnRegionRttTestError(const std::string &err, const std::string &regionId) {
+    LOGW("region %s rtt test failed %s", regionId.c_str(), err.c_str());
+    Answer(0);
+}
+
+void RegionProber::Attempt::OnRegionRttTestClose(const std::string &err, const std::string &regionId) {
+    // closed before any answer, lost.
+    Answer(0);
+}
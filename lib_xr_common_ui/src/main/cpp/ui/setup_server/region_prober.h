@@ -0,0 +1,108 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_REGION_PROBER_H
+#define CLOUDLARKXR_REGION_PROBER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "lark_xr/request/region_rtt_test.h"
+#include "lark_xr/request/region_list.h"
+
+//
+// measure rtt of all regions at once, SAMPLES times each, one RegionRttTest per sample.
+// stops early when a region is faster than all samples of the others.
+// the last selected region of a server is cached on disk so the next start can use it at once.
+//
+class RegionProber {
+public:
+    struct Result {
+        lark::RegionInfo info;
+        // ms. RTT_FAILED when no sample returned.
+        uint64_t median;
+        // ms. mean distance of the samples to the median.
+        uint64_t jitter;
+        uint32_t samples;
+        uint32_t lost;
+    };
+
+    struct CacheEntry {
+        // host:port of the lark server.
+        std::string server;
+        std::string regionId;
+        uint64_t rtt;
+    };
+
+    class Callback {
+    public:
+        // once per Start on a rtt test thread. best is -1 when no region answered.
+        virtual void OnRegionProbeDone(const std::vector<Result>& results, int best) = 0;
+    };
+
+    static const uint32_t SAMPLES = 5;
+    // leader samples before stop early.
+    static const uint32_t MIN_SAMPLES = 3;
+    static const uint64_t CACHE_TTL_SECONDS = 30 * 60;
+    // ms. rtt of a region without any answer, shown as is and sorted after every answered one.
+    static const uint64_t RTT_FAILED = 9999;
+
+    explicit RegionProber(Callback* callback);
+    ~RegionProber();
+
+    // drop the probing before and probe regions.
+    void Start(const std::vector<lark::RegionInfo>& regions);
+    // close all rtt test connections. no callback after return.
+    void Stop();
+
+    // cache in 【dataPath】/larkxr/region_cache. load fails when server changed or entry expired.
+    static bool LoadCache(const std::string& dataPath, const std::string& server, CacheEntry* entry);
+    static bool SaveCache(const std::string& dataPath, const CacheEntry& entry);
+
+    // median and jitter of the answered samples, rtt 0 samples are not counted.
+    static Result GetResult(const lark::RegionInfo& info, const std::vector<uint64_t>& samples, uint32_t lost);
+private:
+    // one rtt sample of a region.
+    class Attempt: public lark::RegionRttTestListener {
+    public:
+        Attempt(RegionProber* prober, uint32_t generation, size_t region);
+        ~Attempt();
+
+        bool Connect(const lark::RegionInfo& info);
+        void Close();
+
+        virtual void OnRegionRttTestResult(uint64_t rtt, const std::string& regionId) override;
+        virtual void OnRegionRttTestError(const std::string& err, const std::string& regionId) override;
+        virtual void OnRegionRttTestClose(const std::string& err, const std::string& regionId) override;
+    private:
+        // result, error or close, only the first one counts.
+        void Answer(uint64_t rtt);
+
+        RegionProber* prober_;
+        uint32_t generation_;
+        size_t region_;
+        std::atomic<bool> answered_ = {false};
+        lark::RegionRttTest test_;
+    };
+
+    // rtt 0 when lost.
+    void OnSample(uint32_t generation, size_t region, uint64_t rtt);
+    // call locked.
+    bool IsFinished() const;
+
+    Callback* callback_;
+    std::mutex mutex_;
+    uint32_t generation_ = 0;
+    bool done_ = true;
+    std::vector<lark::RegionInfo> regions_ = {};
+    std::vector<std::vector<uint64_t>> samples_ = {};
+    std::vector<uint32_t> lost_ = {};
+    // every attempt of this start, closed in Start or Stop, never in a rtt test callback.
+    std::vector<std::shared_ptr<Attempt>> attempts_ = {};
+};
+
+#endif //CLOUDLARKXR_REGION_PROBER_H
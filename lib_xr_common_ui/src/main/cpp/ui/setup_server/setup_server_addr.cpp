@@ -127,8 +127,7 @@ void SetupServerAddr::Init() {
         get_region_list_ = std::make_shared<lark::GetRegionList>();
         get_region_list_->set_listener(this);
 
-        region_rtt_test_ = std::make_shared<lark::RegionRttTest>();
-        region_rtt_test_->set_listener(this);
+        region_prober_ = std::make_shared<RegionProber>(this);
 
         get_region_list_->SendAsync();
     }
@@ -156,12 +155,15 @@ void SetupServerAddr::HandleInput(Ray *rays, int rayCount) {
 
     for(int i = 0; i < region_list_.size(); i ++) {
         if (region_list_[i]->active() && region_list_[i]->picked() && isEnter) {
+            std::lock_guard<std::mutex> lock(region_mutex_);
             if (i < results_.size()) {
                 LOGV("region [%s] picked rtt %ld", results_[i].info.regionName.c_str(), results_[i].rtt);
                 for (int j = 0; j < results_.size(); j++) {
                     results_[j].selected = i == j;
                 }
                 selected_result_ = results_[i];
+                manual_selected_ = true;
+                SaveRegionCache(selected_result_);
                 need_update_region_ = true;
             }
         }
@@ -283,14 +285,17 @@ void SetupServerAddr::setServerAddr() {
     }
 
     // update region
+    if (region_prober_) {
+        region_prober_->Stop();
+    }
     if (!ip.empty() && port != 0 && get_region_list_) {
         get_region_list_->SendAsync();
     }
     {
         std::lock_guard<std::mutex> lock(region_mutex_);
         results_.clear();
-        current_test_ = 0;
         selected_result_ = { 0, false };
+        manual_selected_ = false;
         need_update_region_ = true;
         if (callback_) {
             callback_->OnUpdateRegion(selected_result_);
@@ -361,11 +366,14 @@ void SetupServerAddr::GetAppList() {
 void SetupServerAddr::OnSuccess(bool detectRttFlag, const std::vector<lark::RegionInfo> &regionInfo) {
     LOGV("On region list %ld", regionInfo.size());
 
+    if (region_prober_) {
+        region_prober_->Stop();
+    }
     {
         std::lock_guard<std::mutex> lock(region_mutex_);
         results_.clear();
-        current_test_ = 0;
         selected_result_ = { 0, false };
+        manual_selected_ = false;
         need_update_region_ = true;
     }
 
@@ -374,166 +382,95 @@ void SetupServerAddr::OnSuccess(bool detectRttFlag, const std::vector<lark::Regi
         return;
     }
 
-    for (const auto& region: regionInfo) {
-        LOGV("find region name %s ip %s port %s publicIp %s", region.regionName.c_str(), region.serverIp.c_str(), region.serverPort.c_str(), region.publicIp.c_str());
-         results_.push_back({0, false, region});
-    }
-    // connect
-    if (region_rtt_test_ && !regionInfo.empty()) {
-        const auto region = regionInfo.front();
-        if (!region.publicIp.empty()) {
-            int port;
-            std::istringstream (region.serverPort) >> port;
-            region_rtt_test_->Connect(region.publicIp, port,  "", region.regionId);
-            LOGV("region test [%s] rrt with public %s:%d", region.regionName.c_str(), region.publicIp.c_str(), port);
-        } else if (!region.preferPublicIp.empty()) {
-            std::string ip = lark::XRClient::GetServerHost();
-            int port = lark::XRClient::GetServerPort();
-            region_rtt_test_->Connect(ip, port,
-                                      "/websocket/" + region.serverIp + "/" + region.serverPort,
-                                       region.regionId);
-            LOGV("region test [%s] with preferPublicIp %s:%d %s:%s id %s", region.regionName.c_str(), ip.c_str(), port,
-                 region.serverIp.c_str(), region.serverPort.c_str(), region.regionId.c_str());
-        } else {
-            int port;
-            std::istringstream (region.serverPort) >> port;
-            region_rtt_test_->Connect(region.serverIp, port, "", region.regionId);
-            LOGV("regin test [%s] with %s:%d id %s", region.regionName.c_str(), region.serverIp.c_str(), port, region.regionId.c_str());
+    {
+        std::lock_guard<std::mutex> lock(region_mutex_);
+        for (const auto& region: regionInfo) {
+            LOGV("find region name %s ip %s port %s publicIp %s", region.regionName.c_str(), region.serverIp.c_str(), region.serverPort.c_str(), region.publicIp.c_str());
+            results_.push_back({0, false, region});
+        }
+    }
+    // last selected region of this server takes effect at once, probing updates it later.
+    RegionProber::CacheEntry cache = {};
+    if (RegionProber::LoadCache(Context::instance()->internal_data_path(), GetRegionCacheServer(), &cache)) {
+        std::lock_guard<std::mutex> lock(region_mutex_);
+        for (auto& res: results_) {
+            if (res.info.regionId == cache.regionId) {
+                res.rtt = cache.rtt;
+                res.selected = true;
+                selected_result_ = res;
+                LOGV("use cached region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
+                if (callback_) {
+                    callback_->OnUpdateRegion(selected_result_);
+                }
+                need_update_region_ = true;
+                break;
+            }
         }
     }
+    // probe all regions at once.
+    if (region_prober_ && !regionInfo.empty()) {
+        region_prober_->Start(regionInfo);
+    }
 }
 
 void SetupServerAddr::OnFailed(const std::string &err) {
     LOGW("Fetch Region list failed %s", err.c_str());
+    if (region_prober_) {
+        region_prober_->Stop();
+    }
     {
         std::lock_guard<std::mutex> lock(region_mutex_);
         results_.clear();
-        current_test_ = 0;
         selected_result_ = { 0, false };
+        manual_selected_ = false;
         need_update_region_ = true;
     }
 }
 
-// region_rtt_test callback
-void SetupServerAddr::OnRegionRttTestResult(uint64_t rtt, const std::string& regionId) {
+// region prober callback
+void SetupServerAddr::OnRegionProbeDone(const std::vector<RegionProber::Result> &results, int best) {
     std::lock_guard<std::mutex> lock(region_mutex_);
-    LOGV("get region rtttest result %ld id %s total regionsize %ld", rtt, regionId.c_str(), results_.size());
-
-    if (results_.empty()) {
+    if (results_.size() != results.size()) {
         return;
     }
-
-    if (current_test_ < results_.size() && results_[current_test_].info.regionId == regionId) {
-        results_[current_test_].rtt = rtt;
-
-        // finish
-        if (current_test_ == results_.size() - 1) {
-            for(const auto& res : results_) {
-                LOGV("got region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
-                if (res.rtt != 0 && (selected_result_.rtt == 0 || res.rtt < selected_result_.rtt)) {
-                    selected_result_ = res;
-                    selected_result_.selected = true;
-                }
-            }
-            for(auto& res: results_) {
-                if (res.info.regionId == selected_result_.info.regionId) {
-                    res.selected = true;
-                    LOGV("selected region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
-                }
-            }
-            if (callback_) {
-                callback_->OnUpdateRegion(selected_result_);
-            }
-            // need update ui
-            need_update_region_ = true;
-        } else {
-            // next
-            if (region_rtt_test_) {
-                LOGV("get next rtt info total %ld current %d", results_.size(), current_test_);
-                current_test_++;
-                auto region = results_[current_test_].info;
-                if (!region.publicIp.empty()) {
-                    int port;
-                    std::istringstream (region.serverPort) >> port;
-                    region_rtt_test_->Connect(region.publicIp, port, "", region.regionId);
-                    LOGV("region test [%s] rrt with public %s:%d", region.regionName.c_str(), region.publicIp.c_str(), port);
-                } else if (!region.preferPublicIp.empty()) {
-                    std::string ip = lark::XRClient::GetServerHost();
-                    int port = lark::XRClient::GetServerPort();
-                    region_rtt_test_->Connect(ip, port,
-                                              "/websocket/" + region.serverIp + "/" + region.serverPort,
-                                              region.regionId);
-                    LOGV("region test [%s] with preferPublicIp %s:%d %s:%s id %s", region.regionName.c_str(), ip.c_str(), port,
-                         region.serverIp.c_str(), region.serverPort.c_str(), region.regionId.c_str());
-                } else {
-                    int port;
-                    std::istringstream (region.serverPort) >> port;
-                    region_rtt_test_->Connect(region.serverIp, port, "", region.regionId);
-                    LOGV("regin test [%s] with %s:%d id %s", region.regionName.c_str(), region.serverIp.c_str(), port, region.regionId.c_str());
-                }
-            }
+    for (size_t i = 0; i < results.size(); i++) {
+        results_[i].rtt = results[i].median;
+        if (!manual_selected_) {
+            results_[i].selected = static_cast<int>(i) == best;
         }
     }
-}
-
-void SetupServerAddr::OnRegionRttTestError(const std::string &err, const std::string& regionId) {
-    LOGW("Fetch Region Test Rtt failed %s", err.c_str());
-    std::lock_guard<std::mutex> lock(region_mutex_);
-    if (results_.empty()) {
-        return;
-    }
-    if (current_test_ < results_.size()) {
-        // TODO set to max when rtt check failed.
-        results_[current_test_].rtt = 0;
-
-        // finish
-        if (current_test_ == results_.size() - 1) {
-            for(const auto& res : results_) {
-                LOGV("got region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
-                if (res.rtt != 0 && (selected_result_.rtt == 0 || res.rtt < selected_result_.rtt)) {
-                    selected_result_ = res;
-                    selected_result_.selected = true;
-                }
-            }
-            for(auto& res: results_) {
-                if (res.info.regionId == selected_result_.info.regionId) {
-                    res.selected = true;
-                    LOGV("selected region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
-                }
-            }
-            if (callback_) {
-                callback_->OnUpdateRegion(selected_result_);
-            }
-            // need update ui
-            need_update_region_ = true;
-        } else {
-            // next
-            if (region_rtt_test_) {
-                LOGV("get next rtt info total %ld current %d", results_.size(), current_test_);
-                current_test_++;
-                auto region = results_[current_test_].info;
-                if (!region.publicIp.empty()) {
-                    int port;
-                    std::istringstream (region.serverPort) >> port;
-                    region_rtt_test_->Connect(region.publicIp, port, "", region.regionId);
-                } else if (!region.preferPublicIp.empty()) {
-                    std::string ip = lark::XRClient::GetServerHost();
-                    int port = lark::XRClient::GetServerPort();
-                    region_rtt_test_->Connect(ip, port,
-                                              "/websocket/" + region.serverIp + "/" + region.serverPort,
-                                              region.regionId);
-                } else {
-                    int port;
-                    std::istringstream (region.serverPort) >> port;
-                    region_rtt_test_->Connect(region.serverIp, port, "", region.regionId);
-                }
+    if (manual_selected_) {
+        // picked while probing, keep it and cache it with the measured rtt.
+        for (const auto& res: results_) {
+            if (res.selected) {
+                selected_result_ = res;
+                LOGV("keep picked region %s rtt %ld", res.info.regionName.c_str(), res.rtt);
+                SaveRegionCache(selected_result_);
+                break;
             }
         }
+    } else if (best >= 0) {
+        selected_result_ = results_[best];
+        LOGV("selected region %s rtt %ld jitter %ld", selected_result_.info.regionName.c_str(),
+             selected_result_.rtt, results[best].jitter);
+        SaveRegionCache(selected_result_);
+    } else {
+        selected_result_ = { 0, false };
+    }
+    if (callback_) {
+        callback_->OnUpdateRegion(selected_result_);
     }
+    // need update ui
+    need_update_region_ = true;
+}
+
+std::string SetupServerAddr::GetRegionCacheServer() {
+    return std::string(lark::XRClient::GetServerHost()) + ":" + std::to_string(lark::XRClient::GetServerPort());
 }
 
-void SetupServerAddr::OnRegionRttTestClose(const std::string &err, const std::string &regionId) {
-    LOGW("Fetch Region Test Rtt Closed %s", err.c_str());
+void SetupServerAddr::SaveRegionCache(const RegionTestResult &result) {
+    RegionProber::CacheEntry entry = { GetRegionCacheServer(), result.info.regionId, result.rtt };
+    RegionProber::SaveCache(Context::instance()->internal_data_path(), entry);
 }
 
 void SetupServerAddr::Update() {
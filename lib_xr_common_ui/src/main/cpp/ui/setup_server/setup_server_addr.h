@@ -7,14 +7,14 @@
 
 #include "ui/view.h"
 #include "ui/component/keyboard.h"
-#include "lark_xr/request/region_rtt_test.h"
 #include "lark_xr/request/region_list.h"
+#include "region_prober.h"
 
 class SetupServerAddrListener;
 class SetupServerAddr: public View,
         public Keyboard::Callback,
         public lark::GetRegionListListener,
-        public lark::RegionRttTestListener {
+        public RegionProber::Callback {
 public:
     enum Mode {
         Mode_Audo   = 0,
@@ -68,10 +68,8 @@ public:
     virtual void OnSuccess(bool detectRttFlag, const std::vector<lark::RegionInfo>& appliPageInfo) override;
     virtual void OnFailed(const std::string& msg) override;
 
-    // region_rtt_test callback
-    virtual void OnRegionRttTestResult(uint64_t rtt, const std::string& regionId) override;
-    virtual void OnRegionRttTestError(const std::string& err, const std::string& regionId) override;
-    virtual void OnRegionRttTestClose(const std::string& err, const std::string& regionId) override;
+    // region prober callback
+    virtual void OnRegionProbeDone(const std::vector<RegionProber::Result>& results, int best) override;
 
     inline RegionTestResult selected_region_result() { return selected_result_; }
 
@@ -88,6 +86,9 @@ private:
     void onInputModeChange(InputMode mode);
     //
     void GetAppList();
+    // host:port of the lark server, key of the region cache.
+    static std::string GetRegionCacheServer();
+    void SaveRegionCache(const RegionTestResult& result);
 
     Mode currnet_mode_ = Mode_Manual;
     InputMode input_mode_ = InputMode_None;
@@ -111,19 +112,22 @@ private:
     std::function<void()> get_applist_adapter_;
     bool is_detecting_ = false;
 
-    std::shared_ptr<lark::RegionRttTest> region_rtt_test_ = {};
     std::shared_ptr<lark::GetRegionList> get_region_list_ = {};
     std::vector<RegionTestResult> results_ = {};
     RegionTestResult selected_result_ = { 0, false };
+    // picked in the list, probe results only update its rtt.
+    bool manual_selected_ = false;
 
     std::vector<std::shared_ptr<TextButton>> region_list_ = {};
     std::shared_ptr<Text> region_title_ = {};
 
-    int current_test_ = 0;
     std::mutex region_mutex_ = {};
     bool need_update_region_ = false;
 
     SetupServerAddrListener* callback_ = nullptr;
+
+    // last member, stopped before the members its callback touches are gone.
+    std::shared_ptr<RegionProber> region_prober_ = {};
 };
 
 class SetupServerAddrListener {
@@ -2,6 +2,7 @@
 // Created by fcx@pingixngyun.com on 2019/11/15.
 //
 
+#include <algorithm>
 #include <log.h>
 #include "view.h"
 #include "ui/aa_bb.h"
@@ -25,6 +26,9 @@ float View::VIEW_HEIGHT     = 4.0F;
 View::View(Navigation *navigation):
     navigation_(navigation),
     aabb_list_(),
+    hit_grid_(),
+    hovered_(),
+    hits_(),
     ray_point_(),
     back_btn_(new BackButton),
     bg_(new ColorBox)
@@ -87,6 +91,8 @@ void View::HandleInput(Ray * rays, int rayCount) {
     //    glm::vec3 f = planeDot - ray.p;
     //    float t =  utils::Dot(f, normal) / dot;
     //    0 -> left 1 -> right 2 -> hmd for now.
+    glm::quat rotation = world_trans.GetRotation();
+    glm::mat4 inverseWorld = glm::inverse(world_trans.GetTrans());
     for (int i = 0; i < rayCount; i ++) {
         Ray ray = rays[i];
 
@@ -95,18 +101,14 @@ void View::HandleInput(Ray * rays, int rayCount) {
             continue;
         }
 
-        Transform parentTransforms = GetTransforms();
-        glm::vec3 parentPosition = parentTransforms.GetPosition();
-
         glm::vec3 p;
         p.x = ray.ori.x + t * ray.dir.x;
         p.y = ray.ori.y + t * ray.dir.y;
         p.z = ray.ori.z + t * ray.dir.z;
 
-        glm::quat rotation = parentTransforms.GetRotation();
         glm::mat4 wold = glm::translate(glm::mat4(1.0f), p);
         wold = wold * glm::mat4_cast(rotation);
-        glm::mat4 local = glm::inverse(parentTransforms.GetTrans()) * wold;
+        glm::mat4 local = inverseWorld * wold;
 //        local = glm::translate(local, glm::vec3(0,0,0.01));
         local = glm::translate(local, glm::vec3(0,0,0.2));
         Transform transform(local);
@@ -124,17 +126,11 @@ void View::HandleInput(Ray * rays, int rayCount) {
         ray_point_[i].x = local_position.x;
         ray_point_[i].y = local_position.y;
     }
-    for(auto& aabb : aabb_list_) {
-        if (aabb->aabb_active()) {
-            aabb->HandleInput(ray_point_, rayCount);
-        }
-    }
+    DispatchAABBInput(rayCount);
 
-    if (navigation_ != nullptr &&
-        back_btn_ && back_btn_->active() && back_btn_->picked() &&
-            (Input::GetCurrentInputState().triggerShortPressed || Input::GetCurrentInputState().enterShortPressed)) {
-        // back to home
-        navigation_->SetRouter(Navigation::HOME);
+    Input::Event event = {};
+    while (Input::PollEvent(&event)) {
+        OnInputEvent(event);
     }
 }
 
@@ -145,11 +141,76 @@ void View::Enter() {
 void View::Leave() {
 }
 
+void View::OnInputEvent(const Input::Event &event) {
+    if (event.type != Input::Event_Up || event.ray != Input::GetCurrentRayCastType() ||
+        (event.button != Input::Button_Trigger && event.button != Input::Button_Enter)) {
+        return;
+    }
+    if (navigation_ != nullptr && back_btn_ && back_btn_->active() && back_btn_->picked()) {
+        // back to home
+        navigation_->SetRouter(Navigation::HOME);
+    }
+}
+
+void View::DispatchAABBInput(int rayCount) {
+    if (hit_grid_dirty_ || hit_grid_version_ != AABB::layout_version()) {
+        // keep the items hovered before, they need a leave call.
+        std::vector<AABB*> hovered;
+        for (auto index : hovered_) {
+            hovered.push_back(hit_grid_.items()[index]);
+        }
+        hit_grid_.Build(std::vector<AABB*>(aabb_list_.begin(), aabb_list_.end()));
+        hit_grid_dirty_ = false;
+        hit_grid_version_ = AABB::layout_version();
+
+        hovered_.clear();
+        const std::vector<AABB*>& items = hit_grid_.items();
+        for (uint32_t i = 0; i < items.size(); i++) {
+            if (std::find(hovered.begin(), hovered.end(), items[i]) != hovered.end()) {
+                hovered_.push_back(i);
+            }
+        }
+    }
+
+    // aabb check the main ray point only.
+    int main = Input::GetCurrentRayCastType();
+    if (main < rayCount) {
+        hit_grid_.Query(ray_point_[main], &hits_);
+    } else {
+        hits_.clear();
+    }
+
+    // hovered items every frame for press, others once when the ray left.
+    const std::vector<AABB*>& items = hit_grid_.items();
+    size_t h = 0;
+    size_t n = 0;
+    while (h < hovered_.size() || n < hits_.size()) {
+        uint32_t index;
+        if (n == hits_.size() || (h < hovered_.size() && hovered_[h] < hits_[n])) {
+            index = hovered_[h++];
+        } else {
+            if (h < hovered_.size() && hovered_[h] == hits_[n]) {
+                h++;
+            }
+            index = hits_[n++];
+        }
+        if (items[index]->aabb_active()) {
+            items[index]->HandleInput(ray_point_, rayCount);
+        }
+    }
+    hovered_.swap(hits_);
+}
+
 void View::PushAABB(AABB * aabb) {
-    if (aabb != nullptr)
+    if (aabb != nullptr) {
         aabb_list_.push_back(aabb);
+        hit_grid_dirty_ = true;
+    }
 }
 
 void View::ClearAABB() {
     aabb_list_.clear();
+    hit_grid_.Clear();
+    hovered_.clear();
+    hit_grid_dirty_ = true;
 }
@@ -10,11 +10,13 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <object.h>
 #include <list>
+#include <vector>
 #include "input.h"
 //#include <scene/ray_sphereIntersection.h>
 //#include "app_nav_btns.h"
 #include "component/button.h"
 #include "ui/aa_bb.h"
+#include "ui/hit_grid.h"
 
 class Navigation;
 class View: public  lark::Object {
@@ -34,11 +36,15 @@ public:
     virtual void Leave();
 protected:
     virtual void Init();
+    // input events of this frame, called in HandleInput after the aabb under ray got input.
+    virtual void OnInputEvent(const Input::Event& event);
 
     void PushAABB(AABB * aabb);
     // clear all aabb;
     void ClearAABB();
     // TODO add aaabb remove.
+    // call HandleInput of the aabb under main ray, and the ones ray just left.
+    void DispatchAABBInput(int rayCount);
 
     Navigation                   *navigation_;
     std::shared_ptr<BackButton>  back_btn_;
@@ -52,6 +58,13 @@ protected:
     glm::vec2                    ray_point_[Input::RayCast_Count];
     // aabb check list.
     std::list<AABB*>             aabb_list_;
+    // index of aabb_list_, rebuilt when list or layout changed.
+    HitGrid                      hit_grid_;
+    bool                         hit_grid_dirty_ = true;
+    uint64_t                     hit_grid_version_ = 0;
+    // hit_grid_ item index under main ray, last frame and this frame.
+    std::vector<uint32_t>        hovered_;
+    std::vector<uint32_t>        hits_;
     Input::RayCastType           main_ray_cast_ = Input::RayCast_left;
 };
 
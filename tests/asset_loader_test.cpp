@@ -0,0 +1,270 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <gtest/gtest.h>
+#include "asset_loader.h"
+#include "mesh_file.h"
+#include "model.h"
+#include "skybox_file.h"
+#include "gl_shim.h"
+
+using lark::AndroidAssetContext;
+using lark::AssetLoader;
+using lark::MeshFile;
+using lark::Model;
+using lark::ModelFuture;
+using lark::SkyboxFile;
+using lark::TextureFuture;
+
+namespace {
+const char* MODEL_PATH = "model/box/box.obj";
+// a fifo, the worker reading it blocks until the test writes the image.
+const char* SLOW_TEXTURE_PATH = "textures/slow.ppm";
+const int MAX_FRAMES = 5000;
+const char* SKYBOX_PATH = "textures/sky.jpg";
+// 512 to 1, levels up to 128 uploaded at load.
+const uint32_t SKYBOX_SIZE = 512;
+const uint32_t SKYBOX_STREAMED_LEVELS = 2;
+const uint32_t SKYBOX_FORMAT = 0x9274;
+
+MeshFile::SourceMesh MakeQuad(float size) {
+    MeshFile::SourceMesh mesh;
+    mesh.positions = { {0, 0, 0}, {size, 0, 0}, {size, size, 0}, {0, size, 0} };
+    mesh.normals = { {0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1} };
+    mesh.texcoords = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+    mesh.indices = { 0, 1, 2, 0, 2, 3 };
+    return mesh;
+}
+
+std::string MakePpm() {
+    const int size = 4;
+    std::string ppm = "P6\n" + std::to_string(size) + " " + std::to_string(size) + "\n255\n";
+    ppm.append(size * size * 3, '\x7f');
+    return ppm;
+}
+
+template <class Future>
+bool IsReady(const Future& future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+class AssetLoaderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/asset_loader_test_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        dir_ = dir;
+        mkdir((dir_ + "/model").c_str(), 0700);
+        mkdir((dir_ + "/model/box").c_str(), 0700);
+        mkdir((dir_ + "/textures").c_str(), 0700);
+        ASSERT_EQ(mkfifo((dir_ + "/" + SLOW_TEXTURE_PATH).c_str(), 0600), 0);
+
+        asset_manager_ = AAssetManager_fromDirectory(dir_.c_str());
+        activity_ = {};
+        activity_.vm = &vm_;
+        activity_.internalDataPath = dir_.c_str();
+        activity_.assetManager = asset_manager_;
+        context_ = { &activity_, nullptr, nullptr };
+        gl_shim::Reset();
+    }
+    void TearDown() override {
+        AssetLoader::Release();
+        std::string cmd = "rm -rf " + dir_;
+        system(cmd.c_str());
+    }
+
+    void WriteModel(int meshCount) {
+        std::vector<MeshFile::SourceMesh> meshes(meshCount, MakeQuad(1.0F));
+        ASSERT_TRUE(MeshFile::Write(dir_ + "/" + MeshFile::GetMeshPath(MODEL_PATH), meshes));
+    }
+    void WritePackedSkybox() {
+        std::vector<SkyboxFile::LevelData> levels;
+        for (uint32_t size = SKYBOX_SIZE; size > 0; size >>= 1) {
+            SkyboxFile::LevelData level;
+            for (auto & face : level) {
+                face.assign(16, 1);
+            }
+            levels.push_back(level);
+        }
+        ASSERT_TRUE(SkyboxFile::Write(dir_ + "/" + SkyboxFile::GetSkyboxPath(SKYBOX_PATH),
+                                      SKYBOX_FORMAT, SKYBOX_SIZE, levels));
+    }
+    // unblock the worker waiting on the fifo.
+    void WriteSlowTexture() {
+        std::ofstream out(dir_ + "/" + SLOW_TEXTURE_PATH, std::ios::binary);
+        out << MakePpm();
+    }
+    // one render thread frame.
+    void Frame() {
+        AssetLoader::instance()->Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    template <class Future>
+    bool FrameUntilReady(const Future& future) {
+        for (int i = 0; i < MAX_FRAMES && !IsReady(future); i++) {
+            Frame();
+        }
+        return IsReady(future);
+    }
+
+    std::string dir_;
+    JavaVM vm_;
+    AAssetManager* asset_manager_ = nullptr;
+    ANativeActivity activity_ = {};
+    AndroidAssetContext context_ = {};
+};
+}
+
+TEST_F(AssetLoaderTest, ModelWaitsForTexturesQueuedBefore) {
+    WriteModel(1);
+    AssetLoader* loader = AssetLoader::instance();
+    TextureFuture texture = loader->LoadTextureAsync(&context_, { lark::TextureAssetType_Local_Normal, SLOW_TEXTURE_PATH });
+    ModelFuture model = loader->LoadModelAsync(&context_, { MODEL_PATH });
+
+    // parsed by the other worker, but the texture may be one of the model's.
+    for (int i = 0; i < 50; i++) {
+        Frame();
+    }
+    EXPECT_FALSE(IsReady(texture));
+    EXPECT_FALSE(IsReady(model));
+    EXPECT_EQ(gl_shim::Count("glBufferData"), 0u);
+
+    WriteSlowTexture();
+    ASSERT_TRUE(FrameUntilReady(model));
+    EXPECT_TRUE(IsReady(texture));
+    EXPECT_NE(texture.get(), nullptr);
+    EXPECT_NE(model.get(), nullptr);
+    EXPECT_EQ(loader->FindModel(MODEL_PATH), model.get());
+}
+
+TEST_F(AssetLoaderTest, ModelDoesNotWaitForTexturesQueuedAfter) {
+    WriteModel(1);
+    AssetLoader* loader = AssetLoader::instance();
+    ModelFuture model = loader->LoadModelAsync(&context_, { MODEL_PATH });
+    TextureFuture texture = loader->LoadTextureAsync(&context_, { lark::TextureAssetType_Local_Normal, SLOW_TEXTURE_PATH });
+
+    ASSERT_TRUE(FrameUntilReady(model));
+    EXPECT_NE(model.get(), nullptr);
+    EXPECT_FALSE(IsReady(texture));
+    EXPECT_TRUE(loader->FindLoadingTexture(SLOW_TEXTURE_PATH).valid());
+
+    WriteSlowTexture();
+    ASSERT_TRUE(FrameUntilReady(texture));
+    EXPECT_NE(texture.get(), nullptr);
+    EXPECT_EQ(loader->pending(), 0u);
+}
+
+TEST_F(AssetLoaderTest, OneMeshUploadedPerUpdate) {
+    const int meshCount = 3;
+    WriteModel(meshCount);
+    AssetLoader* loader = AssetLoader::instance();
+    // no budget left after the first job.
+    loader->set_update_budget(0);
+    ModelFuture model = loader->LoadModelAsync(&context_, { MODEL_PATH });
+
+    int uploadFrames = 0;
+    for (int i = 0; i < MAX_FRAMES && !IsReady(model); i++) {
+        size_t before = gl_shim::Count("glBufferData");
+        Frame();
+        size_t uploaded = gl_shim::Count("glBufferData") - before;
+        // vertex and index buffer of one mesh.
+        EXPECT_LE(uploaded, 2u);
+        if (uploaded > 0) {
+            uploadFrames++;
+        }
+    }
+    ASSERT_TRUE(IsReady(model));
+    EXPECT_EQ(uploadFrames, meshCount);
+    std::shared_ptr<Model> loaded = model.get();
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->pending_meshes(), 0u);
+    EXPECT_EQ(loader->pending(), 0u);
+}
+
+TEST_F(AssetLoaderTest, CallerModelNotCached) {
+    WriteModel(2);
+    std::shared_ptr<Model> model = std::make_shared<Model>(MODEL_PATH);
+    ModelFuture future = AssetLoader::instance()->LoadModelAsync(&context_, model);
+    ASSERT_TRUE(FrameUntilReady(future));
+    EXPECT_EQ(future.get(), model);
+    EXPECT_EQ(model->pending_meshes(), 0u);
+    EXPECT_EQ(AssetLoader::instance()->FindModel(MODEL_PATH), nullptr);
+}
+
+TEST_F(AssetLoaderTest, BrokenModelFails) {
+    // no .obj to fall back to either.
+    std::ofstream(dir_ + "/" + MeshFile::GetMeshPath(MODEL_PATH), std::ios::binary) << "broken";
+    ModelFuture model = AssetLoader::instance()->LoadModelAsync(&context_, { MODEL_PATH });
+    ASSERT_TRUE(FrameUntilReady(model));
+    EXPECT_EQ(model.get(), nullptr);
+    EXPECT_EQ(AssetLoader::instance()->pending(), 0u);
+}
+
+TEST_F(AssetLoaderTest, SyncLoadUploadsAllMeshes) {
+    WriteModel(3);
+    std::shared_ptr<Model> model = AssetLoader::instance()->LoadModel(&context_, { MODEL_PATH });
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(model->pending_meshes(), 0u);
+    EXPECT_EQ(gl_shim::Count("glBufferData"), 6u);
+}
+
+namespace {
+// last GL_TEXTURE_BASE_LEVEL set, -1 when never.
+int64_t SkyboxBaseLevel() {
+    int64_t level = -1;
+    for (const auto & call : gl_shim::Find("glTexParameteri")) {
+        if (call.args[1] == GL_TEXTURE_BASE_LEVEL) {
+            level = call.args[2];
+        }
+    }
+    return level;
+}
+}
+
+TEST_F(AssetLoaderTest, PackedSkyboxStreamsLargeLevels) {
+    WritePackedSkybox();
+    AssetLoader* loader = AssetLoader::instance();
+    loader->set_update_budget(0);
+    // sync load leaves the large levels to Update.
+    ASSERT_NE(loader->LoadTexture(&context_, { lark::TextureAssetType_Local_Skybox, SKYBOX_PATH }), nullptr);
+    EXPECT_EQ(gl_shim::Count("glCompressedTexSubImage2D"), (10 - SKYBOX_STREAMED_LEVELS) * 6u);
+    // 128 is level 2 of 512.
+    EXPECT_EQ(SkyboxBaseLevel(), 2);
+    EXPECT_EQ(loader->pending(), 1u);
+
+    loader->Update();
+    EXPECT_EQ(SkyboxBaseLevel(), 1);
+    loader->Update();
+    EXPECT_EQ(SkyboxBaseLevel(), 0);
+    EXPECT_EQ(gl_shim::Count("glCompressedTexSubImage2D"), 10 * 6u);
+    EXPECT_EQ(loader->pending(), 0u);
+}
+
+TEST_F(AssetLoaderTest, PackedSkyboxStopsOnUploadError) {
+    WritePackedSkybox();
+    AssetLoader* loader = AssetLoader::instance();
+    ASSERT_NE(loader->LoadTexture(&context_, { lark::TextureAssetType_Local_Skybox, SKYBOX_PATH }), nullptr);
+    gl_shim::SetErrorOn("glCompressedTexSubImage2D", GL_INVALID_OPERATION);
+    loader->Update();
+    // the rejected level is never sampled.
+    EXPECT_EQ(SkyboxBaseLevel(), 2);
+    EXPECT_EQ(loader->pending(), 0u);
+}
+
+TEST_F(AssetLoaderTest, PackedSkyboxRejectedFallsBackToImage) {
+    WritePackedSkybox();
+    gl_shim::SetErrorOn("glCompressedTexSubImage2D", GL_INVALID_OPERATION);
+    // no image next to it either.
+    EXPECT_EQ(AssetLoader::instance()->LoadTexture(&context_, { lark::TextureAssetType_Local_Skybox, SKYBOX_PATH }), nullptr);
+    EXPECT_EQ(SkyboxBaseLevel(), -1);
+    EXPECT_EQ(AssetLoader::instance()->pending(), 0u);
+}
@@ -0,0 +1,145 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// home page population, one page of 8 covers of 512x512 jpeg.
+// cold: decode and store every cover. warm: map the stored pixels.
+// revalidate: hash the downloaded source and compare it with the stored one.
+// download time is not included, it is the same for cold and revalidate.
+//
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#include "image_decoder.h"
+#include "texture_cache.h"
+
+using lark::CachedImage;
+using lark::ImageDecoder;
+using lark::StbImageDecoder;
+using lark::TextureCache;
+
+namespace {
+const int COVER_SIZE = 512;
+const int PAGE_COVERS = 8;
+
+void AppendBytes(void* context, void* data, int size) {
+    std::vector<char>* out = static_cast<std::vector<char>*>(context);
+    const char* bytes = static_cast<const char*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+}
+
+// gradient with some noise, compresses like a photo.
+std::vector<char> MakeJpeg(int seed) {
+    std::vector<uint8_t> rgb(COVER_SIZE * COVER_SIZE * 3);
+    srand(seed);
+    for (int y = 0; y < COVER_SIZE; y++) {
+        for (int x = 0; x < COVER_SIZE; x++) {
+            uint8_t* p = &rgb[(y * COVER_SIZE + x) * 3];
+            p[0] = static_cast<uint8_t>(x / 2 + rand() % 16);
+            p[1] = static_cast<uint8_t>(y / 2 + rand() % 16);
+            p[2] = static_cast<uint8_t>(seed * 31);
+        }
+    }
+    std::vector<char> jpeg;
+    stbi_write_jpg_to_func(AppendBytes, &jpeg, COVER_SIZE, COVER_SIZE, 3, rgb.data(), 90);
+    return jpeg;
+}
+
+struct Page {
+    std::vector<std::string> urls;
+    std::vector<std::vector<char>> sources;
+};
+
+const Page& GetPage() {
+    static Page page;
+    if (page.urls.empty()) {
+        for (int i = 0; i < PAGE_COVERS; i++) {
+            page.urls.push_back("http://192.168.0.55:8181/cover/" + std::to_string(i) + ".jpg");
+            page.sources.push_back(MakeJpeg(i));
+        }
+    }
+    return page;
+}
+
+// what the streamer worker does on a miss.
+void DecodeAndStore(const std::string& url, const std::vector<char>& source) {
+    StbImageDecoder decoder;
+    uint64_t sourceHash = TextureCache::Hash(source.data(), source.size());
+    decoder.Decode(source.data(), source.size(), [&](const ImageDecoder::Pixels& pixels) {
+        TextureCache::instance()->Store(TextureCache::Hash(url), sourceHash,
+                                        pixels.width, pixels.height, pixels.data);
+    });
+}
+
+class CacheDir {
+public:
+    CacheDir() {
+        char dir[] = "/tmp/cover_cache_benchmark_XXXXXX";
+        dir_ = mkdtemp(dir);
+        TextureCache::Release();
+        TextureCache::instance()->Init(dir_);
+    }
+    ~CacheDir() {
+        TextureCache::Release();
+        std::string cmd = "rm -rf " + dir_;
+        system(cmd.c_str());
+    }
+private:
+    std::string dir_;
+};
+}
+
+static void BM_CoverPageCold(benchmark::State& state) {
+    const Page& page = GetPage();
+    CacheDir dir;
+    for (auto _ : state) {
+        for (int i = 0; i < PAGE_COVERS; i++) {
+            DecodeAndStore(page.urls[i], page.sources[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PAGE_COVERS);
+}
+BENCHMARK(BM_CoverPageCold)->Unit(benchmark::kMillisecond);
+
+static void BM_CoverPageWarm(benchmark::State& state) {
+    const Page& page = GetPage();
+    CacheDir dir;
+    for (int i = 0; i < PAGE_COVERS; i++) {
+        DecodeAndStore(page.urls[i], page.sources[i]);
+    }
+    for (auto _ : state) {
+        for (int i = 0; i < PAGE_COVERS; i++) {
+            uint64_t key = TextureCache::Hash(page.urls[i]);
+            std::shared_ptr<CachedImage> image = TextureCache::instance()->Open(key);
+            // touch every page like the upload does.
+            uint32_t sum = 0;
+            for (size_t offset = 0; image && offset < image->pixels_size(); offset += 4096) {
+                sum += image->pixels()[offset];
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PAGE_COVERS);
+}
+BENCHMARK(BM_CoverPageWarm)->Unit(benchmark::kMillisecond);
+
+static void BM_CoverPageRevalidate(benchmark::State& state) {
+    const Page& page = GetPage();
+    CacheDir dir;
+    for (int i = 0; i < PAGE_COVERS; i++) {
+        DecodeAndStore(page.urls[i], page.sources[i]);
+    }
+    for (auto _ : state) {
+        for (int i = 0; i < PAGE_COVERS; i++) {
+            const std::vector<char>& source = page.sources[i];
+            bool same = TextureCache::instance()->Validate(TextureCache::Hash(page.urls[i]),
+                    TextureCache::Hash(source.data(), source.size()));
+            benchmark::DoNotOptimize(same);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PAGE_COVERS);
+}
+BENCHMARK(BM_CoverPageRevalidate)->Unit(benchmark::kMillisecond);
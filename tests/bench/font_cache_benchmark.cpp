@@ -0,0 +1,125 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// glyph cache hit rate and layout time of cjk titles.
+// LARK_BENCH_FONT selects the font, a cjk font like NotoSansCJK-Regular.ttc gives real glyphs.
+//
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "ui/component/font_cache.h"
+
+namespace {
+// common cjk characters the titles are drawn from.
+const wchar_t CJK_BASE = 0x4E00;
+const int CJK_POOL = 3000;
+
+const char* GetFontPath() {
+    const char* font = getenv("LARK_BENCH_FONT");
+    return font != nullptr ? font : LARK_TEST_FONT;
+}
+
+// app titles with zipf like character frequency, fixed seed.
+std::vector<std::wstring> MakeTitles(int count) {
+    std::mt19937 rng(20230319);
+    std::vector<double> weights(CJK_POOL);
+    for (int i = 0; i < CJK_POOL; i++) {
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<int> character(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> length(4, 16);
+    std::vector<std::wstring> titles;
+    for (int i = 0; i < count; i++) {
+        std::wstring title;
+        for (int n = length(rng); n > 0; n--) {
+            title.push_back(static_cast<wchar_t>(CJK_BASE + character(rng)));
+        }
+        titles.push_back(title);
+    }
+    return titles;
+}
+
+std::shared_ptr<FontFace> MakeFace(FT_UInt pixelSize, std::shared_ptr<FT_LibraryRec_>* ft) {
+    FT_Library library = nullptr;
+    FT_Init_FreeType(&library);
+    *ft = std::shared_ptr<FT_LibraryRec_>(library, FT_Done_FreeType);
+    return std::make_shared<FontFace>(*ft, GetFontPath(), pixelSize);
+}
+
+// same loop as Text::BuildMesh without the vertices.
+size_t Layout(FontFace* face, const std::wstring& text) {
+    size_t glyphs = 0;
+    face->BeginString();
+    for (wchar_t c : text) {
+        glyphs += face->GetGlyph(c) != nullptr ? 1 : 0;
+    }
+    face->EndString();
+    return glyphs;
+}
+
+void SetCounters(benchmark::State& state, const FontFace& face, size_t strings) {
+    uint64_t total = face.hits() + face.misses();
+    state.counters["hit_rate"] = total > 0 ? static_cast<double>(face.hits()) / total : 0.0;
+    state.counters["evictions"] = static_cast<double>(face.evictions());
+    state.counters["atlas_glyphs"] = static_cast<double>(face.capacity());
+    state.counters["strings"] = benchmark::Counter(static_cast<double>(strings), benchmark::Counter::kIsRate);
+}
+}
+
+// home page relayout, a page of titles with a warm atlas.
+static void BM_LayoutTitlesWarm(benchmark::State& state) {
+    std::shared_ptr<FT_LibraryRec_> ft;
+    auto face = MakeFace(static_cast<FT_UInt>(state.range(0)), &ft);
+    auto titles = MakeTitles(static_cast<int>(state.range(1)));
+    size_t strings = 0;
+    for (auto _ : state) {
+        for (const auto& title : titles) {
+            benchmark::DoNotOptimize(Layout(face.get(), title));
+        }
+        strings += titles.size();
+    }
+    SetCounters(state, *face, strings);
+}
+BENCHMARK(BM_LayoutTitlesWarm)->Args({36, 8})->Args({36, 64})->Args({36, 512})->Args({72, 512});
+
+// first page after start, every glyph rasterized and uploaded.
+static void BM_LayoutTitlesCold(benchmark::State& state) {
+    auto titles = MakeTitles(static_cast<int>(state.range(1)));
+    size_t strings = 0;
+    std::shared_ptr<FT_LibraryRec_> ft;
+    std::shared_ptr<FontFace> face;
+    for (auto _ : state) {
+        state.PauseTiming();
+        face = MakeFace(static_cast<FT_UInt>(state.range(0)), &ft);
+        state.ResumeTiming();
+        for (const auto& title : titles) {
+            benchmark::DoNotOptimize(Layout(face.get(), title));
+        }
+        strings += titles.size();
+    }
+    SetCounters(state, *face, strings);
+}
+BENCHMARK(BM_LayoutTitlesCold)->Args({36, 8})->Args({36, 64});
+
+// a page of new titles every iteration, steady state of scrolling the app list.
+static void BM_LayoutTitlesScroll(benchmark::State& state) {
+    std::shared_ptr<FT_LibraryRec_> ft;
+    auto face = MakeFace(static_cast<FT_UInt>(state.range(0)), &ft);
+    auto titles = MakeTitles(4096);
+    size_t page = static_cast<size_t>(state.range(1));
+    size_t next = 0;
+    size_t strings = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < page; i++) {
+            benchmark::DoNotOptimize(Layout(face.get(), titles[next]));
+            next = (next + 1) % titles.size();
+        }
+        strings += page;
+    }
+    SetCounters(state, *face, strings);
+}
+BENCHMARK(BM_LayoutTitlesScroll)->Args({36, 8})->Args({72, 8});
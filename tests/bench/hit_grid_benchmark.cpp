@@ -0,0 +1,96 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// hit test of the main ray against a large view, a scrolled app list of cards with buttons on them.
+// linear: CheckPointIn on every box, what the view did before the grid.
+// grid: HitGrid::Query. build: what a layout change costs the next frame.
+//
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "ui/hit_grid.h"
+
+namespace {
+const int CARD_COLS = 8;
+const int QUERY_POINTS = 1024;
+
+class Box : public AABB {
+public:
+    Box(const glm::vec2& size, const glm::vec2& position): AABB(0, size, position) {}
+    void HandleInput(glm::vec2* point, int pointCount) override {}
+};
+
+// every card has a play and a detail button inside it.
+struct Layout {
+    std::vector<std::unique_ptr<Box>> boxes;
+    std::vector<AABB*> items;
+    std::vector<glm::vec2> points;
+
+    explicit Layout(int count) {
+        for (int i = 0; i < count; i++) {
+            int card = i / 3;
+            glm::vec2 position((card % CARD_COLS) * 0.3F, (card / CARD_COLS) * 0.4F);
+            switch (i % 3) {
+                case 0:
+                    Add(glm::vec2(0.28F, 0.38F), position);
+                    break;
+                case 1:
+                    Add(glm::vec2(0.1F, 0.05F), position + glm::vec2(0.02F, 0.02F));
+                    break;
+                default:
+                    Add(glm::vec2(0.1F, 0.05F), position + glm::vec2(0.16F, 0.02F));
+                    break;
+            }
+        }
+        srand(19);
+        glm::vec2 size(CARD_COLS * 0.3F, (count / 3 / CARD_COLS + 1) * 0.4F);
+        for (int i = 0; i < QUERY_POINTS; i++) {
+            points.emplace_back(size.x * rand() / RAND_MAX, size.y * rand() / RAND_MAX);
+        }
+    }
+    void Add(const glm::vec2& size, const glm::vec2& position) {
+        boxes.emplace_back(new Box(size, position));
+        items.push_back(boxes.back().get());
+    }
+};
+}
+
+static void BM_HitTestLinear(benchmark::State& state) {
+    Layout layout(static_cast<int>(state.range(0)));
+    size_t point = 0;
+    for (auto _ : state) {
+        const glm::vec2& p = layout.points[point++ % QUERY_POINTS];
+        int hits = 0;
+        for (auto aabb : layout.items) {
+            if (aabb->aabb_active() && aabb->CheckPointIn(p)) {
+                hits++;
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+}
+BENCHMARK(BM_HitTestLinear)->Arg(30)->Arg(300)->Arg(3000);
+
+static void BM_HitTestGrid(benchmark::State& state) {
+    Layout layout(static_cast<int>(state.range(0)));
+    HitGrid grid;
+    grid.Build(layout.items);
+    std::vector<uint32_t> hits;
+    size_t point = 0;
+    for (auto _ : state) {
+        grid.Query(layout.points[point++ % QUERY_POINTS], &hits);
+        benchmark::DoNotOptimize(hits.data());
+    }
+}
+BENCHMARK(BM_HitTestGrid)->Arg(30)->Arg(300)->Arg(3000);
+
+static void BM_HitGridBuild(benchmark::State& state) {
+    Layout layout(static_cast<int>(state.range(0)));
+    HitGrid grid;
+    for (auto _ : state) {
+        grid.Build(layout.items);
+    }
+}
+BENCHMARK(BM_HitGridBuild)->Arg(30)->Arg(300)->Arg(3000);
@@ -0,0 +1,118 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// decode of a 2048x2048 jpeg to the cpu bitmap kept by Texture.
+// direct: DecodeBuffer of the decoder, the bitmap is the decode target.
+// copy: pixels of the consumer copied to a second buffer, what DecodeBitmap did before.
+// peak_mb is the resident set high water growth of one decode, measured in a forked child
+// with the free heap trimmed and large allocations mapped fresh. linux 4.0+ to reset the high water.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#include "image_decoder.h"
+
+using lark::ImageDecoder;
+using lark::StbImageDecoder;
+
+namespace {
+const int IMAGE_SIZE = 2048;
+
+void AppendBytes(void* context, void* data, int size) {
+    std::vector<char>* out = static_cast<std::vector<char>*>(context);
+    const char* bytes = static_cast<const char*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+}
+
+const std::vector<char>& GetJpeg() {
+    static std::vector<char> jpeg;
+    if (jpeg.empty()) {
+        std::vector<uint8_t> rgb(IMAGE_SIZE * IMAGE_SIZE * 3);
+        srand(20);
+        for (size_t i = 0; i < rgb.size(); i++) {
+            rgb[i] = static_cast<uint8_t>((i / 3 % IMAGE_SIZE) / 8 + rand() % 16);
+        }
+        stbi_write_jpg_to_func(AppendBytes, &jpeg, IMAGE_SIZE, IMAGE_SIZE, 3, rgb.data(), 90);
+    }
+    return jpeg;
+}
+
+uint8_t* Decode(bool copy) {
+    const std::vector<char>& jpeg = GetJpeg();
+    StbImageDecoder decoder;
+    ImageDecoder::Pixels pixels = {};
+    return copy ? decoder.ImageDecoder::DecodeBuffer(jpeg.data(), jpeg.size(), &pixels) :
+           decoder.DecodeBuffer(jpeg.data(), jpeg.size(), &pixels);
+}
+
+// VmHWM, peak resident set since the last ResetHighWater.
+long HighWaterKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+void ResetHighWater() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+double PeakMb(bool copy) {
+    GetJpeg();
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        // free heap of earlier decodes is still resident.
+        malloc_trim(0);
+        mallopt(M_MMAP_THRESHOLD, 64 * 1024);
+        ResetHighWater();
+        long before = HighWaterKb();
+        free(Decode(copy));
+        long peak = HighWaterKb() - before;
+        write(fds[1], &peak, sizeof(peak));
+        _exit(0);
+    }
+    close(fds[1]);
+    long peak = -1;
+    if (read(fds[0], &peak, sizeof(peak)) != sizeof(peak)) {
+        peak = -1;
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return peak / 1024.0;
+}
+
+void DecodeBitmap(benchmark::State& state, bool copy) {
+    GetJpeg();
+    for (auto _ : state) {
+        free(Decode(copy));
+    }
+    state.counters["peak_mb"] = PeakMb(copy);
+}
+}
+
+static void BM_DecodeBitmapDirect(benchmark::State& state) {
+    DecodeBitmap(state, false);
+}
+BENCHMARK(BM_DecodeBitmapDirect)->Unit(benchmark::kMillisecond);
+
+static void BM_DecodeBitmapCopy(benchmark::State& state) {
+    DecodeBitmap(state, true);
+}
+BENCHMARK(BM_DecodeBitmapCopy)->Unit(benchmark::kMillisecond);
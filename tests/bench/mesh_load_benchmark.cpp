@@ -0,0 +1,109 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// controller model load until the vertex and index data are ready for glBufferData.
+// obj: parse the text model and build the 56 byte MeshVertex array, the tinyobj path of Model.
+//      assimp is an android prebuilt, it does the same work with more overhead.
+// pxymesh: read the packed file and index it in place. on device the buffer is the apk asset.
+// counters: cpu_bytes vertex and index data held before upload, file_bytes asset size.
+//
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include "tiny_obj_loader.h"
+#include "mesh_file.h"
+
+using lark::MeshFile;
+
+namespace {
+// lark::MeshVertex.
+struct MeshVertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+    glm::vec3 Tangent;
+    glm::vec3 Bitangent;
+};
+
+// materials do not change the parse cost.
+class NoMaterialReader: public tinyobj::MaterialReader {
+public:
+    std::string operator()(const std::string& matId, std::vector<tinyobj::material_t>& materials,
+                           std::map<std::string, int>& matMap) override {
+        return "";
+    }
+};
+
+const char* MODELS[] = {
+    "xr_app_openxr_oculus/src/main/assets/model/oculus_quest_controller_left/oculus_quest_controller_left",
+    "xr_app_htc/src/main/assets/model/controller_htc_focus/overlay",
+    "xr_app_pico/src/main/assets/model/controller_pico_g2/controller2",
+};
+
+std::vector<char> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+std::string ModelPath(int index, const char* extension) {
+    return std::string(LARK_ROOT_DIR) + "/" + MODELS[index] + extension;
+}
+}
+
+static void BM_LoadObj(benchmark::State& state) {
+    std::string path = ModelPath(static_cast<int>(state.range(0)), ".obj");
+    size_t fileBytes = ReadFile(path).size();
+    size_t cpuBytes = 0;
+    for (auto _ : state) {
+        std::ifstream file(path);
+        NoMaterialReader materialReader;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        tinyobj::LoadObj(shapes, materials, file, materialReader);
+        cpuBytes = 0;
+        for (const auto & shape : shapes) {
+            std::vector<MeshVertex> vertices;
+            for (size_t j = 0; j < shape.mesh.positions.size() / 3; j++) {
+                MeshVertex vertex = {};
+                vertex.Position = glm::vec3(shape.mesh.positions[3 * j], shape.mesh.positions[3 * j + 1],
+                                            shape.mesh.positions[3 * j + 2]);
+                if (shape.mesh.normals.size() > 3 * j + 2) {
+                    vertex.Normal = glm::vec3(shape.mesh.normals[3 * j], shape.mesh.normals[3 * j + 1],
+                                              shape.mesh.normals[3 * j + 2]);
+                }
+                if (shape.mesh.texcoords.size() > 2 * j + 1) {
+                    vertex.TexCoords = glm::vec2(shape.mesh.texcoords[2 * j], shape.mesh.texcoords[2 * j + 1]);
+                }
+                vertices.push_back(vertex);
+            }
+            std::vector<unsigned int> indices(shape.mesh.indices);
+            cpuBytes += vertices.size() * sizeof(MeshVertex) + indices.size() * sizeof(unsigned int);
+            benchmark::DoNotOptimize(vertices.data());
+        }
+    }
+    state.counters["cpu_bytes"] = static_cast<double>(cpuBytes);
+    state.counters["file_bytes"] = static_cast<double>(fileBytes);
+}
+BENCHMARK(BM_LoadObj)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadPxymesh(benchmark::State& state) {
+    std::string path = ModelPath(static_cast<int>(state.range(0)), MeshFile::EXTENSION);
+    size_t fileBytes = 0;
+    for (auto _ : state) {
+        std::vector<char> data = ReadFile(path);
+        std::vector<MeshFile::MeshView> views;
+        bool res = MeshFile::Parse(data.data(), data.size(), &views);
+        benchmark::DoNotOptimize(res);
+        fileBytes = data.size();
+    }
+    // uploaded straight from the file buffer.
+    state.counters["cpu_bytes"] = static_cast<double>(fileBytes);
+    state.counters["file_bytes"] = static_cast<double>(fileBytes);
+}
+BENCHMARK(BM_LoadPxymesh)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
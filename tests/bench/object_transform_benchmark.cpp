@@ -0,0 +1,124 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// world transforms of a 500 node ui tree, every node asked once per eye per frame like the
+// draw calls do. home page root, 50 cover items, 9 components each (cover, borders, title,
+// tail, icon...).
+// walk: the parent chain multiplied on every call, as GetTransforms did before the cache.
+// cached: lark::Object. arg 0 is how many cover items move per frame, 50 moves the root.
+//
+
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "object.h"
+
+using lark::Object;
+
+namespace {
+const int ITEMS = 50;
+const int COMPONENTS = 9;
+
+class Node: public Object {
+public:
+    glm::mat4 local() const { return transform_.GetTrans(); }
+};
+
+// the recursive GetTransforms before the cache.
+glm::mat4 WalkTransforms(Node* node) {
+    if (node->parent() != nullptr) {
+        return WalkTransforms(static_cast<Node*>(node->parent())) * node->local();
+    }
+    return node->local();
+}
+
+struct Tree {
+    Tree() {
+        root.reset(new Node());
+        nodes.push_back(root.get());
+        for (int i = 0; i < ITEMS; i++) {
+            Node* item = new Node();
+            item->set_parent(root.get());
+            item->Move(static_cast<float>(i % 5), static_cast<float>(i / 5), 0);
+            owned.emplace_back(item);
+            nodes.push_back(item);
+            items.push_back(item);
+            for (int c = 0; c < COMPONENTS; c++) {
+                Node* component = new Node();
+                component->set_parent(item);
+                component->Move(0, 0, 0.01F * c);
+                owned.emplace_back(component);
+                nodes.push_back(component);
+            }
+        }
+    }
+    // components first, parents must outlive them.
+    ~Tree() {
+        for (auto it = owned.rbegin(); it != owned.rend(); ++it) {
+            it->reset();
+        }
+    }
+
+    void Animate(int moving) {
+        if (moving >= ITEMS) {
+            root->Move(0, 0, 0.001F);
+            return;
+        }
+        for (int i = 0; i < moving; i++) {
+            items[i]->Move(0, 0, 0.001F);
+        }
+    }
+
+    std::unique_ptr<Node> root;
+    std::vector<std::unique_ptr<Node>> owned;
+    std::vector<Node*> nodes;
+    std::vector<Node*> items;
+};
+}
+
+static void BM_TransformWalk(benchmark::State& state) {
+    Tree tree;
+    for (auto _ : state) {
+        tree.Animate(static_cast<int>(state.range(0)));
+        for (int eye = 0; eye < 2; eye++) {
+            for (Node* node : tree.nodes) {
+                glm::mat4 world = WalkTransforms(node);
+                benchmark::DoNotOptimize(world);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * tree.nodes.size() * 2);
+}
+BENCHMARK(BM_TransformWalk)->Arg(0)->Arg(1)->Arg(ITEMS);
+
+static void BM_TransformCached(benchmark::State& state) {
+    Tree tree;
+    for (auto _ : state) {
+        tree.Animate(static_cast<int>(state.range(0)));
+        for (int eye = 0; eye < 2; eye++) {
+            for (Node* node : tree.nodes) {
+                const glm::mat4& world = node->GetTransforms();
+                benchmark::DoNotOptimize(world);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * tree.nodes.size() * 2);
+}
+BENCHMARK(BM_TransformCached)->Arg(0)->Arg(1)->Arg(ITEMS);
+
+// one top down pass per frame before drawing.
+static void BM_TransformUpdatePass(benchmark::State& state) {
+    Tree tree;
+    for (auto _ : state) {
+        tree.Animate(static_cast<int>(state.range(0)));
+        tree.root->UpdateWorldTransforms();
+        for (int eye = 0; eye < 2; eye++) {
+            for (Node* node : tree.nodes) {
+                const glm::mat4& world = node->GetTransforms();
+                benchmark::DoNotOptimize(world);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * tree.nodes.size() * 2);
+}
+BENCHMARK(BM_TransformUpdatePass)->Arg(0)->Arg(1)->Arg(ITEMS);
@@ -0,0 +1,117 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// render thread lookup of the latched pose while the tracking thread pushes frames.
+// PoseHistory against the std::map + std::mutex history the apps used before.
+// arg 0 is the producer rate in Hz, 0 pushes as fast as possible.
+//
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "pose_history.h"
+
+namespace {
+// the history the cloudxr apps kept before PoseHistory.
+class MapHistory {
+public:
+    static const int MAXIMUM_TRACKING_FRAMES = 50;
+
+    void Push(const larkxrTrackingFrame& frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        map_.insert(std::pair<uint64_t, larkxrTrackingFrame>(frame.frameIndex, frame));
+        if (map_.size() > MAXIMUM_TRACKING_FRAMES) {
+            map_.erase(map_.cbegin());
+        }
+        latest_.store(frame.frameIndex, std::memory_order_release);
+    }
+
+    bool Find(uint64_t frameIndex, larkxrTrackingFrame* frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(frameIndex);
+        if (it != map_.end()) {
+            *frame = it->second;
+            return true;
+        }
+        if (!map_.empty()) {
+            *frame = map_.cbegin()->second;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t latest() const { return latest_.load(std::memory_order_acquire); }
+private:
+    std::map<uint64_t, larkxrTrackingFrame> map_;
+    std::mutex mutex_;
+    std::atomic<uint64_t> latest_{0};
+};
+
+class RingHistory {
+public:
+    void Push(const larkxrTrackingFrame& frame) {
+        history_.Push(frame);
+        latest_.store(frame.frameIndex, std::memory_order_release);
+    }
+
+    bool Find(uint64_t frameIndex, larkxrTrackingFrame* frame) {
+        return history_.Find(frameIndex, frame) || history_.Latest(frame);
+    }
+
+    uint64_t latest() const { return latest_.load(std::memory_order_acquire); }
+private:
+    PoseHistory history_;
+    std::atomic<uint64_t> latest_{0};
+};
+
+// tracking thread of the cloudxr client.
+template<typename History>
+class Producer {
+public:
+    Producer(History* history, int64_t rateHz): history_(history) {
+        thread_ = std::thread([this, rateHz] {
+            auto period = std::chrono::nanoseconds(rateHz > 0 ? 1000000000 / rateHz : 0);
+            auto next = std::chrono::steady_clock::now();
+            uint64_t index = 1;
+            while (running_.load(std::memory_order_relaxed)) {
+                larkxrTrackingFrame frame = {};
+                frame.frameIndex = index++;
+                history_->Push(frame);
+                if (rateHz > 0) {
+                    next += period;
+                    std::this_thread::sleep_until(next);
+                }
+            }
+        });
+        // wait for the first frames.
+        while (history_->latest() < 4) {
+            std::this_thread::yield();
+        }
+    }
+    ~Producer() {
+        running_ = false;
+        thread_.join();
+    }
+private:
+    History* history_;
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+template<typename History>
+void BM_Lookup(benchmark::State& state) {
+    auto history = std::unique_ptr<History>(new History());
+    Producer<History> producer(history.get(), state.range(0));
+    larkxrTrackingFrame frame = {};
+    for (auto _ : state) {
+        // latched frame is usually a few frames behind the newest pose.
+        benchmark::DoNotOptimize(history->Find(history->latest() - 2, &frame));
+    }
+}
+}
+
+BENCHMARK_TEMPLATE(BM_Lookup, MapHistory)->Arg(144)->Arg(0)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Lookup, RingHistory)->Arg(144)->Arg(0)->UseRealTime();
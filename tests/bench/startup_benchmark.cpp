@@ -0,0 +1,90 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// render thread time from InitGL to the first home frame, startup assets of the Oculus OpenXR app.
+// sync: Load blocks InitGL. async: LoadAsync and the first Update, the rest is finished by later frames.
+// ready_ms and frames count until every asset is loaded, 1ms apart like a 1000hz frame loop.
+// gl calls go to the shim, the ui of the home frame is not drawn.
+//
+
+#include <chrono>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "asset_files.h"
+#include "asset_loader.h"
+
+using lark::AndroidAssetContext;
+using lark::AssetLoader;
+using lark::AssetLists;
+
+namespace {
+struct App {
+    JavaVM vm;
+    ANativeActivity activity;
+    AndroidAssetContext context;
+    AssetLists assets;
+
+    App(): vm(), activity(), context() {
+        // library assets merged into the apk.
+        AAssetManager* assetManager = AAssetManager_fromDirectory(LARK_ROOT_DIR "/xr_app_openxr_oculus/src/main/assets");
+        AAssetManager_addDirectory(assetManager, LARK_ROOT_DIR "/lib_xr_common_ui/src/main/assets");
+        activity.vm = &vm;
+        activity.internalDataPath = "/tmp";
+        activity.assetManager = assetManager;
+        context = { &activity, nullptr, nullptr };
+        assets = Assetlist;
+        // controllers of CONTROLLER_OCULUS_QUEST.
+        assets.modals.push_back({ "model/oculus_quest_controller_left/oculus_quest_controller_left.obj" });
+        assets.modals.push_back({ "model/oculus_quest_controller_right/oculus_quest_controller_right.obj" });
+    }
+};
+
+App* GetApp() {
+    static App app;
+    return &app;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+static void BM_StartupSync(benchmark::State& state) {
+    App* app = GetApp();
+    for (auto _ : state) {
+        AssetLoader::Release();
+        AssetLoader::instance()->Load(&app->context, app->assets);
+        AssetLoader::instance()->Update();
+    }
+    AssetLoader::Release();
+}
+BENCHMARK(BM_StartupSync)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(10);
+
+static void BM_StartupAsync(benchmark::State& state) {
+    App* app = GetApp();
+    double readyMs = 0;
+    int frames = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        AssetLoader::Release();
+        state.ResumeTiming();
+
+        auto start = std::chrono::steady_clock::now();
+        AssetLoader::instance()->LoadAsync(&app->context, app->assets);
+        AssetLoader::instance()->Update();
+
+        state.PauseTiming();
+        frames++;
+        while (AssetLoader::instance()->pending() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            AssetLoader::instance()->Update();
+            frames++;
+        }
+        readyMs += ElapsedMs(start);
+        state.ResumeTiming();
+    }
+    AssetLoader::Release();
+    state.counters["ready_ms"] = readyMs / state.iterations();
+    state.counters["frames"] = static_cast<double>(frames) / state.iterations();
+}
+BENCHMARK(BM_StartupAsync)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(10);
@@ -0,0 +1,129 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <memory>
+#include <set>
+#include <tuple>
+#include <gtest/gtest.h>
+#include "gl_shim.h"
+#include "ui/component/font_cache.h"
+
+namespace {
+// cjk code points, DejaVu draws them with the same visible notdef box.
+const wchar_t CJK_BASE = 0x4E00;
+
+class FontFaceTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        gl_shim::Reset();
+        FT_Library ft = nullptr;
+        ASSERT_EQ(FT_Init_FreeType(&ft), 0);
+        ft_ = std::shared_ptr<FT_LibraryRec_>(ft, FT_Done_FreeType);
+    }
+
+    std::shared_ptr<FontFace> MakeFace(FT_UInt pixelSize) {
+        auto face = std::make_shared<FontFace>(ft_, LARK_TEST_FONT, pixelSize);
+        EXPECT_TRUE(face->is_valid());
+        return face;
+    }
+
+    // u0 v0 of every glyph of the string, glyphs missing are skipped.
+    static std::set<std::tuple<float, float>> BuildString(FontFace* face, wchar_t first, int count) {
+        std::set<std::tuple<float, float>> cells;
+        face->BeginString();
+        for (int i = 0; i < count; i++) {
+            const FontFace::Glyph* glyph = face->GetGlyph(static_cast<wchar_t>(first + i));
+            if (glyph != nullptr) {
+                cells.insert(std::make_tuple(glyph->uv.x, glyph->uv.y));
+            }
+        }
+        face->EndString();
+        return cells;
+    }
+
+    std::shared_ptr<FT_LibraryRec_> ft_;
+};
+}
+
+TEST_F(FontFaceTest, UploadsGlyphOnce) {
+    auto face = MakeFace(36);
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    EXPECT_EQ(face->misses(), 1u);
+    EXPECT_EQ(face->hits(), 1u);
+    EXPECT_EQ(gl_shim::Count("glTexImage2D"), 1u);
+    EXPECT_EQ(gl_shim::Count("glTexSubImage2D"), 1u);
+}
+
+TEST_F(FontFaceTest, SpaceTakesNoCell) {
+    auto face = MakeFace(36);
+    const FontFace::Glyph* glyph = face->GetGlyph(L' ');
+    ASSERT_NE(glyph, nullptr);
+    EXPECT_FALSE(glyph->visible);
+    EXPECT_GT(glyph->advance, 0);
+    EXPECT_EQ(gl_shim::Count("glTexSubImage2D"), 0u);
+}
+
+TEST_F(FontFaceTest, LongStringGrowsAtlasInsteadOfEvictingItself) {
+    auto face = MakeFace(40);
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    const int capacity = face->capacity();
+    ASSERT_GT(capacity, 0);
+
+    const int count = capacity + 16;
+    BuildString(face.get(), CJK_BASE, count);
+    EXPECT_EQ(face->layout_version(), 1u);
+    EXPECT_GT(face->capacity(), capacity);
+    // only 'A', not used by the string.
+    EXPECT_EQ(face->evictions(), 1u);
+    EXPECT_EQ(face->dropped(), 0u);
+
+    // after growing every glyph of the string owns its own cell.
+    auto cells = BuildString(face.get(), CJK_BASE, count);
+    EXPECT_EQ(cells.size(), static_cast<size_t>(count));
+}
+
+TEST_F(FontFaceTest, StringOverMaxAtlasDropsGlyphs) {
+    // big glyphs, atlas starts at max size.
+    auto face = MakeFace(150);
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    const int capacity = face->capacity();
+
+    auto cells = BuildString(face.get(), CJK_BASE, capacity + 5);
+    EXPECT_EQ(face->layout_version(), 0u);
+    // 'A' was not pinned by the string, it is evicted before dropping.
+    EXPECT_EQ(face->evictions(), 1u);
+    EXPECT_EQ(face->dropped(), 5u);
+    EXPECT_EQ(cells.size(), static_cast<size_t>(capacity));
+}
+
+TEST_F(FontFaceTest, EvictsLeastRecentlyUsedGlyphOfOtherStrings) {
+    auto face = MakeFace(150);
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    const int capacity = face->capacity();
+    BuildString(face.get(), CJK_BASE, capacity - 1);
+    EXPECT_EQ(face->evictions(), 0u);
+
+    // touch 'A', the first cjk glyph is the oldest now.
+    uint64_t generation = face->generation();
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    BuildString(face.get(), L'B', 1);
+    EXPECT_EQ(face->evictions(), 1u);
+    EXPECT_GT(face->generation(), generation);
+
+    uint64_t misses = face->misses();
+    ASSERT_NE(face->GetGlyph(L'A'), nullptr);
+    EXPECT_EQ(face->misses(), misses);
+    ASSERT_NE(face->GetGlyph(CJK_BASE), nullptr);
+    EXPECT_EQ(face->misses(), misses + 1);
+}
+
+TEST_F(FontFaceTest, AtlasCreateFailure) {
+    auto face = MakeFace(36);
+    gl_shim::SetError(GL_OUT_OF_MEMORY);
+    EXPECT_EQ(face->GetGlyph(L'A'), nullptr);
+    EXPECT_EQ(gl_shim::Count("glDeleteTextures"), 1u);
+    // next glyph tries again.
+    EXPECT_NE(face->GetGlyph(L'A'), nullptr);
+}
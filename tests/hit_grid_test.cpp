@@ -0,0 +1,174 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ui/hit_grid.h"
+
+namespace {
+class Box : public AABB {
+public:
+    Box(const glm::vec2& size, const glm::vec2& position): AABB(0, size, position) {}
+    void HandleInput(glm::vec2* point, int pointCount) override {}
+};
+
+struct Layout {
+    std::vector<std::unique_ptr<Box>> boxes;
+    std::vector<AABB*> items;
+
+    void Add(const glm::vec2& size, const glm::vec2& position) {
+        boxes.emplace_back(new Box(size, position));
+        items.push_back(boxes.back().get());
+    }
+};
+
+// same edge rule as the grid.
+std::vector<uint32_t> Scan(const std::vector<AABB*>& items, const glm::vec2& point) {
+    std::vector<uint32_t> hits;
+    for (uint32_t i = 0; i < items.size(); i++) {
+        if (!items[i]->aabb_active()) {
+            continue;
+        }
+        glm::vec2 d = point - items[i]->GetAABBPosition();
+        glm::vec2 size = items[i]->GetAABBSize();
+        if (d.x >= 0 && d.y >= 0 && d.x <= size.x && d.y <= size.y) {
+            hits.push_back(i);
+        }
+    }
+    return hits;
+}
+
+float Random(float min, float max) {
+    return min + (max - min) * static_cast<float>(rand()) / RAND_MAX;
+}
+}
+
+TEST(HitGridTest, EmptyGrid) {
+    HitGrid grid;
+    std::vector<uint32_t> hits = { 7 };
+    grid.Query(glm::vec2(0, 0), &hits);
+    EXPECT_TRUE(hits.empty());
+
+    grid.Build({});
+    grid.Query(glm::vec2(0, 0), &hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(HitGridTest, OverlappingHitsAscending) {
+    Layout layout;
+    layout.Add(glm::vec2(2, 2), glm::vec2(0, 0));
+    layout.Add(glm::vec2(1, 1), glm::vec2(5, 5));
+    layout.Add(glm::vec2(2, 2), glm::vec2(1, 1));
+    HitGrid grid;
+    grid.Build(layout.items);
+
+    std::vector<uint32_t> hits;
+    grid.Query(glm::vec2(1.5F, 1.5F), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 0, 2 }));
+    grid.Query(glm::vec2(5.5F, 5.5F), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 1 }));
+    // inside the bounds, between the boxes.
+    grid.Query(glm::vec2(4, 1), &hits);
+    EXPECT_TRUE(hits.empty());
+    // outside the bounds.
+    grid.Query(glm::vec2(-1, 0), &hits);
+    EXPECT_TRUE(hits.empty());
+    grid.Query(glm::vec2(6.1F, 6), &hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(HitGridTest, EdgesIncluded) {
+    Layout layout;
+    layout.Add(glm::vec2(1, 1), glm::vec2(0, 0));
+    layout.Add(glm::vec2(1, 1), glm::vec2(3, 3));
+    HitGrid grid;
+    grid.Build(layout.items);
+
+    std::vector<uint32_t> hits;
+    grid.Query(glm::vec2(0, 0), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 0 }));
+    // max corner of the whole grid, clamped into the last cell.
+    grid.Query(glm::vec2(4, 4), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 1 }));
+}
+
+TEST(HitGridTest, InactiveSkipped) {
+    Layout layout;
+    layout.Add(glm::vec2(2, 2), glm::vec2(0, 0));
+    layout.Add(glm::vec2(2, 2), glm::vec2(0, 0));
+    layout.boxes[0]->set_aabb_active(false);
+    HitGrid grid;
+    grid.Build(layout.items);
+    ASSERT_EQ(grid.items().size(), 2u);
+
+    std::vector<uint32_t> hits;
+    grid.Query(glm::vec2(1, 1), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 1 }));
+
+    layout.boxes[1]->set_aabb_active(false);
+    grid.Build(layout.items);
+    grid.Query(glm::vec2(1, 1), &hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(HitGridTest, FlatLayout) {
+    // a row of buttons with no height, cells must not divide by zero.
+    Layout layout;
+    for (int i = 0; i < 10; i++) {
+        layout.Add(glm::vec2(1, 0), glm::vec2(i * 2, 3));
+    }
+    HitGrid grid;
+    grid.Build(layout.items);
+    std::vector<uint32_t> hits;
+    grid.Query(glm::vec2(4.5F, 3), &hits);
+    EXPECT_EQ(hits, std::vector<uint32_t>({ 2 }));
+    grid.Query(glm::vec2(4.5F, 3.1F), &hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(HitGridTest, MatchesLinearScan) {
+    srand(19);
+    Layout layout;
+    for (int i = 0; i < 2000; i++) {
+        layout.Add(glm::vec2(Random(0.01F, 0.3F), Random(0.01F, 0.3F)), glm::vec2(Random(-2, 2), Random(-1, 1)));
+        if (i % 7 == 0) {
+            layout.boxes.back()->set_aabb_active(false);
+        }
+    }
+    HitGrid grid;
+    grid.Build(layout.items);
+
+    std::vector<uint32_t> hits;
+    for (int i = 0; i < 20000; i++) {
+        glm::vec2 point(Random(-2.5F, 2.5F), Random(-1.5F, 1.5F));
+        grid.Query(point, &hits);
+        ASSERT_EQ(hits, Scan(layout.items, point)) << point.x << " " << point.y;
+    }
+}
+
+TEST(HitGridTest, LayoutVersionChanges) {
+    Box box(glm::vec2(1, 1), glm::vec2(0, 0));
+    uint64_t version = AABB::layout_version();
+    box.SetAABBPositon(glm::vec2(1, 1));
+    EXPECT_GT(AABB::layout_version(), version);
+
+    version = AABB::layout_version();
+    box.SetAABBSize(glm::vec2(2, 2));
+    EXPECT_GT(AABB::layout_version(), version);
+
+    version = AABB::layout_version();
+    box.SetAABBBCenter(glm::vec2(0, 0));
+    EXPECT_GT(AABB::layout_version(), version);
+
+    version = AABB::layout_version();
+    box.set_aabb_active(false);
+    EXPECT_GT(AABB::layout_version(), version);
+
+    // same state, nothing to rebuild.
+    version = AABB::layout_version();
+    box.set_aabb_active(false);
+    EXPECT_EQ(AABB::layout_version(), version);
+}
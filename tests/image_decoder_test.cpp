@@ -0,0 +1,90 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "image_decoder.h"
+#include "texture.h"
+#include "support/gl_shim.h"
+
+using lark::ImageDecoder;
+using lark::StbImageDecoder;
+
+namespace {
+const int WIDTH = 48;
+const int HEIGHT = 16;
+
+// binary ppm, pixel value encodes row and column.
+std::vector<char> MakePpm() {
+    std::string header = "P6\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n255\n";
+    std::vector<char> data(header.begin(), header.end());
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            data.push_back(static_cast<char>(y));
+            data.push_back(static_cast<char>(x));
+            data.push_back(7);
+        }
+    }
+    return data;
+}
+
+std::vector<uint8_t> ConsumerPixels(ImageDecoder* decoder, const std::vector<char>& data) {
+    std::vector<uint8_t> res;
+    decoder->Decode(data.data(), data.size(), [&](const ImageDecoder::Pixels& pixels) {
+        res.assign(pixels.data, pixels.data + pixels.stride * pixels.height);
+    });
+    return res;
+}
+}
+
+TEST(ImageDecoderTest, DecodeBufferMatchesConsumer) {
+    std::vector<char> data = MakePpm();
+    StbImageDecoder decoder;
+    std::vector<uint8_t> expected = ConsumerPixels(&decoder, data);
+    ASSERT_EQ(expected.size(), WIDTH * HEIGHT * 4u);
+
+    // the stb buffer itself and the default copy.
+    for (bool copy : { false, true }) {
+        ImageDecoder::Pixels pixels = {};
+        uint8_t* buffer = copy ? decoder.ImageDecoder::DecodeBuffer(data.data(), data.size(), &pixels) :
+                          decoder.DecodeBuffer(data.data(), data.size(), &pixels);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(pixels.data, buffer);
+        EXPECT_EQ(pixels.width, WIDTH);
+        EXPECT_EQ(pixels.height, HEIGHT);
+        EXPECT_EQ(pixels.stride, WIDTH * 4);
+        EXPECT_EQ(pixels.format, static_cast<GLenum>(GL_RGBA));
+        EXPECT_EQ(memcmp(buffer, expected.data(), expected.size()), 0);
+        free(buffer);
+    }
+}
+
+TEST(ImageDecoderTest, DecodeBufferFails) {
+    const char broken[] = "not an image";
+    StbImageDecoder decoder;
+    ImageDecoder::Pixels pixels = {};
+    EXPECT_EQ(decoder.DecodeBuffer(broken, sizeof(broken), &pixels), nullptr);
+    EXPECT_EQ(decoder.ImageDecoder::DecodeBuffer(broken, sizeof(broken), &pixels), nullptr);
+}
+
+TEST(ImageDecoderTest, LoadTextureKeepsDecodedBitmap) {
+    gl_shim::Reset();
+    std::vector<char> data = MakePpm();
+    StbImageDecoder decoder;
+    std::vector<uint8_t> expected = ConsumerPixels(&decoder, data);
+
+    lark::Texture* texture = lark::Texture::LoadTexture(nullptr, nullptr, data.data(), static_cast<int>(data.size()), 0);
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(texture->width(), static_cast<size_t>(WIDTH));
+    EXPECT_EQ(texture->height(), static_cast<size_t>(HEIGHT));
+    ASSERT_NE(texture->bitmap(), nullptr);
+    EXPECT_EQ(memcmp(texture->bitmap(), expected.data(), expected.size()), 0);
+    delete texture;
+
+    const char broken[] = "not an image";
+    EXPECT_EQ(lark::Texture::LoadTexture(nullptr, nullptr, broken, sizeof(broken), 0), nullptr);
+}
@@ -0,0 +1,160 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "input.h"
+
+namespace {
+// 72hz frames.
+const uint64_t FRAME_US = 13889;
+
+// one frame of a trace, raw button state of every ray.
+struct Frame {
+    bool back[Input::RayCast_Count];
+    bool enter[Input::RayCast_Count];
+    bool trigger[Input::RayCast_Count];
+};
+
+class InputTest : public testing::Test {
+protected:
+    void SetUp() override {
+        Input::ResetInput();
+        timestamp_ = 1000 * 1000;
+    }
+
+    // what the scenes do every frame, left and right controller.
+    void Update(const Frame& frame) {
+        timestamp_ += FRAME_US;
+        for (auto ray : { Input::RayCast_left, Input::RayCast_Right }) {
+            Input::UpdateButtons(ray, frame.back[ray], frame.enter[ray], frame.trigger[ray], timestamp_);
+        }
+    }
+    void Trigger(Input::RayCastType ray, bool down) {
+        Frame frame = {};
+        frame.trigger[ray] = down;
+        Update(frame);
+    }
+    // what View::HandleInput does after the frame update.
+    std::vector<Input::Event> Drain() {
+        std::vector<Input::Event> events;
+        Input::Event event = {};
+        while (Input::PollEvent(&event)) {
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    uint64_t timestamp_ = 0;
+};
+}
+
+TEST_F(InputTest, ClickEdges) {
+    Trigger(Input::RayCast_Right, true);
+    std::vector<Input::Event> events = Drain();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, Input::Event_Down);
+    EXPECT_EQ(events[0].button, Input::Button_Trigger);
+    EXPECT_EQ(events[0].ray, Input::RayCast_Right);
+    EXPECT_EQ(events[0].timestamp, timestamp_);
+    EXPECT_TRUE(Input::GetInputState()[Input::RayCast_Right].triggerButtonDown);
+
+    // held, no events.
+    Trigger(Input::RayCast_Right, true);
+    EXPECT_TRUE(Drain().empty());
+
+    Trigger(Input::RayCast_Right, false);
+    events = Drain();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, Input::Event_Up);
+    EXPECT_EQ(events[1].type, Input::Event_Click);
+    EXPECT_TRUE(Input::GetInputState()[Input::RayCast_Right].triggerShortPressed);
+
+    Trigger(Input::RayCast_Right, false);
+    EXPECT_TRUE(Drain().empty());
+    EXPECT_FALSE(Input::GetInputState()[Input::RayCast_Right].triggerShortPressed);
+}
+
+TEST_F(InputTest, LongPressWithoutClick) {
+    Trigger(Input::RayCast_left, true);
+    EXPECT_EQ(Drain().size(), 1u);
+    int longPress = 0;
+    for (uint64_t held = 0; held < Input::LONG_PRESS_US + 2 * FRAME_US; held += FRAME_US) {
+        Trigger(Input::RayCast_left, true);
+        for (const auto & event : Drain()) {
+            EXPECT_EQ(event.type, Input::Event_LongPress);
+            longPress++;
+        }
+    }
+    EXPECT_EQ(longPress, 1);
+    Trigger(Input::RayCast_left, false);
+    std::vector<Input::Event> events = Drain();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, Input::Event_Up);
+}
+
+TEST_F(InputTest, BothRaysSameFrame) {
+    Frame frame = {};
+    frame.back[Input::RayCast_left] = true;
+    frame.enter[Input::RayCast_Right] = true;
+    frame.trigger[Input::RayCast_Right] = true;
+    Update(frame);
+    std::vector<Input::Event> events = Drain();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].ray, Input::RayCast_left);
+    EXPECT_EQ(events[0].button, Input::Button_Back);
+    EXPECT_EQ(events[1].button, Input::Button_Enter);
+    EXPECT_EQ(events[2].button, Input::Button_Trigger);
+}
+
+TEST_F(InputTest, UndrainedFramesDropped) {
+    // a click while the cloud scene streamed and no view drained.
+    Trigger(Input::RayCast_Right, true);
+    Trigger(Input::RayCast_Right, false);
+    // back in the local scene, nothing happens this frame.
+    Trigger(Input::RayCast_Right, false);
+    EXPECT_TRUE(Drain().empty());
+
+    // only this frame's press.
+    Trigger(Input::RayCast_Right, true);
+    std::vector<Input::Event> events = Drain();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].type, Input::Event_Down);
+}
+
+TEST_F(InputTest, FullQueueKeepsCurrentFrame) {
+    // a long trace of clicks on every button, never drained, wraps the ring many times.
+    for (int i = 0; i < 200; i++) {
+        Frame frame = {};
+        for (int ray = 0; ray < 2; ray++) {
+            frame.back[ray] = frame.enter[ray] = frame.trigger[ray] = i % 2 == 0;
+        }
+        Update(frame);
+    }
+    // last frame released everything, up and click of 3 buttons on 2 rays.
+    std::vector<Input::Event> events = Drain();
+    ASSERT_EQ(events.size(), 12u);
+    for (const auto & event : events) {
+        EXPECT_EQ(event.timestamp, timestamp_);
+        EXPECT_TRUE(event.type == Input::Event_Up || event.type == Input::Event_Click);
+    }
+    EXPECT_TRUE(Drain().empty());
+}
+
+TEST_F(InputTest, ResetClearsQueue) {
+    Trigger(Input::RayCast_Right, true);
+    Input::ResetInput();
+    EXPECT_TRUE(Drain().empty());
+    // edge state reset too, still down counts as a new press.
+    Trigger(Input::RayCast_Right, true);
+    EXPECT_EQ(Drain().size(), 1u);
+}
+
+TEST_F(InputTest, ClearEvents) {
+    Trigger(Input::RayCast_Right, true);
+    Input::ClearEvents();
+    EXPECT_TRUE(Drain().empty());
+    Trigger(Input::RayCast_Right, false);
+    EXPECT_EQ(Drain().size(), 2u);
+}
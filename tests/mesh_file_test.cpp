@@ -0,0 +1,169 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <glm/gtc/packing.hpp>
+#include <gtest/gtest.h>
+#include "mesh_file.h"
+
+using lark::MeshFile;
+
+namespace {
+// quad of two triangles.
+MeshFile::SourceMesh MakeQuad(float size) {
+    MeshFile::SourceMesh mesh;
+    mesh.positions = { {0, 0, 0}, {size, 0, 0}, {size, size, 0}, {0, size, 0} };
+    mesh.normals = { {0, 0, 2}, {0, 0, 1}, {0, 1, 0}, {1, 0, 0} };
+    mesh.texcoords = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+    mesh.indices = { 0, 1, 2, 0, 2, 3 };
+    mesh.diffuse_texture = "quad.png";
+    return mesh;
+}
+
+std::vector<uint8_t> MakeFile(const std::vector<MeshFile::SourceMesh>& meshes) {
+    MeshFile::FileHeader header = { MeshFile::MAGIC, MeshFile::VERSION, static_cast<uint32_t>(meshes.size()), 0 };
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    std::vector<uint8_t> data(bytes, bytes + sizeof(header));
+    std::vector<uint8_t> block;
+    for (const auto & mesh : meshes) {
+        MeshFile::Pack(mesh, MeshFile::DEFAULT_MAX_POSITION_ERROR, &block);
+        data.insert(data.end(), block.begin(), block.end());
+    }
+    return data;
+}
+
+glm::vec3 UnpackNormal(const uint8_t* vertex, uint32_t offset) {
+    uint32_t packed = 0;
+    memcpy(&packed, vertex + offset, sizeof(packed));
+    return glm::vec3(glm::unpackSnorm3x10_1x2(packed));
+}
+}
+
+TEST(MeshFileTest, MeshPath) {
+    EXPECT_EQ(MeshFile::GetMeshPath("model/a/b.obj"), "model/a/b.pxymesh");
+    EXPECT_EQ(MeshFile::GetMeshPath("model/a.b/c"), "model/a.b/c.pxymesh");
+}
+
+TEST(MeshFileTest, PackAndParse) {
+    std::vector<uint8_t> data = MakeFile({ MakeQuad(1.0F), MakeQuad(2.0F) });
+    std::vector<MeshFile::MeshView> views;
+    ASSERT_TRUE(MeshFile::Parse(data.data(), data.size(), &views));
+    ASSERT_EQ(views.size(), 2u);
+
+    const MeshFile::MeshHeader* header = views[1].header;
+    EXPECT_EQ(header->vertex_count, 4u);
+    EXPECT_EQ(header->index_count, 6u);
+    EXPECT_EQ(header->position_format, static_cast<uint32_t>(MeshFile::PositionFormat_Half));
+    EXPECT_EQ(header->index_size, 2u);
+    EXPECT_EQ(header->vertex_stride, 16u);
+    EXPECT_STREQ(header->diffuse_texture, "quad.png");
+
+    const uint8_t* vertices = static_cast<const uint8_t*>(views[1].vertices);
+    const uint8_t* vertex = vertices + 2 * header->vertex_stride;
+    uint64_t position = 0;
+    memcpy(&position, vertex, sizeof(position));
+    glm::vec4 p = glm::unpackHalf4x16(position);
+    EXPECT_FLOAT_EQ(p.x, 2.0F);
+    EXPECT_FLOAT_EQ(p.y, 2.0F);
+    uint32_t uv = 0;
+    memcpy(&uv, vertex + MeshFile::GetTexCoordOffset(header->position_format), sizeof(uv));
+    EXPECT_FLOAT_EQ(glm::unpackHalf2x16(uv).x, 1.0F);
+
+    // normalized before packing.
+    glm::vec3 n = UnpackNormal(vertices, MeshFile::GetNormalOffset(header->position_format));
+    EXPECT_NEAR(n.z, 1.0F, 0.002F);
+
+    const uint16_t* indices = static_cast<const uint16_t*>(views[1].indices);
+    EXPECT_EQ(indices[5], 3);
+}
+
+TEST(MeshFileTest, FloatPositionsWhenHalfLosesTooMuch) {
+    // half float step at 1000 is 0.5.
+    MeshFile::SourceMesh mesh = MakeQuad(1000.3F);
+    std::vector<uint8_t> data = MakeFile({ mesh });
+    std::vector<MeshFile::MeshView> views;
+    ASSERT_TRUE(MeshFile::Parse(data.data(), data.size(), &views));
+    const MeshFile::MeshHeader* header = views[0].header;
+    EXPECT_EQ(header->position_format, static_cast<uint32_t>(MeshFile::PositionFormat_Float));
+    EXPECT_EQ(header->vertex_stride, 20u);
+    glm::vec3 p;
+    memcpy(&p, static_cast<const uint8_t*>(views[0].vertices) + header->vertex_stride, sizeof(p));
+    EXPECT_FLOAT_EQ(p.x, 1000.3F);
+}
+
+TEST(MeshFileTest, WideIndicesForLargeMeshes) {
+    MeshFile::SourceMesh mesh;
+    mesh.positions.resize(65537, glm::vec3(0.0F));
+    mesh.indices = { 0, 1, 65536 };
+    std::vector<uint8_t> data = MakeFile({ mesh });
+    std::vector<MeshFile::MeshView> views;
+    ASSERT_TRUE(MeshFile::Parse(data.data(), data.size(), &views));
+    EXPECT_EQ(views[0].header->index_size, 4u);
+    EXPECT_EQ(static_cast<const uint32_t*>(views[0].indices)[2], 65536u);
+    // no normals and texcoords in the source.
+    EXPECT_NEAR(UnpackNormal(static_cast<const uint8_t*>(views[0].vertices), 8).z, 1.0F, 0.002F);
+}
+
+TEST(MeshFileTest, RejectsBrokenFiles) {
+    std::vector<uint8_t> data = MakeFile({ MakeQuad(1.0F) });
+    std::vector<MeshFile::MeshView> views;
+
+    // truncated.
+    for (size_t size : { static_cast<size_t>(0), sizeof(MeshFile::FileHeader) + 10, data.size() - 1 }) {
+        EXPECT_FALSE(MeshFile::Parse(data.data(), size, &views)) << size;
+        EXPECT_TRUE(views.empty());
+    }
+    std::vector<uint8_t> broken = data;
+    broken[4] = MeshFile::VERSION + 1;
+    EXPECT_FALSE(MeshFile::Parse(broken.data(), broken.size(), &views));
+
+    // vertex size not matching the count.
+    broken = data;
+    MeshFile::MeshHeader* header = reinterpret_cast<MeshFile::MeshHeader*>(broken.data() + sizeof(MeshFile::FileHeader));
+    header->vertex_count = 1000;
+    EXPECT_FALSE(MeshFile::Parse(broken.data(), broken.size(), &views));
+
+    broken = data;
+    header = reinterpret_cast<MeshFile::MeshHeader*>(broken.data() + sizeof(MeshFile::FileHeader));
+    header->index_size = 3;
+    EXPECT_FALSE(MeshFile::Parse(broken.data(), broken.size(), &views));
+
+    // texture name not terminated.
+    broken = data;
+    header = reinterpret_cast<MeshFile::MeshHeader*>(broken.data() + sizeof(MeshFile::FileHeader));
+    memset(header->diffuse_texture, 'a', MeshFile::TEXTURE_NAME_SIZE);
+    EXPECT_FALSE(MeshFile::Parse(broken.data(), broken.size(), &views));
+}
+
+TEST(MeshFileTest, WriteAndReadBack) {
+    std::string path = testing::TempDir() + "mesh_file_test.pxymesh";
+    ASSERT_TRUE(MeshFile::Write(path, { MakeQuad(1.0F) }));
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> expected = MakeFile({ MakeQuad(1.0F) });
+    EXPECT_EQ(data.size(), expected.size());
+    std::vector<MeshFile::MeshView> views;
+    EXPECT_TRUE(MeshFile::Parse(data.data(), data.size(), &views));
+    remove(path.c_str());
+}
+
+// files written by tools/pxymesh/convert_assets.sh.
+TEST(MeshFileTest, ShippedControllerMeshes) {
+    const char* paths[] = {
+        "xr_app_openxr_oculus/src/main/assets/model/oculus_quest_controller_left/oculus_quest_controller_left.pxymesh",
+        "xr_app_openxr_pico/src/main/assets/model/pico_neo_3/ppController_NEO3_L.pxymesh",
+        "xr_app_htc/src/main/assets/model/controller_htc_focus/overlay.pxymesh",
+    };
+    for (const char* path : paths) {
+        std::ifstream file(std::string(LARK_ROOT_DIR) + "/" + path, std::ios::binary);
+        ASSERT_TRUE(file.good()) << path;
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<MeshFile::MeshView> views;
+        EXPECT_TRUE(MeshFile::Parse(data.data(), data.size(), &views)) << path;
+        EXPECT_FALSE(views.empty()) << path;
+    }
+}
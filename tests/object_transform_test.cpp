@@ -0,0 +1,109 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <memory>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+#include "object.h"
+
+using lark::Object;
+
+namespace {
+glm::vec3 Origin(const Object& object) {
+    return glm::vec3(object.GetTransforms()[3]);
+}
+
+void ExpectNear(const glm::vec3& a, const glm::vec3& b) {
+    EXPECT_NEAR(a.x, b.x, 1e-5F);
+    EXPECT_NEAR(a.y, b.y, 1e-5F);
+    EXPECT_NEAR(a.z, b.z, 1e-5F);
+}
+}
+
+TEST(ObjectTransformTest, WorldIsParentTimesLocal) {
+    Object root;
+    Object child;
+    child.set_parent(&root);
+    root.Move(1, 0, 0);
+    child.Move(0, 2, 0);
+    ExpectNear(Origin(child), glm::vec3(1, 2, 0));
+}
+
+TEST(ObjectTransformTest, ParentChangeReachesCachedChildren) {
+    Object root;
+    Object child;
+    Object grandChild;
+    child.set_parent(&root);
+    grandChild.set_parent(&child);
+    grandChild.Move(0, 0, 3);
+    ExpectNear(Origin(grandChild), glm::vec3(0, 0, 3));
+
+    // cached above, must be recomputed.
+    root.Move(1, 0, 0);
+    ExpectNear(Origin(grandChild), glm::vec3(1, 0, 3));
+    root.Scale(2);
+    ExpectNear(Origin(grandChild), glm::vec3(1, 0, 6));
+    root.transform().Translate(0, 1, 0);
+    ExpectNear(Origin(grandChild), glm::vec3(1, 2, 6));
+}
+
+TEST(ObjectTransformTest, ChildChangeLeavesSiblingsCached) {
+    Object root;
+    Object a;
+    Object b;
+    a.set_parent(&root);
+    b.set_parent(&root);
+    root.Move(1, 0, 0);
+    ExpectNear(Origin(b), glm::vec3(1, 0, 0));
+    a.Move(0, 5, 0);
+    ExpectNear(Origin(a), glm::vec3(1, 5, 0));
+    ExpectNear(Origin(b), glm::vec3(1, 0, 0));
+}
+
+TEST(ObjectTransformTest, Reparent) {
+    Object left;
+    Object right;
+    Object child;
+    left.Move(-1, 0, 0);
+    right.Move(1, 0, 0);
+    child.set_parent(&left);
+    ExpectNear(Origin(child), glm::vec3(-1, 0, 0));
+    child.set_parent(&right);
+    ExpectNear(Origin(child), glm::vec3(1, 0, 0));
+    // no longer follows the old parent.
+    left.Move(0, 9, 0);
+    ExpectNear(Origin(child), glm::vec3(1, 0, 0));
+}
+
+TEST(ObjectTransformTest, ParentDestroyedFirst) {
+    Object child;
+    child.Move(0, 1, 0);
+    {
+        Object root;
+        root.Move(4, 0, 0);
+        child.set_parent(&root);
+        ExpectNear(Origin(child), glm::vec3(4, 1, 0));
+    }
+    EXPECT_EQ(child.parent(), nullptr);
+    ExpectNear(Origin(child), glm::vec3(0, 1, 0));
+}
+
+TEST(ObjectTransformTest, UpdateWorldTransformsWholeTree) {
+    Object root;
+    std::unique_ptr<Object> items[4];
+    std::unique_ptr<Object> covers[4];
+    for (int i = 0; i < 4; i++) {
+        items[i].reset(new Object());
+        items[i]->set_parent(&root);
+        items[i]->Move(static_cast<float>(i), 0, 0);
+        covers[i].reset(new Object());
+        covers[i]->set_parent(items[i].get());
+        covers[i]->Move(0, 0, 1);
+    }
+    root.Move(0, 1, 0);
+    root.UpdateWorldTransforms();
+    for (int i = 0; i < 4; i++) {
+        ExpectNear(Origin(*covers[i]), glm::vec3(i, 1, 1));
+    }
+}
@@ -0,0 +1,207 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <glm/gtc/quaternion.hpp>
+#include "pose_filter.h"
+
+namespace {
+const int64_t NS = 1000 * 1000 * 1000;
+// 90hz tracking.
+const int64_t PERIOD_NS = NS / 90;
+
+larkxrTrackedPose MakePose(const glm::vec3& position, const glm::quat& rotation) {
+    larkxrTrackedPose pose = {};
+    pose.isConnected = true;
+    pose.isValidPose = true;
+    pose.position = position;
+    pose.rotation = rotation;
+    return pose;
+}
+
+// acos of the dot product has no precision below 0.05 degree in float.
+float AngleDegrees(const glm::quat& a, const glm::quat& b) {
+    glm::quat d = glm::inverse(glm::normalize(a)) * glm::normalize(b);
+    return glm::degrees(2.0F * std::atan2(glm::length(glm::vec3(d.x, d.y, d.z)), std::abs(d.w)));
+}
+
+//
+// synthetic head motion standing in for a recording. yaw turns of 60 degrees with a smooth
+// step, slow pitch nods and tracking noise from a fixed seed, the same on every run.
+//
+struct HeadTrace {
+    std::vector<int64_t> time;
+    std::vector<glm::quat> rotation;
+    std::vector<glm::vec3> position;
+};
+
+float SmoothStep(float x) {
+    x = std::min(1.0F, std::max(0.0F, x));
+    return x * x * (3.0F - 2.0F * x);
+}
+
+HeadTrace MakeTrace(int seconds) {
+    HeadTrace trace;
+    std::mt19937 random(20230319);
+    auto noise = [&random](float scale) {
+        // raw engine output is the same on every platform, distributions are not.
+        return (static_cast<float>(random()) / static_cast<float>(std::mt19937::max()) - 0.5F) * 2.0F * scale;
+    };
+    int count = seconds * 90;
+    for (int i = 0; i < count; i++) {
+        float t = static_cast<float>(i) / 90.0F;
+        // turn every 2 seconds, left and right.
+        int turn = static_cast<int>(t / 2.0F);
+        float phase = (t - turn * 2.0F) / 0.6F;
+        float from = (turn % 2 == 0) ? -30.0F : 30.0F;
+        float yaw = from - from * 2.0F * SmoothStep(phase);
+        float pitch = 10.0F * std::sin(t * 1.3F);
+        glm::quat q = glm::angleAxis(glm::radians(yaw + noise(0.05F)), glm::vec3(0, 1, 0)) *
+                      glm::angleAxis(glm::radians(pitch + noise(0.05F)), glm::vec3(1, 0, 0));
+        trace.time.push_back(static_cast<int64_t>(i) * PERIOD_NS);
+        trace.rotation.push_back(glm::normalize(q));
+        trace.position.push_back(glm::vec3(0.1F * std::sin(t), 1.6F, 0.05F * std::cos(t * 0.7F)));
+    }
+    return trace;
+}
+
+struct ReplayError {
+    float mean;
+    float p95;
+};
+
+// feed the trace through the filter, predict every sample horizonMs ahead and compare with the trace.
+ReplayError Replay(const HeadTrace& trace, PoseFilter::Mode mode, int horizonMs) {
+    PoseFilter filter(mode);
+    int ahead = static_cast<int>(std::lround(horizonMs * 90 / 1000.0));
+    std::vector<float> errors;
+    for (size_t i = 0; i + ahead < trace.time.size(); i++) {
+        larkxrTrackedPose pose = MakePose(trace.position[i], trace.rotation[i]);
+        filter.Update(&pose, trace.time[i], false);
+        PoseFilter::Extrapolate(&pose, mode,
+                static_cast<float>(trace.time[i + ahead] - trace.time[i]) / 1e9F);
+        // skip warm up.
+        if (i >= 10) {
+            errors.push_back(AngleDegrees(pose.rotation.toGlm(), trace.rotation[i + ahead]));
+        }
+    }
+    std::sort(errors.begin(), errors.end());
+    float sum = 0;
+    for (float e : errors) {
+        sum += e;
+    }
+    return { sum / errors.size(), errors[errors.size() * 95 / 100] };
+}
+}
+
+TEST(PoseFilterTest, RuntimeModeKeepsPose) {
+    PoseFilter filter(PoseFilter::Mode_Runtime);
+    larkxrTrackedPose pose = MakePose(glm::vec3(1, 2, 3), glm::quat(1, 0, 0, 0));
+    pose.velocity = glm::vec3(1, 0, 0);
+    filter.Predict(&pose, 0.05F);
+    EXPECT_EQ(pose.position.toGlm(), glm::vec3(1, 2, 3));
+}
+
+TEST(PoseFilterTest, VelocityFromSamples) {
+    PoseFilter filter(PoseFilter::Mode_ConstantVelocity);
+    glm::vec3 axis(0, 1, 0);
+    for (int i = 0; i < 5; i++) {
+        // 1 m/s along x, 90 deg/s around y.
+        float t = static_cast<float>(i) / 90.0F;
+        larkxrTrackedPose pose = MakePose(glm::vec3(t, 0, 0), glm::angleAxis(glm::half_pi<float>() * t, axis));
+        filter.Update(&pose, i * PERIOD_NS, false);
+        if (i == 0) {
+            EXPECT_EQ(pose.velocity.toGlm(), glm::vec3(0));
+            continue;
+        }
+        EXPECT_NEAR(pose.velocity.x, 1.0F, 1e-3F);
+        EXPECT_NEAR(pose.angularVelocity.y, glm::half_pi<float>(), 1e-3F);
+    }
+}
+
+TEST(PoseFilterTest, RuntimeVelocityKept) {
+    PoseFilter filter(PoseFilter::Mode_ConstantVelocity);
+    larkxrTrackedPose pose = MakePose(glm::vec3(0), glm::quat(1, 0, 0, 0));
+    pose.velocity = glm::vec3(0, 0, 2);
+    filter.Update(&pose, 0, true);
+    EXPECT_EQ(pose.velocity.toGlm(), glm::vec3(0, 0, 2));
+}
+
+TEST(PoseFilterTest, GapDropsHistory) {
+    PoseFilter filter(PoseFilter::Mode_ConstantVelocity);
+    larkxrTrackedPose pose = MakePose(glm::vec3(0), glm::quat(1, 0, 0, 0));
+    filter.Update(&pose, 0, false);
+    // paused for a second, jumped 1 meter.
+    pose = MakePose(glm::vec3(1, 0, 0), glm::quat(1, 0, 0, 0));
+    filter.Update(&pose, NS, false);
+    EXPECT_EQ(pose.velocity.toGlm(), glm::vec3(0));
+}
+
+TEST(PoseFilterTest, EyesMoveWithHead) {
+    larkxrTrackedPose pose = MakePose(glm::vec3(0), glm::quat(1, 0, 0, 0));
+    pose.eye[0].viewPosition = glm::vec3(-0.032F, 0, 0);
+    pose.eye[0].viewRotation = glm::quat(1, 0, 0, 0);
+    pose.angularVelocity = glm::vec3(0, glm::half_pi<float>(), 0);
+    // quarter turn around y, left eye moves to +z.
+    PoseFilter::Extrapolate(&pose, PoseFilter::Mode_ConstantVelocity, 1.0F);
+    EXPECT_NEAR(pose.eye[0].viewPosition.x, 0.0F, 1e-4F);
+    EXPECT_NEAR(pose.eye[0].viewPosition.z, 0.032F, 1e-4F);
+    EXPECT_NEAR(AngleDegrees(pose.eye[0].viewRotation.toGlm(), pose.rotation.toGlm()), 0.0F, 1e-2F);
+}
+
+TEST(PoseFilterTest, DevicePairModeOnNextApply) {
+    DevicePairFilter filter;
+    EXPECT_TRUE(filter.sample_at_display_time());
+
+    filter.set_mode(PoseFilter::Mode_ConstantVelocity);
+    EXPECT_EQ(filter.mode(), PoseFilter::Mode_ConstantVelocity);
+    EXPECT_FALSE(filter.sample_at_display_time());
+
+    larkxrDevicePair pair = {};
+    pair.hmdPose = MakePose(glm::vec3(0), glm::quat(1, 0, 0, 0));
+    filter.Apply(&pair, 0, 0, false);
+    pair.hmdPose = MakePose(glm::vec3(0.01F, 0, 0), glm::quat(1, 0, 0, 0));
+    filter.Apply(&pair, PERIOD_NS, PERIOD_NS * 2, false);
+    // extrapolated one period ahead.
+    EXPECT_NEAR(pair.hmdPose.position.x, 0.02F, 1e-4F);
+
+    // closed connection, the next sample starts a new history.
+    filter.Reset();
+    pair.hmdPose = MakePose(glm::vec3(0.02F, 0, 0), glm::quat(1, 0, 0, 0));
+    filter.Apply(&pair, PERIOD_NS * 2, PERIOD_NS * 3, false);
+    EXPECT_EQ(pair.hmdPose.velocity.toGlm(), glm::vec3(0));
+    EXPECT_NEAR(pair.hmdPose.position.x, 0.02F, 1e-6F);
+}
+
+// offline replay. prints angular error at 20/40/60ms, extrapolation must beat holding the last pose.
+TEST(PoseFilterTest, ReplayAngularError) {
+    HeadTrace trace = MakeTrace(20);
+    const PoseFilter::Mode modes[] = {
+            PoseFilter::Mode_Runtime,
+            PoseFilter::Mode_ConstantVelocity,
+            PoseFilter::Mode_ConstantAcceleration,
+            PoseFilter::Mode_OneEuro,
+    };
+    const char* names[] = { "hold", "constant velocity", "constant acceleration", "one euro" };
+    const int horizons[] = { 20, 40, 60 };
+
+    printf("%-24s %18s %18s %18s\n", "angular error deg", "20ms mean/p95", "40ms mean/p95", "60ms mean/p95");
+    for (int m = 0; m < 4; m++) {
+        printf("%-24s", names[m]);
+        for (int horizon : horizons) {
+            ReplayError error = Replay(trace, modes[m], horizon);
+            printf(" %8.3f /%8.3f", error.mean, error.p95);
+            if (modes[m] != PoseFilter::Mode_Runtime) {
+                ReplayError hold = Replay(trace, PoseFilter::Mode_Runtime, horizon);
+                EXPECT_LT(error.mean, hold.mean) << names[m] << " " << horizon << "ms";
+            }
+        }
+        printf("\n");
+    }
+}
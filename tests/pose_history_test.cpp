@@ -0,0 +1,91 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <atomic>
+#include <thread>
+#include <gtest/gtest.h>
+#include "pose_history.h"
+
+namespace {
+larkxrTrackingFrame MakeFrame(uint64_t frameIndex) {
+    larkxrTrackingFrame frame = {};
+    frame.frameIndex = frameIndex;
+    frame.fetchTime = frameIndex * 3;
+    frame.displayTime = static_cast<double>(frameIndex) * 2.0;
+    return frame;
+}
+
+// every field derived from the frame index, a torn copy mixes two frames.
+bool IsConsistent(const larkxrTrackingFrame& frame) {
+    return frame.fetchTime == frame.frameIndex * 3 &&
+           frame.displayTime == static_cast<double>(frame.frameIndex) * 2.0;
+}
+}
+
+TEST(PoseHistoryTest, EmptyHasNoFrame) {
+    PoseHistory history;
+    larkxrTrackingFrame frame = {};
+    EXPECT_TRUE(history.empty());
+    EXPECT_FALSE(history.Latest(&frame));
+    EXPECT_FALSE(history.Find(0, &frame));
+}
+
+TEST(PoseHistoryTest, FindsPushedFrame) {
+    PoseHistory history;
+    for (uint64_t i = 1; i <= 10; i++) {
+        history.Push(MakeFrame(i));
+    }
+    larkxrTrackingFrame frame = {};
+    ASSERT_TRUE(history.Find(5, &frame));
+    EXPECT_EQ(frame.frameIndex, 5u);
+    EXPECT_TRUE(IsConsistent(frame));
+    ASSERT_TRUE(history.Latest(&frame));
+    EXPECT_EQ(frame.frameIndex, 10u);
+    EXPECT_EQ(history.count(), 10u);
+}
+
+TEST(PoseHistoryTest, OverwrittenFrameIsNotFound) {
+    PoseHistory history;
+    history.Push(MakeFrame(3));
+    history.Push(MakeFrame(3 + PoseHistory::CAPACITY));
+    larkxrTrackingFrame frame = {};
+    EXPECT_FALSE(history.Find(3, &frame));
+    ASSERT_TRUE(history.Find(3 + PoseHistory::CAPACITY, &frame));
+    // a frame not pushed yet in a used slot.
+    EXPECT_FALSE(history.Find(3 + PoseHistory::CAPACITY * 2, &frame));
+}
+
+TEST(PoseHistoryTest, ReaderNeverSeesTornFrame) {
+    PoseHistory history;
+    const uint64_t frames = 200000;
+    std::atomic<bool> done(false);
+    std::thread producer([&] {
+        for (uint64_t i = 1; i <= frames; i++) {
+            history.Push(MakeFrame(i));
+        }
+        done = true;
+    });
+
+    uint64_t reads = 0;
+    uint64_t lastLatest = 0;
+    while (!done) {
+        larkxrTrackingFrame frame = {};
+        if (history.Latest(&frame)) {
+            ASSERT_TRUE(IsConsistent(frame));
+            ASSERT_GE(frame.frameIndex, lastLatest);
+            lastLatest = frame.frameIndex;
+            reads++;
+        }
+        uint64_t back = lastLatest > 8 ? lastLatest - 8 : 1;
+        if (history.Find(back, &frame)) {
+            ASSERT_EQ(frame.frameIndex, back);
+            ASSERT_TRUE(IsConsistent(frame));
+        }
+    }
+    producer.join();
+    larkxrTrackingFrame frame = {};
+    ASSERT_TRUE(history.Latest(&frame));
+    EXPECT_EQ(frame.frameIndex, frames);
+    EXPECT_GT(reads, 0u);
+}
@@ -0,0 +1,176 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "pose_sampler.h"
+
+namespace {
+uint64_t NowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// tracking source with a frame counter, and a send sink that records what it got.
+class FakeSource: public PoseSampler::Source {
+public:
+    bool SamplePose(larkxrTrackingDevicePairFrame* devicePairFrame) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!tracking_) {
+            return false;
+        }
+        devicePairFrame->frameIndex = ++sampled_;
+        devicePairFrame->fetchTime = NowUs();
+        devicePairFrame->devicePair.hmdPose.position.y = static_cast<float>(sampled_);
+        return true;
+    }
+    void SendPose(const larkxrTrackingDevicePairFrame& devicePairFrame) override {
+        uint64_t now = NowUs();
+        std::chrono::microseconds stall;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sends_.push_back({ devicePairFrame.frameIndex, now, now - devicePairFrame.fetchTime,
+                               devicePairFrame.devicePair.hmdPose.position.y });
+            stall = send_stall_;
+            send_stall_ = std::chrono::microseconds(0);
+        }
+        // network send blocking once.
+        std::this_thread::sleep_for(stall);
+    }
+
+    struct Send {
+        uint64_t frame_index;
+        uint64_t time_us;
+        uint64_t latency_us;
+        float hmd_y;
+    };
+    std::vector<Send> sends() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sends_;
+    }
+    void set_tracking(bool tracking) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tracking_ = tracking;
+    }
+    void StallNextSend(std::chrono::microseconds stall) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        send_stall_ = stall;
+    }
+private:
+    std::mutex mutex_;
+    bool tracking_ = true;
+    uint64_t sampled_ = 0;
+    std::chrono::microseconds send_stall_ = std::chrono::microseconds(0);
+    std::vector<Send> sends_;
+};
+}
+
+TEST(PoseSamplerTest, SendsSampledPoseAtRate) {
+    FakeSource source;
+    PoseSampler sampler;
+    sampler.Start(&source, 200);
+    EXPECT_TRUE(sampler.running());
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    sampler.Stop();
+    EXPECT_FALSE(sampler.running());
+
+    std::vector<FakeSource::Send> sends = source.sends();
+    // 100 at 200hz, loose for a loaded host.
+    EXPECT_GE(sends.size(), 60u);
+    EXPECT_LE(sends.size(), 110u);
+    EXPECT_EQ(sampler.sent(), sends.size());
+    for (size_t i = 0; i < sends.size(); i++) {
+        // every sample sent once, in order, with its own pose.
+        EXPECT_EQ(sends[i].frame_index, i + 1);
+        EXPECT_FLOAT_EQ(sends[i].hmd_y, static_cast<float>(i + 1));
+    }
+}
+
+TEST(PoseSamplerTest, SampleToSendLatency) {
+    FakeSource source;
+    PoseSampler sampler;
+    sampler.Start(&source, 500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    sampler.Stop();
+
+    std::vector<uint64_t> latency;
+    for (const auto & send : source.sends()) {
+        latency.push_back(send.latency_us);
+    }
+    ASSERT_GT(latency.size(), 50u);
+    std::sort(latency.begin(), latency.end());
+    uint64_t p50 = latency[latency.size() / 2];
+    uint64_t p99 = latency[latency.size() * 99 / 100];
+    RecordProperty("p50_us", static_cast<int>(p50));
+    RecordProperty("p99_us", static_cast<int>(p99));
+    // sampled and sent back to back on the sampler thread, no render frame in between.
+    EXPECT_LT(p99, 1000u);
+    EXPECT_LT(sampler.send_latency_us(), 5000u);
+}
+
+TEST(PoseSamplerTest, NoSendWithoutTracking) {
+    FakeSource source;
+    source.set_tracking(false);
+    PoseSampler sampler;
+    sampler.Start(&source, 500);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(source.sends().empty());
+
+    source.set_tracking(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    sampler.Stop();
+    EXPECT_FALSE(source.sends().empty());
+}
+
+TEST(PoseSamplerTest, StallDoesNotBurst) {
+    FakeSource source;
+    PoseSampler sampler;
+    sampler.Start(&source, 200);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    source.StallNextSend(std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    sampler.Stop();
+
+    // the ticks missed during the stall are not sent at once after it.
+    std::vector<FakeSource::Send> sends = source.sends();
+    int burst = 0;
+    for (size_t i = 1; i < sends.size(); i++) {
+        if (sends[i].time_us - sends[i - 1].time_us < 1000) {
+            burst++;
+        }
+    }
+    EXPECT_LE(burst, 2);
+}
+
+TEST(PoseSamplerTest, NoSourceCallAfterStop) {
+    FakeSource source;
+    PoseSampler sampler;
+    sampler.Start(&source, PoseSampler::MAX_RATE_HZ);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sampler.Stop();
+    size_t sent = source.sends().size();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(source.sends().size(), sent);
+    // stop twice is fine, start again restarts the stats.
+    sampler.Stop();
+    sampler.Start(&source, 100);
+    EXPECT_TRUE(sampler.running());
+    sampler.Stop();
+}
+
+TEST(PoseSamplerTest, RateClamped) {
+    const uint32_t minRate = PoseSampler::MIN_RATE_HZ;
+    const uint32_t maxRate = PoseSampler::MAX_RATE_HZ;
+    PoseSampler sampler;
+    sampler.set_rate_hz(1);
+    EXPECT_EQ(sampler.rate_hz(), minRate);
+    sampler.set_rate_hz(100000);
+    EXPECT_EQ(sampler.rate_hz(), maxRate);
+    sampler.set_rate_hz(90);
+    EXPECT_EQ(sampler.rate_hz(), 90u);
+}
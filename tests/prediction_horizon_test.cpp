@@ -0,0 +1,145 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <lark_xr/xr_config.h>
+#include <gtest/gtest.h>
+#include "prediction_horizon.h"
+#include "telemetry.h"
+
+namespace {
+// without sleep tracking -> submit is a few micro seconds, horizon is one display refresh.
+const uint64_t REFRESH_72_NS = 1000 * 1000 * 1000 / 72;
+// copies, gtest takes the arguments by reference and the class constants have no definition.
+const uint64_t DEFAULT_HORIZON_NS = PredictionHorizon::DEFAULT_HORIZON_NS;
+const uint64_t MIN_HORIZON_NS = PredictionHorizon::MIN_HORIZON_NS;
+
+// same clock as FramePacer.
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Submit(PredictionHorizon* horizon, uint64_t first, uint64_t count) {
+    for (uint64_t i = first; i < first + count; i++) {
+        horizon->OnTracking(i);
+        horizon->OnSubmit(i);
+    }
+}
+}
+
+TEST(PredictionHorizonTest, DefaultUntilEnoughSamples) {
+    lark::XRConfig::fps = 72;
+    PredictionHorizon horizon;
+    Submit(&horizon, 1, 29);
+    EXPECT_EQ(horizon.samples(), 29u);
+    EXPECT_EQ(horizon.horizon_ns(), DEFAULT_HORIZON_NS);
+
+    Submit(&horizon, 30, 1);
+    EXPECT_GE(horizon.horizon_ns(), REFRESH_72_NS);
+    EXPECT_LT(horizon.horizon_ns(), REFRESH_72_NS + 5 * 1000 * 1000);
+}
+
+TEST(PredictionHorizonTest, ClampedToMinimum) {
+    // 1 / 200hz is below the minimum horizon.
+    lark::XRConfig::fps = 200;
+    PredictionHorizon horizon;
+    Submit(&horizon, 1, 60);
+    EXPECT_EQ(horizon.horizon_ns(), MIN_HORIZON_NS);
+    lark::XRConfig::fps = 72;
+}
+
+TEST(PredictionHorizonTest, IgnoresUnknownFrame) {
+    PredictionHorizon horizon;
+    // index 0 is never matched.
+    horizon.OnTracking(0);
+    horizon.OnSubmit(0);
+    // submitted before tracked.
+    horizon.OnSubmit(7);
+    EXPECT_EQ(horizon.samples(), 0u);
+
+    // slot reused by a newer pose.
+    horizon.OnTracking(3);
+    horizon.OnTracking(3 + 128);
+    horizon.OnSubmit(3);
+    EXPECT_EQ(horizon.samples(), 0u);
+    horizon.OnSubmit(3 + 128);
+    EXPECT_EQ(horizon.samples(), 1u);
+}
+
+TEST(PredictionHorizonTest, MatchesPoseTimestampIds) {
+    // pico uses the pose timestamp in ns as the id, from a clock with ms resolution.
+    // 6 frames in flight.
+    const int frames = 200;
+    const int inFlight = 6;
+    std::vector<uint64_t> timestamps;
+    for (int i = 0; i < frames; i++) {
+        timestamps.push_back((1679212800123ULL + i * 11ULL) * 1000 * 1000);
+    }
+
+    PredictionHorizon raw;
+    PredictionHorizon hashed;
+    for (int i = 0; i < frames + inFlight; i++) {
+        if (i < frames) {
+            raw.OnTracking(timestamps[i]);
+            hashed.OnTracking(PredictionHorizon::TimestampId(timestamps[i]));
+        }
+        if (i >= inFlight) {
+            raw.OnSubmit(timestamps[i - inFlight]);
+            hashed.OnSubmit(PredictionHorizon::TimestampId(timestamps[i - inFlight]));
+        }
+    }
+    // low bits of ms in ns are constant, in flight poses overwrite each other.
+    EXPECT_LT(raw.samples(), static_cast<uint64_t>(frames) / 2);
+    EXPECT_EQ(hashed.samples(), static_cast<uint64_t>(frames));
+    EXPECT_NE(hashed.horizon_ns(), DEFAULT_HORIZON_NS);
+    EXPECT_EQ(PredictionHorizon::TimestampId(0), 0u);
+}
+
+TEST(PredictionHorizonTest, ResetOnNextSubmit) {
+    PredictionHorizon horizon;
+    Submit(&horizon, 1, 40);
+    EXPECT_NE(horizon.horizon_ns(), DEFAULT_HORIZON_NS);
+
+    horizon.Reset();
+    EXPECT_EQ(horizon.horizon_ns(), DEFAULT_HORIZON_NS);
+    horizon.OnSubmit(0);
+    EXPECT_EQ(horizon.samples(), 0u);
+    EXPECT_EQ(horizon.latency_ns(), 0u);
+}
+
+TEST(PredictionHorizonTest, DefaultHorizonChangedBeforeSamples) {
+    PredictionHorizon horizon;
+    horizon.set_default_horizon_ns(25 * 1000 * 1000);
+    EXPECT_EQ(horizon.horizon_ns(), 25u * 1000 * 1000);
+}
+
+TEST(PredictionHorizonTest, RecordsFrameReadyLatency) {
+    const LatencyHistogram& ready = Telemetry::instance()->histogram(Telemetry::Metric_TrackingToFrameReady);
+    const LatencyHistogram& submit = Telemetry::instance()->histogram(Telemetry::Metric_TrackingToSubmit);
+    PredictionHorizon horizon;
+    uint64_t readyCount = ready.count();
+    uint64_t submitCount = submit.count();
+
+    horizon.OnTracking(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    uint64_t readyNs = NowNs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    horizon.OnSubmit(1, readyNs);
+    EXPECT_EQ(ready.count(), readyCount + 1);
+    EXPECT_EQ(submit.count(), submitCount + 1);
+    // ready before submit.
+    EXPECT_GE(ready.max(), 2000u);
+    EXPECT_LT(ready.max(), submit.max());
+
+    // frame pacer missed the frame, or ready before the pose was sent.
+    horizon.OnTracking(2);
+    horizon.OnSubmit(2, 0);
+    horizon.OnTracking(3);
+    horizon.OnSubmit(3, readyNs);
+    EXPECT_EQ(ready.count(), readyCount + 1);
+    EXPECT_EQ(submit.count(), submitCount + 3);
+}
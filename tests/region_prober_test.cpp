@@ -0,0 +1,245 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ui/setup_server/region_prober.h"
+
+namespace {
+const uint64_t RTT_FAILED = RegionProber::RTT_FAILED;
+const uint32_t SAMPLES = RegionProber::SAMPLES;
+const uint32_t MIN_SAMPLES = RegionProber::MIN_SAMPLES;
+
+// loopback tcp echo server, answers each connection after its delay. a negative delay closes without answer.
+class EchoServer {
+public:
+    explicit EchoServer(std::vector<int> delaysMs): delays_(std::move(delaysMs)) {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t size = sizeof(addr);
+        bind(fd_, reinterpret_cast<sockaddr*>(&addr), size);
+        listen(fd_, 16);
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &size);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread(&EchoServer::Run, this);
+    }
+    ~EchoServer() {
+        running_ = false;
+        thread_.join();
+        close(fd_);
+    }
+    inline int port() const { return port_; }
+    inline int accepted() const { return accepted_; }
+private:
+    void Run() {
+        while (running_) {
+            pollfd pfd = { fd_, POLLIN, 0 };
+            if (poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            int client = accept(fd_, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            int delay = delays_[accepted_++ % delays_.size()];
+            char data = 0;
+            if (delay >= 0 && recv(client, &data, 1, 0) == 1) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+                send(client, &data, 1, MSG_NOSIGNAL);
+            }
+            close(client);
+        }
+    }
+
+    std::vector<int> delays_;
+    int fd_ = -1;
+    int port_ = 0;
+    std::atomic<int> accepted_ = {0};
+    std::atomic<bool> running_ = {true};
+    std::thread thread_;
+};
+
+// a port nobody listens on, connect is refused.
+int ClosedPort() {
+    EchoServer server({ 0 });
+    return server.port();
+}
+
+lark::RegionInfo MakeRegion(const std::string& id, int port) {
+    lark::RegionInfo info = {};
+    info.regionId = id;
+    info.regionName = id;
+    info.publicIp = "127.0.0.1";
+    info.serverPort = std::to_string(port);
+    return info;
+}
+
+class ProbeCallback: public RegionProber::Callback {
+public:
+    void OnRegionProbeDone(const std::vector<RegionProber::Result>& results, int best) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_ = results;
+        best_ = best;
+        calls_++;
+        cond_.notify_all();
+    }
+    bool Wait(std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, timeout, [this] { return calls_ > 0; });
+    }
+    std::vector<RegionProber::Result> results() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return results_;
+    }
+    int best() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return best_;
+    }
+    int calls() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_;
+    }
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<RegionProber::Result> results_;
+    int best_ = -2;
+    int calls_ = 0;
+};
+}
+
+TEST(RegionProberTest, MedianAndJitter) {
+    RegionProber::Result result = RegionProber::GetResult(MakeRegion("a", 1), { 30, 10, 20, 40, 1000 }, 0);
+    EXPECT_EQ(result.median, 30u);
+    // (20 + 10 + 0 + 10 + 970) / 5
+    EXPECT_EQ(result.jitter, 202u);
+    EXPECT_EQ(result.samples, 5u);
+    EXPECT_EQ(result.lost, 0u);
+    EXPECT_EQ(result.info.regionId, "a");
+
+    // upper median of an even count.
+    EXPECT_EQ(RegionProber::GetResult(MakeRegion("a", 1), { 20, 10 }, 0).median, 20u);
+}
+
+TEST(RegionProberTest, NoSampleIsFailed) {
+    RegionProber::Result result = RegionProber::GetResult(MakeRegion("a", 1), {}, SAMPLES);
+    EXPECT_EQ(result.median, RTT_FAILED);
+    EXPECT_EQ(result.samples, 0u);
+    EXPECT_EQ(result.lost, SAMPLES);
+
+    // a 0 sample is no answer.
+    result = RegionProber::GetResult(MakeRegion("a", 1), { 0, 15 }, 1);
+    EXPECT_EQ(result.median, 15u);
+    EXPECT_EQ(result.samples, 1u);
+    EXPECT_EQ(result.lost, 2u);
+    EXPECT_EQ(RegionProber::GetResult(MakeRegion("a", 1), { 0 }, 0).median, RTT_FAILED);
+}
+
+TEST(RegionProberTest, LoopbackPicksFastest) {
+    EchoServer slow({ 60 });
+    EchoServer fast({ 5, 7, 5, 6, 5 });
+    // one answer lost, still the fastest.
+    EchoServer lossy({ -1, 20 });
+    ProbeCallback callback;
+    RegionProber prober(&callback);
+    prober.Start({ MakeRegion("slow", slow.port()), MakeRegion("fast", fast.port()),
+                   MakeRegion("lossy", lossy.port()), MakeRegion("dead", ClosedPort()) });
+    ASSERT_TRUE(callback.Wait());
+    prober.Stop();
+
+    std::vector<RegionProber::Result> results = callback.results();
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_EQ(callback.best(), 1);
+    EXPECT_GE(results[1].median, 5u);
+    EXPECT_LT(results[1].median, 60u);
+    EXPECT_GE(results[1].samples, MIN_SAMPLES);
+    // the dead region is not 0 ms.
+    EXPECT_EQ(results[3].median, RTT_FAILED);
+    EXPECT_EQ(results[3].samples, 0u);
+    EXPECT_EQ(results[3].lost, SAMPLES);
+    EXPECT_EQ(callback.calls(), 1);
+}
+
+TEST(RegionProberTest, LoopbackStopsEarlyOnClearWinner) {
+    EchoServer fast({ 2 });
+    EchoServer slow({ 80 });
+    ProbeCallback callback;
+    RegionProber prober(&callback);
+    auto start = std::chrono::steady_clock::now();
+    prober.Start({ MakeRegion("fast", fast.port()), MakeRegion("slow", slow.port()) });
+    ASSERT_TRUE(callback.Wait());
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    prober.Stop();
+
+    std::vector<RegionProber::Result> results = callback.results();
+    EXPECT_EQ(callback.best(), 0);
+    // the first slow answer is slower than every fast one, no need for the other 4.
+    EXPECT_LT(results[1].samples + results[1].lost, SAMPLES);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(SAMPLES * 80));
+}
+
+TEST(RegionProberTest, LoopbackAllFailed) {
+    EchoServer mute({ -1 });
+    ProbeCallback callback;
+    RegionProber prober(&callback);
+    prober.Start({ MakeRegion("mute", mute.port()), MakeRegion("dead", ClosedPort()) });
+    ASSERT_TRUE(callback.Wait());
+    prober.Stop();
+    EXPECT_EQ(callback.best(), -1);
+    for (const auto & result : callback.results()) {
+        EXPECT_EQ(result.median, RTT_FAILED);
+        EXPECT_EQ(result.lost, SAMPLES);
+    }
+}
+
+TEST(RegionProberTest, NoCallbackAfterStop) {
+    EchoServer slow({ 100 });
+    ProbeCallback callback;
+    RegionProber prober(&callback);
+    prober.Start({ MakeRegion("slow", slow.port()) });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    prober.Stop();
+    EXPECT_FALSE(callback.Wait(std::chrono::milliseconds(300)));
+
+    // the restart reports once, for the new regions only.
+    EchoServer fast({ 1 });
+    prober.Start({ MakeRegion("fast", fast.port()) });
+    ASSERT_TRUE(callback.Wait());
+    prober.Stop();
+    EXPECT_EQ(callback.calls(), 1);
+    ASSERT_EQ(callback.results().size(), 1u);
+    EXPECT_EQ(callback.results()[0].info.regionId, "fast");
+}
+
+TEST(RegionProberTest, Cache) {
+    char dir[] = "/tmp/region_prober_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    RegionProber::CacheEntry entry = { "127.0.0.1:8181", "region-1", 23 };
+    ASSERT_TRUE(RegionProber::SaveCache(dir, entry));
+
+    RegionProber::CacheEntry loaded = {};
+    ASSERT_TRUE(RegionProber::LoadCache(dir, "127.0.0.1:8181", &loaded));
+    EXPECT_EQ(loaded.regionId, "region-1");
+    EXPECT_EQ(loaded.rtt, 23u);
+    // another server.
+    EXPECT_FALSE(RegionProber::LoadCache(dir, "192.168.0.55:8181", &loaded));
+    EXPECT_FALSE(RegionProber::SaveCache(dir, { "127.0.0.1:8181", "", 0 }));
+    std::string cmd = std::string("rm -rf ") + dir;
+    system(cmd.c_str());
+}
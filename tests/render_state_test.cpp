@@ -0,0 +1,170 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <gtest/gtest.h>
+#include "render_state.h"
+#include "render_queue.h"
+#include "support/gl_shim.h"
+
+using lark::DrawItem;
+using lark::RenderQueue;
+using lark::RenderState;
+
+namespace {
+class RenderStateTest : public testing::Test {
+protected:
+    void SetUp() override {
+        gl_shim::Reset();
+        RenderState::Release();
+    }
+    void TearDown() override {
+        RenderState::Release();
+    }
+};
+
+DrawItem MakeItem(GLuint program, GLuint texture, GLuint vertexArray, float depth, bool transparent,
+                  std::vector<int>* order, int id) {
+    DrawItem item = { program, texture, vertexArray, depth, transparent, [order, id]() { order->push_back(id); } };
+    return item;
+}
+}
+
+TEST_F(RenderStateTest, FirstCallReachesGl) {
+    RenderState* state = RenderState::instance();
+    state->UseProgram(0);
+    state->BindVertexArray(0);
+    state->Disable(GL_BLEND);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 1u);
+    EXPECT_EQ(gl_shim::Count("glBindVertexArray"), 1u);
+    EXPECT_EQ(gl_shim::Count("glDisable"), 1u);
+    EXPECT_EQ(state->issued(), 3u);
+    EXPECT_EQ(state->skipped(), 0u);
+}
+
+TEST_F(RenderStateTest, RedundantCallsSkipped) {
+    RenderState* state = RenderState::instance();
+    for (int i = 0; i < 3; i++) {
+        state->UseProgram(5);
+        state->BindVertexArray(6);
+        state->ActiveTexture(GL_TEXTURE0);
+        state->BindTexture(GL_TEXTURE_2D, 7);
+        state->Enable(GL_DEPTH_TEST);
+        state->DepthMask(GL_TRUE);
+        state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    EXPECT_EQ(gl_shim::calls().size(), 7u);
+    EXPECT_EQ(state->issued(), 7u);
+    EXPECT_EQ(state->skipped(), 14u);
+
+    state->ResetCounters();
+    state->UseProgram(8);
+    state->BlendFunc(GL_ONE, GL_ONE);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 2u);
+    EXPECT_EQ(gl_shim::Count("glBlendFunc"), 2u);
+    EXPECT_EQ(state->issued(), 2u);
+}
+
+TEST_F(RenderStateTest, TexturesTrackedPerUnitAndTarget) {
+    RenderState* state = RenderState::instance();
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, 1);
+    state->BindTexture(GL_TEXTURE_CUBE_MAP, 1);
+    state->ActiveTexture(GL_TEXTURE1);
+    state->BindTexture(GL_TEXTURE_2D, 1);
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, 1);
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 3u);
+    EXPECT_EQ(gl_shim::Count("glActiveTexture"), 3u);
+
+    // not tracked, always issued.
+    state->BindTexture(GL_TEXTURE_3D, 2);
+    state->BindTexture(GL_TEXTURE_3D, 2);
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 5u);
+}
+
+TEST_F(RenderStateTest, UnknownCapsAlwaysIssued) {
+    RenderState* state = RenderState::instance();
+    state->Enable(GL_STENCIL_TEST);
+    state->Enable(GL_STENCIL_TEST);
+    state->Enable(GL_SCISSOR_TEST);
+    state->Enable(GL_SCISSOR_TEST);
+    EXPECT_EQ(gl_shim::Count("glEnable"), 3u);
+}
+
+TEST_F(RenderStateTest, InvalidateAndForget) {
+    RenderState* state = RenderState::instance();
+    state->UseProgram(3);
+    state->BindVertexArray(4);
+    state->ActiveTexture(GL_TEXTURE0);
+    state->BindTexture(GL_TEXTURE_2D, 5);
+
+    // names reused by new objects.
+    state->ForgetProgram(3);
+    state->ForgetVertexArray(4);
+    state->ForgetTexture(5);
+    state->UseProgram(3);
+    state->BindVertexArray(4);
+    state->BindTexture(GL_TEXTURE_2D, 5);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 2u);
+    EXPECT_EQ(gl_shim::Count("glBindVertexArray"), 2u);
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 2u);
+
+    // third party rendering changed everything.
+    state->Invalidate();
+    state->UseProgram(3);
+    state->ActiveTexture(GL_TEXTURE0);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 3u);
+    EXPECT_EQ(gl_shim::Count("glActiveTexture"), 2u);
+}
+
+TEST_F(RenderStateTest, QueueGroupsOpaqueByState) {
+    std::vector<int> order;
+    RenderQueue queue;
+    // submit order alternates programs and textures like the ui tree does.
+    queue.Submit(MakeItem(2, 10, 1, 1.0F, false, &order, 0));
+    queue.Submit(MakeItem(1, 11, 1, 1.0F, false, &order, 1));
+    queue.Submit(MakeItem(2, 11, 1, 2.0F, false, &order, 2));
+    queue.Submit(MakeItem(1, 11, 1, 0.5F, false, &order, 3));
+    queue.Submit(MakeItem(2, 10, 1, 0.5F, false, &order, 4));
+    queue.Flush();
+
+    std::vector<int> expected = { 3, 1, 4, 0, 2 };
+    EXPECT_EQ(order, expected);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 2u);
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 3u);
+    EXPECT_EQ(gl_shim::Count("glBindVertexArray"), 1u);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(RenderStateTest, QueueDrawsTransparentBackToFront) {
+    std::vector<int> order;
+    RenderQueue queue;
+    queue.Submit(MakeItem(1, 0, 1, 1.0F, true, &order, 0));
+    queue.Submit(MakeItem(1, 0, 1, 3.0F, true, &order, 1));
+    queue.Submit(MakeItem(2, 0, 1, 9.0F, false, &order, 2));
+    queue.Submit(MakeItem(2, 0, 1, 1.0F, true, &order, 3));
+    queue.Submit(MakeItem(1, 0, 1, 2.0F, true, &order, 4));
+    queue.Flush();
+
+    // opaque first. same depth keeps submit order.
+    std::vector<int> expected = { 2, 1, 4, 0, 3 };
+    EXPECT_EQ(order, expected);
+    // no texture, unit 0 untouched.
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 0u);
+}
+
+TEST_F(RenderStateTest, QueueSkipsStateSetByPreviousFrame) {
+    std::vector<int> order;
+    RenderQueue queue;
+    for (int frame = 0; frame < 2; frame++) {
+        queue.Submit(MakeItem(1, 5, 2, 1.0F, false, &order, 0));
+        queue.Submit(MakeItem(1, 5, 2, 2.0F, false, &order, 1));
+        queue.Flush();
+    }
+    EXPECT_EQ(order.size(), 4u);
+    EXPECT_EQ(gl_shim::Count("glUseProgram"), 1u);
+    EXPECT_EQ(gl_shim::Count("glBindTexture"), 1u);
+    EXPECT_EQ(RenderState::instance()->issued(), 4u);
+    EXPECT_EQ(RenderState::instance()->skipped(), 12u);
+}
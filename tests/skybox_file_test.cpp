@@ -0,0 +1,121 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "skybox_file.h"
+
+using lark::SkyboxFile;
+
+namespace {
+const uint32_t FORMAT_ETC2_RGB8 = 0x9274;
+
+// face bytes hold level and face, odd sizes to check the padding.
+std::vector<SkyboxFile::LevelData> MakeLevels(uint32_t faceSize) {
+    std::vector<SkyboxFile::LevelData> levels;
+    for (uint32_t size = faceSize, level = 0; size > 0; size >>= 1, level++) {
+        SkyboxFile::LevelData data;
+        for (int face = 0; face < SkyboxFile::FACE_COUNT; face++) {
+            data[face].assign(size * 2 + 1, static_cast<uint8_t>(level * 16 + face));
+        }
+        levels.push_back(data);
+    }
+    return levels;
+}
+
+std::vector<uint8_t> WriteAndRead(const std::vector<SkyboxFile::LevelData>& levels, uint32_t faceSize) {
+    char path[] = "/tmp/skybox_file_test_XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT_GE(fd, 0);
+    close(fd);
+    EXPECT_TRUE(SkyboxFile::Write(path, FORMAT_ETC2_RGB8, faceSize, levels));
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    remove(path);
+    return data;
+}
+}
+
+TEST(SkyboxFileTest, SkyboxPath) {
+    EXPECT_EQ(SkyboxFile::GetSkyboxPath("textures/skybox_9.jpg"), "textures/skybox_9.pxysky");
+    EXPECT_EQ(SkyboxFile::GetSkyboxPath("textures/skybox"), "textures/skybox.pxysky");
+    EXPECT_EQ(SkyboxFile::GetSkyboxPath("textures.v2/skybox"), "textures.v2/skybox.pxysky");
+}
+
+TEST(SkyboxFileTest, WriteAndParse) {
+    const uint32_t faceSize = 64;
+    std::vector<SkyboxFile::LevelData> levels = MakeLevels(faceSize);
+    std::vector<uint8_t> data = WriteAndRead(levels, faceSize);
+
+    SkyboxFile::FileHeader header = {};
+    std::vector<SkyboxFile::LevelView> views;
+    ASSERT_TRUE(SkyboxFile::Parse(data.data(), data.size(), &header, &views));
+    EXPECT_EQ(header.internal_format, FORMAT_ETC2_RGB8);
+    EXPECT_EQ(header.face_size, faceSize);
+    ASSERT_EQ(header.levels, levels.size());
+    ASSERT_EQ(views.size(), levels.size());
+
+    // smallest level first.
+    for (size_t i = 0; i < views.size(); i++) {
+        const SkyboxFile::LevelView& view = views[i];
+        EXPECT_EQ(view.level, header.levels - 1 - i);
+        EXPECT_EQ(view.size, faceSize >> view.level);
+        const SkyboxFile::LevelData& expected = levels[view.level];
+        ASSERT_EQ(view.face_bytes, expected[0].size());
+        for (int face = 0; face < SkyboxFile::FACE_COUNT; face++) {
+            // faces are 4 byte aligned in the buffer.
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(view.faces[face]) % 4, reinterpret_cast<uintptr_t>(data.data()) % 4);
+            EXPECT_EQ(memcmp(view.faces[face], expected[face].data(), view.face_bytes), 0);
+        }
+    }
+}
+
+TEST(SkyboxFileTest, TruncatedRejected) {
+    const uint32_t faceSize = 16;
+    std::vector<uint8_t> data = WriteAndRead(MakeLevels(faceSize), faceSize);
+    SkyboxFile::FileHeader header = {};
+    std::vector<SkyboxFile::LevelView> views;
+    for (size_t size : { size_t(0), sizeof(SkyboxFile::FileHeader) - 1, sizeof(SkyboxFile::FileHeader) + 2,
+                         data.size() / 2, data.size() - 1 }) {
+        EXPECT_FALSE(SkyboxFile::Parse(data.data(), size, &header, &views)) << size;
+        EXPECT_TRUE(views.empty());
+    }
+    EXPECT_FALSE(SkyboxFile::Parse(nullptr, data.size(), &header, &views));
+}
+
+TEST(SkyboxFileTest, BrokenHeaderRejected) {
+    const uint32_t faceSize = 16;
+    std::vector<uint8_t> data = WriteAndRead(MakeLevels(faceSize), faceSize);
+    SkyboxFile::FileHeader header = {};
+    std::vector<SkyboxFile::LevelView> views;
+
+    auto parseWith = [&](void (*edit)(SkyboxFile::FileHeader*)) {
+        std::vector<uint8_t> copy = data;
+        edit(reinterpret_cast<SkyboxFile::FileHeader*>(copy.data()));
+        return SkyboxFile::Parse(copy.data(), copy.size(), &header, &views);
+    };
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->magic = 0; }));
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->version = SkyboxFile::VERSION + 1; }));
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->face_size = 0; }));
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->levels = 0; }));
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->levels = 17; }));
+    // more levels than the face size has.
+    EXPECT_FALSE(parseWith([](SkyboxFile::FileHeader* h) { h->levels = 6; }));
+    EXPECT_TRUE(parseWith([](SkyboxFile::FileHeader* h) {}));
+}
+
+TEST(SkyboxFileTest, FaceSizeMismatchRejected) {
+    const uint32_t faceSize = 4;
+    std::vector<SkyboxFile::LevelData> levels = MakeLevels(faceSize);
+    // faces of a level must have the same size.
+    levels[1][3].push_back(0);
+    std::vector<uint8_t> data = WriteAndRead(levels, faceSize);
+    SkyboxFile::FileHeader header = {};
+    std::vector<SkyboxFile::LevelView> views;
+    EXPECT_FALSE(SkyboxFile::Parse(data.data(), data.size(), &header, &views));
+}
@@ -0,0 +1,160 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "snapshot_buffer.h"
+#include "support/gl_shim.h"
+
+using lark::SnapshotBuffer;
+
+namespace {
+const int OBJECT_COUNT = 64;
+
+// what a scene snapshot carries per object, every field stamped with the generation.
+struct SceneSnapshot {
+    uint64_t generation = 0;
+    std::array<glm::mat4, OBJECT_COUNT> transforms;
+    std::array<glm::vec4, OBJECT_COUNT> colors;
+    std::array<bool, OBJECT_COUNT> visible;
+};
+
+void Fill(SceneSnapshot* scene, uint64_t generation) {
+    scene->generation = generation;
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        scene->transforms[i] = glm::mat4(static_cast<float>(generation));
+        scene->colors[i] = glm::vec4(static_cast<float>(generation));
+        // half the objects hidden on odd generations.
+        scene->visible[i] = generation % 2 == 0 || i % 2 == 0;
+    }
+}
+
+bool Consistent(const SceneSnapshot& scene) {
+    float value = static_cast<float>(scene.generation);
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        if (scene.transforms[i] != glm::mat4(value) || scene.colors[i] != glm::vec4(value) ||
+            scene.visible[i] != (scene.generation % 2 == 0 || i % 2 == 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// draw with the gl shim, return draw calls.
+size_t Draw(const SceneSnapshot& scene) {
+    gl_shim::Reset();
+    for (int i = 0; i < OBJECT_COUNT; i++) {
+        if (!scene.visible[i]) {
+            continue;
+        }
+        glUniformMatrix4fv(0, 1, GL_FALSE, glm::value_ptr(scene.transforms[i]));
+        glUniform4fv(1, 1, glm::value_ptr(scene.colors[i]));
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+    }
+    return gl_shim::Count("glDrawElements");
+}
+}
+
+TEST(SnapshotBufferTest, AcquireOnlyWhenPublished) {
+    SnapshotBuffer<int> buffer;
+    EXPECT_FALSE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), 0);
+
+    buffer.Publish(1);
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), 1);
+    EXPECT_FALSE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), 1);
+}
+
+TEST(SnapshotBufferTest, LatestWins) {
+    SnapshotBuffer<int> buffer;
+    for (int i = 1; i <= 5; i++) {
+        buffer.Publish(i);
+    }
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), 5);
+    // front stays while the producer goes on.
+    buffer.Publish(6);
+    buffer.Publish(7);
+    EXPECT_EQ(buffer.front(), 5);
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), 7);
+}
+
+TEST(SnapshotBufferTest, ModifyEditsLastPublished) {
+    SnapshotBuffer<std::vector<int>> buffer;
+    buffer.Publish({ 1, 2 });
+    buffer.Modify([](std::vector<int>& latest) { latest.push_back(3); });
+    EXPECT_TRUE(buffer.Acquire());
+    EXPECT_EQ(buffer.front(), std::vector<int>({ 1, 2, 3 }));
+}
+
+// simulation thread publishes scenes with spikes inside the edit, render thread draws the newest
+// one every frame. every drawn scene must come from one publish, and the render frame must not
+// wait for the simulation.
+TEST(SnapshotBufferTest, RenderThreadNeverWaitsForSimulation) {
+    const int frames = 400;
+    const auto spike = std::chrono::milliseconds(15);
+    SnapshotBuffer<SceneSnapshot> buffer;
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> published(0);
+
+    std::thread simulation([&] {
+        for (uint64_t generation = 1; running; generation++) {
+            buffer.Modify([&](SceneSnapshot& scene) {
+                // app list rebuild or text raster every 10th update.
+                if (generation % 10 == 0) {
+                    std::this_thread::sleep_for(spike);
+                }
+                Fill(&scene, generation);
+            });
+            published = generation;
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    });
+
+    // first scene before the first frame.
+    while (!buffer.Acquire()) {
+        std::this_thread::yield();
+    }
+    std::vector<double> frameMs;
+    uint64_t last = 0;
+    int newFrames = 0;
+    int broken = 0;
+    for (int i = 0; i < frames; i++) {
+        auto start = std::chrono::steady_clock::now();
+        if (buffer.Acquire()) {
+            newFrames++;
+        }
+        const SceneSnapshot& scene = buffer.front();
+        size_t draws = Draw(scene);
+        frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        if (!Consistent(scene) || scene.generation < last ||
+            draws != (scene.generation % 2 == 0 ? OBJECT_COUNT : OBJECT_COUNT / 2u)) {
+            broken++;
+        }
+        last = scene.generation;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running = false;
+    simulation.join();
+
+    EXPECT_EQ(broken, 0);
+
+    std::sort(frameMs.begin(), frameMs.end());
+    double p99 = frameMs[frameMs.size() * 99 / 100];
+    RecordProperty("p99_us", static_cast<int>(p99 * 1000));
+    // a frame waiting on a spike would take 15ms.
+    EXPECT_LT(p99, 5.0);
+    EXPECT_GT(newFrames, frames / 4);
+    EXPECT_GT(published.load(), 10u);
+}
@@ -0,0 +1,13 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_API_LEVEL_H
+#define LARKXR_TESTS_ANDROID_API_LEVEL_H
+
+// gtest asks for it when __ANDROID__ is defined.
+#ifndef __ANDROID_API__
+#define __ANDROID_API__ 26
+#endif
+
+#endif //LARKXR_TESTS_ANDROID_API_LEVEL_H
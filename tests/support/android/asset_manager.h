@@ -0,0 +1,37 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_ASSET_MANAGER_H
+#define LARKXR_TESTS_ANDROID_ASSET_MANAGER_H
+
+#include <sys/types.h>
+
+// host replacement of the ndk asset manager, see android_asset.cpp.
+struct AAssetManager;
+struct AAsset;
+struct AAssetDir;
+
+enum {
+    AASSET_MODE_UNKNOWN   = 0,
+    AASSET_MODE_RANDOM    = 1,
+    AASSET_MODE_STREAMING = 2,
+    AASSET_MODE_BUFFER    = 3,
+};
+
+AAsset* AAssetManager_open(AAssetManager* mgr, const char* filename, int mode);
+void AAsset_close(AAsset* asset);
+const void* AAsset_getBuffer(AAsset* asset);
+off_t AAsset_getLength(AAsset* asset);
+int AAsset_read(AAsset* asset, void* buf, size_t count);
+AAssetDir* AAssetManager_openDir(AAssetManager* mgr, const char* dirName);
+const char* AAssetDir_getNextFileName(AAssetDir* assetDir);
+void AAssetDir_close(AAssetDir* assetDir);
+
+// asset manager reading files below root, eg. lib_xr_common_ui/src/main/assets.
+// test only. root is copied.
+AAssetManager* AAssetManager_fromDirectory(const char* root);
+// assets of another module merged like the apk build does. searched after the roots added before.
+void AAssetManager_addDirectory(AAssetManager* mgr, const char* root);
+
+#endif //LARKXR_TESTS_ANDROID_ASSET_MANAGER_H
@@ -0,0 +1,12 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_ASSET_MANAGER_JNI_H
+#define LARKXR_TESTS_ANDROID_ASSET_MANAGER_JNI_H
+
+// host replacement. asset managers come from AAssetManager_fromDirectory.
+#include "jni.h"
+#include "android/asset_manager.h"
+
+#endif //LARKXR_TESTS_ANDROID_ASSET_MANAGER_JNI_H
@@ -0,0 +1,28 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_BITMAP_H
+#define LARKXR_TESTS_ANDROID_BITMAP_H
+
+#include <cstdint>
+#include <jni.h>
+
+// host replacement of the ndk bitmap types.
+enum AndroidBitmapFormat {
+    ANDROID_BITMAP_FORMAT_NONE      = 0,
+    ANDROID_BITMAP_FORMAT_RGBA_8888 = 1,
+    ANDROID_BITMAP_FORMAT_RGB_565   = 4,
+    ANDROID_BITMAP_FORMAT_RGBA_4444 = 7,
+    ANDROID_BITMAP_FORMAT_A_8       = 8,
+};
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    int32_t format;
+    uint32_t flags;
+} AndroidBitmapInfo;
+
+#endif //LARKXR_TESTS_ANDROID_BITMAP_H
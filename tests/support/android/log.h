@@ -0,0 +1,28 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_LOG_H
+#define LARKXR_TESTS_ANDROID_LOG_H
+
+#include <cstdarg>
+
+// host replacement of the ndk log, see android_log.cpp.
+enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+};
+
+extern "C" {
+int __android_log_print(int prio, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+int __android_log_vprint(int prio, const char* tag, const char* fmt, va_list ap);
+}
+
+#endif //LARKXR_TESTS_ANDROID_LOG_H
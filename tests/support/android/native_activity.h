@@ -0,0 +1,28 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_ANDROID_NATIVE_ACTIVITY_H
+#define LARKXR_TESTS_ANDROID_NATIVE_ACTIVITY_H
+
+#include <cstdint>
+#include "jni.h"
+#include "android/asset_manager.h"
+
+// host replacement, same fields as the ndk struct. tests fill the paths and asset manager.
+struct ANativeActivityCallbacks;
+
+typedef struct ANativeActivity {
+    ANativeActivityCallbacks* callbacks;
+    JavaVM* vm;
+    JNIEnv* env;
+    jobject clazz;
+    const char* internalDataPath;
+    const char* externalDataPath;
+    int32_t sdkVersion;
+    void* instance;
+    AAssetManager* assetManager;
+    const char* obbPath;
+} ANativeActivity;
+
+#endif //LARKXR_TESTS_ANDROID_NATIVE_ACTIVITY_H
@@ -0,0 +1,108 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include "android/asset_manager.h"
+
+// an asset is the whole file read into memory, like AASSET_MODE_BUFFER.
+struct AAssetManager {
+    std::vector<std::string> roots;
+};
+
+struct AAsset {
+    std::vector<char> data;
+    size_t offset = 0;
+};
+
+struct AAssetDir {
+    DIR* dir;
+};
+
+AAssetManager* AAssetManager_fromDirectory(const char* root) {
+    return new AAssetManager{{root}};
+}
+
+void AAssetManager_addDirectory(AAssetManager* mgr, const char* root) {
+    mgr->roots.emplace_back(root);
+}
+
+AAsset* AAssetManager_open(AAssetManager* mgr, const char* filename, int mode) {
+    if (mgr == nullptr || filename == nullptr) {
+        return nullptr;
+    }
+    FILE* file = nullptr;
+    for (const auto & root : mgr->roots) {
+        std::string path = root + "/" + filename;
+        file = fopen(path.c_str(), "rb");
+        if (file != nullptr) {
+            break;
+        }
+    }
+    if (file == nullptr) {
+        return nullptr;
+    }
+    auto* asset = new AAsset();
+    char buf[64 * 1024];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        asset->data.insert(asset->data.end(), buf, buf + n);
+    }
+    fclose(file);
+    return asset;
+}
+
+void AAsset_close(AAsset* asset) {
+    delete asset;
+}
+
+const void* AAsset_getBuffer(AAsset* asset) {
+    return asset->data.data();
+}
+
+off_t AAsset_getLength(AAsset* asset) {
+    return static_cast<off_t>(asset->data.size());
+}
+
+int AAsset_read(AAsset* asset, void* buf, size_t count) {
+    size_t n = std::min(count, asset->data.size() - asset->offset);
+    memcpy(buf, asset->data.data() + asset->offset, n);
+    asset->offset += n;
+    return static_cast<int>(n);
+}
+
+AAssetDir* AAssetManager_openDir(AAssetManager* mgr, const char* dirName) {
+    DIR* dir = nullptr;
+    for (const auto & root : mgr->roots) {
+        dir = opendir((root + "/" + dirName).c_str());
+        if (dir != nullptr) {
+            break;
+        }
+    }
+    return new AAssetDir{dir};
+}
+
+const char* AAssetDir_getNextFileName(AAssetDir* assetDir) {
+    if (assetDir->dir == nullptr) {
+        return nullptr;
+    }
+    // files only, like the ndk.
+    for (dirent* entry = readdir(assetDir->dir); entry != nullptr; entry = readdir(assetDir->dir)) {
+        if (entry->d_type == DT_REG) {
+            return entry->d_name;
+        }
+    }
+    return nullptr;
+}
+
+void AAssetDir_close(AAssetDir* assetDir) {
+    if (assetDir->dir != nullptr) {
+        closedir(assetDir->dir);
+    }
+    delete assetDir;
+}
@@ -0,0 +1,33 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include "android/log.h"
+
+namespace {
+    // LARK_TEST_LOG=1 prints verbose logs too.
+    int MinPriority() {
+        static int priority = getenv("LARK_TEST_LOG") != nullptr ? ANDROID_LOG_VERBOSE : ANDROID_LOG_WARN;
+        return priority;
+    }
+}
+
+int __android_log_vprint(int prio, const char* tag, const char* fmt, va_list ap) {
+    if (prio < MinPriority()) {
+        return 0;
+    }
+    fprintf(stderr, "[%s] ", tag);
+    int res = vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    return res;
+}
+
+int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int res = __android_log_vprint(prio, tag, fmt, ap);
+    va_end(ap);
+    return res;
+}
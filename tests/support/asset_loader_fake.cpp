@@ -0,0 +1,31 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+// AssetLoader needs assimp. the parts Object uses, shaders are never loaded on the host.
+
+#include "asset_loader.h"
+
+namespace lark {
+AssetLoader* AssetLoader::instance_ = nullptr;
+
+AssetLoader* AssetLoader::instance() {
+    if (instance_ == nullptr) {
+        instance_ = new AssetLoader();
+    }
+    return instance_;
+}
+
+void AssetLoader::Release() {
+    delete instance_;
+    instance_ = nullptr;
+}
+
+AssetLoader::AssetLoader() = default;
+
+AssetLoader::~AssetLoader() = default;
+
+std::shared_ptr<Shader> AssetLoader::LoadShader(AAssetManager* assetManager, const ShaderAsset& shaderAsset) {
+    return nullptr;
+}
+}
@@ -0,0 +1,20 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+// the java BitmapFactory is not on the host. decode with stb_image instead,
+// same rgba8 output as BitmapFactory with ARGB_8888.
+
+#include "bitmap_factory.h"
+
+namespace lark {
+BitmapFactoryDecoder::BitmapFactoryDecoder(BitmapFactory *bitmapFactory, JNIEnv *env):
+    bitmap_factory_(bitmapFactory),
+    env_(env) {
+}
+
+bool BitmapFactoryDecoder::Decode(const void *data, size_t size, const Consumer &consumer) {
+    StbImageDecoder decoder;
+    return decoder.Decode(data, size, consumer);
+}
+}
@@ -0,0 +1,220 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "gl_shim.h"
+
+namespace {
+    std::vector<gl_shim::Call> calls_;
+    GLenum error_ = GL_NO_ERROR;
+    GLenum sync_result_ = GL_ALREADY_SIGNALED;
+    GLuint next_name_ = 1;
+    uintptr_t next_sync_ = 1;
+    std::vector<uint8_t> mapped_;
+    std::string error_call_;
+    GLenum error_call_error_ = GL_NO_ERROR;
+
+    void Record(const char* name, std::vector<int64_t> args = {}) {
+        calls_.push_back({name, std::move(args)});
+        if (!error_call_.empty() && error_call_ == name) {
+            error_ = error_call_error_;
+            error_call_.clear();
+        }
+    }
+
+    void Gen(const char* name, GLsizei n, GLuint* names) {
+        for (GLsizei i = 0; i < n; i++) {
+            names[i] = next_name_++;
+        }
+        Record(name, {n});
+    }
+}
+
+namespace gl_shim {
+void Reset() {
+    calls_.clear();
+    error_ = GL_NO_ERROR;
+    sync_result_ = GL_ALREADY_SIGNALED;
+    error_call_.clear();
+}
+
+const std::vector<Call>& calls() {
+    return calls_;
+}
+
+size_t Count(const std::string& name) {
+    size_t count = 0;
+    for (const auto & call : calls_) {
+        count += call.name == name ? 1 : 0;
+    }
+    return count;
+}
+
+std::vector<Call> Find(const std::string& name) {
+    std::vector<Call> res;
+    for (const auto & call : calls_) {
+        if (call.name == name) {
+            res.push_back(call);
+        }
+    }
+    return res;
+}
+
+void SetError(GLenum error) {
+    error_ = error;
+}
+
+void SetErrorOn(const std::string& name, GLenum error) {
+    error_call_ = name;
+    error_call_error_ = error;
+}
+
+void SetSyncResult(GLenum result) {
+    sync_result_ = result;
+}
+
+const std::vector<uint8_t>& mapped() {
+    return mapped_;
+}
+}
+
+GLenum glGetError() {
+    GLenum error = error_;
+    error_ = GL_NO_ERROR;
+    return error;
+}
+
+// objects
+void glGenTextures(GLsizei n, GLuint* textures) { Gen("glGenTextures", n, textures); }
+void glGenBuffers(GLsizei n, GLuint* buffers) { Gen("glGenBuffers", n, buffers); }
+void glGenVertexArrays(GLsizei n, GLuint* arrays) { Gen("glGenVertexArrays", n, arrays); }
+void glDeleteTextures(GLsizei n, const GLuint* textures) { Record("glDeleteTextures", {n, n > 0 ? textures[0] : 0}); }
+void glDeleteBuffers(GLsizei n, const GLuint* buffers) { Record("glDeleteBuffers", {n, n > 0 ? buffers[0] : 0}); }
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays) { Record("glDeleteVertexArrays", {n, n > 0 ? arrays[0] : 0}); }
+
+// state
+void glUseProgram(GLuint program) { Record("glUseProgram", {program}); }
+void glUniform1i(GLint location, GLint v0) { Record("glUniform1i", {location, v0}); }
+void glUniform1f(GLint location, GLfloat v0) { Record("glUniform1f", {location}); }
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value) { Record("glUniform3fv", {location, count}); }
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value) { Record("glUniform4fv", {location, count}); }
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    Record("glUniformMatrix4fv", {location, count, transpose});
+}
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    Record("glDrawElements", {mode, count, type});
+}
+void glBindVertexArray(GLuint array) { Record("glBindVertexArray", {array}); }
+void glActiveTexture(GLenum texture) { Record("glActiveTexture", {texture}); }
+void glBindTexture(GLenum target, GLuint texture) { Record("glBindTexture", {target, texture}); }
+void glBindBuffer(GLenum target, GLuint buffer) { Record("glBindBuffer", {target, buffer}); }
+void glEnable(GLenum cap) { Record("glEnable", {cap}); }
+void glDisable(GLenum cap) { Record("glDisable", {cap}); }
+void glDepthMask(GLboolean flag) { Record("glDepthMask", {flag}); }
+void glBlendFunc(GLenum sfactor, GLenum dfactor) { Record("glBlendFunc", {sfactor, dfactor}); }
+void glPixelStorei(GLenum pname, GLint param) { Record("glPixelStorei", {pname, param}); }
+void glTexParameteri(GLenum target, GLenum pname, GLint param) { Record("glTexParameteri", {target, pname, param}); }
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param) {
+    Record("glTexParameterf", {target, pname, static_cast<int64_t>(param)});
+}
+
+// data
+void glGenerateMipmap(GLenum target) { Record("glGenerateMipmap", {target}); }
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                  GLint border, GLenum format, GLenum type, const void* pixels) {
+    Record("glTexImage2D", {target, level, internalformat, width, height, format, type});
+}
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                     GLenum format, GLenum type, const void* pixels) {
+    Record("glTexSubImage2D", {target, level, xoffset, yoffset, width, height, format, type});
+}
+void glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+                               GLenum format, GLsizei imageSize, const void* data) {
+    Record("glCompressedTexSubImage2D", {target, level, xoffset, yoffset, width, height, format, imageSize});
+}
+void glTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) {
+    Record("glTexStorage2D", {target, levels, internalformat, width, height});
+}
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    Record("glBufferData", {target, size, usage});
+}
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    Record("glMapBufferRange", {target, offset, length, access});
+    mapped_.assign(static_cast<size_t>(length), 0);
+    return mapped_.data();
+}
+GLboolean glUnmapBuffer(GLenum target) {
+    Record("glUnmapBuffer", {target});
+    return GL_TRUE;
+}
+
+// sync
+GLsync glFenceSync(GLenum condition, GLbitfield flags) {
+    GLsync sync = reinterpret_cast<GLsync>(next_sync_++);
+    Record("glFenceSync", {static_cast<int64_t>(reinterpret_cast<uintptr_t>(sync))});
+    return sync;
+}
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    Record("glClientWaitSync", {static_cast<int64_t>(reinterpret_cast<uintptr_t>(sync))});
+    return sync_result_;
+}
+void glDeleteSync(GLsync sync) {
+    Record("glDeleteSync", {static_cast<int64_t>(reinterpret_cast<uintptr_t>(sync))});
+}
+
+// programs. compile and link always succeed, no binary formats.
+GLuint glCreateShader(GLenum type) { GLuint name = next_name_++; Record("glCreateShader", {type, name}); return name; }
+GLuint glCreateProgram() { GLuint name = next_name_++; Record("glCreateProgram", {name}); return name; }
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+    Record("glShaderSource", {shader, count});
+}
+void glCompileShader(GLuint shader) { Record("glCompileShader", {shader}); }
+void glAttachShader(GLuint program, GLuint shader) { Record("glAttachShader", {program, shader}); }
+void glLinkProgram(GLuint program) { Record("glLinkProgram", {program}); }
+void glDeleteShader(GLuint shader) { Record("glDeleteShader", {shader}); }
+void glDeleteProgram(GLuint program) { Record("glDeleteProgram", {program}); }
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+}
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    if (length != nullptr) {
+        *length = 0;
+    }
+    if (bufSize > 0 && infoLog != nullptr) {
+        infoLog[0] = '\0';
+    }
+}
+void glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) {
+    if (length != nullptr) {
+        *length = 0;
+    }
+    Record("glGetProgramBinary", {program});
+}
+void glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+    Record("glProgramBinary", {program, binaryFormat, length});
+}
+void glProgramParameteri(GLuint program, GLenum pname, GLint value) { Record("glProgramParameteri", {program, pname, value}); }
+GLint glGetAttribLocation(GLuint program, const GLchar* name) { return -1; }
+GLint glGetUniformLocation(GLuint program, const GLchar* name) { return -1; }
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName) { return GL_INVALID_INDEX; }
+void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) {
+    Record("glUniformBlockBinding", {program, uniformBlockIndex, uniformBlockBinding});
+}
+
+// vertex data
+void glEnableVertexAttribArray(GLuint index) { Record("glEnableVertexAttribArray", {index}); }
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    Record("glVertexAttribPointer", {index, size, type, normalized, stride,
+                                     static_cast<int64_t>(reinterpret_cast<uintptr_t>(pointer))});
+}
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    Record("glBufferSubData", {target, offset, size});
+}
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) { Record("glBindBufferBase", {target, index, buffer}); }
+
+// queries
+void glGetIntegerv(GLenum pname, GLint* data) { *data = 0; }
+const GLubyte* glGetString(GLenum name) { return reinterpret_cast<const GLubyte*>(""); }
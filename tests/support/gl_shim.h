@@ -0,0 +1,41 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_GL_SHIM_H
+#define LARKXR_TESTS_GL_SHIM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <GLES3/gl31.h>
+
+//
+// host replacement of the gles functions used by the tested code.
+// every call is recorded with its integer arguments, nothing is drawn.
+// gen functions return increasing names, glGetError returns the error set by SetError once.
+//
+namespace gl_shim {
+struct Call {
+    std::string name;
+    std::vector<int64_t> args;
+};
+
+// clear recorded calls and pending error. names keep increasing.
+void Reset();
+const std::vector<Call>& calls();
+// count of recorded calls with the name.
+size_t Count(const std::string& name);
+// calls with the name in record order.
+std::vector<Call> Find(const std::string& name);
+// next glGetError returns error.
+void SetError(GLenum error);
+// the next call with the name sets the error, like a call the driver rejects.
+void SetErrorOn(const std::string& name, GLenum error);
+// result of glClientWaitSync, GL_ALREADY_SIGNALED by default.
+void SetSyncResult(GLenum result);
+// memory returned by the last glMapBufferRange, valid until the next map.
+const std::vector<uint8_t>& mapped();
+}
+
+#endif //LARKXR_TESTS_GL_SHIM_H
@@ -0,0 +1,46 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_JNI_H
+#define LARKXR_TESTS_JNI_H
+
+#include <cstdint>
+
+// host replacement of jni.h. types only, tested code never calls into java.
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef float jfloat;
+typedef jint jsize;
+
+class _jobject {};
+typedef _jobject* jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef jobject jbyteArray;
+
+struct _jmethodID;
+typedef _jmethodID* jmethodID;
+struct _jfieldID;
+typedef _jfieldID* jfieldID;
+
+struct JNIEnv;
+
+#define JNIEXPORT
+#define JNICALL
+#define JNI_TRUE 1
+#define JNI_FALSE 0
+#define JNI_OK 0
+#define JNI_VERSION_1_6 0x00010006
+
+// every thread counts as attached, env stays null.
+struct JavaVM {
+    jint GetEnv(void** env, jint version) {
+        *env = nullptr;
+        return JNI_OK;
+    }
+};
+
+#endif //LARKXR_TESTS_JNI_H
@@ -0,0 +1,29 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+// the lark_xr sdk is a prebuilt android library. the parts used by the tested sources.
+
+#include <lark_xr/xr_client.h>
+#include <lark_xr/xr_config.h>
+#include <lark_xr/xr_latency_collector.h>
+
+namespace lark {
+int XRConfig::fps = 72;
+larkHeadSetControllerDesc XRConfig::headset_desc = {};
+
+XRLatencyCollector XRLatencyCollector::instance_;
+
+XRLatencyCollector::XRLatencyCollector() = default;
+
+XRLatencyCollector& XRLatencyCollector::Instance() {
+    return instance_;
+}
+
+uint64_t XRLatencyCollector::packets_lost_in_second() { return 0; }
+uint64_t XRLatencyCollector::fec_failure_in_second() { return 0; }
+uint32_t XRLatencyCollector::frames_in_second() { return 0; }
+
+const char* XRClient::GetServerHost() { return "127.0.0.1"; }
+uint16_t XRClient::GetServerPort() { return 8181; }
+}
@@ -0,0 +1,99 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+// RegionRttTest of the sdk measures over the lark websocket. on the host it is one tcp round trip,
+// a byte sent to ip:port and the echo back, so tests can probe loopback echo servers.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <lark_xr/request/region_rtt_test.h>
+
+namespace {
+    const int ANSWER_TIMEOUT_MS = 1000;
+}
+
+namespace lark {
+class RegionRttTestImp {
+public:
+    RegionRttTestListener* listener = nullptr;
+    std::thread thread;
+    std::mutex mutex;
+    // owned by the test thread, shut down by Close.
+    int fd = -1;
+};
+
+RegionRttTest::RegionRttTest(): region_rtt_test_(new RegionRttTestImp) {
+}
+
+RegionRttTest::~RegionRttTest() {
+    Close();
+    delete region_rtt_test_;
+}
+
+bool RegionRttTest::Connect(const std::string &ip, int port, const std::string &path, const std::string &regionId) {
+    RegionRttTestImp* imp = region_rtt_test_;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (imp->thread.joinable() || inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    timeval timeout = { ANSWER_TIMEOUT_MS / 1000, (ANSWER_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    imp->fd = fd;
+    imp->thread = std::thread([imp, fd, addr, regionId] {
+        RegionRttTestListener* listener = imp->listener;
+        char data = 'p';
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            listener->OnRegionRttTestError("connect failed", regionId);
+        } else {
+            auto start = std::chrono::steady_clock::now();
+            if (send(fd, &data, 1, MSG_NOSIGNAL) == 1 && recv(fd, &data, 1, 0) == 1) {
+                auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                listener->OnRegionRttTestResult(static_cast<uint64_t>(rtt), regionId);
+            } else {
+                listener->OnRegionRttTestError("no answer", regionId);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(imp->mutex);
+            close(imp->fd);
+            imp->fd = -1;
+        }
+        listener->OnRegionRttTestClose("", regionId);
+    });
+    return true;
+}
+
+void RegionRttTest::Close() {
+    RegionRttTestImp* imp = region_rtt_test_;
+    {
+        std::lock_guard<std::mutex> lock(imp->mutex);
+        if (imp->fd >= 0) {
+            shutdown(imp->fd, SHUT_RDWR);
+        }
+    }
+    if (imp->thread.joinable()) {
+        if (imp->thread.get_id() == std::this_thread::get_id()) {
+            imp->thread.detach();
+        } else {
+            imp->thread.join();
+        }
+    }
+}
+
+void RegionRttTest::set_listener(RegionRttTestListener *listener) {
+    region_rtt_test_->listener = listener;
+}
+}
@@ -0,0 +1,103 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <map>
+#include "wvr_runtime_fake.h"
+
+namespace {
+    std::map<WVR_DeviceType, wvr_fake::Device> devices_;
+    std::map<std::string, size_t> counts_;
+
+    const wvr_fake::Device* Find(WVR_DeviceType type) {
+        auto it = devices_.find(type);
+        return it == devices_.end() ? nullptr : &it->second;
+    }
+
+    bool Bit(uint32_t mask, WVR_InputId id) {
+        return (mask & (1u << id)) != 0;
+    }
+}
+
+namespace wvr_fake {
+void Reset() {
+    devices_.clear();
+    counts_.clear();
+}
+
+void SetDevice(WVR_DeviceType type, const Device &device) {
+    devices_[type] = device;
+}
+
+size_t Count(const std::string &name) {
+    auto it = counts_.find(name);
+    return it == counts_.end() ? 0 : it->second;
+}
+}
+
+int32_t WVR_GetInputTypeCount(WVR_DeviceType type, WVR_InputType inputType) {
+    counts_["WVR_GetInputTypeCount"]++;
+    const wvr_fake::Device* device = Find(type);
+    if (device == nullptr) {
+        return -1;
+    }
+    switch (inputType) {
+        case WVR_InputType_Analog:
+            return static_cast<int32_t>(device->analogs.size());
+        case WVR_InputType_Button:
+            return __builtin_popcount(device->buttons);
+        case WVR_InputType_Touch:
+            return __builtin_popcount(device->touches);
+        default:
+            return -1;
+    }
+}
+
+bool WVR_GetInputDeviceState(WVR_DeviceType type, uint32_t inputType, uint32_t* buttons, uint32_t* touches,
+                             WVR_AnalogState_t* analogArray, uint32_t analogArrayCount) {
+    counts_["WVR_GetInputDeviceState"]++;
+    const wvr_fake::Device* device = Find(type);
+    if (device == nullptr || (inputType & device->failed_types) != 0) {
+        return false;
+    }
+    if ((inputType & WVR_InputType_Analog) != 0 && analogArrayCount != device->analogs.size()) {
+        return false;
+    }
+    if ((inputType & WVR_InputType_Button) != 0) {
+        *buttons = device->buttons;
+    }
+    if ((inputType & WVR_InputType_Touch) != 0) {
+        *touches = device->touches;
+    }
+    if ((inputType & WVR_InputType_Analog) != 0) {
+        for (uint32_t i = 0; i < analogArrayCount; i++) {
+            analogArray[i] = device->analogs[i];
+        }
+    }
+    return true;
+}
+
+bool WVR_GetInputButtonState(WVR_DeviceType type, WVR_InputId id) {
+    counts_["WVR_GetInputButtonState"]++;
+    const wvr_fake::Device* device = Find(type);
+    return device != nullptr && Bit(device->buttons, id);
+}
+
+bool WVR_GetInputTouchState(WVR_DeviceType type, WVR_InputId id) {
+    counts_["WVR_GetInputTouchState"]++;
+    const wvr_fake::Device* device = Find(type);
+    return device != nullptr && Bit(device->touches, id);
+}
+
+WVR_Axis_t WVR_GetInputAnalogAxis(WVR_DeviceType type, WVR_InputId id) {
+    counts_["WVR_GetInputAnalogAxis"]++;
+    const wvr_fake::Device* device = Find(type);
+    if (device != nullptr) {
+        for (const auto & analog : device->analogs) {
+            if (analog.id == id) {
+                return analog.axis;
+            }
+        }
+    }
+    return {};
+}
@@ -0,0 +1,32 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_TESTS_WVR_RUNTIME_FAKE_H
+#define LARKXR_TESTS_WVR_RUNTIME_FAKE_H
+
+#include <string>
+#include <vector>
+#include <wvr/wvr_device.h>
+
+//
+// host replacement of the wave input functions. devices hold the state returned by the
+// runtime and every call is counted by name.
+//
+namespace wvr_fake {
+struct Device {
+    uint32_t buttons;
+    uint32_t touches;
+    std::vector<WVR_AnalogState_t> analogs;
+    // input types WVR_GetInputDeviceState fails on, like a type the device has no data for.
+    uint32_t failed_types;
+};
+
+// remove devices and counts.
+void Reset();
+void SetDevice(WVR_DeviceType type, const Device& device);
+// calls of the wave function with the name since the last Reset.
+size_t Count(const std::string& name);
+}
+
+#endif //LARKXR_TESTS_WVR_RUNTIME_FAKE_H
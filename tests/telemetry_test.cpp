@@ -0,0 +1,126 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <dirent.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "telemetry.h"
+
+namespace {
+const int SUB_BUCKETS = LatencyHistogram::SUB_BUCKETS;
+const int BUCKET_COUNT = LatencyHistogram::BUCKET_COUNT;
+const int MAX_EXPORT_FILES = Telemetry::MAX_EXPORT_FILES;
+
+std::vector<std::string> ListExports(const std::string& dir) {
+    std::vector<std::string> files;
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr) {
+        return files;
+    }
+    struct dirent* ent = nullptr;
+    while ((ent = readdir(d)) != nullptr) {
+        if (strncmp(ent->d_name, "telemetry_", 10) == 0) {
+            files.emplace_back(ent->d_name);
+        }
+    }
+    closedir(d);
+    return files;
+}
+}
+
+TEST(LatencyHistogramTest, SmallValuesExact) {
+    for (uint64_t value = 0; value < static_cast<uint64_t>(SUB_BUCKETS); value++) {
+        EXPECT_EQ(LatencyHistogram::ToIndex(value), static_cast<int>(value));
+        EXPECT_EQ(LatencyHistogram::FromIndex(static_cast<int>(value)), value);
+    }
+}
+
+TEST(LatencyHistogramTest, BucketRelativeError) {
+    int last = 0;
+    for (uint64_t value = 1; value < (1ULL << 36); value = value * 17 / 16 + 1) {
+        int index = LatencyHistogram::ToIndex(value);
+        // monotonic, inside the table.
+        EXPECT_GE(index, last);
+        EXPECT_LT(index, BUCKET_COUNT);
+        last = index;
+        double middle = static_cast<double>(LatencyHistogram::FromIndex(index));
+        EXPECT_LE(std::fabs(middle - static_cast<double>(value)) / static_cast<double>(value), 1.0 / SUB_BUCKETS)
+                << value;
+    }
+    // larger values go to the last bucket.
+    EXPECT_EQ(LatencyHistogram::ToIndex(~0ULL), BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.Percentile(50), 0u);
+    // 1 .. 1000 us.
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.Record(value);
+    }
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.max(), 1000u);
+    EXPECT_NEAR(static_cast<double>(histogram.Percentile(50)), 500.0, 500.0 / SUB_BUCKETS);
+    EXPECT_NEAR(static_cast<double>(histogram.Percentile(99)), 990.0, 990.0 / SUB_BUCKETS);
+    EXPECT_EQ(histogram.Percentile(0), 1u);
+    // bucket middle clamped to the max.
+    EXPECT_EQ(histogram.Percentile(100), 1000u);
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.Percentile(99), 0u);
+}
+
+TEST(LatencyHistogramTest, TailNotHiddenByMedian) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 990; i++) {
+        histogram.Record(20 * 1000);
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.Record(200 * 1000);
+    }
+    EXPECT_NEAR(static_cast<double>(histogram.Percentile(50)), 20000.0, 20000.0 / SUB_BUCKETS);
+    EXPECT_NEAR(static_cast<double>(histogram.Percentile(99.5)), 200000.0, 200000.0 / SUB_BUCKETS);
+}
+
+TEST(LatencyHistogramTest, Json) {
+    LatencyHistogram histogram;
+    histogram.Record(3);
+    histogram.Record(3);
+    histogram.Record(100);
+    std::string json;
+    histogram.ToJson(&json);
+    EXPECT_EQ(json.find("{\"count\":3,\"max\":100,\"p50\":3,"), 0u) << json;
+    std::string buckets = "\"buckets\":[[3,2],[" + std::to_string(LatencyHistogram::ToIndex(100)) + ",1]]}";
+    EXPECT_NE(json.find(buckets), std::string::npos) << json;
+}
+
+TEST(TelemetryTest, KeepsLastExports) {
+    char dir[] = "/tmp/telemetry_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    std::string exportDir = std::string(dir) + "/larkxr/telemetry";
+    Telemetry* telemetry = Telemetry::instance();
+    telemetry->Start(dir);
+    const int windows = MAX_EXPORT_FILES + 5;
+    for (int i = 0; i < windows; i++) {
+        telemetry->Record(Telemetry::Metric_TrackingToFrameReady, 30 * 1000);
+        ASSERT_TRUE(telemetry->Export());
+        // file name is the window start in ms.
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // nothing recorded, nothing written.
+    EXPECT_FALSE(telemetry->Export());
+    std::vector<std::string> files = ListExports(exportDir);
+    EXPECT_EQ(files.size(), static_cast<size_t>(MAX_EXPORT_FILES));
+    telemetry->Stop();
+    Telemetry::Release();
+    std::string cmd = std::string("rm -rf ") + dir;
+    system(cmd.c_str());
+}
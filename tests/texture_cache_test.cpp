@@ -0,0 +1,178 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include "texture_cache.h"
+
+using lark::CachedImage;
+using lark::TextureCache;
+
+namespace {
+const int WIDTH = 16;
+const int HEIGHT = 8;
+// magic, version, format, levels, width, height, source_hash, data_size.
+const long VALIDATED_TIME_OFFSET = 6 * 4 + 8 * 2;
+
+std::vector<uint8_t> MakePixels(uint8_t value) {
+    return std::vector<uint8_t>(WIDTH * HEIGHT * 4, value);
+}
+
+std::string EntryPath(const std::string& dir, uint64_t key) {
+    char name[32] = {};
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return dir + "/" + name + ".pxyc";
+}
+
+class TextureCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char dir[] = "/tmp/texture_cache_test_XXXXXX";
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        dir_ = dir;
+    }
+    void TearDown() override {
+        TextureCache::Release();
+        std::string cmd = "rm -rf " + dir_;
+        system(cmd.c_str());
+    }
+    // like a new launch.
+    void Reopen(size_t maxBytes = TextureCache::DEFAULT_MAX_BYTES,
+                int64_t maxAgeS = TextureCache::DEFAULT_MAX_AGE_S) {
+        TextureCache::Release();
+        ASSERT_TRUE(TextureCache::instance()->Init(dir_, maxBytes, maxAgeS));
+    }
+
+    std::string dir_;
+};
+}
+
+TEST_F(TextureCacheTest, StoreAndOpen) {
+    Reopen();
+    TextureCache* cache = TextureCache::instance();
+    uint64_t key = TextureCache::Hash("http://cover/1.jpg");
+    EXPECT_FALSE(cache->Contains(key));
+    EXPECT_EQ(cache->Open(key), nullptr);
+
+    std::vector<uint8_t> pixels = MakePixels(9);
+    ASSERT_TRUE(cache->Store(key, 42, WIDTH, HEIGHT, pixels.data()));
+    EXPECT_TRUE(cache->Contains(key));
+    std::shared_ptr<CachedImage> image = cache->Open(key);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->width(), WIDTH);
+    EXPECT_EQ(image->height(), HEIGHT);
+    EXPECT_EQ(image->source_hash(), 42u);
+    ASSERT_EQ(image->pixels_size(), pixels.size());
+    EXPECT_EQ(image->pixels()[pixels.size() - 1], 9);
+    EXPECT_EQ(cache->hits(), 1u);
+    EXPECT_EQ(cache->misses(), 1u);
+}
+
+TEST_F(TextureCacheTest, EvictsLeastRecentlyUsed) {
+    const size_t entryBytes = WIDTH * HEIGHT * 4 + 64;
+    Reopen(entryBytes * 2);
+    TextureCache* cache = TextureCache::instance();
+    std::vector<uint8_t> pixels = MakePixels(1);
+    ASSERT_TRUE(cache->Store(1, 1, WIDTH, HEIGHT, pixels.data()));
+    ASSERT_TRUE(cache->Store(2, 2, WIDTH, HEIGHT, pixels.data()));
+    // 1 used after 2.
+    ASSERT_NE(cache->Open(1), nullptr);
+    ASSERT_TRUE(cache->Store(3, 3, WIDTH, HEIGHT, pixels.data()));
+    EXPECT_TRUE(cache->Contains(1));
+    EXPECT_FALSE(cache->Contains(2));
+    EXPECT_TRUE(cache->Contains(3));
+    EXPECT_NE(access(EntryPath(dir_, 2).c_str(), F_OK), 0);
+}
+
+TEST_F(TextureCacheTest, IndexReloadedWithSourceHash) {
+    Reopen();
+    std::vector<uint8_t> pixels = MakePixels(3);
+    ASSERT_TRUE(TextureCache::instance()->Store(7, 1234, WIDTH, HEIGHT, pixels.data()));
+
+    Reopen();
+    TextureCache* cache = TextureCache::instance();
+    EXPECT_TRUE(cache->Contains(7));
+    EXPECT_FALSE(cache->IsStale(7));
+    // same source bytes.
+    EXPECT_TRUE(cache->Validate(7, 1234));
+    // image behind the url changed.
+    EXPECT_FALSE(cache->Validate(7, 4321));
+    EXPECT_FALSE(cache->Validate(8, 1234));
+}
+
+TEST_F(TextureCacheTest, StaleAfterMaxAge) {
+    Reopen();
+    std::vector<uint8_t> pixels = MakePixels(3);
+    ASSERT_TRUE(TextureCache::instance()->Store(7, 1234, WIDTH, HEIGHT, pixels.data()));
+
+    // entry last validated at 1970.
+    FILE* file = fopen(EntryPath(dir_, 7).c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    int64_t old = 0;
+    fseek(file, VALIDATED_TIME_OFFSET, SEEK_SET);
+    ASSERT_EQ(fwrite(&old, sizeof(old), 1, file), 1u);
+    fclose(file);
+
+    Reopen();
+    TextureCache* cache = TextureCache::instance();
+    EXPECT_TRUE(cache->Contains(7));
+    EXPECT_TRUE(cache->IsStale(7));
+    // still readable while the download checks it.
+    EXPECT_NE(cache->Open(7), nullptr);
+
+    // validated time written back to the file.
+    ASSERT_TRUE(cache->Validate(7, 1234));
+    EXPECT_FALSE(cache->IsStale(7));
+    Reopen();
+    EXPECT_FALSE(TextureCache::instance()->IsStale(7));
+}
+
+TEST_F(TextureCacheTest, MissingIsStale) {
+    Reopen();
+    EXPECT_TRUE(TextureCache::instance()->IsStale(99));
+}
+
+TEST_F(TextureCacheTest, ReplacedWhenSourceChanged) {
+    Reopen();
+    TextureCache* cache = TextureCache::instance();
+    std::vector<uint8_t> oldPixels = MakePixels(1);
+    std::vector<uint8_t> newPixels = MakePixels(2);
+    ASSERT_TRUE(cache->Store(7, 1, WIDTH, HEIGHT, oldPixels.data()));
+    ASSERT_FALSE(cache->Validate(7, 2));
+    ASSERT_TRUE(cache->Store(7, 2, WIDTH, HEIGHT, newPixels.data()));
+    std::shared_ptr<CachedImage> image = cache->Open(7);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(image->source_hash(), 2u);
+    EXPECT_EQ(image->pixels()[0], 2);
+    EXPECT_TRUE(cache->Validate(7, 2));
+}
+
+TEST_F(TextureCacheTest, BrokenFilesRemovedOnInit) {
+    // entry of an older version and a truncated one.
+    std::string old = EntryPath(dir_, 5);
+    std::string truncated = EntryPath(dir_, 6);
+    FILE* file = fopen(old.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    uint32_t header[] = { TextureCache::MAGIC, 1, 0, 1, WIDTH, HEIGHT, 0, 0, 0, 0, 0, 0 };
+    fwrite(header, sizeof(header), 1, file);
+    std::vector<uint8_t> pixels = MakePixels(1);
+    fwrite(pixels.data(), pixels.size(), 1, file);
+    fclose(file);
+    file = fopen(truncated.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(header, 8, 1, file);
+    fclose(file);
+
+    Reopen();
+    EXPECT_FALSE(TextureCache::instance()->Contains(5));
+    EXPECT_FALSE(TextureCache::instance()->Contains(6));
+    EXPECT_NE(access(old.c_str(), F_OK), 0);
+    EXPECT_NE(access(truncated.c_str(), F_OK), 0);
+    EXPECT_EQ(TextureCache::instance()->total_bytes(), 0u);
+}
@@ -0,0 +1,194 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "texture_streamer.h"
+#include "support/gl_shim.h"
+
+using lark::TextureRequest;
+using lark::TextureStreamer;
+
+namespace {
+const int WIDTH = 64;
+const int HEIGHT = 32;
+const size_t ROW_BYTES = WIDTH * 4;
+
+// binary ppm, stb_image decodes it to rgba. pixel value encodes row and column.
+std::vector<char> MakePpm(int width, int height) {
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    std::vector<char> data(header.begin(), header.end());
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            data.push_back(static_cast<char>(y));
+            data.push_back(static_cast<char>(x));
+            data.push_back(7);
+        }
+    }
+    return data;
+}
+
+// bytes passed to glTexSubImage2D since the last Reset.
+size_t UploadedBytes() {
+    size_t bytes = 0;
+    for (const auto & call : gl_shim::Find("glTexSubImage2D")) {
+        bytes += static_cast<size_t>(call.args[4] * call.args[5] * 4);
+    }
+    return bytes;
+}
+
+// one frame after another until the request is done. return frames that uploaded rows.
+int RunFrames(const std::shared_ptr<TextureRequest>& request, size_t budget) {
+    int uploadFrames = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!request->done() && std::chrono::steady_clock::now() < deadline) {
+        gl_shim::Reset();
+        TextureStreamer::instance()->Update();
+        size_t bytes = UploadedBytes();
+        EXPECT_LE(bytes, budget);
+        if (bytes > 0) {
+            uploadFrames++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return uploadFrames;
+}
+
+class TextureStreamerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        gl_shim::Reset();
+    }
+    void TearDown() override {
+        TextureStreamer::Release();
+    }
+};
+}
+
+TEST_F(TextureStreamerTest, UploadsWithinBudgetEveryFrame) {
+    // 8 rows per frame.
+    const size_t budget = ROW_BYTES * 8;
+    TextureStreamer::instance()->set_upload_budget(budget);
+    std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(MakePpm(WIDTH, HEIGHT));
+
+    int uploadFrames = RunFrames(request, budget);
+    ASSERT_EQ(request->state(), TextureRequest::State_Ready);
+    EXPECT_EQ(uploadFrames, HEIGHT / 8);
+    ASSERT_NE(request->texture(), nullptr);
+    EXPECT_EQ(request->texture()->width(), WIDTH);
+    EXPECT_EQ(request->texture()->height(), HEIGHT);
+    EXPECT_EQ(TextureStreamer::instance()->uploaded_bytes(), ROW_BYTES * HEIGHT);
+    EXPECT_EQ(TextureStreamer::instance()->completed(), 1u);
+}
+
+TEST_F(TextureStreamerTest, UploadsDecodedRows) {
+    const size_t budget = ROW_BYTES * 8;
+    TextureStreamer::instance()->set_upload_budget(budget);
+    std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(MakePpm(WIDTH, HEIGHT));
+
+    // stop at the first frame that uploads and check the pixel buffer.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (gl_shim::Count("glTexSubImage2D") == 0 && std::chrono::steady_clock::now() < deadline) {
+        gl_shim::Reset();
+        TextureStreamer::instance()->Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::vector<gl_shim::Call> uploads = gl_shim::Find("glTexSubImage2D");
+    ASSERT_EQ(uploads.size(), 1u);
+    // from the pixel unpack buffer, first 8 rows.
+    EXPECT_EQ(uploads[0].args[3], 0);
+    EXPECT_EQ(uploads[0].args[5], 8);
+    const std::vector<uint8_t>& pixels = gl_shim::mapped();
+    ASSERT_EQ(pixels.size(), budget);
+    size_t last = (7 * WIDTH + 5) * 4;
+    EXPECT_EQ(pixels[last], 7);
+    EXPECT_EQ(pixels[last + 1], 5);
+    EXPECT_EQ(pixels[last + 2], 7);
+    EXPECT_EQ(pixels[last + 3], 255);
+}
+
+TEST_F(TextureStreamerTest, ReadyAfterFence) {
+    TextureStreamer::instance()->set_upload_budget(ROW_BYTES * HEIGHT);
+    std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(MakePpm(WIDTH, HEIGHT));
+
+    gl_shim::SetSyncResult(GL_TIMEOUT_EXPIRED);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (gl_shim::Count("glFenceSync") == 0 && std::chrono::steady_clock::now() < deadline) {
+        TextureStreamer::instance()->Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(gl_shim::Count("glFenceSync"), 1u);
+    // gpu still copying.
+    TextureStreamer::instance()->Update();
+    EXPECT_EQ(request->state(), TextureRequest::State_Uploading);
+
+    gl_shim::SetSyncResult(GL_CONDITION_SATISFIED);
+    TextureStreamer::instance()->Update();
+    EXPECT_EQ(request->state(), TextureRequest::State_Ready);
+    EXPECT_EQ(gl_shim::Count("glDeleteSync"), 1u);
+}
+
+TEST_F(TextureStreamerTest, DecodeFailureKeepsEncoded) {
+    std::vector<char> garbage(100, 'x');
+    std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(std::move(garbage));
+    RunFrames(request, TextureStreamer::DEFAULT_UPLOAD_BUDGET);
+    EXPECT_EQ(request->state(), TextureRequest::State_Failed);
+    // caller falls back to another decoder.
+    EXPECT_EQ(request->encoded().size(), 100u);
+    EXPECT_EQ(gl_shim::Count("glTexImage2D"), 0u);
+}
+
+TEST_F(TextureStreamerTest, DroppedRequestNotUploaded) {
+    std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(MakePpm(WIDTH, HEIGHT));
+    request.reset();
+    for (int i = 0; i < 20; i++) {
+        TextureStreamer::instance()->Update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(gl_shim::Count("glTexSubImage2D"), 0u);
+    EXPECT_EQ(TextureStreamer::instance()->uploaded_bytes(), 0u);
+}
+
+TEST_F(TextureStreamerTest, RequestWhileReleased) {
+    // cover loader threads request while the render thread updates and releases on context loss.
+    std::atomic<bool> running(true);
+    std::atomic<int> requested(0);
+    // like Image, requests are released in render thread.
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TextureRequest>> requests;
+    std::vector<std::thread> loaders;
+    for (int i = 0; i < 4; i++) {
+        loaders.emplace_back([&] {
+            while (running) {
+                std::shared_ptr<TextureRequest> request = TextureStreamer::instance()->Request(MakePpm(4, 4));
+                EXPECT_NE(request, nullptr);
+                requested++;
+                std::lock_guard<std::mutex> lock(mutex);
+                requests.push_back(request);
+            }
+        });
+    }
+    for (int i = 0; i < 200; i++) {
+        TextureStreamer::instance()->Update();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.clear();
+        }
+        if (i % 10 == 0) {
+            TextureStreamer::Release();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    running = false;
+    for (auto & loader : loaders) {
+        loader.join();
+    }
+    requests.clear();
+    EXPECT_GT(requested, 0);
+}
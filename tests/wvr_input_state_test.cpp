@@ -0,0 +1,105 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include <gtest/gtest.h>
+#include "wvr_input_state.h"
+#include "wvr_runtime_fake.h"
+
+using wvr::InputDeviceState;
+
+namespace {
+const WVR_DeviceType RIGHT = WVR_DeviceType_Controller_Right;
+const WVR_DeviceType LEFT = WVR_DeviceType_Controller_Left;
+
+uint32_t Mask(std::initializer_list<WVR_InputId> ids) {
+    uint32_t mask = 0;
+    for (auto id : ids) {
+        mask |= 1u << id;
+    }
+    return mask;
+}
+
+wvr_fake::Device MakeController() {
+    wvr_fake::Device device = {};
+    device.buttons = Mask({ WVR_InputId_Alias1_Trigger, WVR_InputId_Alias1_Menu });
+    device.touches = Mask({ WVR_InputId_Alias1_Touchpad, WVR_InputId_Alias1_A });
+    device.analogs = {
+        { WVR_InputId_Alias1_Trigger, WVR_AnalogType_1D, { 1.0F, 0.0F } },
+        { WVR_InputId_Alias1_Touchpad, WVR_AnalogType_2D, { 0.25F, -0.5F } },
+    };
+    return device;
+}
+
+// per button calls the scenes made before, for each controller every frame.
+size_t PerButtonCalls() {
+    return wvr_fake::Count("WVR_GetInputButtonState") + wvr_fake::Count("WVR_GetInputTouchState") +
+           wvr_fake::Count("WVR_GetInputAnalogAxis");
+}
+
+class WvrInputStateTest : public testing::Test {
+protected:
+    void SetUp() override {
+        wvr_fake::Reset();
+    }
+};
+}
+
+TEST_F(WvrInputStateTest, OneDeviceStateCallPerFrame) {
+    wvr_fake::SetDevice(RIGHT, MakeController());
+    wvr_fake::SetDevice(LEFT, MakeController());
+    const int frames = 90;
+    for (int i = 0; i < frames; i++) {
+        for (auto type : { LEFT, RIGHT }) {
+            InputDeviceState state = InputDeviceState::Sample(type);
+            EXPECT_TRUE(state.button(WVR_InputId_Alias1_Trigger));
+        }
+    }
+    EXPECT_EQ(wvr_fake::Count("WVR_GetInputDeviceState"), frames * 2u);
+    EXPECT_EQ(PerButtonCalls(), 0u);
+}
+
+TEST_F(WvrInputStateTest, ButtonsTouchesAndTouchpad) {
+    wvr_fake::SetDevice(RIGHT, MakeController());
+    InputDeviceState state = InputDeviceState::Sample(RIGHT);
+    EXPECT_TRUE(state.button(WVR_InputId_Alias1_Trigger));
+    EXPECT_TRUE(state.button(WVR_InputId_Alias1_Menu));
+    EXPECT_FALSE(state.button(WVR_InputId_Alias1_Touchpad));
+    EXPECT_FALSE(state.button(WVR_InputId_Alias1_Digital_Trigger));
+    EXPECT_TRUE(state.touch(WVR_InputId_Alias1_Touchpad));
+    EXPECT_TRUE(state.touch(WVR_InputId_Alias1_A));
+    EXPECT_FALSE(state.touch(WVR_InputId_Alias1_B));
+    // the touchpad entry, not the first analog.
+    EXPECT_FLOAT_EQ(state.touchpad.x, 0.25F);
+    EXPECT_FLOAT_EQ(state.touchpad.y, -0.5F);
+}
+
+TEST_F(WvrInputStateTest, NoAnalogDevice) {
+    wvr_fake::Device device = MakeController();
+    device.analogs.clear();
+    wvr_fake::SetDevice(RIGHT, device);
+    InputDeviceState state = InputDeviceState::Sample(RIGHT);
+    EXPECT_TRUE(state.button(WVR_InputId_Alias1_Trigger));
+    EXPECT_FLOAT_EQ(state.touchpad.x, 0.0F);
+    EXPECT_EQ(wvr_fake::Count("WVR_GetInputDeviceState"), 1u);
+}
+
+TEST_F(WvrInputStateTest, AnalogFailureKeepsButtons) {
+    wvr_fake::Device device = MakeController();
+    device.failed_types = WVR_InputType_Analog;
+    wvr_fake::SetDevice(RIGHT, device);
+    InputDeviceState state = InputDeviceState::Sample(RIGHT);
+    EXPECT_TRUE(state.button(WVR_InputId_Alias1_Menu));
+    EXPECT_TRUE(state.touch(WVR_InputId_Alias1_A));
+    EXPECT_FLOAT_EQ(state.touchpad.x, 0.0F);
+    // second call without the analog, still no per button calls.
+    EXPECT_EQ(wvr_fake::Count("WVR_GetInputDeviceState"), 2u);
+    EXPECT_EQ(PerButtonCalls(), 0u);
+}
+
+TEST_F(WvrInputStateTest, DisconnectedDeviceEmpty) {
+    InputDeviceState state = InputDeviceState::Sample(RIGHT);
+    EXPECT_EQ(state.buttons, 0u);
+    EXPECT_EQ(state.touches, 0u);
+    EXPECT_EQ(PerButtonCalls(), 0u);
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Created by fcx@pingxingyun.com on 2023/3/19.
+#
+# build the converter and write .pxymesh next to every controller model the apps load.
+# run from anywhere after changing a model, commit the written files with it.
+# fbx models need the converter built with assimp, they are skipped otherwise.
+#
+set -e
+
+tool_dir=$(cd "$(dirname "$0")" && pwd)
+root_dir=$(cd "$tool_dir/../.." && pwd)
+build_dir=${PXYMESH_BUILD_DIR:-$root_dir/build_pxymesh}
+
+cmake -S "$tool_dir" -B "$build_dir" -DCMAKE_BUILD_TYPE=Release > /dev/null
+cmake --build "$build_dir" > /dev/null
+converter=$build_dir/pxymesh_converter
+
+# model paths of ControllerConfig in lib_xr_common_ui controller.h.
+models=$(grep -o '"model/[^"]*"' "$root_dir/lib_xr_common_ui/src/main/cpp/ui/controller.h" | tr -d '"' | sort -u)
+
+for app in "$root_dir"/xr_app_*; do
+    for model in $models; do
+        path=$app/src/main/assets/$model
+        if [ ! -f "$path" ]; then
+            continue
+        fi
+        if ! "$converter" "$path"; then
+            echo "skip $path"
+        fi
+    done
+done
@@ -0,0 +1,196 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// convert a model to .pxymesh next to it, see lib_pxygl mesh_file.h.
+// assimp reads any format when built with it, otherwise .obj is read with tinyobj.
+// both give the meshes Model builds with assimp at runtime.
+//
+// usage: pxymesh_converter model.obj [max_position_error]
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef ENABLE_ASSIMP
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#else
+#include "tiny_obj_loader.h"
+#endif
+#include "mesh_file.h"
+
+namespace {
+    using lark::MeshFile;
+
+    void SetDiffuseTexture(const std::string& fileName, MeshFile::SourceMesh* mesh) {
+        mesh->diffuse_texture = fileName;
+        if (mesh->diffuse_texture.size() >= MeshFile::TEXTURE_NAME_SIZE) {
+            fprintf(stderr, "texture name too long, dropped: %s\n", fileName.c_str());
+            mesh->diffuse_texture.clear();
+        }
+    }
+
+#ifndef ENABLE_ASSIMP
+    // missing .mtl files only warn, like assimp. tinyobj stops loading otherwise.
+    class MaterialReader: public tinyobj::MaterialReader {
+    public:
+        explicit MaterialReader(std::string dir): dir_(std::move(dir)) {}
+
+        std::string operator()(const std::string& matId, std::vector<tinyobj::material_t>& materials,
+                               std::map<std::string, int>& matMap) override {
+            std::ifstream file(dir_ + matId);
+            if (!file) {
+                fprintf(stderr, "material %s%s not found\n", dir_.c_str(), matId.c_str());
+                return "";
+            }
+            return tinyobj::LoadMtl(matMap, materials, file);
+        }
+    private:
+        std::string dir_;
+    };
+
+    // one mesh per shape. uv flipped like aiProcess_FlipUVs.
+    bool LoadObj(const std::string& input, std::vector<MeshFile::SourceMesh>* meshes) {
+        std::ifstream file(input);
+        if (!file) {
+            return false;
+        }
+        size_t slash = input.find_last_of('/');
+        MaterialReader materialReader(slash == std::string::npos ? "" : input.substr(0, slash + 1));
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string err = tinyobj::LoadObj(shapes, materials, file, materialReader);
+        if (!err.empty()) {
+            fprintf(stderr, "tinyobj: %s\n", err.c_str());
+        }
+        if (shapes.empty()) {
+            return false;
+        }
+        for (const auto & shape : shapes) {
+            const tinyobj::mesh_t& src = shape.mesh;
+            MeshFile::SourceMesh res;
+            for (size_t i = 0; i + 2 < src.positions.size(); i += 3) {
+                res.positions.emplace_back(src.positions[i], src.positions[i + 1], src.positions[i + 2]);
+            }
+            for (size_t i = 0; i + 2 < src.normals.size(); i += 3) {
+                res.normals.emplace_back(src.normals[i], src.normals[i + 1], src.normals[i + 2]);
+            }
+            for (size_t i = 0; i + 1 < src.texcoords.size(); i += 2) {
+                res.texcoords.emplace_back(src.texcoords[i], 1.0F - src.texcoords[i + 1]);
+            }
+            res.indices.assign(src.indices.begin(), src.indices.end());
+            if (!src.material_ids.empty() && src.material_ids[0] >= 0 &&
+                static_cast<size_t>(src.material_ids[0]) < materials.size()) {
+                SetDiffuseTexture(materials[src.material_ids[0]].diffuse_texname, &res);
+            }
+            meshes->push_back(res);
+        }
+        return true;
+    }
+#else
+    MeshFile::SourceMesh ProcessMesh(const aiMesh* mesh, const aiScene* scene) {
+        MeshFile::SourceMesh res;
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+            const aiVector3D& p = mesh->mVertices[i];
+            res.positions.emplace_back(p.x, p.y, p.z);
+            if (mesh->mNormals) {
+                const aiVector3D& n = mesh->mNormals[i];
+                res.normals.emplace_back(n.x, n.y, n.z);
+            }
+            if (mesh->mTextureCoords[0]) {
+                const aiVector3D& uv = mesh->mTextureCoords[0][i];
+                res.texcoords.emplace_back(uv.x, uv.y);
+            }
+        }
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+            const aiFace& face = mesh->mFaces[i];
+            for (unsigned int j = 0; j < face.mNumIndices; j++) {
+                res.indices.push_back(face.mIndices[j]);
+            }
+        }
+        // same as Model::ProcessMesh, first diffuse texture only.
+        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+            aiString fileName;
+            material->GetTexture(aiTextureType_DIFFUSE, 0, &fileName);
+            SetDiffuseTexture(fileName.C_Str(), &res);
+        }
+        return res;
+    }
+
+    // same order as Model::ProcessNode.
+    void ProcessNode(const aiNode* node, const aiScene* scene, std::vector<MeshFile::SourceMesh>* meshes) {
+        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+            meshes->push_back(ProcessMesh(scene->mMeshes[node->mMeshes[i]], scene));
+        }
+        for (unsigned int i = 0; i < node->mNumChildren; i++) {
+            ProcessNode(node->mChildren[i], scene, meshes);
+        }
+    }
+
+    bool LoadAssimp(const std::string& input, std::vector<MeshFile::SourceMesh>* meshes) {
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(input,
+                aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            fprintf(stderr, "assimp: %s\n", importer.GetErrorString());
+            return false;
+        }
+        ProcessNode(scene->mRootNode, scene, meshes);
+        return true;
+    }
+#endif
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s model [max_position_error]\n", argv[0]);
+        return 1;
+    }
+    std::string input = argv[1];
+    float maxPositionError = argc > 2 ? strtof(argv[2], nullptr) : MeshFile::DEFAULT_MAX_POSITION_ERROR;
+
+    std::vector<MeshFile::SourceMesh> meshes;
+#ifdef ENABLE_ASSIMP
+    bool loaded = LoadAssimp(input, &meshes);
+#else
+    bool isObj = input.size() > 4 && input.compare(input.size() - 4, 4, ".obj") == 0;
+    if (!isObj) {
+        fprintf(stderr, "%s: built without assimp, only .obj supported\n", input.c_str());
+        return 1;
+    }
+    bool loaded = LoadObj(input, &meshes);
+#endif
+    if (!loaded) {
+        fprintf(stderr, "load %s failed\n", input.c_str());
+        return 1;
+    }
+
+    std::string output = MeshFile::GetMeshPath(input);
+    if (!MeshFile::Write(output, meshes, maxPositionError)) {
+        fprintf(stderr, "write %s failed\n", output.c_str());
+        return 1;
+    }
+
+    // MeshVertex is 56 bytes with assimp, indices 4 bytes.
+    size_t before = 0;
+    size_t after = sizeof(MeshFile::FileHeader);
+    std::vector<uint8_t> block;
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const MeshFile::SourceMesh& mesh = meshes[i];
+        before += mesh.positions.size() * 56 + mesh.indices.size() * 4;
+        MeshFile::Pack(mesh, maxPositionError, &block);
+        after += block.size();
+        const MeshFile::MeshHeader* header = reinterpret_cast<const MeshFile::MeshHeader*>(block.data());
+        printf("mesh %zu: vertices %u indices %u position %s index %u bytes texture %s\n",
+               i, header->vertex_count, header->index_count,
+               header->position_format == MeshFile::PositionFormat_Half ? "half" : "float",
+               header->index_size, header->diffuse_texture);
+    }
+    printf("%s: %zu bytes, gpu data before %zu bytes\n", output.c_str(), after, before);
+    return 0;
+}
@@ -0,0 +1,263 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+// convert a skybox cross image to .pxysky next to it, see lib_pxygl skybox_file.h.
+// faces split like Texture::SetupSkyboxTexture, mips box filtered down to 1x1,
+// every level encoded to GL_COMPRESSED_RGB8_ETC2.
+//
+// usage: pxysky_converter skybox.jpg
+//
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "skybox_file.h"
+
+namespace {
+    using lark::SkyboxFile;
+
+    const uint32_t GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+
+    // rgb pixels of one face level.
+    struct Image {
+        int size;
+        std::vector<uint8_t> rgb;
+    };
+
+    Image Downsample(const Image& src) {
+        Image res;
+        res.size = std::max(src.size / 2, 1);
+        res.rgb.resize(res.size * res.size * 3);
+        for (int y = 0; y < res.size; y++) {
+            for (int x = 0; x < res.size; x++) {
+                for (int c = 0; c < 3; c++) {
+                    int sum = 0;
+                    for (int i = 0; i < 4; i++) {
+                        int sx = std::min(x * 2 + i % 2, src.size - 1);
+                        int sy = std::min(y * 2 + i / 2, src.size - 1);
+                        sum += src.rgb[(sy * src.size + sx) * 3 + c];
+                    }
+                    res.rgb[(y * res.size + x) * 3 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return res;
+    }
+
+    //
+    // etc1 blocks, individual and differential modes only.
+    // base + delta kept inside 0..31 so the blocks decode the same as etc2.
+    //
+    const int ETC_MODIFIERS[8][2] = {
+            {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183},
+    };
+
+    int Clamp255(int value) {
+        return std::min(std::max(value, 0), 255);
+    }
+
+    // best table and pixel indices of one sub block. return error.
+    int FitSubBlock(const uint8_t pixels[16][3], const int* members, const int base[3], int* table, int indices[16]) {
+        int bestError = INT_MAX;
+        for (int t = 0; t < 8; t++) {
+            const int modifiers[4] = {
+                    ETC_MODIFIERS[t][0], ETC_MODIFIERS[t][1], -ETC_MODIFIERS[t][0], -ETC_MODIFIERS[t][1],
+            };
+            int error = 0;
+            int pick[16] = {};
+            for (int i = 0; i < 8; i++) {
+                const uint8_t* p = pixels[members[i]];
+                int bestPixel = INT_MAX;
+                for (int m = 0; m < 4; m++) {
+                    int e = 0;
+                    for (int c = 0; c < 3; c++) {
+                        int d = Clamp255(base[c] + modifiers[m]) - p[c];
+                        e += d * d;
+                    }
+                    if (e < bestPixel) {
+                        bestPixel = e;
+                        pick[members[i]] = m;
+                    }
+                }
+                error += bestPixel;
+            }
+            if (error < bestError) {
+                bestError = error;
+                *table = t;
+                for (int i = 0; i < 8; i++) {
+                    indices[members[i]] = pick[members[i]];
+                }
+            }
+        }
+        return bestError;
+    }
+
+    uint64_t EncodeBlock(const uint8_t pixels[16][3], int64_t* blockError) {
+        uint64_t best = 0;
+        int bestError = INT_MAX;
+        for (int flip = 0; flip < 2; flip++) {
+            // pixel index is x * 4 + y.
+            int members[2][8];
+            int count[2] = {};
+            int average[2][3] = {};
+            for (int i = 0; i < 16; i++) {
+                int x = i / 4;
+                int y = i % 4;
+                int sub = flip ? (y >= 2) : (x >= 2);
+                members[sub][count[sub]++] = i;
+                for (int c = 0; c < 3; c++) {
+                    average[sub][c] += pixels[i][c];
+                }
+            }
+            int color5[2][3];
+            bool differential = true;
+            for (int c = 0; c < 3; c++) {
+                for (int s = 0; s < 2; s++) {
+                    color5[s][c] = std::min((average[s][c] / 8 * 31 + 127) / 255, 31);
+                }
+                int delta = color5[1][c] - color5[0][c];
+                differential = differential && delta >= -4 && delta <= 3;
+            }
+            int base[2][3];
+            uint64_t block = 0;
+            for (int c = 0; c < 3; c++) {
+                int shift = 59 - c * 8;
+                if (differential) {
+                    base[0][c] = color5[0][c] << 3 | color5[0][c] >> 2;
+                    base[1][c] = color5[1][c] << 3 | color5[1][c] >> 2;
+                    block |= static_cast<uint64_t>(color5[0][c]) << shift;
+                    block |= static_cast<uint64_t>((color5[1][c] - color5[0][c]) & 7) << (shift - 3);
+                } else {
+                    for (int s = 0; s < 2; s++) {
+                        int color4 = std::min((average[s][c] / 8 * 15 + 127) / 255, 15);
+                        base[s][c] = color4 << 4 | color4;
+                        block |= static_cast<uint64_t>(color4) << (shift + 1 - s * 4);
+                    }
+                }
+            }
+            int tables[2];
+            int indices[16] = {};
+            int error = FitSubBlock(pixels, members[0], base[0], &tables[0], indices) +
+                        FitSubBlock(pixels, members[1], base[1], &tables[1], indices);
+            if (error >= bestError) {
+                continue;
+            }
+            block |= static_cast<uint64_t>(tables[0]) << 37;
+            block |= static_cast<uint64_t>(tables[1]) << 34;
+            block |= static_cast<uint64_t>(differential) << 33;
+            block |= static_cast<uint64_t>(flip) << 32;
+            // modifier 0..3 -> +a, +b, -a, -b stored as msb:lsb 00, 01, 10, 11.
+            for (int i = 0; i < 16; i++) {
+                block |= static_cast<uint64_t>(indices[i] >> 1) << (16 + i);
+                block |= static_cast<uint64_t>(indices[i] & 1) << i;
+            }
+            best = block;
+            bestError = error;
+        }
+        *blockError += bestError;
+        return best;
+    }
+
+    std::vector<uint8_t> EncodeEtc2(const Image& image, int64_t* error) {
+        int blocks = (image.size + 3) / 4;
+        std::vector<uint8_t> res;
+        res.reserve(blocks * blocks * 8);
+        for (int by = 0; by < blocks; by++) {
+            for (int bx = 0; bx < blocks; bx++) {
+                uint8_t pixels[16][3];
+                for (int i = 0; i < 16; i++) {
+                    // repeat the edge of small levels.
+                    int x = std::min(bx * 4 + i / 4, image.size - 1);
+                    int y = std::min(by * 4 + i % 4, image.size - 1);
+                    for (int c = 0; c < 3; c++) {
+                        pixels[i][c] = image.rgb[(y * image.size + x) * 3 + c];
+                    }
+                }
+                uint64_t block = EncodeBlock(pixels, error);
+                // big endian.
+                for (int i = 7; i >= 0; i--) {
+                    res.push_back(static_cast<uint8_t>(block >> (i * 8)));
+                }
+            }
+        }
+        return res;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s skybox.jpg\n", argv[0]);
+        return 1;
+    }
+    std::string input = argv[1];
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    uint8_t* bitmap = stbi_load(input.c_str(), &width, &height, &channels, 3);
+    if (bitmap == nullptr) {
+        fprintf(stderr, "load %s failed: %s\n", input.c_str(), stbi_failure_reason());
+        return 1;
+    }
+    int faceSize = width / 4;
+    if (faceSize == 0 || faceSize * 4 != width || faceSize * 3 != height) {
+        fprintf(stderr, "%s %dx%d is not a 4x3 skybox cross\n", input.c_str(), width, height);
+        stbi_image_free(bitmap);
+        return 1;
+    }
+
+    // same cells as Texture::SetupSkyboxTexture.
+    const int index[SkyboxFile::FACE_COUNT] = {6, 4, 1, 9, 5, 7};
+    std::vector<SkyboxFile::LevelData> levels;
+    int64_t error = 0;
+    size_t pixels = 0;
+    Image faces[SkyboxFile::FACE_COUNT];
+    for (int i = 0; i < SkyboxFile::FACE_COUNT; i++) {
+        faces[i].size = faceSize;
+        faces[i].rgb.resize(faceSize * faceSize * 3);
+        int x = faceSize * (index[i] % 4);
+        int y = faceSize * (index[i] / 4);
+        for (int row = 0; row < faceSize; row++) {
+            const uint8_t* src = bitmap + ((y + row) * width + x) * 3;
+            std::copy(src, src + faceSize * 3, faces[i].rgb.begin() + row * faceSize * 3);
+        }
+    }
+    stbi_image_free(bitmap);
+
+    for (int size = faceSize;; size /= 2) {
+        SkyboxFile::LevelData level;
+        for (int i = 0; i < SkyboxFile::FACE_COUNT; i++) {
+            level[i] = EncodeEtc2(faces[i], &error);
+            pixels += faces[i].size * faces[i].size;
+            faces[i] = Downsample(faces[i]);
+        }
+        levels.push_back(level);
+        if (size == 1) {
+            break;
+        }
+    }
+
+    std::string output = SkyboxFile::GetSkyboxPath(input);
+    if (!SkyboxFile::Write(output, GL_COMPRESSED_RGB8_ETC2, faceSize, levels)) {
+        fprintf(stderr, "write %s failed\n", output.c_str());
+        return 1;
+    }
+
+    // runtime path uploads GL_RGB5_A1 and generates mips, 2 bytes a pixel.
+    size_t before = pixels * 2;
+    size_t after = sizeof(SkyboxFile::FileHeader);
+    for (const auto & level : levels) {
+        for (const auto & face : level) {
+            after += sizeof(uint32_t) + ((face.size() + 3) & ~static_cast<size_t>(3));
+        }
+    }
+    printf("%s: face %d levels %zu, %zu bytes, gpu data before %zu bytes, rms error %.2f\n",
+           output.c_str(), faceSize, levels.size(), after, before,
+           std::sqrt(static_cast<double>(error) / (pixels * 3)));
+    return 0;
+}
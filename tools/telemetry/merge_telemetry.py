@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+#
+# Created by fcx@pingxingyun.com on 2023/3/14.
+#
+# merge telemetry json files exported by lib_xr_common_ui telemetry.cpp and
+# print percentiles of each metric.
+#
+# usage: merge_telemetry.py telemetry_*.json
+#
+import json
+import sys
+
+# same as LatencyHistogram in telemetry.h
+SUB_BUCKETS = 16
+
+
+def from_index(index):
+    if index < SUB_BUCKETS:
+        return index
+    shift = index // SUB_BUCKETS - 1
+    sub = index % SUB_BUCKETS
+    return ((SUB_BUCKETS + sub) << shift) + ((1 << shift) >> 1)
+
+
+def percentile(buckets, total, maximum, p):
+    if total == 0:
+        return 0
+    rank = max(1, int(p / 100.0 * total + 0.5))
+    seen = 0
+    for index in sorted(buckets):
+        seen += buckets[index]
+        if seen >= rank:
+            return min(from_index(index), maximum)
+    return maximum
+
+
+def main(files):
+    metrics = {}
+    for name in files:
+        with open(name) as f:
+            data = json.load(f)
+        if data.get("version") != 1:
+            print("skip %s unknown version" % name, file=sys.stderr)
+            continue
+        for metric, histogram in data["metrics"].items():
+            merged = metrics.setdefault(metric, {"count": 0, "max": 0, "buckets": {}})
+            merged["count"] += histogram["count"]
+            merged["max"] = max(merged["max"], histogram["max"])
+            for index, count in histogram["buckets"]:
+                merged["buckets"][index] = merged["buckets"].get(index, 0) + count
+
+    print("%-28s %10s %10s %10s %10s %10s" % ("metric", "count", "p50", "p95", "p99", "max"))
+    for metric in sorted(metrics):
+        merged = metrics[metric]
+        total = sum(merged["buckets"].values())
+        print("%-28s %10d %10d %10d %10d %10d" % (
+            metric, merged["count"],
+            percentile(merged["buckets"], total, merged["max"], 50),
+            percentile(merged["buckets"], total, merged["max"], 95),
+            percentile(merged["buckets"], total, merged["max"], 99),
+            merged["max"]))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: %s telemetry_*.json" % sys.argv[0])
+        sys.exit(1)
+    main(sys.argv[1:])
@@ -14,6 +14,8 @@
 #include <lark_xr/xr_config.h>
 #include <asset_loader.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
 #include <unistd.h>
 #include <utils.h>
 #include <wvr/wvr_system.h>
@@ -45,6 +47,8 @@ bool WaveApplication::s_is_vive_flow() {
 
 WaveApplication::WaveApplication() {
     RegiseredInstance(this);
+    // wave runtime predicted 25ms before.
+    prediction_horizon_.set_default_horizon_ns(25 * 1000 * 1000);
 }
 WaveApplication::~WaveApplication() {
     UnRegiseredInstance();
@@ -205,7 +209,8 @@ bool WaveApplication::InitGL() {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&context, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&context, Assetlist);
 
     left_eye_q_ = WVR_ObtainTextureQueue(WVR_TextureTarget_2D, WVR_TextureFormat_RGBA, WVR_TextureType_UnsignedByte, render_width_, render_height_, 0);
     for (int i = 0; i < WVR_GetTextureQueueLength(left_eye_q_); i++) {
@@ -285,6 +290,7 @@ void WaveApplication::InitJava() {
 
 void WaveApplication::ShutdownVR() {
     connected_ = false;
+    pose_sampler_.Stop();
 
     if (recording_stream_) {
         recording_stream_->close();
@@ -325,7 +331,10 @@ void WaveApplication::ShutdownGL() {
         }
         WVR_ReleaseTextureQueue(right_eye_q_);
     }
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
 }
 
 bool WaveApplication::OnUpdate() {
@@ -348,6 +357,11 @@ bool WaveApplication::OnUpdate() {
         check_timestamp_ = now;
     }
 
+    // finish async asset loads within the frame budget.
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
+
 #ifdef ENABLE_CLOUDXR
     if (need_recreat_cloudxr_client_) {
         cloudxr_client_->Init();
@@ -389,16 +403,11 @@ bool WaveApplication::OnUpdate() {
         larkxrTrackingFrame trackingFrame = {};
         {
             uint64_t frameIndex = latched.poseID;
-            std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-            auto it = tracking_frame_map_.find(frameIndex);
-            if (it != tracking_frame_map_.end()) {
-                trackingFrame = it->second;
-            } else {
-                if (!tracking_frame_map_.empty()) {
-                    LOGW("cant find new tracking frame in map. use old. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
-                    trackingFrame = tracking_frame_map_.cbegin()->second;
+            if (!pose_history_.Find(frameIndex, &trackingFrame)) {
+                if (pose_history_.Latest(&trackingFrame)) {
+                    LOGW("cant find tracking frame in history. use latest %ld; index %ld", trackingFrame.frameIndex, frameIndex);
                 } else {
-                    LOGW("cant find tracking frame in map. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
+                    LOGW("cant find tracking frame in history. count %ld; index %ld", pose_history_.count(), frameIndex);
                     return false;
                 }
             }
@@ -418,27 +427,30 @@ bool WaveApplication::OnUpdate() {
 #ifdef USE_RENDER_QUEUE
         larkxrTrackingFrame trackingFrame;
         lark::XRVideoFrame xrVideoFrame(0);
+        // block until new cloud frame or the deadline before next vsync.
+        if (xr_client_->media_ready()) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
+        }
         if (!xr_client_->Render(&trackingFrame, &xrVideoFrame)) {
             if (!xr_client_->media_ready()) {
                 scene_cloud_->Update();
             } else {
                 scene_cloud_->HandleInput();
-                usleep(1000);
             }
         } else {
             scene_cloud_->HandleInput();
             scene_cloud_->Render(trackingFrame, xrVideoFrame);
             xr_client_->ReleaseRenderTexture();
+            frame_pacer_.FrameEnd();
         }
 #else
         if (xr_client_->media_ready()) {
             scene_cloud_->HandleInput();
-            if (xr_client_->HasNewFrame()) {
+            if (frame_pacer_.WaitForFrame(xr_client_.get())) {
                 larkxrTrackingFrame trackingFrame{};
                 xr_client_->Render(&trackingFrame);
                 scene_cloud_->Render(trackingFrame);
-            } else {
-                usleep(1000);
+                frame_pacer_.FrameEnd();
             }
         } else {
             scene_cloud_->Update();
@@ -468,6 +480,7 @@ void WaveApplication::OnConnected() {
     LOGI("==========OnConnected============");
     connected_ = true;
     scene_cloud_->OnConnect();
+    pose_sampler_.Start(this);
 }
 
 void WaveApplication::OnError(int errCode, const char* msg) {
@@ -486,6 +499,7 @@ void WaveApplication::OnError(int errCode, const char* msg) {
         scene_local_->HomePage();
     } else {
         connected_ = false;
+        pose_sampler_.Stop();
         scene_cloud_->OnClose();
         scene_local_->HomePage();
     }
@@ -504,6 +518,7 @@ void WaveApplication::OnClose(int code) {
 #endif
 
     connected_ = false;
+    pose_sampler_.Stop();
     scene_cloud_->OnClose();
     scene_local_->HomePage();
 }
@@ -543,12 +558,24 @@ void WaveApplication::OnMediaReady() {
 
 void WaveApplication::RequestTrackingInfo() {
     Application::RequestTrackingInfo();
+    // sent by pose sampler.
+    if (pose_sampler_.running()) {
+        return;
+    }
     // send device pair
     larkxrTrackingDevicePairFrame devicePairFrame;
     scene_cloud_->UpdateAsync(&devicePairFrame);
     xr_client_->SendDevicePair(devicePairFrame);
 }
 
+bool WaveApplication::SamplePose(larkxrTrackingDevicePairFrame *devicePairFrame) {
+    return scene_cloud_->SamplePose(devicePairFrame);
+}
+
+void WaveApplication::SendPose(const larkxrTrackingDevicePairFrame &devicePairFrame) {
+    xr_client_->SendDevicePair(devicePairFrame);
+}
+
 void
 WaveApplication::OnHapticsFeedback(bool isLeft, uint64_t startTime, float amplitude, float duration,
                                    float frequency) {
@@ -630,13 +657,7 @@ void WaveApplication::GetTrackingState(cxrVRTrackingState *state) {
         frame.fetchTime = devicePairFrame.fetchTime;
         frame.displayTime = devicePairFrame.displayTime;
         frame.tracking = devicePairFrame.devicePair.hmdPose;
-        // unique_ptr
-        std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-        tracking_frame_map_.insert(
-                std::pair<uint64_t, larkxrTrackingFrame>(frame.frameIndex, frame));
-        if (tracking_frame_map_.size() > MAXIMUM_TRACKING_FRAMES) {
-            tracking_frame_map_.erase(tracking_frame_map_.cbegin());
-        }
+        pose_history_.Push(frame);
     }
 
     *state = CloudXRClient::VRTrackingStateFrom(devicePairFrame);
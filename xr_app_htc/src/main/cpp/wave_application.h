@@ -6,13 +6,15 @@
 #define CLOUDLARKXR_WAVE_APPLICATION_H
 
 #include "application.h"
+#include "pose_sampler.h"
 #include "wvr_scene_local.h"
 #include "wvr_scene_cloud.h"
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
+#include <pose_history.h>
 #endif
 
-class WaveApplication: public Application
+class WaveApplication: public Application, public PoseSampler::Source
 #ifdef ENABLE_CLOUDXR
         ,public CloudXRClientObserver
 #endif
@@ -58,6 +60,9 @@ public:
     virtual void OnTrackingFrame(const larkxrTrackingFrame& trackingFrame) override {};
     //
     virtual void RequestTrackingInfo() override;
+    // pose sampler thread.
+    virtual bool SamplePose(larkxrTrackingDevicePairFrame* devicePairFrame) override;
+    virtual void SendPose(const larkxrTrackingDevicePairFrame& devicePairFrame) override;
     virtual void OnHapticsFeedback(bool isLeft, uint64_t startTime, float amplitude, float duration, float frequency) override;
 
 #ifdef ENABLE_CLOUDXR
@@ -84,11 +89,12 @@ private:
     std::vector<WvrFrameBuffer*> left_eye_fbo_{};
     std::vector<WvrFrameBuffer*> right_eye_fbo_{};
 
+    // send pose at its own rate while connected instead of in RequestTrackingInfo.
+    PoseSampler pose_sampler_{};
+
 #ifdef ENABLE_CLOUDXR
-    static const int MAXIMUM_TRACKING_FRAMES = 50;
-    typedef std::map<uint64_t, larkxrTrackingFrame> TRACKING_FRAME_MAP;
-    TRACKING_FRAME_MAP tracking_frame_map_{};
-    std::mutex tracking_frame_mutex_{};
+    // pushed by cloudxr tracking thread, read by render thread when frame latched.
+    PoseHistory pose_history_{};
 
     uint64_t pre_controller_state[2] = {};
     std::shared_ptr<CloudXRClient> cloudxr_client_ = nullptr;
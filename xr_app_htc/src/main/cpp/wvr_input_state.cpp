@@ -0,0 +1,38 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "wvr_input_state.h"
+
+namespace wvr {
+InputDeviceState InputDeviceState::Sample(WVR_DeviceType type) {
+    InputDeviceState state = {};
+    WVR_AnalogState_t analog[WVR_InputId_Max] = {};
+    int32_t analogCount = WVR_GetInputTypeCount(type, WVR_InputType_Analog);
+    uint32_t inputType = WVR_InputType_Button | WVR_InputType_Touch;
+    if (analogCount > 0) {
+        inputType |= WVR_InputType_Analog;
+        analogCount = analogCount < WVR_InputId_Max ? analogCount : WVR_InputId_Max;
+    } else {
+        analogCount = 0;
+    }
+    if (!WVR_GetInputDeviceState(type, inputType, &state.buttons, &state.touches,
+                                 analog, static_cast<uint32_t>(analogCount))) {
+        // the call fails as a whole when one input type fails, keep the buttons without the axis.
+        state = {};
+        if (analogCount == 0 ||
+            !WVR_GetInputDeviceState(type, WVR_InputType_Button | WVR_InputType_Touch,
+                                     &state.buttons, &state.touches, nullptr, 0)) {
+            return {};
+        }
+        return state;
+    }
+    for (int32_t i = 0; i < analogCount; i++) {
+        if (analog[i].id == WVR_InputId_Alias1_Touchpad) {
+            state.touchpad = analog[i].axis;
+            break;
+        }
+    }
+    return state;
+}
+}
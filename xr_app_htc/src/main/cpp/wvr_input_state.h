@@ -0,0 +1,29 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef CLOUDLARKXR_WVR_INPUT_STATE_H
+#define CLOUDLARKXR_WVR_INPUT_STATE_H
+
+#include <cstdint>
+#include <wvr/wvr_types.h>
+#include <wvr/wvr_device.h>
+
+namespace wvr {
+// buttons, touches and touchpad axis of one device, sampled with a single WVR_GetInputDeviceState call
+// instead of one WVR_GetInputButtonState/WVR_GetInputTouchState call per button.
+struct InputDeviceState {
+    // bit (1 << WVR_InputId) set when the button is pressed / touched.
+    uint32_t buttons;
+    uint32_t touches;
+    WVR_Axis_t touchpad;
+
+    inline bool button(WVR_InputId id) const { return (buttons & (1u << id)) != 0; }
+    inline bool touch(WVR_InputId id) const { return (touches & (1u << id)) != 0; }
+
+    // call once per device every frame. state is empty when the runtime has no input for the device.
+    static InputDeviceState Sample(WVR_DeviceType type);
+};
+}
+
+#endif //CLOUDLARKXR_WVR_INPUT_STATE_H
@@ -10,6 +10,7 @@
 #include <ui/component/base.h>
 #include "wvr_scene.h"
 #include "wvr_utils.h"
+#include "render_state.h"
 
 static void dumpMatrix(const char * name, const glm::mat4& mat) {
     LOGV("%s =\n"
@@ -170,6 +171,8 @@ void WvrScene::RenderScene(WVR_Eye nEye) {
         project = &projection_right_;
         eyeView = eye_pos_right_ * hmd_pose_;
     }
+    // state set without the cache and by the runtime.
+    lark::RenderState::instance()->Invalidate();
     for(auto it = objects_.begin(); it != objects_.end(); it ++) {
         if (it->get()->active()) {
             it->get()->Draw(objEye, *project, eyeView);
@@ -9,8 +9,10 @@
 #include <lark_xr/app_list_task.h>
 #include "wvr_scene_cloud.h"
 #include "wvr_utils.h"
+#include "wvr_input_state.h"
 #include "utils.h"
 #include "wave_application.h"
+#include "render_state.h"
 
 #define LOG_TAG "wvr_scene_cloud"
 
@@ -57,6 +59,13 @@ bool WvrSceneCloud::InitGL(void* left_eye_queue, void* right_eye_qeue,
     WvrScene::AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
 
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+
     return WvrScene::InitGL(left_eye_queue, right_eye_qeue, left_eye_fbo, right_eye_fbo);
 }
 
@@ -69,16 +78,78 @@ void WvrSceneCloud::Update() {
 }
 
 void WvrSceneCloud::UpdateAsync(larkxrTrackingDevicePairFrame *devicePairFrame) {
-    devicePairFrame->displayTime = 0;
-    devicePairFrame->frameIndex = frame_index_;
-    devicePairFrame->fetchTime = utils::GetTimestampUs();
+    std::lock_guard<std::mutex> lock(tracking_mutex_);
+    BeginTracking(devicePairFrame);
 
     // 姿态预测头部 pose.
 //    WVR_PoseState_t poseState{};
 //    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnGround, 0, &poseState);
 //    device_pair_.hmdPose = wvr::wToLarkHMDTrakedPose(poseState);
 
-    devicePairFrame->devicePair = device_pair_;
+    tracking_pair_.Acquire();
+    devicePairFrame->devicePair = tracking_pair_.front();
+}
+
+bool WvrSceneCloud::SamplePose(larkxrTrackingDevicePairFrame *devicePairFrame) {
+    std::lock_guard<std::mutex> lock(tracking_mutex_);
+    tracking_pair_.Acquire();
+    larkxrDevicePair devicePair = tracking_pair_.front();
+
+    uint32_t horizonMs = static_cast<uint32_t>(Application::instance()->prediction_horizon().horizon_ms());
+    WVR_PoseState_t poseState{};
+    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnGround, horizonMs, &poseState);
+    if (!poseState.isValidPose) {
+        return false;
+    }
+    devicePair.hmdPose = wvr::wToLarkHMDTrakedPose(poseState);
+
+    for (int i = 0; i < 2; i++) {
+        larkxrControllerDeviceState* controllerDeviceState = &devicePair.controllerState[i];
+        // keep the controllers HandleInput skipped or disconnected.
+        if (!controllerDeviceState->pose.isValidPose) {
+            continue;
+        }
+        bool isLeft = i == 0;
+        WVR_GetPoseState(isLeft ? WVR_DeviceType_Controller_Left : WVR_DeviceType_Controller_Right,
+                         WVR_PoseOriginModel_OriginOnGround, horizonMs, &poseState);
+        if (!poseState.isValidPose) {
+            continue;
+        }
+        // menu view disconnects the controllers from the cloud app.
+        bool isConnected = controllerDeviceState->pose.isConnected;
+        SetControllerPose(isLeft, poseState, controllerDeviceState);
+        controllerDeviceState->pose.isConnected = isConnected;
+    }
+
+    BeginTracking(devicePairFrame);
+    devicePairFrame->devicePair = devicePair;
+    return true;
+}
+
+void WvrSceneCloud::BeginTracking(larkxrTrackingDevicePairFrame *devicePairFrame) {
+    uint64_t frameIndex = frame_index_.load();
+    devicePairFrame->displayTime = 0;
+    devicePairFrame->frameIndex = frameIndex;
+    devicePairFrame->fetchTime = utils::GetTimestampUs();
+    Application::instance()->prediction_horizon().OnTracking(frameIndex);
+}
+
+void WvrSceneCloud::SetControllerPose(bool isLeft, const WVR_PoseState_t &poseState,
+                                      larkxrControllerDeviceState *state) {
+    state->pose = wvr::wToLarkControllerTrackedPose(isLeft, poseState);
+    // htc focus plus 设置旋转
+    larkxrSystemInfo info = lark::XRClient::system_info();
+    if (state->pose.is6Dof) {
+        // 3.1.8.0 remove rotate
+        // remove rotate
+//            state->rotateDeg = glm::half_pi<float>() / 3.0F;
+//            state->rotateAxis = glm::vec3(1, 0, 0);
+    } else if (info.platFromType == Larkxr_Platform_PICO_NEO || info.platFromType == Larkxr_Platform_PICO_G2_4k) {
+        state->pose.velocity = glm::vec3(0,0,0);
+        state->pose.angularVelocity = glm::vec3(0,0,0);
+        state->pose.angularAcceleration = glm::vec3(0,0,0);
+        state->pose.acceleration = glm::vec3(0,0,0);
+    }
 }
 
 bool WvrSceneCloud::Render() {
@@ -129,6 +200,8 @@ bool WvrSceneCloud::Render(const larkxrTrackingFrame &trackingFrame) {
     glClearColor(0.30f, 0.30f, 0.37f, 1.0f); // nice background color, but not black
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // state set without the cache and by the runtime.
+    lark::RenderState::instance()->Invalidate();
     for(auto it = objects_.begin(); it != objects_.end(); it ++) {
         if (it->get()->active()) {
             it->get()->Draw(lark::Object::EYE_LEFT, projection_left_, eye_pos_left_ * hmd_pose_);
@@ -145,6 +218,8 @@ bool WvrSceneCloud::Render(const larkxrTrackingFrame &trackingFrame) {
     glClearColor(0.30f, 0.30f, 0.37f, 1.0f); // nice background color, but not black
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // state set without the cache and by the runtime.
+    lark::RenderState::instance()->Invalidate();
     for(auto it = objects_.begin(); it != objects_.end(); it ++) {
         if (it->get()->active()) {
             it->get()->Draw(lark::Object::EYE_RIGHT, projection_right_, eye_pos_right_ * hmd_pose_);
@@ -158,6 +233,8 @@ bool WvrSceneCloud::Render(const larkxrTrackingFrame &trackingFrame) {
     glm::vec3 trackingAng = glm::eulerAngles(hmdPose.rotation.toGlm());
     float degree = glm::degrees(renderAng.y - trackingAng.y);
     lark::XRLatencyCollector::Instance().Submit(trackingFrame.frameIndex, degree);
+    Application::instance()->prediction_horizon().OnSubmit(trackingFrame.frameIndex,
+                                                           Application::instance()->frame_pacer().ready_ns());
 
     WVR_PoseState_t poseState = wvr::fromLarkvrTrackedPose(trackingFrame.tracking);
 
@@ -193,7 +270,8 @@ bool WvrSceneCloud::HandleInput() {
     // 姿态预测头部 pose.
     WVR_PoseState_t poseState{};
 //    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnHead, 25, &poseState);
-    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnGround, 25, &poseState);
+    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnGround,
+                     static_cast<uint32_t>(Application::instance()->prediction_horizon().horizon_ms()), &poseState);
     devicePair.hmdPose = wvr::wToLarkHMDTrakedPose(poseState);
 //    WVR_GetSyncPose(WVR_PoseOriginModel_OriginOnHead, vr_device_pairs_, WVR_DEVICE_COUNT_LEVEL_1);
     WVR_GetSyncPose(WVR_PoseOriginModel_OriginOnGround, vr_device_pairs_, WVR_DEVICE_COUNT_LEVEL_1);
@@ -233,54 +311,29 @@ bool WvrSceneCloud::HandleInput() {
 
         larkxrControllerDeviceState* controllerDeviceState = &devicePair.controllerState[isLeft ? 0 : 1];
         controllerDeviceState->deviceType = isLeft ? Larkxr_Controller_Left : Larkxr_Controller_Right;
-        controllerDeviceState->pose = wvr::wToLarkControllerTrackedPose(isLeft, posePair.pose);
+        SetControllerPose(isLeft, posePair.pose, controllerDeviceState);
         // battery
 
-        // htc focus plus 设置旋转
-        larkxrSystemInfo info = lark::XRClient::system_info();
-        if (controllerDeviceState->pose.is6Dof) {
-            // 3.1.8.0 remove rotate
-            // remove rotate
-//            controllerDeviceState->rotateDeg = glm::half_pi<float>() / 3.0F;
-//            controllerDeviceState->rotateAxis = glm::vec3(1, 0, 0);
-        } else if (info.platFromType == Larkxr_Platform_PICO_NEO || info.platFromType == Larkxr_Platform_PICO_G2_4k) {
-            controllerDeviceState->pose.velocity = glm::vec3(0,0,0);
-            controllerDeviceState->pose.angularVelocity = glm::vec3(0,0,0);
-            controllerDeviceState->pose.angularAcceleration = glm::vec3(0,0,0);
-            controllerDeviceState->pose.acceleration = glm::vec3(0,0,0);
-        }
-
         // TODO check HTC FLOW
         if (WaveApplication::s_is_vive_flow()) {
             controllerDeviceState->rotateDeg = glm::half_pi<float>() / 3.0F;
             controllerDeviceState->rotateAxis = glm::vec3(-1, 0, 0);
         }
 
+        // 每帧每个设备只取一次全部按键状态
+        wvr::InputDeviceState deviceInput = wvr::InputDeviceState::Sample(posePair.type);
+
         int deviceIndex = isLeft ? Input::RayCast_left : Input::RayCast_Right;
-        backButtonDownThisFrame[deviceIndex] = WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Menu);
-        enterButtonDownThisFrame[deviceIndex] = WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Touchpad);
-        triggerDownThisFrame[deviceIndex] = WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Trigger) ||
-                WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Digital_Trigger);
+        backButtonDownThisFrame[deviceIndex] = deviceInput.button(WVR_InputId_Alias1_Menu);
+        enterButtonDownThisFrame[deviceIndex] = deviceInput.button(WVR_InputId_Alias1_Touchpad);
+        triggerDownThisFrame[deviceIndex] = deviceInput.button(WVR_InputId_Alias1_Trigger) ||
+                deviceInput.button(WVR_InputId_Alias1_Digital_Trigger);
         // local operate
-        bool backButtonDownLastFrame = back_button_down_last_frame_[deviceIndex];
-        back_button_down_last_frame_[deviceIndex] = backButtonDownThisFrame[deviceIndex];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[deviceIndex];
-        trigger_button_down_last_frame_[deviceIndex] = triggerDownThisFrame[deviceIndex];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[deviceIndex];
-        enter_button_down_last_frame_[deviceIndex] = enterButtonDownThisFrame[deviceIndex];
-
         Input::RayCastType rayCastType = isLeft ? Input::RayCast_left : Input::RayCast_Right;
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // back button.
-        if (backButtonDownLastFrame && !backButtonDownThisFrame[deviceIndex]) {
+        if (inputState[rayCastType].backShortPressed) {
             LOGV( "back button short press" );
             if (menu_view_->active()) {
                 HideMenu();
@@ -288,19 +341,19 @@ bool WvrSceneCloud::HandleInput() {
         }
 
         // call after pressup.
-        if ( triggerDownThisFrame[deviceIndex] && backButtonDownLastFrame && !backButtonDownThisFrame[deviceIndex] )
+        if ( triggerDownThisFrame[deviceIndex] && inputState[rayCastType].backShortPressed )
         {
             // 显示退出菜单
             ShowMenu();
         }
 
         // call ater pressup.
-        if ( traggerButtonDownLastFrame && !triggerDownThisFrame[deviceIndex] ) {
+        if ( inputState[rayCastType].triggerShortPressed ) {
             LOGV( "trigger button short press" );
         }
 
         // enter button.
-        if (enterButtonDownLastFrame && !enterButtonDownThisFrame[deviceIndex]) {
+        if (inputState[rayCastType].enterShortPressed) {
             LOGV( "enter button short press" );
         }
 
@@ -312,11 +365,11 @@ bool WvrSceneCloud::HandleInput() {
         }
         // 6 dof use trigger as trigger. 3dof use digit trigger as trigger
         if (posePair.pose.is6DoFPose) {
-            if (WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Trigger)) {
+            if (deviceInput.button(WVR_InputId_Alias1_Trigger)) {
                 controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Trigger_Click);
                 controllerDeviceState->inputState.triggerValue = 1.0F;
             }
-            if (WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Digital_Trigger)) {
+            if (deviceInput.button(WVR_InputId_Alias1_Digital_Trigger)) {
                 controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Grip_Click);
                 controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Grip_Touch);
                 controllerDeviceState->inputState.gripValue = 1.0F;
@@ -325,12 +378,12 @@ bool WvrSceneCloud::HandleInput() {
             }
             LOGV("is6DoFPose");
         } else {
-            if (WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Trigger)) {
+            if (deviceInput.button(WVR_InputId_Alias1_Trigger)) {
                 controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Trigger_Click);
                 controllerDeviceState->inputState.triggerValue = 1.0F;
                 LOGV("WVR_InputId_Alias1_Trigger");
             }
-            if (WVR_GetInputButtonState(posePair.type, WVR_InputId_Alias1_Digital_Trigger)) {
+            if (deviceInput.button(WVR_InputId_Alias1_Digital_Trigger)) {
                 controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Trigger_Click);
                 controllerDeviceState->inputState.triggerValue = 1.0F;
                 LOGV("WVR_InputId_Alias1_Digital_Trigger");
@@ -340,21 +393,20 @@ bool WvrSceneCloud::HandleInput() {
 //            controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Trackpad_Click);
             controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Joystick_Click);
         }
-        if (WVR_GetInputTouchState(posePair.type, WVR_InputId_Alias1_Touchpad)) {
+        if (deviceInput.touch(WVR_InputId_Alias1_Touchpad)) {
 //            controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Trackpad_Touch);
             controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_Joystick_Touch);
         }
-        if (WVR_GetInputTouchState(posePair.type, WVR_InputId_Alias1_A)) {
+        if (deviceInput.touch(WVR_InputId_Alias1_A)) {
             controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_A_Click);
         }
-        if (WVR_GetInputTouchState(posePair.type, WVR_InputId_Alias1_B)) {
+        if (deviceInput.touch(WVR_InputId_Alias1_B)) {
             controllerDeviceState->inputState.buttons |= LARKXR_BUTTON_FLAG(larkxr_Input_B_Click);
         }
 
         // touchpad axis
-        WVR_Axis touchpadAxis = WVR_GetInputAnalogAxis(posePair.type, WVR_InputId_Alias1_Touchpad);
-        controllerDeviceState->inputState.touchPadAxis.x = touchpadAxis.x;
-        controllerDeviceState->inputState.touchPadAxis.y = touchpadAxis.y;
+        controllerDeviceState->inputState.touchPadAxis.x = deviceInput.touchpad.x;
+        controllerDeviceState->inputState.touchPadAxis.y = deviceInput.touchpad.y;
     }
 
     if (menu_view_->active()) {
@@ -370,6 +422,7 @@ bool WvrSceneCloud::HandleInput() {
     {
         // send pose
         device_pair_ = devicePair;
+        tracking_pair_.Publish(devicePair);
     }
     return WvrScene::HandleInput();
 }
@@ -427,6 +480,14 @@ void WvrSceneCloud::OnMenuViewSelect(bool submit) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void WvrSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void WvrSceneCloud::ShowMenu() {
     LOGV("show menu");
     fake_hmd_->set_transform(lark::Transform(device_pair_.hmdPose.rotation.toGlm(),
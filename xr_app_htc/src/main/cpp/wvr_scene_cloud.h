@@ -6,11 +6,17 @@
 #define CLOUDLARKXR_WVR_SCENE_CLOUD_H
 
 
+#include <atomic>
+#include <mutex>
 #include <skybox.h>
+#include <snapshot_buffer.h>
 #include <lark_xr/types.h>
 #include <lark_xr/xr_tracking_frame.h>
 #include <ui/controller.h>
 #include <ui/menu_view.h>
+#ifdef ENABLE_PERF_HUD
+#include "ui/perf_hud.h"
+#endif
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
 #endif
@@ -33,12 +39,17 @@ public:
 
     void Update() override;
     void UpdateAsync(larkxrTrackingDevicePairFrame* devicePairFrame);
+    // pose sampler thread. fresh hmd and controller poses with the input of the last HandleInput.
+    bool SamplePose(larkxrTrackingDevicePairFrame* devicePairFrame);
     bool Render() override;
     bool Render(const larkxrTrackingFrame& trackingFrame);
     bool Render(const larkxrTrackingFrame& trackingFrame, const lark::XRVideoFrame& videoFrame);
     bool HandleInput() override;
 
     virtual void OnMenuViewSelect(bool submit) override;
+#ifdef ENABLE_PERF_HUD
+    virtual void OnMenuViewToggleHud() override;
+#endif
 
 #ifdef ENABLE_CLOUDXR
     void SetCloudXRClient(const std::shared_ptr<CloudXRClient>& client);
@@ -48,10 +59,9 @@ private:
     void ShowMenu();
     void HideMenu();
     void OnCloseApp();
-
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
+    static void SetControllerPose(bool isLeft, const WVR_PoseState_t& poseState, larkxrControllerDeviceState* state);
+    // fill frame index and fetch time of the pose going to be sent.
+    void BeginTracking(larkxrTrackingDevicePairFrame* devicePairFrame);
 
     std::shared_ptr<lark::SkyBox> sky_box_;
     std::shared_ptr<Loading> loading_;
@@ -59,11 +69,17 @@ private:
     std::shared_ptr<lark::Controller> controller_right_{};
     std::shared_ptr<lark::Object> fake_hmd_;
     std::shared_ptr<MenuView> menu_view_;
+#ifdef ENABLE_PERF_HUD
+    std::shared_ptr<PerfHud> perf_hud_;
+#endif
 
     std::shared_ptr<RectTexture> rect_texture_{};
     larkxrDevicePair device_pair_{};
+    // device_pair_ handed to the tracking threads, consumers serialized by tracking_mutex_.
+    lark::SnapshotBuffer<larkxrDevicePair> tracking_pair_;
+    std::mutex tracking_mutex_;
 
-    uint64_t frame_index_ = 0;
+    std::atomic<uint64_t> frame_index_ = {0};
 
 #ifdef ENABLE_CLOUDXR
     std::shared_ptr<CloudXRClient> cloudxr_client_ = {};
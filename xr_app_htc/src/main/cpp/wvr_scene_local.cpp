@@ -8,6 +8,7 @@
 #include <application.h>
 #include "wvr_scene_local.h"
 #include "wvr_utils.h"
+#include "wvr_input_state.h"
 #define LOG_TAG "wvr_scene_local"
 
 WvrSceneLocal::~WvrSceneLocal() = default;
@@ -128,42 +129,29 @@ bool WvrSceneLocal::HandleInput() {
         ray->dir = transform.Forward();
 
         // input state
-        if (WVR_GetInputButtonState(devicePose.type, WVR_InputId_Alias1_Menu)) {
+        wvr::InputDeviceState deviceInput = wvr::InputDeviceState::Sample(devicePose.type);
+        if (deviceInput.button(WVR_InputId_Alias1_Menu)) {
             LOGI("Controller device Menu button was pressed");
             backButtonDownThisFrame[rayCastType] = true;
         } else {
             backButtonDownThisFrame[rayCastType] = false;
         }
-        if (WVR_GetInputButtonState(devicePose.type, WVR_InputId_Alias1_Touchpad)) {
+        if (deviceInput.button(WVR_InputId_Alias1_Touchpad)) {
             LOGI("Controller device dpad button was pressed");
             enterButtonDownThisFrame[rayCastType] = true;
         } else {
             enterButtonDownThisFrame[rayCastType] = false;
         }
 
-        if (WVR_GetInputButtonState(devicePose.type, WVR_InputId_Alias1_Trigger)
-            || WVR_GetInputButtonState(devicePose.type, WVR_InputId_Alias1_Digital_Trigger)) {
+        if (deviceInput.button(WVR_InputId_Alias1_Trigger)
+            || deviceInput.button(WVR_InputId_Alias1_Digital_Trigger)) {
             LOGI("Controller device Tragger button was pressed");
             triggerDownThisFrame[rayCastType] = true;
         } else {
             triggerDownThisFrame[rayCastType] = false;
         }
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         //             call after pressup.
         if ( inputState[rayCastType].backShortPressed)
@@ -0,0 +1,147 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#include "frame_buffer.h"
+#include "log.h"
+
+#define LOG_TAG "hxr_framebuffer"
+
+// GL_OVR_multiview
+typedef void(*PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR)(GLenum, GLenum, GLuint, GLint, GLint, GLsizei);
+
+namespace {
+    const int MULTIVIEW_LAYERS = 2;
+    PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR glFramebufferTextureMultiviewOVR = NULL;
+}
+
+namespace hxr {
+FrameBuffer::FrameBuffer() = default;
+
+FrameBuffer::~FrameBuffer() = default;
+
+bool FrameBuffer::Create(XrSession session, GLenum colorFormat, int width, int height) {
+    glFramebufferTextureMultiviewOVR = (PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR)eglGetProcAddress(
+            "glFramebufferTextureMultiviewOVR");
+    if (glFramebufferTextureMultiviewOVR == NULL) {
+        LOGE("Failed to get proc address for glFramebufferTextureMultiviewOVR");
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+
+    XrSwapchainCreateInfo swapchainCreateInfo{XR_TYPE_SWAPCHAIN_CREATE_INFO};
+    swapchainCreateInfo.createFlags = 0;
+    swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchainCreateInfo.format = colorFormat;
+    swapchainCreateInfo.sampleCount = 1;
+    swapchainCreateInfo.width = width;
+    swapchainCreateInfo.height = height;
+    swapchainCreateInfo.faceCount = 1;
+    swapchainCreateInfo.arraySize = MULTIVIEW_LAYERS;
+    swapchainCreateInfo.mipCount = 1;
+
+    XrResult res = xrCreateSwapchain(session, &swapchainCreateInfo, &swapchain_);
+    if (XR_FAILED(res)) {
+        LOGW("create multiview swapchain failed %d", res);
+        swapchain_ = XR_NULL_HANDLE;
+        return false;
+    }
+
+    uint32_t imageCount = 0;
+    xrEnumerateSwapchainImages(swapchain_, 0, &imageCount, nullptr);
+    images_.resize(imageCount, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_ES_KHR});
+    xrEnumerateSwapchainImages(swapchain_, imageCount, &imageCount,
+                               reinterpret_cast<XrSwapchainImageBaseHeader*>(images_.data()));
+
+    depth_buffers_.resize(imageCount, 0);
+    frame_buffers_.resize(imageCount, 0);
+    layer_frame_buffers_.resize(imageCount * MULTIVIEW_LAYERS, 0);
+
+    for (uint32_t i = 0; i < imageCount; i++) {
+        const GLuint colorTexture = images_[i].image;
+        glBindTexture(GL_TEXTURE_2D_ARRAY, colorTexture);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        // depth texture with the same layers as color.
+        glGenTextures(1, &depth_buffers_[i]);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, depth_buffers_[i]);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT24, width_, height_, MULTIVIEW_LAYERS);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        // first the fbo with all layers, then one fbo per layer.
+        for (int view = -1; view < MULTIVIEW_LAYERS; view++) {
+            GLuint* fbo = view < 0 ? &frame_buffers_[i] : &layer_frame_buffers_[i * MULTIVIEW_LAYERS + view];
+            GLint baseView = view < 0 ? 0 : view;
+            GLsizei numViews = view < 0 ? MULTIVIEW_LAYERS : 1;
+            glGenFramebuffers(1, fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, *fbo);
+            glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                             depth_buffers_[i], 0, baseView, numViews);
+            glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                             colorTexture, 0, baseView, numViews);
+            GLenum status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            if (status != GL_FRAMEBUFFER_COMPLETE) {
+                LOGE("Incomplete multiview frame buffer object: 0x%x", status);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void FrameBuffer::Acquire() {
+    XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+    xrAcquireSwapchainImage(swapchain_, &acquireInfo, &swapchain_index_);
+
+    XrSwapchainImageWaitInfo waitInfo{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+    waitInfo.timeout = XR_INFINITE_DURATION;
+    xrWaitSwapchainImage(swapchain_, &waitInfo);
+}
+
+void FrameBuffer::Release() {
+    XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
+    xrReleaseSwapchainImage(swapchain_, &releaseInfo);
+}
+
+void FrameBuffer::SetCurrent() {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frame_buffers_[swapchain_index_]);
+}
+
+void FrameBuffer::SetCurrentLayer(int layer) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, layer_frame_buffers_[swapchain_index_ * MULTIVIEW_LAYERS + layer]);
+}
+
+void FrameBuffer::SetNone() {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::Resolve() {
+    const GLenum depthAttachment[1] = {GL_DEPTH_ATTACHMENT};
+    glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, 1, depthAttachment);
+}
+
+void FrameBuffer::Destroy() {
+    // 0 names are ignored, safe after a failed Create.
+    glDeleteFramebuffers(static_cast<GLsizei>(frame_buffers_.size()), frame_buffers_.data());
+    glDeleteFramebuffers(static_cast<GLsizei>(layer_frame_buffers_.size()), layer_frame_buffers_.data());
+    glDeleteTextures(static_cast<GLsizei>(depth_buffers_.size()), depth_buffers_.data());
+    if (swapchain_ != XR_NULL_HANDLE) {
+        xrDestroySwapchain(swapchain_);
+        swapchain_ = XR_NULL_HANDLE;
+    }
+    images_.clear();
+    depth_buffers_.clear();
+    frame_buffers_.clear();
+    layer_frame_buffers_.clear();
+    swapchain_index_ = 0;
+    width_ = 0;
+    height_ = 0;
+}
+}
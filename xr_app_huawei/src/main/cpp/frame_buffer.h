@@ -0,0 +1,61 @@
+//
+// Created by fcx@pingxingyun.com on 2023/3/19.
+//
+
+#ifndef LARKXR_FRAME_BUFFER_H
+#define LARKXR_FRAME_BUFFER_H
+
+#include <vector>
+#include "jni.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+#include <GLES3/gl3ext.h>
+#include "openxr/openxr_platform.h"
+
+namespace hxr {
+//
+// multiview swapchain, one image array layer per eye, rendered in one pass with GL_OVR_multiview2.
+// per eye swapchains keep rendering into the target the runtime binds on xrWaitSwapchainImage,
+// the layers of an array image need own fbos.
+//
+class FrameBuffer {
+public:
+    FrameBuffer();
+    ~FrameBuffer();
+
+    // return false when the runtime or gl driver rejects the array swapchain. Destroy after failed.
+    bool Create(XrSession session, GLenum colorFormat, int width, int height);
+
+    void Acquire();
+    void Release();
+
+    // both layers in one pass.
+    void SetCurrent();
+    // one layer, for objects can not draw multiview.
+    void SetCurrentLayer(int layer);
+    void SetNone();
+    // drop depth, so the tiler won't write it back.
+    void Resolve();
+
+    void Destroy();
+
+    inline int width() const { return width_; }
+    inline int height() const { return height_; }
+    inline XrSwapchain swapchain() const { return swapchain_; }
+private:
+    int width_ = 0;
+    int height_ = 0;
+    XrSwapchain swapchain_ = XR_NULL_HANDLE;
+    uint32_t swapchain_index_ = 0;
+    std::vector<XrSwapchainImageOpenGLESKHR> images_{};
+    // 2d array depth texture per swapchain image.
+    std::vector<GLuint> depth_buffers_{};
+    // all layers per swapchain image.
+    std::vector<GLuint> frame_buffers_{};
+    // one per layer of each swapchain image.
+    std::vector<GLuint> layer_frame_buffers_{};
+};
+}
+
+#endif //LARKXR_FRAME_BUFFER_H
@@ -5,6 +5,9 @@
 
 #include <env_context.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
+#include <multiview.h>
 #include <lark_xr/xr_latency_collector.h>
 #include "hxr_application.h"
 #include "hxr_utils.h"
@@ -20,6 +23,8 @@ namespace {
 namespace hxr {
 HxrApplication::HxrApplication() {
     RegiseredInstance(this);
+    // huawei runtime has deeper pipeline, start with bigger horizon.
+    prediction_horizon_.set_default_horizon_ns(50 * 1000 * 1000);
 }
 
 HxrApplication::~HxrApplication() {
@@ -91,7 +96,8 @@ bool HxrApplication::InitGL(OpenxrContext *context) {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&asset_context, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&asset_context, Assetlist);
 
     scene_local_ = std::make_shared<XrSceneLocal>();
     scene_local_->InitGL();
@@ -138,7 +144,11 @@ void HxrApplication::ShutdownGL() {
 
     // reset all state.
     Input::ResetInput();
+    lark::TextureStreamer::Release();
+    lark::Multiview::Release();
+    lark::RenderState::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
 
     Application::ShutdownGL();
 }
@@ -179,6 +189,11 @@ void HxrApplication::RenderFrame() {
     bool has_new_frame_pxy_stream = false;
     bool has_new_frame_cloudxr = false;
 
+    // finish async asset loads within the frame budget.
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
+
 #ifdef ENABLE_CLOUDXR
     if (need_recreat_cloudxr_client_) {
         cloudxr_client_->Init();
@@ -215,16 +230,11 @@ void HxrApplication::RenderFrame() {
 
         {
             uint64_t frameIndex = latched.poseID;
-            std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-            auto it = tracking_frame_map_.find(frameIndex);
-            if (it != tracking_frame_map_.end()) {
-                trackingFrame = it->second;
-            } else {
-                if (!tracking_frame_map_.empty()) {
-                    LOGW("cant find new tracking frame in map. use old. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
-                    trackingFrame = tracking_frame_map_.cbegin()->second;
+            if (!pose_history_.Find(frameIndex, &trackingFrame)) {
+                if (pose_history_.Latest(&trackingFrame)) {
+                    LOGW("cant find tracking frame in history. use latest %ld; index %ld", trackingFrame.frameIndex, frameIndex);
                 } else {
-                    LOGW("cant find tracking frame in map. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
+                    LOGW("cant find tracking frame in history. count %ld; index %ld", pose_history_.count(), frameIndex);
                     return;
                 }
             }
@@ -241,6 +251,10 @@ void HxrApplication::RenderFrame() {
     // LOGV("cloudmedia_ready %d", cloudmedia_ready);
 
     if (!has_new_frame_cloudxr && xr_client_->is_connected()) {
+        // block until new cloud frame or the deadline before next vsync.
+        if (cloudmedia_ready) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
+        }
         has_new_frame_pxy_stream = xr_client_->Render(&trackingFrame, &xrVideoFrame);
 
         // LOGV("cloudmedia_ready %d has_new_frame_pxy_stream %d", cloudmedia_ready, has_new_frame_pxy_stream);
@@ -248,7 +262,7 @@ void HxrApplication::RenderFrame() {
         // wait for cloud frame
         if (cloudmedia_ready && !has_new_frame_pxy_stream) {
 //            LOGV("wait for new frame");
-            usleep(1000);
+            // deadline passed. submit nothing, compositor reprojects last frame.
             return;
         }
         if (has_new_frame_pxy_stream) {
@@ -272,6 +286,7 @@ void HxrApplication::RenderFrame() {
     frameState.next = NULL;
 
     xrWaitFrame(context_->session(), &waitFrameInfo, &frameState);
+    frame_pacer_.SetDisplayTiming(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
 
     // Get the HMD pose, predicted for the middle of the time period during which
     // the new eye images will be displayed. The number of frames predicted ahead
@@ -304,6 +319,7 @@ void HxrApplication::RenderFrame() {
     endFrameInfo.layerCount = layers.size();
     endFrameInfo.layers = layers.data();
     xrEndFrame(context_->session(), &endFrameInfo);
+    frame_pacer_.FrameEnd();
 
 #ifdef USE_RENDER_QUEUE
     if (has_new_frame_pxy_stream) {
@@ -319,12 +335,14 @@ void HxrApplication::RenderFrame() {
         float degree = glm::degrees(renderAng.y - trackingAng.y);
 
         lark::XRLatencyCollector::Instance().Submit(trackingFrame.frameIndex, degree);
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         xr_client_->ReleaseRenderTexture();
     }
 #endif
 
 #ifdef ENABLE_CLOUDXR
     if (has_new_frame_cloudxr) {
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         cloudxr_client_->Release();
         cloudxr_client_->Stats();
     }
@@ -362,14 +380,16 @@ bool HxrApplication::RenderLayer(XrTime predictedDisplayTime,
     for (int i = 0; i < viewCountOutput; i++)   //viewCountOutput ==> 1
     {
         //3.1 Acquire Image
-        uint32_t swapchainImageIndex;
-        XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
-        xrAcquireSwapchainImage(context_->swapchains()[i], &acquireInfo, &swapchainImageIndex);
-
-        //3.2 Wait Image
-        XrSwapchainImageWaitInfo waitInfo{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
-        waitInfo.timeout = XR_INFINITE_DURATION;
-        xrWaitSwapchainImage(context_->swapchains()[i], &waitInfo);
+        uint32_t swapchainImageIndex = 0;
+        if (!context_->multiview()) {
+            XrSwapchainImageAcquireInfo acquireInfo{XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO};
+            xrAcquireSwapchainImage(context_->swapchains()[i], &acquireInfo, &swapchainImageIndex);
+
+            //3.2 Wait Image
+            XrSwapchainImageWaitInfo waitInfo{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+            waitInfo.timeout = XR_INFINITE_DURATION;
+            xrWaitSwapchainImage(context_->swapchains()[i], &waitInfo);
+        }
 
         //3.3 Prepare LayerViews
         projectionLayerViews[i] = {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW};
@@ -387,6 +407,15 @@ bool HxrApplication::RenderLayer(XrTime predictedDisplayTime,
         LOGI("i = %d : pose orientation:%f,%f,%f,%f",i,mViews[i].pose.orientation.x,mViews[i].pose.orientation.y,mViews[i].pose.orientation.z,mViews[i].pose.orientation.w);
         LOGI("i = %d : fov:%f,%f,%f,%f",i,mViews[i].fov.angleUp,mViews[i].fov.angleDown,mViews[i].fov.angleLeft,mViews[i].fov.angleRight);*/
         projectionLayerViews[i].fov = mViews[i].fov;
+        if (context_->multiview()) {
+            // multiview swapchain has one layer per eye, both drawn after all views filled.
+            FrameBuffer& frameBuffer = context_->frame_buffer();
+            projectionLayerViews[i].subImage.swapchain = frameBuffer.swapchain();
+            projectionLayerViews[i].subImage.imageRect.offset = {0, 0};
+            projectionLayerViews[i].subImage.imageRect.extent = {frameBuffer.width(), frameBuffer.height()};
+            projectionLayerViews[i].subImage.imageArrayIndex = i;
+            continue;
+        }
         projectionLayerViews[i].subImage.swapchain = context_->swapchains()[i];
         projectionLayerViews[i].subImage.imageRect.offset = {0, 0};
         projectionLayerViews[i].subImage.imageRect.extent = {1080, 1080};
@@ -406,6 +435,17 @@ bool HxrApplication::RenderLayer(XrTime predictedDisplayTime,
 
     }
 
+    if (context_->multiview()) {
+        FrameBuffer& frameBuffer = context_->frame_buffer();
+        frameBuffer.Acquire();
+        if (xr_client_->is_connected()) {
+            scene_cloud_->RenderMultiview(projectionLayerViews.data(), frameBuffer);
+        } else {
+            scene_local_->RenderMultiview(projectionLayerViews.data(), frameBuffer);
+        }
+        frameBuffer.Release();
+    }
+
     //4. Make Layer
     layer.next = nullptr;
     layer.layerFlags = 0;
@@ -588,13 +628,7 @@ void HxrApplication::GetTrackingState(cxrVRTrackingState *state) {
         frame.fetchTime = devicePairFrame.fetchTime;
         frame.displayTime = devicePairFrame.displayTime;
         frame.tracking = devicePairFrame.devicePair.hmdPose;
-        // unique_ptr
-        std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-        tracking_frame_map_.insert(
-                std::pair<uint64_t, larkxrTrackingFrame>(frame.frameIndex, frame));
-        if (tracking_frame_map_.size() > MAXIMUM_TRACKING_FRAMES) {
-            tracking_frame_map_.erase(tracking_frame_map_.cbegin());
-        }
+        pose_history_.Push(frame);
     }
 
     *state = CloudXRClient::VRTrackingStateFrom(devicePairFrame);
@@ -617,12 +651,16 @@ void HxrApplication::SetupSkyBox(int index) {
 }
 bool HxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& trackingDevicePairFrame) {
     uint64_t now = utils::GetTimestampNs();
-    XrTime predictedDisplayTime = now + 1000 * 1000 * 50;
+    XrTime predictedDisplayTime = now + prediction_horizon_.horizon_ns();
 //    XrTime predictedDisplayTime = 0;
+    // runtime predicts to display time itself, or sample now and extrapolate by pose filter.
+    XrTime sampleTime = pose_filter_.sample_at_display_time() ? predictedDisplayTime : now;
     XrSpace space = GetSelectedXRSpace();
 
+    XrSpaceVelocity headVelocity{XR_TYPE_SPACE_VELOCITY};
     XrSpaceLocation spaceLocation_h{XR_TYPE_SPACE_LOCATION};
-    xrLocateSpace(context_->input_state().HeadSpace, space, predictedDisplayTime, &spaceLocation_h);
+    spaceLocation_h.next = &headVelocity;
+    xrLocateSpace(context_->input_state().HeadSpace, space, sampleTime, &spaceLocation_h);
     // LOGI("spaceLocation_h_position:%f,%f,%f",spaceLocation_h.pose.position.x,spaceLocation_h.pose.position.y,spaceLocation_h.pose.position.z);
     // LOGI("spaceLocation_h_orientation:%f,%f,%f,%f",spaceLocation_h.pose.orientation.x,spaceLocation_h.pose.orientation.y,spaceLocation_h.pose.orientation.z,spaceLocation_h.pose.orientation.w);
     // LOGI("spaceLocation_h_locationFlags: %u", (unsigned int)spaceLocation_h.locationFlags);
@@ -641,7 +679,7 @@ bool HxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& tra
 
     XrViewLocateInfo viewLocateInfo{XR_TYPE_VIEW_LOCATE_INFO};
     viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO; //XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO; XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO
-    viewLocateInfo.displayTime = predictedDisplayTime;
+    viewLocateInfo.displayTime = sampleTime;
     viewLocateInfo.space = context_->app_space();   //mView相对于世界坐标系
 
     XrViewState viewState{XR_TYPE_VIEW_STATE};
@@ -664,6 +702,13 @@ bool HxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& tra
         pose.eye[i].viewRotation = toGlm(mViews[i].pose.orientation);
     }
 
+    bool hasVelocity = (headVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) &&
+                       (headVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT);
+    if (hasVelocity) {
+        pose.velocity = toGlm(headVelocity.linearVelocity);
+        pose.angularVelocity = toGlm(headVelocity.angularVelocity);
+    }
+
 
     larkxrDevicePair devicePair = {};
     devicePair.hmdPose = pose;
@@ -688,8 +733,11 @@ bool HxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& tra
         devicePair.controllerState[1].pose.position.y += CLOUD_LOCALSPACE_HEIGHT_OFFSET;
     }
 
+    pose_filter_.Apply(&devicePair, sampleTime, predictedDisplayTime, hasVelocity);
+
     static uint64_t frame_index = 0;
     frame_index++;
+    prediction_horizon_.OnTracking(frame_index);
 
     trackingDevicePairFrame = {
             frame_index,
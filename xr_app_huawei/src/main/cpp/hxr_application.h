@@ -9,6 +9,7 @@
 #include <android_native_app_glue.h>
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
+#include <pose_history.h>
 #endif
 #include "utils.h"
 #include "xr_scene_local.h"
@@ -44,6 +45,8 @@ public:
     virtual void SetupSapce(Space space) override;
     // ui 设置天空盒, 更新场景中的天空盒
     virtual void SetupSkyBox(int index) override;
+    // 发送前用 XrSpaceVelocity 填充速度, 可选客户端外推
+    virtual bool SupportPoseFilter() override { return true; };
 
     //
     // xr client callback
@@ -89,10 +92,8 @@ private:
     std::shared_ptr<XrSceneCloud> scene_cloud_ = {};
 
 #ifdef ENABLE_CLOUDXR
-    static const int MAXIMUM_TRACKING_FRAMES = 50;
-    typedef std::map<uint64_t, larkxrTrackingFrame> TRACKING_FRAME_MAP;
-    TRACKING_FRAME_MAP tracking_frame_map_{};
-    std::mutex tracking_frame_mutex_{};
+    // pushed by cloudxr tracking thread, read by render thread when frame latched.
+    PoseHistory pose_history_{};
 
     uint64_t pre_controller_state[2] = {};
     std::shared_ptr<CloudXRClient> cloudxr_client_ = nullptr;
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <unistd.h>
 #include <utils.h>
+#include <multiview.h>
 #include "openxr_context.h"
 #include "log.h"
 
@@ -188,6 +189,22 @@ void OpenxrContext::CreateSwapchains() {
     xrEnumerateSwapchainFormats(session_, formatCount, &formatCount, swapchainFormats.data());
 
 
+    // one swapchain with a layer per eye when single pass stereo supported.
+    // enabled before scenes created, objects load the multiview shaders.
+    multiview_ = lark::Multiview::instance()->Enable();
+    if (multiview_) {
+        multiview_ = frame_buffer_.Create(session_, GL_RGBA8,
+                                          viewConfigViews[0].recommendedImageRectWidth,
+                                          viewConfigViews[0].recommendedImageRectHeight);
+        if (!multiview_) {
+            frame_buffer_.Destroy();
+        }
+    }
+    LOGV("use multiview %d", multiview_);
+    if (multiview_) {
+        return;
+    }
+
     LOGI("XrCreateSwapchain xrEnumerateSwapchainImages");
     swapchains_.resize(viewCount);
     swapchains_image_array_.resize(viewCount);
@@ -419,6 +436,11 @@ void OpenxrContext::PollActions() {
 void OpenxrContext::Destory() {
     input_state_ = {};
 
+    if (multiview_) {
+        frame_buffer_.Destroy();
+        multiview_ = false;
+    }
+
     graphics_plugin_->DestroyContext();
 
     xrDestroySpace(app_space_);
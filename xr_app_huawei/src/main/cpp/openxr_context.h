@@ -7,6 +7,7 @@
 #define LARKXR_OPENXR_CONTEXT_H
 
 #include <memory>
+#include "frame_buffer.h"
 #include "graphics_device_android.h"
 #include "input_state.h"
 
@@ -65,6 +66,10 @@ public:
     inline std::vector<XrSwapchain>& swapchains() { return swapchains_;}
     inline std::vector<std::vector<XrSwapchainImageOpenGLESKHR>>& swapchains_image_array() { return swapchains_image_array_;}
 
+    // both eyes render into frame_buffer() in one pass, swapchains() empty.
+    inline bool multiview() const { return multiview_; }
+    inline FrameBuffer& frame_buffer() { return frame_buffer_; }
+
     inline GraphicsDeviceAndroid&  graphics_plugin() const { return *graphics_plugin_; }
 
     inline double GetSeconds()
@@ -126,6 +131,9 @@ private:
     std::vector<XrSwapchain> swapchains_{};
     std::vector<std::vector<XrSwapchainImageOpenGLESKHR>> swapchains_image_array_{};
 
+    FrameBuffer frame_buffer_{};
+    bool multiview_ = false;
+
     //time
     double start_;
     double finish_;
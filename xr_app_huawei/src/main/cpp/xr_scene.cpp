@@ -3,9 +3,11 @@
 // Copyright (c) 2022 www.pingxingyun.com All rights reserved.
 //
 
+#include <multiview.h>
 #include "xr_scene.h"
 #include "matrix_functions.h"
 #include "hxr_utils.h"
+#include "render_state.h"
 
 namespace hxr {
 XrScene::XrScene() {
@@ -21,7 +23,71 @@ void XrScene::ReleaseGL() {
 }
 
 void XrScene::Render(lark::Object::Eye eye, const XrCompositionLayerProjectionView &layerView) {
+    glm::mat4 g_proj;
+    glm::mat4 g_view;
+    GetMatrices(layerView, &g_proj, &g_view);
 
+    // state set without the cache and by the runtime.
+    lark::RenderState::instance()->Invalidate();
+    for(auto it = objects_.begin(); it != objects_.end(); it ++) {
+        if (it->get()->active()) {
+            it->get()->Draw(eye, g_proj, g_view);
+        }
+    }
+}
+
+void XrScene::RenderMultiview(const XrCompositionLayerProjectionView* layerViews, FrameBuffer &frameBuffer) {
+    glm::mat4 g_proj[lark::Multiview::VIEW_COUNT];
+    glm::mat4 g_view[lark::Multiview::VIEW_COUNT];
+    for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+        GetMatrices(layerViews[eye], &g_proj[eye], &g_view[eye]);
+    }
+
+    if (CanDrawMultiview()) {
+        frameBuffer.SetCurrent();
+        BeginDraw(frameBuffer);
+        lark::Multiview::instance()->SetSceneMatrices(g_proj, g_view);
+        for (auto & object : objects_) {
+            if (object->active()) {
+                object->DrawMultiview(g_proj[0], g_view[0]);
+            }
+        }
+        frameBuffer.Resolve();
+    } else {
+        for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+            frameBuffer.SetCurrentLayer(eye);
+            BeginDraw(frameBuffer);
+            for (auto & object : objects_) {
+                if (object->active()) {
+                    object->Draw((lark::Object::Eye) eye, g_proj[eye], g_view[eye]);
+                }
+            }
+            frameBuffer.Resolve();
+        }
+    }
+
+    frameBuffer.SetNone();
+}
+
+bool XrScene::CanDrawMultiview() {
+    return true;
+}
+
+void XrScene::BeginDraw(FrameBuffer &frameBuffer) {
+    lark::RenderState* state = lark::RenderState::instance();
+    // state set without the cache and by the runtime.
+    state->Invalidate();
+    state->Disable(GL_SCISSOR_TEST);
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);
+    glViewport(0, 0, frameBuffer.width(), frameBuffer.height());
+    glClearColor(0, 0, 0, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void XrScene::GetMatrices(const XrCompositionLayerProjectionView &layerView, glm::mat4 *projection,
+                          glm::mat4 *view) {
     XrQuaternionf xrquat;
     XrVector3f xrvec;
     xrquat.x = layerView.pose.orientation.x;
@@ -43,14 +109,8 @@ void XrScene::Render(lark::Object::Eye eye, const XrCompositionLayerProjectionVi
 
     XrMatrix4x4f projectionMatrix = XrMatrix4x4f_CreateProjection(tanAngleLeft, tanAngleRight, tanAngleUp, tanAngleDown, 0.1f, 200.0f);
 
-    glm::mat4 g_proj = toGlm(projectionMatrix);
-    glm::mat4 g_view = toGlm(eyeViewMatrix);
-
-    for(auto it = objects_.begin(); it != objects_.end(); it ++) {
-        if (it->get()->active()) {
-            it->get()->Draw(eye, g_proj, g_view);
-        }
-    }
+    *projection = toGlm(projectionMatrix);
+    *view = toGlm(eyeViewMatrix);
 }
 
 void XrScene::AddObject(std::shared_ptr<lark::Object> object) {
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <object.h>
+#include "frame_buffer.h"
 #include "input_state.h"
 
 namespace hxr {
@@ -18,14 +19,23 @@ public:
 
     virtual void InitGL();
     virtual void Render(lark::Object::Eye eye, const XrCompositionLayerProjectionView& layerView);
+    // both eyes into the layers of an acquired multiview frame buffer.
+    // one pass when all objects can draw multiview, one pass per layer otherwise.
+    virtual void RenderMultiview(const XrCompositionLayerProjectionView* layerViews, FrameBuffer& frameBuffer);
     virtual void HandleInput(const InputState& input_state);
     virtual void ReleaseGL();
 protected:
+    // objects not support single pass stereo, like cloudxr.
+    virtual bool CanDrawMultiview();
     void AddObject(std::shared_ptr<lark::Object> object);
     void RemoveObject(std::shared_ptr<lark::Object> object);
     void ClearObject();
     // objects.
     std::vector<std::shared_ptr<lark::Object>> objects_{};
+private:
+    // own fbo, not set up by the runtime like the per eye swapchains.
+    static void BeginDraw(FrameBuffer& frameBuffer);
+    static void GetMatrices(const XrCompositionLayerProjectionView& layerView, glm::mat4* projection, glm::mat4* view);
 };
 }
 #endif //LARKXR_XR_SCENE_H
@@ -51,6 +51,23 @@ void XrSceneCloud::InitGL() {
     menu_view_->set_active(false);
     AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
+
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+}
+
+bool XrSceneCloud::CanDrawMultiview() {
+#ifdef ENABLE_CLOUDXR
+    // cloudxr renders both eyes side by side into one 2d texture.
+    if (cloudxr_client_ && cloudxr_client_->active()) {
+        return false;
+    }
+#endif
+    return true;
 }
 
 void XrSceneCloud::HandleInput(const InputState &input_state) {
@@ -105,32 +122,7 @@ void XrSceneCloud::HandleInput(const InputState &input_state) {
             triggerDownThisFrame[rayCastType] = input_state.TriggerClick3Dof.currentState;
         }
 
-
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        if (input_state.m_isUse6DofProfile) {
-            inputState[rayCastType].backShortPressed = input_state.BClick.currentState || input_state.YClick.currentState;
-            inputState[rayCastType].enterShortPressed = input_state.AClick.currentState || input_state.XClick.currentState;
-            inputState[rayCastType].triggerShortPressed = input_state.TriggerClick[hand].currentState;
-        } else {
-            inputState[rayCastType].backShortPressed = input_state.BackClick.currentState;
-            inputState[rayCastType].enterShortPressed = input_state.TrackPadClick.currentState;
-            inputState[rayCastType].triggerShortPressed = input_state.TriggerClick3Dof.currentState;
-        }
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // short press backbutton
         if (inputState[rayCastType].backShortPressed) {
@@ -235,6 +227,14 @@ void XrSceneCloud::OnMenuViewSelect(bool submit) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void XrSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void XrSceneCloud::ShowMenu() {
     LOGV("show menu");
     glm::quat rotate = toGlm(headpose_.orientation);
@@ -115,32 +115,7 @@ void XrSceneLocal::HandleInput(const InputState &input_state) {
             triggerDownThisFrame[rayCastType] = input_state.TriggerClick3Dof.currentState;
         }
 
-
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        if (input_state.m_isUse6DofProfile) {
-            inputState[rayCastType].backShortPressed = input_state.BClick.currentState || input_state.YClick.currentState;
-            inputState[rayCastType].enterShortPressed = input_state.AClick.currentState || input_state.XClick.currentState;
-            inputState[rayCastType].triggerShortPressed = input_state.TriggerClick[hand].currentState;
-        } else {
-            inputState[rayCastType].backShortPressed = input_state.BackClick.currentState;
-            inputState[rayCastType].enterShortPressed = input_state.TrackPadClick.currentState;
-            inputState[rayCastType].triggerShortPressed = input_state.TriggerClick3Dof.currentState;
-        }
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         //             call after pressup.
         if ( inputState[rayCastType].backShortPressed)
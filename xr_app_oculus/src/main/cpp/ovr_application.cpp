@@ -9,6 +9,8 @@
 #include <EGL/egl.h>
 #include <unistd.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
 #include "ovr_application.h"
 #include "log.h"
 #include "egl_utils.h"
@@ -85,7 +87,8 @@ bool OvrApplication::InitGL() {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&context, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&context, Assetlist);
 
     scene_local_ = std::make_shared<OvrSceneLocal>();
     scene_cloud_ = std::make_shared<OvrSceneCloud>();
@@ -164,7 +167,10 @@ void OvrApplication::ShutdownGL() {
     scene_local_.reset();
     scene_cloud_->ShutdownGL();
     scene_cloud_.reset();
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
 
     DestoryFrameBuffer();
     ovr_egl_->destoryContext();
@@ -423,6 +429,10 @@ bool OvrApplication::OnUpdate() {
     if (ovr_ == nullptr) {
         return false;
     }
+    // finish async asset loads within the frame budget.
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
 #ifdef ENABLE_CLOUDXR
     if (need_recreat_cloudxr_client_) {
         cloudxr_client_->Init();
@@ -473,16 +483,20 @@ bool OvrApplication::OnUpdate() {
 #ifdef USE_RENDER_QUEUE
         larkxrTrackingFrame trackingFrame;
         lark::XRVideoFrame xrVideoFrame(0);
+        // block until new cloud frame or the deadline before next vsync.
+        if (xr_client_->media_ready()) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
+        }
         if (xr_client_->Render(&trackingFrame, &xrVideoFrame)) {
             scene_cloud_->HandleInput();
             scene_cloud_->Render(ovr_, trackingFrame, xrVideoFrame);
             xr_client_->ReleaseRenderTexture();
+            frame_pacer_.FrameEnd();
         } else {
             if (!xr_client_->media_ready()) {
                 scene_cloud_->Update(ovr_);
             } else {
                 scene_cloud_->HandleInput();
-                usleep(1000);
             }
         }
 #else
@@ -491,10 +505,9 @@ bool OvrApplication::OnUpdate() {
             scene_cloud_->HandleInput();
             scene_cloud_->UpdateAsync(ovr_);
             larkxrTrackingFrame trackingFrame;
-            if (xr_client_->Render(&trackingFrame)) {
+            if (frame_pacer_.WaitForFrame(xr_client_.get()) && xr_client_->Render(&trackingFrame)) {
                 scene_cloud_->Render(ovr_, trackingFrame);
-            } else {
-                usleep(1000);
+                frame_pacer_.FrameEnd();
             }
         } else {
             scene_cloud_->Update(ovr_);
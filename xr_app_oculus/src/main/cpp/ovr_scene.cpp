@@ -18,6 +18,7 @@
 #include "egl_utils.h"
 #include "utils.h"
 #include "ovr_utils.h"
+#include "render_state.h"
 
 #define LOG_TAG "ovr_scene"
 
@@ -257,6 +258,8 @@ ovrLayerProjection2 OvrScene::RenderFrame(const ovrTracking2 *tracking, ovrMobil
         glm::mat4 project = ovr::toGlm(tracking->Eye[eye].ProjectionMatrix);;
         glm::mat4 eyeView = ovr::toGlm(tracking->Eye[eye].ViewMatrix);
 
+        // state set without the cache above and by the runtime.
+        lark::RenderState::instance()->Invalidate();
         for(auto & object : objects_) {
             if (object->active())
                 object->Draw(objEye, project, eyeView);
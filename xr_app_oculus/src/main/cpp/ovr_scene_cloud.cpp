@@ -54,6 +54,13 @@ bool OvrSceneCloud::InitGL(OvrFrameBuffer *frame_buffer, int num_buffers) {
     OvrScene::AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
 
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+
     return OvrScene::InitGL(frame_buffer, num_buffers);
 }
 
@@ -76,7 +83,9 @@ bool OvrSceneCloud::UpdateAsync(ovrMobile *ovr) {
         tracking_frame_index_ = frame_index_;
     }
     tracking_frame_index_++;
-    const double predictedDisplayTime = vrapi_GetPredictedDisplayTime(ovr, tracking_frame_index_);
+    // predict by measured cloud latency instead of local render pipeline.
+    const double predictedDisplayTime = vrapi_GetTimeInSeconds() + Application::instance()->prediction_horizon().horizon_s();
+    Application::instance()->prediction_horizon().OnTracking(tracking_frame_index_);
     display_time_ = predictedDisplayTime;
     device_pair_frame_ = {
             tracking_frame_index_,
@@ -121,22 +130,8 @@ void OvrSceneCloud::HandleInput() {
         triggerDownThisFrame[deviceIndex] =
                 device_pair_frame_.devicePair.controllerState[deviceIndex].inputState.buttons & LARKXR_BUTTON_FLAG(larkxrInput::larkxr_Input_Trigger_Click);
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[deviceIndex];
-        back_button_down_last_frame_[deviceIndex] = backButtonDownThisFrame[deviceIndex];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[deviceIndex];
-        trigger_button_down_last_frame_[deviceIndex] = triggerDownThisFrame[deviceIndex];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[deviceIndex];
-        enter_button_down_last_frame_[deviceIndex] = enterButtonDownThisFrame[deviceIndex];
-
         Input::RayCastType rayCastType = (Input::RayCastType)i;
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // short press backbutton
         if (inputState[rayCastType].backShortPressed) {
@@ -146,7 +141,7 @@ void OvrSceneCloud::HandleInput() {
         }
 
         // call after pressup.
-        if ( triggerDownThisFrame[deviceIndex] && backButtonDownLastFrame && !backButtonDownThisFrame[deviceIndex] ) {
+        if ( triggerDownThisFrame[deviceIndex] && inputState[rayCastType].backShortPressed ) {
             LOGV("close app." );
             if (Application::instance()->ui_mode() == Application::ApplicationUIMode_Opengles_3D &&
                 lark::AppListTask::run_mode() == lark::GetVrClientRunMode::ClientRunMode::CLIENT_RUNMODE_SELF) {
@@ -308,6 +303,8 @@ bool OvrSceneCloud::Render(ovrMobile *ovr, const larkxrTrackingFrame &trackingFr
     glm::vec3 trackingAng = glm::eulerAngles(hmdPose.rotation.toGlm());
     float degree = glm::degrees(renderAng.y - trackingAng.y);
     lark::XRLatencyCollector::Instance().Submit(trackingFrame.frameIndex, degree);
+    Application::instance()->prediction_horizon().OnSubmit(trackingFrame.frameIndex,
+                                                           Application::instance()->frame_pacer().ready_ns());
 
     // Hand over the eye images to the time warp.
     vrapi_SubmitFrame2( ovr, &frameDesc );
@@ -375,6 +372,14 @@ void OvrSceneCloud::OnMenuViewSelect(bool submit) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void OvrSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void OvrSceneCloud::ShowMenu() {
     LOGV("show menu");
     fake_hmd_->set_transform(lark::Transform(device_pair_frame_.devicePair.hmdPose.rotation.toGlm(),
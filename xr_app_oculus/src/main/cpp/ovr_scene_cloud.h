@@ -12,6 +12,9 @@
 #include "ui/loading/loading.h"
 #include "rect_texture.h"
 #include "ui/menu_view.h"
+#ifdef ENABLE_PERF_HUD
+#include "ui/perf_hud.h"
+#endif
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
 #endif
@@ -47,6 +50,9 @@ public:
     inline larkxrTrackingDevicePairFrame device_pair_frame() { return device_pair_frame_; }
 
     virtual void OnMenuViewSelect(bool submit) override;
+#ifdef ENABLE_PERF_HUD
+    virtual void OnMenuViewToggleHud() override;
+#endif
 
 #ifdef ENABLE_CLOUDXR
     void SetCloudXRClient(const std::shared_ptr<CloudXRClient>& client);
@@ -61,16 +67,15 @@ private:
 
     larkxrDevicePair GetDevicePair(ovrMobile *ovr, double preditTime);
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<lark::SkyBox> sky_box_;
     std::shared_ptr<Loading> loading_;
     std::shared_ptr<lark::Controller> controller_left_;
     std::shared_ptr<lark::Controller> controller_right_;
     std::shared_ptr<lark::Object> fake_hmd_;
     std::shared_ptr<MenuView> menu_view_;
+#ifdef ENABLE_PERF_HUD
+    std::shared_ptr<PerfHud> perf_hud_;
+#endif
 
     std::shared_ptr<RectTexture> rect_texture_{};
     larkxrTrackingDevicePairFrame device_pair_frame_{};
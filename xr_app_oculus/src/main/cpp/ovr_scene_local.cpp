@@ -143,21 +143,7 @@ bool OvrSceneLocal::HandleInput(ovrMobile * ovr) {
                 lark::XRClient::SetControlerBatteryLevel(isLeft, trackedRemoteState.BatteryPercentRemaining);
             }
 
-            bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-            back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-            bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-            trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-            bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-            enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-            inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-            inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-            inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-            inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-            inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-            inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+            Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
 //             call after pressup.
             if ( inputState[rayCastType].backShortPressed)
@@ -22,6 +22,16 @@
 #define GL_FRAMEBUFFER_SRGB_EXT 0x8DB9
 #endif
 
+// GL_OVR_multiview, GL_OVR_multiview_multisampled_render_to_texture
+typedef void(*PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR)(GLenum, GLenum, GLuint, GLint, GLint, GLsizei);
+typedef void(*PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVR)(GLenum, GLenum, GLuint, GLint, GLsizei, GLint, GLsizei);
+
+namespace {
+    const int MULTIVIEW_LAYERS = 2;
+    PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR glFramebufferTextureMultiviewOVR = NULL;
+    PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVR glFramebufferTextureMultisampleMultiviewOVR = NULL;
+}
+
 namespace oxr {
 FrameBuffer::FrameBuffer() {
 
@@ -32,7 +42,7 @@ FrameBuffer::~FrameBuffer() {
 }
 
 bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int width,
-                         const int height, const int multisamples) {
+                         const int height, const int multisamples, bool multiview, bool foveation) {
     PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT =
             (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)eglGetProcAddress(
                     "glRenderbufferStorageMultisampleEXT");
@@ -43,6 +53,20 @@ bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int
     width_ = width;
     height_ = height;
     multi_samples_ = multisamples;
+    multiview_ = multiview;
+    layer_frame_buffers_ = NULL;
+    stream_ = false;
+
+    if (multiview_) {
+        glFramebufferTextureMultiviewOVR = (PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVR)eglGetProcAddress(
+                "glFramebufferTextureMultiviewOVR");
+        glFramebufferTextureMultisampleMultiviewOVR = (PFNGLFRAMEBUFFERTEXTUREMULTISAMPLEMULTIVIEWOVR)eglGetProcAddress(
+                "glFramebufferTextureMultisampleMultiviewOVR");
+        if (glFramebufferTextureMultiviewOVR == NULL) {
+            ALOGE("Failed to get proc address for glFramebufferTextureMultiviewOVR");
+            return false;
+        }
+    }
 
     GLenum requestedGLFormat = colorFormat;
 
@@ -86,15 +110,14 @@ bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int
     swapChainCreateInfo.width = width;
     swapChainCreateInfo.height = height;
     swapChainCreateInfo.faceCount = 1;
-    swapChainCreateInfo.arraySize = 1;
+    swapChainCreateInfo.arraySize = multiview_ ? MULTIVIEW_LAYERS : 1;
     swapChainCreateInfo.mipCount = 1;
 
     // Enable Foveation on this swapchain
-//    XrSwapchainCreateInfoFoveationFB swapChainFoveationCreateInfo;
-//    memset(&swapChainFoveationCreateInfo, 0, sizeof(swapChainFoveationCreateInfo));
-//    swapChainFoveationCreateInfo.type = XR_TYPE_SWAPCHAIN_CREATE_INFO_FOVEATION_FB;
-//    swapChainCreateInfo.next = &swapChainFoveationCreateInfo;
-    swapChainCreateInfo.next = NULL;
+    XrSwapchainCreateInfoFoveationFB swapChainFoveationCreateInfo;
+    memset(&swapChainFoveationCreateInfo, 0, sizeof(swapChainFoveationCreateInfo));
+    swapChainFoveationCreateInfo.type = XR_TYPE_SWAPCHAIN_CREATE_INFO_FOVEATION_FB;
+    swapChainCreateInfo.next = foveation ? &swapChainFoveationCreateInfo : NULL;
 
     color_swapchain_.Width = swapChainCreateInfo.width;
     color_swapchain_.Height = swapChainCreateInfo.height;
@@ -123,11 +146,24 @@ bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int
             (GLuint*)malloc(texture_swapchain_length_ * sizeof(GLuint));
     frame_buffers_ =
             (GLuint*)malloc(texture_swapchain_length_ * sizeof(GLuint));
+    if (multiview_) {
+        layer_frame_buffers_ =
+                (GLuint*)malloc(texture_swapchain_length_ * MULTIVIEW_LAYERS * sizeof(GLuint));
+    }
+    stream_frame_buffers_ =
+            (GLuint*)malloc(texture_swapchain_length_ * sizeof(GLuint));
 
     for (uint32_t i = 0; i < texture_swapchain_length_; i++) {
         // Create the color buffer texture.
         const GLuint colorTexture = color_swapchain_image_[i].image;
 
+        if (multiview_) {
+            if (!CreateMultiview(colorTexture, i) || !CreateStream(colorTexture, i)) {
+                return false;
+            }
+            continue;
+        }
+
         GLenum colorTextureTarget = GL_TEXTURE_2D;
         GL(glBindTexture(colorTextureTarget, colorTexture));
         GL(glTexParameteri(colorTextureTarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
@@ -195,6 +231,10 @@ bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int
                 return false;
             }
         }
+
+        if (!CreateStream(colorTexture, i)) {
+            return false;
+        }
     }
 
     // hack color space
@@ -204,16 +244,105 @@ bool FrameBuffer::Create(XrSession session, const GLenum colorFormat, const int
     return true;
 }
 
+bool FrameBuffer::CreateMultiview(GLuint colorTexture, int index) {
+    GL(glBindTexture(GL_TEXTURE_2D_ARRAY, colorTexture));
+    GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GL(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    // depth texture with the same layers as color.
+    GL(glGenTextures(1, &depth_buffers_[index]));
+    GL(glBindTexture(GL_TEXTURE_2D_ARRAY, depth_buffers_[index]));
+    GL(glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT24, width_, height_, MULTIVIEW_LAYERS));
+    GL(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    bool msaa = multi_samples_ > 1 && glFramebufferTextureMultisampleMultiviewOVR != NULL;
+    // first the fbo with all layers, then one fbo per layer.
+    for (int view = -1; view < MULTIVIEW_LAYERS; view++) {
+        GLuint* fbo = view < 0 ? &frame_buffers_[index] : &layer_frame_buffers_[index * MULTIVIEW_LAYERS + view];
+        GLint baseView = view < 0 ? 0 : view;
+        GLsizei numViews = view < 0 ? MULTIVIEW_LAYERS : 1;
+        GL(glGenFramebuffers(1, fbo));
+        GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, *fbo));
+        if (msaa) {
+            GL(glFramebufferTextureMultisampleMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                    depth_buffers_[index], 0, multi_samples_, baseView, numViews));
+            GL(glFramebufferTextureMultisampleMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                    colorTexture, 0, multi_samples_, baseView, numViews));
+        } else {
+            GL(glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                    depth_buffers_[index], 0, baseView, numViews));
+            GL(glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                    colorTexture, 0, baseView, numViews));
+        }
+        GL(GLenum renderFramebufferStatus = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER));
+        GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
+        if (renderFramebufferStatus != GL_FRAMEBUFFER_COMPLETE) {
+            ALOGE(
+                    "Incomplete multiview frame buffer object: %s",
+                    GlFrameBufferStatusString(renderFramebufferStatus));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameBuffer::CreateStream(GLuint colorTexture, int index) {
+    GL(glGenFramebuffers(1, &stream_frame_buffers_[index]));
+    GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, stream_frame_buffers_[index]));
+    if (multiview_) {
+        GL(glFramebufferTextureMultiviewOVR(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                colorTexture, 0, 0, MULTIVIEW_LAYERS));
+    } else {
+        GL(glFramebufferTexture2D(
+                GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0));
+    }
+    GL(GLenum renderFramebufferStatus = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER));
+    GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
+    if (renderFramebufferStatus != GL_FRAMEBUFFER_COMPLETE) {
+        ALOGE(
+                "Incomplete stream frame buffer object: %s",
+                GlFrameBufferStatusString(renderFramebufferStatus));
+        return false;
+    }
+    return true;
+}
+
 void FrameBuffer::SetCurrent() {
+    stream_ = false;
     GL(glBindFramebuffer(
             GL_DRAW_FRAMEBUFFER, frame_buffers_[texture_swapchain_index_]));
 }
 
+void FrameBuffer::SetCurrentLayer(int layer) {
+    if (!multiview_) {
+        SetCurrent();
+        return;
+    }
+    stream_ = false;
+    GL(glBindFramebuffer(
+            GL_DRAW_FRAMEBUFFER, layer_frame_buffers_[texture_swapchain_index_ * MULTIVIEW_LAYERS + layer]));
+}
+
+void FrameBuffer::SetCurrentStream() {
+    stream_ = true;
+    GL(glBindFramebuffer(
+            GL_DRAW_FRAMEBUFFER, stream_frame_buffers_[texture_swapchain_index_]));
+    // tiler skips loading the last frame.
+    const GLenum colorAttachment[1] = {GL_COLOR_ATTACHMENT0};
+    GL(glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, 1, colorAttachment));
+}
+
 void FrameBuffer::SetNone() {
     GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0));
 }
 
 void FrameBuffer::Resolve() {
+    if (stream_) {
+        return;
+    }
     // Discard the depth buffer, so the tiler won't need to write it back out to memory.
     const GLenum depthAttachment[1] = {GL_DEPTH_ATTACHMENT};
     glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, 1, depthAttachment);
@@ -260,16 +389,28 @@ void FrameBuffer::Clear() {
     color_swapchain_image_ = NULL;
     depth_buffers_ = NULL;
     frame_buffers_ = NULL;
+    multiview_ = false;
+    layer_frame_buffers_ = NULL;
+    stream_frame_buffers_ = NULL;
+    stream_ = false;
 }
 
 void FrameBuffer::Destroy() {
     GL(glDeleteFramebuffers(texture_swapchain_length_, frame_buffers_));
-    GL(glDeleteRenderbuffers(texture_swapchain_length_, depth_buffers_));
+    GL(glDeleteFramebuffers(texture_swapchain_length_, stream_frame_buffers_));
+    if (multiview_) {
+        GL(glDeleteFramebuffers(texture_swapchain_length_ * MULTIVIEW_LAYERS, layer_frame_buffers_));
+        GL(glDeleteTextures(texture_swapchain_length_, depth_buffers_));
+        free(layer_frame_buffers_);
+    } else {
+        GL(glDeleteRenderbuffers(texture_swapchain_length_, depth_buffers_));
+    }
     OXR(xrDestroySwapchain(color_swapchain_.Handle));
     free(color_swapchain_image_);
 
     free(depth_buffers_);
     free(frame_buffers_);
+    free(stream_frame_buffers_);
 
     Clear();
 }
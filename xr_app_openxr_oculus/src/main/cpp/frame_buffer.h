@@ -27,9 +27,18 @@ public:
     FrameBuffer();
     ~FrameBuffer();
 
-    bool Create(XrSession session, const GLenum colorFormat, const int width, const int height, const int multisamples);
+    // multiview: one swapchain with an array layer per eye for both eyes.
+    // foveation: swapchain accepts XR_FB_foveation profiles, needs XR_FB_swapchain_update_state.
+    bool Create(XrSession session, const GLenum colorFormat, const int width, const int height, const int multisamples,
+                bool multiview = false, bool foveation = false);
 
+    // multiview swapchain renders both layers in one pass.
     void SetCurrent();
+    // render one layer of multiview swapchain, for objects can not draw multiview.
+    void SetCurrentLayer(int layer);
+    // color only single sample target for a full screen copy of the cloud frame, both layers when multiview.
+    // every pixel is overwritten, so old contents are invalidated instead of cleared.
+    void SetCurrentStream();
     void SetNone();
     void Resolve();
     void Acquire();
@@ -41,6 +50,7 @@ public:
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
+    inline bool multiview() const { return multiview_; }
     inline const ovrSwapChain color_swapchain() const { return color_swapchain_;}
 private:
     int width_;
@@ -52,6 +62,18 @@ private:
     XrSwapchainImageOpenGLESKHR* color_swapchain_image_;
     GLuint* depth_buffers_;
     GLuint* frame_buffers_;
+
+    // multiview. depth_buffers_ are 2d array textures.
+    bool CreateMultiview(GLuint colorTexture, int index);
+    bool multiview_ = false;
+    // one per layer of each swapchain image.
+    GLuint* layer_frame_buffers_ = nullptr;
+
+    // no depth, no msaa.
+    bool CreateStream(GLuint colorTexture, int index);
+    GLuint* stream_frame_buffers_ = nullptr;
+    // stream frame buffer bound, nothing to discard on resolve.
+    bool stream_ = false;
 };
 }
 
@@ -11,6 +11,7 @@
 #include "openxr_context.h"
 #include "openxr/openxr_oculus_helpers.h"
 #include "log.h"
+#include "multiview.h"
 
 #define GL_FRAMEBUFFER_SRGB               0x8DB9
 
@@ -389,6 +390,10 @@ void OpenxrContext::CreateSwapchains() {
     // https://forums.oculusvr.com/t5/OpenXR-Development/sRGB-RGB-giving-washed-out-bright-image/m-p/957475
     glDisable(GL_FRAMEBUFFER_SRGB);
 
+    // one swapchain with a layer per eye when single pass stereo supported.
+    multiview_ = lark::Multiview::instance()->Enable();
+    LOGV("use multiview %d", multiview_);
+
     for (int eye = 0; eye < ovrMaxNumEyes; eye++) {
         // TODO config render width
         // Screen Refresh Rate
@@ -414,18 +419,18 @@ void OpenxrContext::CreateSwapchains() {
                                   GL_SRGB8_ALPHA8,
                                   view_configuration_view_[eye].recommendedImageRectWidth,
                                   view_configuration_view_[eye].recommendedImageRectHeight,
-                                  NUM_MULTI_SAMPLES);
+                                  NUM_MULTI_SAMPLES,
+                                  multiview_,
+                                  foveation_supported());
+        if (multiview_) {
+            break;
+        }
     }
 
     // init views
     // Create and cache view buffer for xrLocateViews later.
     // TODO get view count
     views_.resize(ovrMaxNumEyes, {XR_TYPE_VIEW});
-
-    // Test set fov.
-//    SetFoveation(XR_FOVEATION_LEVEL_NONE_FB,
-//                 0,
-//                 XR_FOVEATION_DYNAMIC_DISABLED_FB);
 }
 
 void OpenxrContext::InitSpace() {
@@ -757,8 +762,8 @@ void OpenxrContext::HandleSessionStateChanges(XrSessionState state) {
 void OpenxrContext::Destory() {
     input_state_ = {};
 
-    for (auto & i : frame_buffer_) {
-        i.Destroy();
+    for (int i = 0; i < frame_buffer_count(); i++) {
+        frame_buffer_[i].Destroy();
     }
 
     graphics_plugin_->DestroyContext();
@@ -775,7 +780,12 @@ void OpenxrContext::Destory() {
 
 void OpenxrContext::SetFoveation(XrFoveationLevelFB level, float verticalOffset,
                                  XrFoveationDynamicFB dynamic) {
-    for (int eye = 0; eye < ovrMaxNumEyes; eye++) {
+    if (!foveation_supported()) {
+        ALOGE("foveation not supported");
+        return;
+    }
+    ALOGV("set foveation level %d dynamic %d", level, dynamic);
+    for (int eye = 0; eye < frame_buffer_count(); eye++) {
         XrFoveationLevelProfileCreateInfoFB levelProfileCreateInfo;
         memset(&levelProfileCreateInfo, 0, sizeof(levelProfileCreateInfo));
         levelProfileCreateInfo.type = XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB;
@@ -788,9 +798,13 @@ void OpenxrContext::SetFoveation(XrFoveationLevelFB level, float verticalOffset,
         profileCreateInfo.type = XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB;
         profileCreateInfo.next = &levelProfileCreateInfo;
 
-        XrFoveationProfileFB foveationProfile;
+        XrFoveationProfileFB foveationProfile = XR_NULL_HANDLE;
 
-        pfnCreateFoveationProfileFB(session_, &profileCreateInfo, &foveationProfile);
+        XrResult result = pfnCreateFoveationProfileFB(session_, &profileCreateInfo, &foveationProfile);
+        if (XR_FAILED(result)) {
+            ALOGE("create foveation profile failed %d", result);
+            return;
+        }
 
         XrSwapchainStateFoveationFB foveationUpdateState;
         memset(&foveationUpdateState, 0, sizeof(foveationUpdateState));
@@ -798,7 +812,7 @@ void OpenxrContext::SetFoveation(XrFoveationLevelFB level, float verticalOffset,
         foveationUpdateState.profile = foveationProfile;
 
         pfnUpdateSwapchainFB(
-                frame_buffer_[eye].color_swapchain().Handle,
+                frame_buffer(eye).color_swapchain().Handle,
                 (XrSwapchainStateBaseHeaderFB*)(&foveationUpdateState));
 
         pfnDestroyFoveationProfileFB(foveationProfile);
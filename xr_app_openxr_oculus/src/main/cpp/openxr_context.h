@@ -50,9 +50,13 @@ public:
     float GetCurrentDisplayRefreshRate();
     void SetDisplayRefreshRate(float fps);
     void SetColorSpace(XrColorSpaceFB colorSpaceFB);
+    // apply a foveation profile to the eye swapchains, takes effect on next acquired image.
     void SetFoveation(XrFoveationLevelFB level,
                       float verticalOffset,
                       XrFoveationDynamicFB dynamic);
+    inline bool foveation_supported() const {
+        return pfnCreateFoveationProfileFB != nullptr && pfnDestroyFoveationProfileFB != nullptr && pfnUpdateSwapchainFB != nullptr;
+    }
 
     inline void set_resumed(bool resumed) { resumed_ = resumed; }
     inline bool resumed() { return resumed_; }
@@ -67,7 +71,11 @@ public:
     inline const XrSpace& head_space() const { return head_space_; }
     inline XrSystemId system_id() { return system_id_; }
     inline FrameBuffer* frame_buffer() { return frame_buffer_; }
-    inline FrameBuffer& frame_buffer(int eye) { return frame_buffer_[eye]; }
+    // both eyes share frame_buffer_[0] in multiview mode.
+    inline FrameBuffer& frame_buffer(int eye) { return frame_buffer_[multiview_ ? 0 : eye]; }
+    inline int frame_buffer_count() const { return multiview_ ? 1 : ovrMaxNumEyes; }
+    // single pass stereo, eye index is the layer of swapchain.
+    inline bool multiview() const { return multiview_; }
 
     inline XrViewConfigurationProperties viewport_config() { return viewport_config_; }
 
@@ -118,11 +126,12 @@ private:
     PFN_xrSetColorSpaceFB pfnxrSetColorSpaceFB = nullptr;
     PFN_xrCreateFoveationProfileFB pfnCreateFoveationProfileFB = nullptr;
     PFN_xrDestroyFoveationProfileFB pfnDestroyFoveationProfileFB = nullptr;
-    PFN_xrUpdateSwapchainFB pfnUpdateSwapchainFB;
+    PFN_xrUpdateSwapchainFB pfnUpdateSwapchainFB = nullptr;
 
     std::unique_ptr<GraphicsDeviceAndroid> graphics_plugin_;
     InputState input_state_;
     FrameBuffer frame_buffer_[ovrMaxNumEyes];
+    bool multiview_ = false;
 
     // state
     bool resumed_ = false;
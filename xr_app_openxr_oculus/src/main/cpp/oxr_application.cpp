@@ -5,6 +5,10 @@
 
 #include <env_context.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
+#include <program_cache.h>
+#include <multiview.h>
 #include <lark_xr/xr_latency_collector.h>
 #include "oxr_application.h"
 
@@ -14,6 +18,29 @@
 
 namespace {
     const float CLOUD_LOCALSPACE_HEIGHT_OFFSET = 1.5f;
+
+    void GetFoveationLevel(Application::Foveation foveation, XrFoveationLevelFB* level, XrFoveationDynamicFB* dynamic) {
+        *dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+        switch (foveation) {
+            case Application::Foveation_Low:
+                *level = XR_FOVEATION_LEVEL_LOW_FB;
+                break;
+            case Application::Foveation_Medium:
+                *level = XR_FOVEATION_LEVEL_MEDIUM_FB;
+                break;
+            case Application::Foveation_High:
+                *level = XR_FOVEATION_LEVEL_HIGH_FB;
+                break;
+            case Application::Foveation_Dynamic:
+                // level is the upper bound in dynamic mode.
+                *level = XR_FOVEATION_LEVEL_HIGH_FB;
+                *dynamic = XR_FOVEATION_DYNAMIC_LEVEL_ENABLED_FB;
+                break;
+            default:
+                *level = XR_FOVEATION_LEVEL_NONE_FB;
+                break;
+        }
+    }
 }
 
 namespace oxr {
@@ -27,6 +54,9 @@ OxrApplication::~OxrApplication() {
 
 bool OxrApplication::InitGL(OpenxrContext *context) {
     context_ = context;
+    init_gl_time_ns_ = utils::GetTimestampNs();
+    first_frame_logged_ = false;
+    assets_ready_logged_ = false;
 
     // 初始化客户端接入凭证
     InitCertificate();
@@ -49,6 +79,9 @@ bool OxrApplication::InitGL(OpenxrContext *context) {
         lark::XRConfig::use_multiview = true;
     }
 
+    // swapchains created, apply current level.
+    SetupFoveation(foveation_);
+
     xr_client_.reset();
     xr_client_ = std::make_shared<lark::XRClient>();
 
@@ -72,7 +105,8 @@ bool OxrApplication::InitGL(OpenxrContext *context) {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&asset_context, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&asset_context, Assetlist);
 
     scene_local_ = std::make_shared<XrSceneLocal>();
     scene_local_->InitGL();
@@ -115,7 +149,11 @@ void OxrApplication::ShutdownGL() {
 
     // reset all state.
     Input::ResetInput();
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
+    lark::Multiview::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
 
     Application::ShutdownGL();
 }
@@ -156,6 +194,10 @@ void OxrApplication::RenderFrame() {
     bool has_new_frame_pxy_stream = false;
     bool has_new_frame_cloudxr = false;
 
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
+
 #ifdef ENABLE_CLOUDXR
     if (need_recreat_cloudxr_client_) {
         cloudxr_client_->Init();
@@ -192,16 +234,11 @@ void OxrApplication::RenderFrame() {
 
         {
             uint64_t frameIndex = latched.poseID;
-            std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-            auto it = tracking_frame_map_.find(frameIndex);
-            if (it != tracking_frame_map_.end()) {
-                trackingFrame = it->second;
-            } else {
-                if (!tracking_frame_map_.empty()) {
-                    LOGW("cant find new tracking frame in map. use old. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
-                    trackingFrame = tracking_frame_map_.cbegin()->second;
+            if (!pose_history_.Find(frameIndex, &trackingFrame)) {
+                if (pose_history_.Latest(&trackingFrame)) {
+                    LOGW("cant find tracking frame in history. use latest %ld; index %ld", trackingFrame.frameIndex, frameIndex);
                 } else {
-                    LOGW("cant find tracking frame in map. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
+                    LOGW("cant find tracking frame in history. count %ld; index %ld", pose_history_.count(), frameIndex);
                     return;
                 }
             }
@@ -218,6 +255,10 @@ void OxrApplication::RenderFrame() {
     // LOGV("cloudmedia_ready %d", cloudmedia_ready);
 
     if (!has_new_frame_cloudxr && xr_client_->is_connected()) {
+        // block until new cloud frame or the deadline before next vsync.
+        if (cloudmedia_ready) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
+        }
         has_new_frame_pxy_stream = xr_client_->Render(&trackingFrame, &xrVideoFrame);
 
         // LOGV("cloudmedia_ready %d has_new_frame_pxy_stream %d", cloudmedia_ready, has_new_frame_pxy_stream);
@@ -225,7 +266,7 @@ void OxrApplication::RenderFrame() {
         // wait for cloud frame
         if (cloudmedia_ready && !has_new_frame_pxy_stream) {
 //            LOGV("wait for new frame");
-            usleep(1000);
+            // deadline passed. submit nothing, compositor reprojects last frame.
             return;
         }
         if (has_new_frame_pxy_stream) {
@@ -249,6 +290,7 @@ void OxrApplication::RenderFrame() {
     frameState.next = NULL;
 
     OXR(xrWaitFrame(context_->session(), &waitFrameInfo, &frameState));
+    frame_pacer_.SetDisplayTiming(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
 
     // Get the HMD pose, predicted for the middle of the time period during which
     // the new eye images will be displayed. The number of frames predicted ahead
@@ -281,6 +323,11 @@ void OxrApplication::RenderFrame() {
     endFrameInfo.layerCount = layers.size();
     endFrameInfo.layers = layers.data();
     xrEndFrame(context_->session(), &endFrameInfo);
+    frame_pacer_.FrameEnd();
+
+    if (!layers.empty() && !xr_client_->is_connected()) {
+        LogStartupTime();
+    }
 
 #ifdef USE_RENDER_QUEUE
     if (has_new_frame_pxy_stream) {
@@ -296,12 +343,14 @@ void OxrApplication::RenderFrame() {
         float degree = glm::degrees(renderAng.y - trackingAng.y);
 
         lark::XRLatencyCollector::Instance().Submit(trackingFrame.frameIndex, degree);
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         xr_client_->ReleaseRenderTexture();
     }
 #endif
 
 #ifdef ENABLE_CLOUDXR
     if (has_new_frame_cloudxr) {
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         cloudxr_client_->Release();
         cloudxr_client_->Stats();
     }
@@ -392,7 +441,7 @@ bool OxrApplication::RenderLayer(XrTime predictedDisplayTime,
     projection_layer.views = projectionLayerViews.data();
 
     for (int eye = 0; eye < oxr::OpenxrContext::ovrMaxNumEyes; eye++) {
-        oxr::FrameBuffer frameBuffer = context_->frame_buffer(eye);
+        oxr::FrameBuffer& frameBuffer = context_->frame_buffer(eye);
 
         memset(
                 &projectionLayerViews[eye], 0, sizeof(XrCompositionLayerProjectionView));
@@ -417,8 +466,12 @@ bool OxrApplication::RenderLayer(XrTime predictedDisplayTime,
                 frameBuffer.color_swapchain().Width;
         projectionLayerViews[eye].subImage.imageRect.extent.height =
                 frameBuffer.color_swapchain().Height;
-        projectionLayerViews[eye].subImage.imageArrayIndex = 0;
+        // multiview swapchain has one layer per eye.
+        projectionLayerViews[eye].subImage.imageArrayIndex = context_->multiview() ? eye : 0;
 
+        if (context_->multiview()) {
+            continue;
+        }
         if (xr_client_->is_connected()) {
             scene_cloud_->Render((lark::Object::Eye)eye, projectionLayerViews[eye], frameBuffer);
         } else {
@@ -427,11 +480,37 @@ bool OxrApplication::RenderLayer(XrTime predictedDisplayTime,
 
     }
 
+    // both eyes after all views filled.
+    if (context_->multiview()) {
+        if (xr_client_->is_connected()) {
+            scene_cloud_->RenderMultiview(projectionLayerViews.data(), context_->frame_buffer(0));
+        } else {
+            scene_local_->RenderMultiview(projectionLayerViews.data(), context_->frame_buffer(0));
+        }
+    }
+
     layer = projection_layer;
 
     return true;
 }
 
+void OxrApplication::LogStartupTime() {
+    uint64_t elapsedMs = (utils::GetTimestampNs() - init_gl_time_ns_) / 1000000;
+    if (!first_frame_logged_) {
+        first_frame_logged_ = true;
+        LOGI("startup first home frame %llu ms", static_cast<unsigned long long>(elapsedMs));
+    }
+    if (!assets_ready_logged_ && lark::AssetLoader::instance()->pending() == 0) {
+        assets_ready_logged_ = true;
+        LOGI("startup assets ready %llu ms", static_cast<unsigned long long>(elapsedMs));
+        lark::ProgramCache* programCache = lark::ProgramCache::instance();
+        LOGI("startup programs from cache %llu %.2f ms; compiled %llu %.2f ms; rejected %llu",
+             static_cast<unsigned long long>(programCache->loaded()), programCache->load_ms(),
+             static_cast<unsigned long long>(programCache->compiled()), programCache->compile_ms(),
+             static_cast<unsigned long long>(programCache->rejected()));
+    }
+}
+
 void OxrApplication::OnConnected() {
     Application::OnConnected();
     connected_ = true;
@@ -603,13 +682,7 @@ void OxrApplication::GetTrackingState(cxrVRTrackingState *state) {
         frame.fetchTime = devicePairFrame.fetchTime;
         frame.displayTime = devicePairFrame.displayTime;
         frame.tracking = devicePairFrame.devicePair.hmdPose;
-        // unique_ptr
-        std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-        tracking_frame_map_.insert(
-                std::pair<uint64_t, larkxrTrackingFrame>(frame.frameIndex, frame));
-        if (tracking_frame_map_.size() > MAXIMUM_TRACKING_FRAMES) {
-            tracking_frame_map_.erase(tracking_frame_map_.cbegin());
-        }
+        pose_history_.Push(frame);
     }
 
     *state = CloudXRClient::VRTrackingStateFrom(devicePairFrame);
@@ -622,12 +695,14 @@ bool OxrApplication::GetViewTransform(const XrSpace& space,
                                       const XrTime& predictedDisplayTime,
                                       XrPosef *viewTransform,
                                       int viewTransformCount,
-                                      XrPosef* xfStageFromHead) {
+                                      XrPosef* xfStageFromHead,
+                                      XrSpaceVelocity* headVelocity) {
     // only support view count 2
     assert(viewTransformCount == oxr::OpenxrContext::ovrMaxNumEyes);
 
     XrSpaceLocation loc = {};
     loc.type = XR_TYPE_SPACE_LOCATION;
+    loc.next = headVelocity;
 
     // get head pose
     OXR(xrLocateSpace(
@@ -696,6 +771,22 @@ void OxrApplication::SetupSapce(Space space) {
     current_cloud_space_ = space;
 }
 
+void OxrApplication::SetupFoveation(Foveation foveation) {
+    Application::SetupFoveation(foveation);
+    if (!SupportFoveation()) {
+        LOGW("request foveation[%d] not support", foveation);
+        return;
+    }
+    XrFoveationLevelFB level = XR_FOVEATION_LEVEL_NONE_FB;
+    XrFoveationDynamicFB dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+    GetFoveationLevel(foveation, &level, &dynamic);
+    context_->SetFoveation(level, 0, dynamic);
+}
+
+bool OxrApplication::SupportFoveation() {
+    return context_ != nullptr && context_->foveation_supported();
+}
+
 void OxrApplication::SetupSkyBox(int index) {
     Application::SetupSkyBox(index);
     // sync skybox
@@ -705,12 +796,15 @@ void OxrApplication::SetupSkyBox(int index) {
 }
 bool OxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& trackingDevicePairFrame) {
     uint64_t now = utils::GetTimestampNs();
-    XrTime predictedDisplayTime = now + 1000 * 1000 * 40;
+    XrTime predictedDisplayTime = now + prediction_horizon_.horizon_ns();
+    // runtime predicts to display time itself, or sample now and extrapolate by pose filter.
+    XrTime sampleTime = pose_filter_.sample_at_display_time() ? predictedDisplayTime : now;
     XrSpace space = GetSelectedXRSpace();
     XrPosef xfStageFromHead = {};
     XrPosef viewTransform[oxr::OpenxrContext::ovrMaxNumEyes];
+    XrSpaceVelocity headVelocity = {XR_TYPE_SPACE_VELOCITY};
 
-    if (!GetViewTransform(space, predictedDisplayTime, viewTransform, oxr::OpenxrContext::ovrMaxNumEyes, &xfStageFromHead)) {
+    if (!GetViewTransform(space, sampleTime, viewTransform, oxr::OpenxrContext::ovrMaxNumEyes, &xfStageFromHead, &headVelocity)) {
         return {};
     }
 
@@ -736,6 +830,13 @@ bool OxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& tra
         pose.eye[i].viewRotation = toGlm(viewTransform[i].orientation);
     }
 
+    bool hasVelocity = (headVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) &&
+                       (headVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT);
+    if (hasVelocity) {
+        pose.velocity = toGlm(headVelocity.linearVelocity);
+        pose.angularVelocity = toGlm(headVelocity.angularVelocity);
+    }
+
     larkxrDevicePair devicePair = {};
     devicePair.hmdPose = pose;
 
@@ -751,8 +852,11 @@ bool OxrApplication::UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& tra
         devicePair.controllerState[1].pose.position.y += CLOUD_LOCALSPACE_HEIGHT_OFFSET;
     }
 
+    pose_filter_.Apply(&devicePair, sampleTime, predictedDisplayTime, hasVelocity);
+
     static uint64_t frame_index = 0;
     frame_index++;
+    prediction_horizon_.OnTracking(frame_index);
 
     trackingDevicePairFrame = {
             frame_index,
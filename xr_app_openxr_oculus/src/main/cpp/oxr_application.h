@@ -9,6 +9,7 @@
 #include <android_native_app_glue.h>
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
+#include <pose_history.h>
 #endif
 #include "utils.h"
 #include "xr_scene_local.h"
@@ -53,6 +54,11 @@ public:
     virtual void SetupSapce(Space space) override;
     // ui 设置天空盒, 更新场景中的天空盒
     virtual void SetupSkyBox(int index) override;
+    // ui 设置本地注视点渲染等级, XR_FB_foveation
+    virtual void SetupFoveation(Foveation foveation) override;
+    virtual bool SupportFoveation() override;
+    // 发送前用 XrSpaceVelocity 填充速度, 可选客户端外推
+    virtual bool SupportPoseFilter() override { return true; };
 
     //
     // xr client callback
@@ -88,10 +94,14 @@ private:
                                  const XrTime& predictedDisplayTime,
                                  XrPosef *viewTransform,
                                  int viewTransformCount,
-                                 XrPosef* xfStageFromHead);
+                                 XrPosef* xfStageFromHead,
+                                 XrSpaceVelocity* headVelocity = nullptr);
 
     bool UpdateCloudTrackingState(larkxrTrackingDevicePairFrame& trackingDevicePairFrame);
 
+    // time from InitGL to the first home frame and to all assets loaded.
+    void LogStartupTime();
+
     inline XrSpace GetSelectedXRSpace() { return current_cloud_space_ == Space_Local ? context_->local_space() : context_->app_space(); }
 
     OpenxrContext* context_ = nullptr;
@@ -103,10 +113,8 @@ private:
     std::shared_ptr<XrSceneCloud> scene_cloud_ = {};
 
 #ifdef ENABLE_CLOUDXR
-    static const int MAXIMUM_TRACKING_FRAMES = 50;
-    typedef std::map<uint64_t, larkxrTrackingFrame> TRACKING_FRAME_MAP;
-    TRACKING_FRAME_MAP tracking_frame_map_{};
-    std::mutex tracking_frame_mutex_{};
+    // pushed by cloudxr tracking thread, read by render thread when frame latched.
+    PoseHistory pose_history_{};
 
     uint64_t pre_controller_state[2] = {};
     std::shared_ptr<CloudXRClient> cloudxr_client_ = nullptr;
@@ -117,6 +125,10 @@ private:
 
     bool config_inited_ = false;
 
+    uint64_t init_gl_time_ns_ = 0;
+    bool first_frame_logged_ = false;
+    bool assets_ready_logged_ = false;
+
     Space current_cloud_space_ = Space_Local;
 };
 }
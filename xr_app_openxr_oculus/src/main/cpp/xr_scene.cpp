@@ -4,6 +4,9 @@
 //
 
 #include <openxr/openxr_oculus_helpers.h>
+#include <multiview.h>
+#include <render_state.h>
+#include "telemetry.h"
 #include "xr_scene.h"
 
 namespace oxr {
@@ -21,49 +24,155 @@ void XrScene::ReleaseGL() {
 
 void XrScene::Render(lark::Object::Eye eye, const XrCompositionLayerProjectionView &layerView,
                      FrameBuffer &frameBuffer) {
+    PollGpuTimers();
+
     frameBuffer.Acquire();
 
-    frameBuffer.SetCurrent();
+    glm::mat4 g_proj;
+    glm::mat4 g_view;
+    GetMatrices(layerView, &g_proj, &g_view);
+
+    if (UseStreamPass()) {
+        frameBuffer.SetCurrentStream();
+        stream_timer_.Begin();
+        BeginStreamDraw(frameBuffer);
+        DrawStream(eye, g_proj, g_view);
+        stream_timer_.End();
+    } else {
+        frameBuffer.SetCurrent();
+        scene_timer_.Begin();
+        BeginDraw(frameBuffer);
+        for(auto it = objects_.begin(); it != objects_.end(); it ++) {
+            if (it->get()->active()) {
+                it->get()->Draw(eye, g_proj, g_view);
+            }
+        }
+        scene_timer_.End();
+    }
+
+    frameBuffer.Resolve();
+
+    frameBuffer.Release();
+
+    frameBuffer.SetNone();
+}
+
+void XrScene::RenderMultiview(const XrCompositionLayerProjectionView* layerViews, FrameBuffer &frameBuffer) {
+    PollGpuTimers();
+
+    frameBuffer.Acquire();
+
+    glm::mat4 g_proj[lark::Multiview::VIEW_COUNT];
+    glm::mat4 g_view[lark::Multiview::VIEW_COUNT];
+    for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+        GetMatrices(layerViews[eye], &g_proj[eye], &g_view[eye]);
+    }
+
+    if (CanDrawMultiview() && UseStreamPass()) {
+        frameBuffer.SetCurrentStream();
+        stream_timer_.Begin();
+        BeginStreamDraw(frameBuffer);
+        lark::Multiview::instance()->SetSceneMatrices(g_proj, g_view);
+        DrawStreamMultiview(g_proj[0], g_view[0]);
+        stream_timer_.End();
+    } else if (CanDrawMultiview()) {
+        frameBuffer.SetCurrent();
+        scene_timer_.Begin();
+        BeginDraw(frameBuffer);
+        lark::Multiview::instance()->SetSceneMatrices(g_proj, g_view);
+        for (auto & object : objects_) {
+            if (object->active()) {
+                object->DrawMultiview(g_proj[0], g_view[0]);
+            }
+        }
+        scene_timer_.End();
+        frameBuffer.Resolve();
+    } else {
+        scene_timer_.Begin();
+        for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+            frameBuffer.SetCurrentLayer(eye);
+            BeginDraw(frameBuffer);
+            for (auto & object : objects_) {
+                if (object->active()) {
+                    object->Draw((lark::Object::Eye) eye, g_proj[eye], g_view[eye]);
+                }
+            }
+            frameBuffer.Resolve();
+        }
+        scene_timer_.End();
+    }
+
+    frameBuffer.Release();
+
+    frameBuffer.SetNone();
+}
+
+bool XrScene::CanDrawMultiview() {
+    return true;
+}
+
+bool XrScene::UseStreamPass() {
+    return false;
+}
+
+void XrScene::DrawStream(lark::Object::Eye eye, const glm::mat4 &projection, const glm::mat4 &view) {
+}
+
+void XrScene::DrawStreamMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+}
 
+void XrScene::BeginDraw(FrameBuffer &frameBuffer) {
+    lark::RenderState* state = lark::RenderState::instance();
+    // openxr runtime and media decoder may have changed gl state since last frame.
+    state->Invalidate();
     // 开启透明同道混合
-    GL( glEnable(GL_BLEND) );
-    GL( glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) );
-//
-    GL( glEnable(GL_DEPTH_TEST) );
-    GL( glDepthFunc(GL_LEQUAL) );
-    GL( glDepthMask(true) );
+    state->Enable(GL_BLEND);
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    GL(glEnable(GL_SCISSOR_TEST));
-    GL(glDepthMask(GL_TRUE));
-    GL(glEnable(GL_DEPTH_TEST));
+    state->Enable(GL_SCISSOR_TEST);
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
     GL(glDepthFunc(GL_LEQUAL));
-    GL(glDisable(GL_CULL_FACE));
+    state->Disable(GL_CULL_FACE);
     GL( glCullFace( GL_BACK ) );
     GL(glViewport(0, 0, frameBuffer.width(), frameBuffer.height()));
     GL(glScissor(0, 0, frameBuffer.width(), frameBuffer.height()));
     GL(glClearColor(0, 0, 0, 1.0f));
     GL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+}
 
-    XrMatrix4x4f proj;
-    XrMatrix4x4f_CreateProjectionFov(&proj, GRAPHICS_OPENGL_ES, layerView.fov, 0.05f, 100.0f);
-
-    XrPosef pose = XrPosef_Inverse(layerView.pose);
-    XrMatrix4x4f view = XrMatrix4x4f_CreateFromRigidTransform(&pose);
-
-    glm::mat4 g_proj = toGlm(proj);
-    glm::mat4 g_view = toGlm(view);
+void XrScene::BeginStreamDraw(FrameBuffer &frameBuffer) {
+    lark::RenderState* state = lark::RenderState::instance();
+    state->Invalidate();
+    // state left by scene pass or other objects.
+    state->Disable(GL_BLEND);
+    state->Disable(GL_DEPTH_TEST);
+    state->DepthMask(GL_FALSE);
+    state->Disable(GL_SCISSOR_TEST);
+    state->Disable(GL_CULL_FACE);
+    GL(glViewport(0, 0, frameBuffer.width(), frameBuffer.height()));
+}
 
-    for(auto it = objects_.begin(); it != objects_.end(); it ++) {
-        if (it->get()->active()) {
-            it->get()->Draw(eye, g_proj, g_view);
-        }
+void XrScene::PollGpuTimers() {
+    uint64_t elapsedNs = 0;
+    if (scene_timer_.Poll(&elapsedNs)) {
+        Telemetry::instance()->Record(Telemetry::Metric_GpuScenePass, elapsedNs / 1000);
+    }
+    if (stream_timer_.Poll(&elapsedNs)) {
+        Telemetry::instance()->Record(Telemetry::Metric_GpuStreamPass, elapsedNs / 1000);
     }
+}
 
-    frameBuffer.Resolve();
+void XrScene::GetMatrices(const XrCompositionLayerProjectionView &layerView, glm::mat4 *projection,
+                          glm::mat4 *view) {
+    XrMatrix4x4f proj;
+    XrMatrix4x4f_CreateProjectionFov(&proj, GRAPHICS_OPENGL_ES, layerView.fov, 0.05f, 100.0f);
 
-    frameBuffer.Release();
+    XrPosef pose = XrPosef_Inverse(layerView.pose);
+    XrMatrix4x4f xrView = XrMatrix4x4f_CreateFromRigidTransform(&pose);
 
-    frameBuffer.SetNone();
+    *projection = toGlm(proj);
+    *view = toGlm(xrView);
 }
 
 void XrScene::AddObject(std::shared_ptr<lark::Object> object) {
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <object.h>
+#include <gpu_timer.h>
 #include "frame_buffer.h"
 #include "input_state.h"
 
@@ -19,14 +20,33 @@ public:
 
     virtual void InitGL();
     virtual void Render(lark::Object::Eye eye, const XrCompositionLayerProjectionView& layerView, FrameBuffer& frameBuffer);
+    // both eyes into the layers of a multiview frame buffer.
+    // one pass when all objects can draw multiview, one pass per layer otherwise.
+    virtual void RenderMultiview(const XrCompositionLayerProjectionView* layerViews, FrameBuffer& frameBuffer);
     virtual void HandleInput(const InputState& input_state);
     virtual void ReleaseGL();
 protected:
+    // objects not support single pass stereo, like cloudxr.
+    virtual bool CanDrawMultiview();
+    // full screen cloud frame hides everything else. draw DrawStream only, into a color only
+    // single sample target without clear, blend and depth.
+    virtual bool UseStreamPass();
+    virtual void DrawStream(lark::Object::Eye eye, const glm::mat4& projection, const glm::mat4& view);
+    virtual void DrawStreamMultiview(const glm::mat4& projection, const glm::mat4& view);
     void AddObject(std::shared_ptr<lark::Object> object);
     void RemoveObject(std::shared_ptr<lark::Object> object);
     void ClearObject();
     // objects.
     std::vector<std::shared_ptr<lark::Object>> objects_{};
+private:
+    static void BeginDraw(FrameBuffer& frameBuffer);
+    static void BeginStreamDraw(FrameBuffer& frameBuffer);
+    // record finished gpu times to telemetry.
+    void PollGpuTimers();
+    static void GetMatrices(const XrCompositionLayerProjectionView& layerView, glm::mat4* projection, glm::mat4* view);
+
+    lark::GpuTimer scene_timer_{};
+    lark::GpuTimer stream_timer_{};
 };
 }
 #endif //LARKXR_XR_SCENE_H
@@ -4,6 +4,7 @@
 //
 
 #include <application.h>
+#include <render_state.h>
 
 #include <memory>
 #include "xr_scene_cloud.h"
@@ -51,6 +52,52 @@ void XrSceneCloud::InitGL() {
     menu_view_->set_active(false);
     AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
+
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+}
+
+bool XrSceneCloud::CanDrawMultiview() {
+#ifdef ENABLE_CLOUDXR
+    // cloudxr renders both eyes side by side into one 2d texture.
+    if (cloudxr_client_ && cloudxr_client_->active()) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+bool XrSceneCloud::UseStreamPass() {
+    // menu and controllers need the depth buffer.
+    return streaming_ && rect_texture_->HasTexture() && !menu_view_->active();
+}
+
+void XrSceneCloud::DrawStream(lark::Object::Eye eye, const glm::mat4 &projection, const glm::mat4 &view) {
+    rect_texture_->Draw(eye, projection, view);
+#ifdef ENABLE_PERF_HUD
+    if (perf_hud_->active()) {
+        lark::RenderState::instance()->Enable(GL_BLEND);
+        lark::RenderState::instance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        perf_hud_->Draw(eye, projection, view);
+        lark::RenderState::instance()->Disable(GL_BLEND);
+    }
+#endif
+}
+
+void XrSceneCloud::DrawStreamMultiview(const glm::mat4 &projection, const glm::mat4 &view) {
+    rect_texture_->DrawMultiview(projection, view);
+#ifdef ENABLE_PERF_HUD
+    if (perf_hud_->active()) {
+        lark::RenderState::instance()->Enable(GL_BLEND);
+        lark::RenderState::instance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        perf_hud_->DrawMultiview(projection, view);
+        lark::RenderState::instance()->Disable(GL_BLEND);
+    }
+#endif
 }
 
 void XrSceneCloud::HandleInput(const InputState &input_state) {
@@ -93,21 +140,7 @@ void XrSceneCloud::HandleInput(const InputState &input_state) {
         enterButtonDownThisFrame[rayCastType] = input_state.AClick.currentState || input_state.XClick.currentState;
         triggerDownThisFrame[rayCastType] = input_state.TriggerClick[hand].currentState;
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // short press backbutton
         if (inputState[rayCastType].backShortPressed) {
@@ -148,6 +181,7 @@ void XrSceneCloud::OnConnect() {
         loading_->Enter();
     }
     HideMenu();
+    streaming_ = false;
 }
 
 void XrSceneCloud::SetVideoFrame(const lark::XRVideoFrame &videoFrame) {
@@ -164,6 +198,7 @@ void XrSceneCloud::OnMediaReady(int nativeTexture) {
     controller_left_->set_active(false);
     controller_right_->set_active(false);
     rect_texture_->SetMutiviewModeTexture(nativeTexture);
+    streaming_ = true;
 }
 
 void XrSceneCloud::OnMediaReady(int nativeTextrueLeft, int nativeTextureRight) {
@@ -171,6 +206,7 @@ void XrSceneCloud::OnMediaReady(int nativeTextrueLeft, int nativeTextureRight) {
     controller_left_->set_active(false);
     controller_right_->set_active(false);
     rect_texture_->SetStereoTexture(nativeTextrueLeft, nativeTextureRight);
+    streaming_ = true;
 }
 
 void XrSceneCloud::OnMediaReady() {
@@ -195,6 +231,7 @@ void XrSceneCloud::OnClose() {
     controller_right_->set_active(true);
     sky_box_->set_active(true);
     rect_texture_->ClearTexture();
+    streaming_ = false;
 #ifdef ENABLE_CLOUDXR
     cloudxr_client_->set_active(false);
 #endif
@@ -212,6 +249,14 @@ void XrSceneCloud::OnMenuViewSelect(bool submit) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void XrSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void XrSceneCloud::ShowMenu() {
     LOGV("show menu");
     glm::quat rotate = toGlm(headpose_.orientation);
@@ -250,6 +295,7 @@ void XrSceneCloud::SetCloudXRClient(const std::shared_ptr<CloudXRClient> &client
 void XrSceneCloud::OnCloudXRConnected() {
     loading_->set_active(false);
     rect_texture_->ClearTexture();
+    streaming_ = false;
     controller_left_->set_active(false);
     controller_right_->set_active(false);
     sky_box_->set_active(false);
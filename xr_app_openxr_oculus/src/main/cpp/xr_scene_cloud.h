@@ -7,6 +7,9 @@
 #define LARKXR_XR_SCENE_CLOUD_H
 
 #include "ui/menu_view.h"
+#ifdef ENABLE_PERF_HUD
+#include "ui/perf_hud.h"
+#endif
 #include "xr_scene.h"
 #include <ui/controller.h>
 #include <ui/loading/loading.h>
@@ -38,6 +41,9 @@ public:
     virtual void SetVideoFrame(const lark::XRVideoFrame& videoFrame);
 
     virtual void OnMenuViewSelect(bool submit) override;
+#ifdef ENABLE_PERF_HUD
+    virtual void OnMenuViewToggleHud() override;
+#endif
 #ifdef ENABLE_CLOUDXR
     void SetCloudXRClient(const std::shared_ptr<CloudXRClient>& client);
     void OnCloudXRConnected();
@@ -47,15 +53,16 @@ public:
 
     inline bool IsMenuActive() { return menu_view_->active(); }
     inline void set_headpose(XrPosef pose) { headpose_ = pose; }
+protected:
+    virtual bool CanDrawMultiview() override;
+    virtual bool UseStreamPass() override;
+    virtual void DrawStream(lark::Object::Eye eye, const glm::mat4& projection, const glm::mat4& view) override;
+    virtual void DrawStreamMultiview(const glm::mat4& projection, const glm::mat4& view) override;
 private:
     void ShowMenu();
     void HideMenu();
     void OnCloseApp();
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<lark::SkyBox> sky_box_ = nullptr;
     std::shared_ptr<Loading> loading_ = nullptr;
     std::shared_ptr<lark::Controller> controller_left_ = nullptr;
@@ -63,8 +70,13 @@ private:
 
     std::shared_ptr<lark::Object> fake_hmd_;
     std::shared_ptr<MenuView> menu_view_;
+#ifdef ENABLE_PERF_HUD
+    std::shared_ptr<PerfHud> perf_hud_;
+#endif
 
     std::shared_ptr<RectTexture> rect_texture_{};
+    // lark stream frames received, skybox and controllers are hidden behind the frame.
+    bool streaming_ = false;
 
 
 #ifdef ENABLE_CLOUDXR
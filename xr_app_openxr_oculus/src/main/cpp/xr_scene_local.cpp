@@ -102,21 +102,7 @@ void XrSceneLocal::HandleInput(const InputState &input_state) {
         enterButtonDownThisFrame[rayCastType] = input_state.AClick.currentState || input_state.XClick.currentState;
         triggerDownThisFrame[rayCastType] = input_state.TriggerClick[hand].currentState;
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         //             call after pressup.
         if ( inputState[rayCastType].backShortPressed)
@@ -34,10 +34,6 @@ public:
 private:
     void OnCloseApp();
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<lark::SkyBox> sky_box_;
     std::shared_ptr<lark::Controller> controller_left_;
     std::shared_ptr<lark::Controller> controller_right_;
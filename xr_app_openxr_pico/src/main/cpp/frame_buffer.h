@@ -26,9 +26,15 @@ public:
     FrameBuffer();
     ~FrameBuffer();
 
-    bool Create(XrSession session, const GLenum colorFormat, const int width, const int height, const int multisamples);
+    // multiview: one swapchain with an array layer per eye for both eyes.
+    // foveation: swapchain accepts XR_FB_foveation profiles, needs XR_FB_swapchain_update_state.
+    bool Create(XrSession session, const GLenum colorFormat, const int width, const int height, const int multisamples,
+                bool multiview = false, bool foveation = false);
 
+    // multiview swapchain renders both layers in one pass.
     void SetCurrent();
+    // render one layer of multiview swapchain, for objects can not draw multiview.
+    void SetCurrentLayer(int layer);
     void SetNone();
     void Resolve();
     void Acquire();
@@ -40,6 +46,7 @@ public:
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
+    inline bool multiview() const { return multiview_; }
     inline const ovrSwapChain color_swapchain() const { return color_swapchain_;}
 private:
     int width_;
@@ -51,6 +58,12 @@ private:
     XrSwapchainImageOpenGLESKHR* color_swapchain_image_;
     GLuint* depth_buffers_;
     GLuint* frame_buffers_;
+
+    // multiview. depth_buffers_ are 2d array textures.
+    bool CreateMultiview(GLuint colorTexture, int index);
+    bool multiview_ = false;
+    // one per layer of each swapchain image.
+    GLuint* layer_frame_buffers_ = nullptr;
 };
 }
 
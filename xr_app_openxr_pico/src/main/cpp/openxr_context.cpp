@@ -5,6 +5,7 @@
 #include "openxr_context.h"
 #include "common.h"
 #include "pvr_xr_utils.h"
+#include "multiview.h"
 // #include "pController.h"
 
 using namespace pxrutils;
@@ -56,6 +57,26 @@ namespace {
             }
         }
     }
+
+    bool HasInstanceExtensions(const std::vector<const char*>& names) {
+        uint32_t count = 0;
+        if (XR_FAILED(xrEnumerateInstanceExtensionProperties(nullptr, 0, &count, nullptr))) {
+            return false;
+        }
+        std::vector<XrExtensionProperties> extensions(count, {XR_TYPE_EXTENSION_PROPERTIES});
+        if (XR_FAILED(xrEnumerateInstanceExtensionProperties(nullptr, count, &count, extensions.data()))) {
+            return false;
+        }
+        for (const char* name : names) {
+            auto it = std::find_if(extensions.begin(), extensions.end(), [name](const XrExtensionProperties& extension) {
+                return strcmp(extension.extensionName, name) == 0;
+            });
+            if (it == extensions.end()) {
+                return false;
+            }
+        }
+        return true;
+    }
 }
 
 OpenxrContext::OpenxrContext(const std::shared_ptr<Options>& options, const std::shared_ptr<IPlatformPlugin>& platformPlugin)
@@ -65,8 +86,8 @@ OpenxrContext::OpenxrContext(const std::shared_ptr<Options>& options, const std:
 }
 
 OpenxrContext::~OpenxrContext() {
-    for (auto & i : frame_buffer_) {
-        i.Destroy();
+    for (int i = 0; i < frame_buffer_count(); i++) {
+        frame_buffer_[i].Destroy();
     }
 
     if (input_.actionSet != XR_NULL_HANDLE) {
@@ -115,6 +136,17 @@ void OpenxrContext::CreateInstance() {
     // extensions.push_back(XR_PICO_CONFIGS_EXT_EXTENSION_NAME);
     // extensions.push_back(XR_PICO_RESET_SENSOR_EXTENSION_NAME);
 
+    // optional, runtime may not support foveation.
+    const std::vector<const char*> foveationExtensions = {
+            XR_FB_FOVEATION_EXTENSION_NAME,
+            XR_FB_FOVEATION_CONFIGURATION_EXTENSION_NAME,
+            XR_FB_SWAPCHAIN_UPDATE_STATE_EXTENSION_NAME,
+    };
+    bool foveation = HasInstanceExtensions(foveationExtensions);
+    if (foveation) {
+        extensions.insert(extensions.end(), foveationExtensions.begin(), foveationExtensions.end());
+    }
+
     XrInstanceCreateInfo createInfo{XR_TYPE_INSTANCE_CREATE_INFO};
     createInfo.next = platform_plugin_->GetInstanceCreateExtension();
     createInfo.enabledExtensionCount = (uint32_t)extensions.size();
@@ -125,6 +157,16 @@ void OpenxrContext::CreateInstance() {
 
     CHECK_XRCMD(xrCreateInstance(&createInfo, &instance_));
 
+    if (foveation) {
+        xrGetInstanceProcAddr(instance_, "xrCreateFoveationProfileFB",
+                              reinterpret_cast<PFN_xrVoidFunction *>(&pfn_create_foveation_profile_fb_));
+        xrGetInstanceProcAddr(instance_, "xrDestroyFoveationProfileFB",
+                              reinterpret_cast<PFN_xrVoidFunction *>(&pfn_destroy_foveation_profile_fb_));
+        xrGetInstanceProcAddr(instance_, "xrUpdateSwapchainFB",
+                              reinterpret_cast<PFN_xrVoidFunction *>(&pfn_update_swapchain_fb_));
+    }
+    Log::Write(Log::Level::Info, Fmt("foveation supported %d", foveation_supported()));
+
     // PICO 2.2.0
     // pxr::InitializeGraphicDeivce(instance_);
 
@@ -382,6 +424,10 @@ void OpenxrContext::CreateSwapchains() {
 
         assert(viewCount == ovrMaxNumEyes);
 
+        // one swapchain with a layer per eye when single pass stereo supported.
+        multiview_ = lark::Multiview::instance()->Enable();
+        Log::Write(Log::Level::Info, Fmt("Use multiview %d", multiview_));
+
         for (int eye = 0; eye < ovrMaxNumEyes; eye++) {
 
             // TODO setup res
@@ -395,7 +441,12 @@ void OpenxrContext::CreateSwapchains() {
                                       color_swapchain_format_,
                                       config_views_[eye].recommendedImageRectWidth,
                                       config_views_[eye].recommendedImageRectHeight,
-                                      NUM_MULTI_SAMPLES);
+                                      NUM_MULTI_SAMPLES,
+                                      multiview_,
+                                      foveation_supported());
+            if (multiview_) {
+                break;
+            }
         }
     }
 }
@@ -579,6 +630,37 @@ void OpenxrContext::PollActions() {
     }
 }
 
+void OpenxrContext::SetFoveation(XrFoveationLevelFB level, float verticalOffset, XrFoveationDynamicFB dynamic) {
+    if (!foveation_supported() || session_ == XR_NULL_HANDLE) {
+        Log::Write(Log::Level::Warning, "foveation not supported");
+        return;
+    }
+    Log::Write(Log::Level::Info, Fmt("set foveation level %d dynamic %d", level, dynamic));
+    for (int eye = 0; eye < frame_buffer_count(); eye++) {
+        XrFoveationLevelProfileCreateInfoFB levelProfileCreateInfo{XR_TYPE_FOVEATION_LEVEL_PROFILE_CREATE_INFO_FB};
+        levelProfileCreateInfo.level = level;
+        levelProfileCreateInfo.verticalOffset = verticalOffset;
+        levelProfileCreateInfo.dynamic = dynamic;
+
+        XrFoveationProfileCreateInfoFB profileCreateInfo{XR_TYPE_FOVEATION_PROFILE_CREATE_INFO_FB};
+        profileCreateInfo.next = &levelProfileCreateInfo;
+
+        XrFoveationProfileFB foveationProfile = XR_NULL_HANDLE;
+        XrResult result = pfn_create_foveation_profile_fb_(session_, &profileCreateInfo, &foveationProfile);
+        if (XR_FAILED(result)) {
+            Log::Write(Log::Level::Warning, Fmt("create foveation profile failed %d", result));
+            return;
+        }
+
+        XrSwapchainStateFoveationFB foveationUpdateState{XR_TYPE_SWAPCHAIN_STATE_FOVEATION_FB};
+        foveationUpdateState.profile = foveationProfile;
+        pfn_update_swapchain_fb_(frame_buffer(eye).color_swapchain().Handle,
+                                 reinterpret_cast<XrSwapchainStateBaseHeaderFB*>(&foveationUpdateState));
+
+        pfn_destroy_foveation_profile_fb_(foveationProfile);
+    }
+}
+
 // PICO 2.2.0
 // https://developer-cn.pico-interactive.com/document/native/release-notes/
 //float OpenxrContext::GetFPS() {
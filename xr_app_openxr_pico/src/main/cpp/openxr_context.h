@@ -73,7 +73,11 @@ public:
     inline XrSystemId system_id() { return system_id_; }
 
     inline picoxr::FrameBuffer* frame_buffer() { return frame_buffer_; }
-    inline picoxr::FrameBuffer& frame_buffer(int eye) { return frame_buffer_[eye]; }
+    // both eyes share frame_buffer_[0] in multiview mode.
+    inline picoxr::FrameBuffer& frame_buffer(int eye) { return frame_buffer_[multiview_ ? 0 : eye]; }
+    inline int frame_buffer_count() const { return multiview_ ? 1 : ovrMaxNumEyes; }
+    // single pass stereo, eye index is the layer of swapchain.
+    inline bool multiview() const { return multiview_; }
 
     inline XrViewConfigurationProperties viewport_config() { return viewport_config_; }
 
@@ -82,6 +86,13 @@ public:
     // PICO 2.2.0
     // float GetFPS();
     // void SetFPS(float fps);
+
+    // XR_FB_foveation. apply a foveation profile to the eye swapchains.
+    void SetFoveation(XrFoveationLevelFB level, float verticalOffset, XrFoveationDynamicFB dynamic);
+    inline bool foveation_supported() const {
+        return pfn_create_foveation_profile_fb_ != nullptr && pfn_destroy_foveation_profile_fb_ != nullptr &&
+               pfn_update_swapchain_fb_ != nullptr;
+    }
 private:
     void LogInstanceInfo();
     void LogViewConfigurations();
@@ -125,7 +136,13 @@ private:
     // PFN_xrGetConfigPICO    pfn_xr_get_config_pico_ = nullptr;
     // PFN_xrSetConfigPICO    pfn_xr_set_config_pico_ = nullptr;
 
+    // XR_FB_foveation, null when runtime not support.
+    PFN_xrCreateFoveationProfileFB pfn_create_foveation_profile_fb_ = nullptr;
+    PFN_xrDestroyFoveationProfileFB pfn_destroy_foveation_profile_fb_ = nullptr;
+    PFN_xrUpdateSwapchainFB pfn_update_swapchain_fb_ = nullptr;
+
     picoxr::FrameBuffer frame_buffer_[ovrMaxNumEyes];
+    bool multiview_ = false;
 };
 
 
@@ -4,6 +4,9 @@
 
 #include <env_context.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
+#include <multiview.h>
 #include <utils.h>
 #include <log.h>
 #include <lark_xr/xr_latency_collector.h>
@@ -19,6 +22,29 @@
 
 namespace {
     const float CLOUD_LOCALSPACE_HEIGHT_OFFSET = 1.5f;
+
+    void GetFoveationLevel(Application::Foveation foveation, XrFoveationLevelFB* level, XrFoveationDynamicFB* dynamic) {
+        *dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+        switch (foveation) {
+            case Application::Foveation_Low:
+                *level = XR_FOVEATION_LEVEL_LOW_FB;
+                break;
+            case Application::Foveation_Medium:
+                *level = XR_FOVEATION_LEVEL_MEDIUM_FB;
+                break;
+            case Application::Foveation_High:
+                *level = XR_FOVEATION_LEVEL_HIGH_FB;
+                break;
+            case Application::Foveation_Dynamic:
+                // level is the upper bound in dynamic mode.
+                *level = XR_FOVEATION_LEVEL_HIGH_FB;
+                *dynamic = XR_FOVEATION_DYNAMIC_LEVEL_ENABLED_FB;
+                break;
+            default:
+                *level = XR_FOVEATION_LEVEL_NONE_FB;
+                break;
+        }
+    }
 }
 
 PvrXrApplication::PvrXrApplication() {
@@ -67,7 +93,8 @@ bool PvrXrApplication::InitGL(OpenxrContext *context) {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&context_config, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&context_config, Assetlist);
 
     // TODO
     // PICO SDK 2.2.0
@@ -145,6 +172,9 @@ bool PvrXrApplication::InitGL(OpenxrContext *context) {
     lark::XRConfig::headset_desc.type = larkHeadSetType_PICO_3;
     lark::XRConfig::use_multiview = true;
     lark::XRConfig::request_pose_fps = 72;
+
+    // swapchains created, apply current level.
+    SetupFoveation(foveation_);
     // test force hmd to htc
     // lark::XRConfig::set_force_headset_type(larkHeadSetType_HTC);
 
@@ -232,7 +262,11 @@ void PvrXrApplication::ShutdownGL() {
 
     scene_local_.reset();
     scene_cloud_.reset();
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
+    lark::Multiview::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
 }
 
 void PvrXrApplication::Update() {
@@ -272,6 +306,11 @@ void PvrXrApplication::RenderFrame() {
     bool has_new_frame_pxy_stream = false;
     bool has_new_frame_cloudxr = false;
 
+    // finish async asset loads within the frame budget.
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
+
 #ifdef ENABLE_CLOUDXR
     if (need_recreat_cloudxr_client_) {
         cloudxr_client_->Init();
@@ -308,16 +347,11 @@ void PvrXrApplication::RenderFrame() {
 
         {
             uint64_t frameIndex = latched.poseID;
-            std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-            auto it = tracking_frame_map_.find(frameIndex);
-            if (it != tracking_frame_map_.end()) {
-                trackingFrame = it->second;
-            } else {
-                if (!tracking_frame_map_.empty()) {
-                    LOGW("cant find new tracking frame in map. use old. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
-                    trackingFrame = tracking_frame_map_.cbegin()->second;
+            if (!pose_history_.Find(frameIndex, &trackingFrame)) {
+                if (pose_history_.Latest(&trackingFrame)) {
+                    LOGW("cant find tracking frame in history. use latest %ld; index %ld", trackingFrame.frameIndex, frameIndex);
                 } else {
-                    LOGW("cant find tracking frame in map. size %ld; index %ld", tracking_frame_map_.size(), frameIndex);
+                    LOGW("cant find tracking frame in history. count %ld; index %ld", pose_history_.count(), frameIndex);
                     return;
                 }
             }
@@ -332,8 +366,10 @@ void PvrXrApplication::RenderFrame() {
     lark::XRVideoFrame xrVideoFrame(0);
 
     if (!has_new_frame_cloudxr && xr_client_->is_connected()) {
-        // block wait frame
-        xr_client_->WaitFroNewFrame(33);
+        // block until new cloud frame or the deadline before next vsync.
+        if (cloudmedia_ready) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
+        }
 
         has_new_frame_pxy_stream = xr_client_->Render(&trackingFrame, &xrVideoFrame);
 
@@ -342,7 +378,7 @@ void PvrXrApplication::RenderFrame() {
         // skip rendering if no new frame
         if (cloudmedia_ready && !has_new_frame_pxy_stream) {
 //            LOGV("wait for new frame");
-            usleep(1000);
+            // deadline passed. submit nothing, compositor reprojects last frame.
             return;
         }
 
@@ -364,6 +400,7 @@ void PvrXrApplication::RenderFrame() {
     XrFrameWaitInfo frameWaitInfo{XR_TYPE_FRAME_WAIT_INFO};
     XrFrameState frameState{XR_TYPE_FRAME_STATE};
     CHECK_XRCMD(xrWaitFrame(session, &frameWaitInfo, &frameState));
+    frame_pacer_.SetDisplayTiming(frameState.predictedDisplayTime, frameState.predictedDisplayPeriod);
 
     if(frameState.predictedDisplayTime <= 0)
         frameState.predictedDisplayTime = 0;
@@ -395,6 +432,7 @@ void PvrXrApplication::RenderFrame() {
     frameEndInfo.layerCount = (uint32_t)layers.size();
     frameEndInfo.layers = layers.data();
     CHECK_XRCMD(xrEndFrame(session, &frameEndInfo));
+    frame_pacer_.FrameEnd();
 
 #ifdef USE_RENDER_QUEUE
     if (has_new_frame_pxy_stream) {
@@ -411,12 +449,14 @@ void PvrXrApplication::RenderFrame() {
         float degree = glm::degrees(renderAng.y - trackingAng.y);
 
         lark::XRLatencyCollector::Instance().Submit(trackingFrame.frameIndex, degree);
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         xr_client_->ReleaseRenderTexture();
     }
 #endif
 
 #ifdef ENABLE_CLOUDXR
     if (has_new_frame_cloudxr) {
+        prediction_horizon_.OnSubmit(trackingFrame.frameIndex, frame_pacer_.ready_ns());
         cloudxr_client_->Release();
         cloudxr_client_->Stats();
     }
@@ -505,7 +545,7 @@ bool PvrXrApplication::RenderLayer(XrTime predictedDisplayTime,
     projection_layer.views = projectionLayerViews.data();
 
     for (int eye = 0; eye < 2; eye++) {
-        picoxr::FrameBuffer frameBuffer = context_->frame_buffer(eye);
+        picoxr::FrameBuffer& frameBuffer = context_->frame_buffer(eye);
 
         memset(
                 &projectionLayerViews[eye], 0, sizeof(XrCompositionLayerProjectionView));
@@ -530,8 +570,12 @@ bool PvrXrApplication::RenderLayer(XrTime predictedDisplayTime,
                 frameBuffer.color_swapchain().Width;
         projectionLayerViews[eye].subImage.imageRect.extent.height =
                 frameBuffer.color_swapchain().Height;
-        projectionLayerViews[eye].subImage.imageArrayIndex = 0;
+        // multiview swapchain has one layer per eye.
+        projectionLayerViews[eye].subImage.imageArrayIndex = context_->multiview() ? eye : 0;
 
+        if (context_->multiview()) {
+            continue;
+        }
         if (xr_client_->is_connected()) {
             scene_cloud_->RenderView((lark::Object::Eye)eye, projectionLayerViews[eye], frameBuffer);
         } else {
@@ -540,6 +584,15 @@ bool PvrXrApplication::RenderLayer(XrTime predictedDisplayTime,
 
     }
 
+    // both eyes after all views filled.
+    if (context_->multiview()) {
+        if (xr_client_->is_connected()) {
+            scene_cloud_->RenderMultiview(projectionLayerViews.data(), context_->frame_buffer(0));
+        } else {
+            scene_local_->RenderMultiview(projectionLayerViews.data(), context_->frame_buffer(0));
+        }
+    }
+
     layer = projection_layer;
     return true;
 }
@@ -635,12 +688,15 @@ void PvrXrApplication::RequestTrackingInfo() {
     Application::RequestTrackingInfo();
 
     uint64_t now = utils::GetTimestampNs();
-    XrTime predictedDisplayTime = now + 1000 * 1000 * 40;
+    XrTime predictedDisplayTime = now + prediction_horizon_.horizon_ns();
+    // runtime predicts to display time itself, or sample now and extrapolate by pose filter.
+    XrTime sampleTime = pose_filter_.sample_at_display_time() ? predictedDisplayTime : now;
     XrSpace space = GetSelectedXRSpace();
     XrPosef xfStageFromHead = {};
     XrPosef viewTransform[2];
+    XrSpaceVelocity headVelocity = {XR_TYPE_SPACE_VELOCITY};
 
-    if (!GetViewTransform(space, predictedDisplayTime, viewTransform, 2, &xfStageFromHead)) {
+    if (!GetViewTransform(space, sampleTime, viewTransform, 2, &xfStageFromHead, &headVelocity)) {
         return;
     }
 
@@ -665,6 +721,13 @@ void PvrXrApplication::RequestTrackingInfo() {
         pose.eye[i].viewPosition = pvr::toGlm(viewTransform[i].position);
         pose.eye[i].viewRotation = pvr::toGlm(viewTransform[i].orientation);
     }
+
+    bool hasVelocity = (headVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) &&
+                       (headVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT);
+    if (hasVelocity) {
+        pose.velocity = pvr::toGlm(headVelocity.linearVelocity);
+        pose.angularVelocity = pvr::toGlm(headVelocity.angularVelocity);
+    }
 //    LOGV("update pose %f %f %f; %f %f %f",
 //            view_state_pico_.headpose.position.x, view_state_pico_.headpose.position.y, view_state_pico_.headpose.position.z,
 //            hmd_view_pose[0].position.x, hmd_view_pose[0].position.y, hmd_view_pose[0].position.z);
@@ -706,8 +769,11 @@ void PvrXrApplication::RequestTrackingInfo() {
 //         devicePair.controllerState[1].pose.rotation.x, devicePair.controllerState[1].pose.rotation.y, devicePair.controllerState[1].pose.rotation.z, devicePair.controllerState[1].pose.rotation.w,
 //         ROOM_HEIGHT, devicePair.controllerState[0].deviceType, devicePair.controllerState[1].deviceType);
 
+    pose_filter_.Apply(&devicePair, sampleTime, predictedDisplayTime, hasVelocity);
+
     static uint64_t frame_index = 0;
     frame_index++;
+    prediction_horizon_.OnTracking(frame_index);
 
     larkxrTrackingDevicePairFrame devicePairFrame = {
             frame_index,
@@ -806,14 +872,18 @@ void PvrXrApplication::GetTrackingState(cxrVRTrackingState *state) {
 
     static uint64_t frameIndex = 0;
     frameIndex++;
+    prediction_horizon_.OnTracking(frameIndex);
 
     uint64_t now = utils::GetTimestampNs();
-    XrTime predictedDisplayTime = now + 1000 * 1000 * 40;
+    XrTime predictedDisplayTime = now + prediction_horizon_.horizon_ns();
+    // runtime predicts to display time itself, or sample now and extrapolate by pose filter.
+    XrTime sampleTime = pose_filter_.sample_at_display_time() ? predictedDisplayTime : now;
     XrSpace space = GetSelectedXRSpace();
     XrPosef xfStageFromHead = {};
     XrPosef viewTransform[2];
+    XrSpaceVelocity headVelocity = {XR_TYPE_SPACE_VELOCITY};
 
-    if (!GetViewTransform(space, predictedDisplayTime, viewTransform, 2, &xfStageFromHead)) {
+    if (!GetViewTransform(space, sampleTime, viewTransform, 2, &xfStageFromHead, &headVelocity)) {
         return;
     }
 
@@ -839,6 +909,13 @@ void PvrXrApplication::GetTrackingState(cxrVRTrackingState *state) {
         pose.eye[i].viewRotation = pvr::toGlm(viewTransform[i].orientation);
     }
 
+    bool hasVelocity = (headVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) &&
+                       (headVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT);
+    if (hasVelocity) {
+        pose.velocity = pvr::toGlm(headVelocity.linearVelocity);
+        pose.angularVelocity = pvr::toGlm(headVelocity.angularVelocity);
+    }
+
     larkxrDevicePair devicePair = {};
     devicePair.hmdPose = pose;
 
@@ -847,6 +924,8 @@ void PvrXrApplication::GetTrackingState(cxrVRTrackingState *state) {
         devicePair.controllerState[hand].pose.position.y += CLOUD_LOCALSPACE_HEIGHT_OFFSET;
     }
 
+    pose_filter_.Apply(&devicePair, sampleTime, predictedDisplayTime, hasVelocity);
+
     larkxrTrackingDevicePairFrame devicePairFrame = {
             frameIndex,
             now,
@@ -860,13 +939,7 @@ void PvrXrApplication::GetTrackingState(cxrVRTrackingState *state) {
         frame.fetchTime = devicePairFrame.fetchTime;
         frame.displayTime = devicePairFrame.displayTime;
         frame.tracking = devicePairFrame.devicePair.hmdPose;
-        // unique_ptr
-        std::lock_guard<std::mutex> lock(tracking_frame_mutex_);
-        tracking_frame_map_.insert(
-                std::pair<uint64_t, larkxrTrackingFrame>(frame.frameIndex, frame));
-        if (tracking_frame_map_.size() > MAXIMUM_TRACKING_FRAMES) {
-            tracking_frame_map_.erase(tracking_frame_map_.cbegin());
-        }
+        pose_history_.Push(frame);
     }
 
     *state = CloudXRClient::VRTrackingStateFrom(devicePairFrame);
@@ -892,6 +965,22 @@ void PvrXrApplication::SetupSapce(Application::Space space) {
     current_cloud_space_ = space;
 }
 
+void PvrXrApplication::SetupFoveation(Application::Foveation foveation) {
+    Application::SetupFoveation(foveation);
+    if (!SupportFoveation()) {
+        LOGW("request foveation[%d] not support", foveation);
+        return;
+    }
+    XrFoveationLevelFB level = XR_FOVEATION_LEVEL_NONE_FB;
+    XrFoveationDynamicFB dynamic = XR_FOVEATION_DYNAMIC_DISABLED_FB;
+    GetFoveationLevel(foveation, &level, &dynamic);
+    context_->SetFoveation(level, 0, dynamic);
+}
+
+bool PvrXrApplication::SupportFoveation() {
+    return context_ != nullptr && context_->foveation_supported();
+}
+
 void PvrXrApplication::SetupSkyBox(int index) {
     Application::SetupSkyBox(index);
 
@@ -914,12 +1003,13 @@ void PvrXrApplication::OnDataChannelOpen() {
 
 bool PvrXrApplication::GetViewTransform(XrSpace const &space, const XrTime &predictedDisplayTime,
                                         XrPosef *viewTransform, int viewTransformCount,
-                                        XrPosef *xfStageFromHead) {
+                                        XrPosef *xfStageFromHead, XrSpaceVelocity* headVelocity) {
     // only support view count 2
     assert(viewTransformCount == 2);
 
     XrSpaceLocation loc = {};
     loc.type = XR_TYPE_SPACE_LOCATION;
+    loc.next = headVelocity;
 
     // get head pose
     OXR(xrLocateSpace(
@@ -10,6 +10,7 @@
 #include <application.h>
 #ifdef ENABLE_CLOUDXR
 #include <cloudxr_client.h>
+#include <pose_history.h>
 #endif
 #include "pvr_xr_scene_local.h"
 #include "pvr_xr_scene_cloud.h"
@@ -42,6 +43,11 @@ public:
     virtual void SetupSapce(Space space) override;
     // ui 设置天空盒, 更新场景中的天空盒
     virtual void SetupSkyBox(int index) override;
+    // ui 设置本地注视点渲染等级, 运行时支持 XR_FB_foveation 时生效
+    virtual void SetupFoveation(Foveation foveation) override;
+    virtual bool SupportFoveation() override;
+    // 发送前用 XrSpaceVelocity 填充速度, 可选客户端外推
+    virtual bool SupportPoseFilter() override { return true; };
 
     //
     // xr client callback
@@ -74,7 +80,8 @@ private:
                           const XrTime& predictedDisplayTime,
                           XrPosef *viewTransform,
                           int viewTransformCount,
-                          XrPosef* xfStageFromHead);
+                          XrPosef* xfStageFromHead,
+                          XrSpaceVelocity* headVelocity = nullptr);
 
     inline XrSpace GetSelectedXRSpace() { return current_cloud_space_ == Space_Local ? context_->local_space() : context_->app_space(); }
 
@@ -87,10 +94,8 @@ private:
     // XrFrameEndInfoEXT xr_frame_end_info_ext_ = {};
 
 #ifdef ENABLE_CLOUDXR
-    static const int MAXIMUM_TRACKING_FRAMES = 50;
-    typedef std::map<uint64_t, larkxrTrackingFrame> TRACKING_FRAME_MAP;
-    TRACKING_FRAME_MAP tracking_frame_map_{};
-    std::mutex tracking_frame_mutex_{};
+    // pushed by cloudxr tracking thread, read by render thread when frame latched.
+    PoseHistory pose_history_{};
 
     uint64_t pre_controller_state[2] = {};
     std::shared_ptr<CloudXRClient> cloudxr_client_ = nullptr;
@@ -5,6 +5,8 @@
 #include <common/xr_linear.h>
 #include "pvr_xr_scene.h"
 #include "pvr_xr_utils.h"
+#include "multiview.h"
+#include "render_state.h"
 
 namespace {
     constexpr float DarkSlateGray[] = {0.184313729f, 0.309803933f, 0.309803933f, 1.0f};
@@ -36,20 +38,97 @@ void PvrXRScene::RenderView(lark::Object::Eye eye, const XrCompositionLayerProje
 
     frameBuffer.SetCurrent();
 
+    BeginDraw(layerView);
+
+    glm::mat4 g_proj;
+    glm::mat4 g_view;
+    GetMatrices(layerView, &g_proj, &g_view);
+
+    for(auto it = objects_.begin(); it != objects_.end(); it ++) {
+        if (it->get()->active()) {
+            it->get()->Draw(eye, g_proj, g_view);
+        }
+    }
+
+//    sky_box_->Draw(lark::Object::EYE_LEFT, g_proj, g_view);
+//    test_obj_->Draw(lark::Object::EYE_LEFT, g_proj, g_view);
+
+
+    // glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // glDisable(GL_BLEND);
+
+    // device_->Swap();
+
+    frameBuffer.Resolve();
+
+    frameBuffer.Release();
+
+    frameBuffer.SetNone();
+}
+
+void PvrXRScene::RenderMultiview(const XrCompositionLayerProjectionView* layerViews, picoxr::FrameBuffer& frameBuffer) {
+    if (device_ == nullptr) {
+        return;
+    }
+
+    frameBuffer.Acquire();
+
+    glm::mat4 g_proj[lark::Multiview::VIEW_COUNT];
+    glm::mat4 g_view[lark::Multiview::VIEW_COUNT];
+    for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+        GetMatrices(layerViews[eye], &g_proj[eye], &g_view[eye]);
+    }
+
+    if (CanDrawMultiview()) {
+        frameBuffer.SetCurrent();
+        BeginDraw(layerViews[0]);
+        lark::Multiview::instance()->SetSceneMatrices(g_proj, g_view);
+        for (auto & object : objects_) {
+            if (object->active()) {
+                object->DrawMultiview(g_proj[0], g_view[0]);
+            }
+        }
+        frameBuffer.Resolve();
+    } else {
+        for (int eye = 0; eye < lark::Multiview::VIEW_COUNT; eye++) {
+            frameBuffer.SetCurrentLayer(eye);
+            BeginDraw(layerViews[eye]);
+            for (auto & object : objects_) {
+                if (object->active()) {
+                    object->Draw((lark::Object::Eye) eye, g_proj[eye], g_view[eye]);
+                }
+            }
+            frameBuffer.Resolve();
+        }
+    }
+
+    frameBuffer.Release();
+
+    frameBuffer.SetNone();
+}
+
+bool PvrXRScene::CanDrawMultiview() {
+    return true;
+}
+
+void PvrXRScene::BeginDraw(const XrCompositionLayerProjectionView& layerView) {
 //        glFrontFace(GL_CW);
 //    glFrontFace(GL_CCW);
-    glEnable(GL_SCISSOR_TEST);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_DEPTH_TEST);
+    lark::RenderState* state = lark::RenderState::instance();
+    // openxr runtime and media decoder may have changed gl state since last frame.
+    state->Invalidate();
+    state->Enable(GL_SCISSOR_TEST);
+    state->DepthMask(GL_TRUE);
+    state->Enable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
-    glEnable(GL_CULL_FACE);
+    state->Enable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
     // 开启透明同道混合
-    glEnable( GL_BLEND );
+    state->Enable(GL_BLEND);
     //配置混合方程式，默认为 GL_FUNC_ADD 方程
     glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 
     glViewport(static_cast<GLint>(layerView.subImage.imageRect.offset.x),
@@ -66,24 +145,20 @@ void PvrXRScene::RenderView(lark::Object::Eye eye, const XrCompositionLayerProje
     glClearColor(DarkSlateGray[0], DarkSlateGray[1], DarkSlateGray[2], DarkSlateGray[3]);
     glClearDepthf(1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
 
+void PvrXRScene::GetMatrices(const XrCompositionLayerProjectionView& layerView, glm::mat4* projection, glm::mat4* view) {
     const auto& pose = layerView.pose;
     XrMatrix4x4f proj;
     XrMatrix4x4f_CreateProjectionFov(&proj, GRAPHICS_OPENGL_ES, layerView.fov, 0.05f, 100.0f);
     XrMatrix4x4f toView;
     XrVector3f scale{1.f, 1.f, 1.f};
     XrMatrix4x4f_CreateTranslationRotationScale(&toView, &pose.position, &pose.orientation, &scale);
-    XrMatrix4x4f view;
-    XrMatrix4x4f_InvertRigidBody(&view, &toView);
-
-    glm::mat4 g_proj = pvr::toGlm(proj);
-    glm::mat4 g_view = pvr::toGlm(view);
+    XrMatrix4x4f xrView;
+    XrMatrix4x4f_InvertRigidBody(&xrView, &toView);
 
-    for(auto it = objects_.begin(); it != objects_.end(); it ++) {
-        if (it->get()->active()) {
-            it->get()->Draw(eye, g_proj, g_view);
-        }
-    }
+    *projection = pvr::toGlm(proj);
+    *view = pvr::toGlm(xrView);
 
 //    const float tanLeft = tanf(layerView.fov.angleLeft);
 //    const float tanRight = tanf(layerView.fov.angleRight);
@@ -103,21 +178,6 @@ void PvrXRScene::RenderView(lark::Object::Eye eye, const XrCompositionLayerProje
 //    g_rotation.w = pose.orientation.w;
 //    glm::mat4 g_view = glm::mat4_cast(g_rotation);
 //    g_view = glm::inverse(g_view);
-
-//    sky_box_->Draw(lark::Object::EYE_LEFT, g_proj, g_view);
-//    test_obj_->Draw(lark::Object::EYE_LEFT, g_proj, g_view);
-
-
-    // glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    // glDisable(GL_BLEND);
-
-    // device_->Swap();
-
-    frameBuffer.Resolve();
-
-    frameBuffer.Release();
-
-    frameBuffer.SetNone();
 }
 
 void PvrXRScene::AddObject(std::shared_ptr<lark::Object> object) {
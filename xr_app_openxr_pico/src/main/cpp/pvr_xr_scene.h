@@ -21,9 +21,14 @@ public:
     virtual void InitGL(GraphicsDeviceAndroid* device);
     virtual void HandleInput(const InputState& input_state, const XrSession& session, const XrSpace& space);
     virtual void RenderView(lark::Object::Eye eye, const XrCompositionLayerProjectionView& layerView, picoxr::FrameBuffer& frameBuffer);
+    // both eyes into the layers of a multiview frame buffer.
+    // one pass when all objects can draw multiview, one pass per layer otherwise.
+    virtual void RenderMultiview(const XrCompositionLayerProjectionView* layerViews, picoxr::FrameBuffer& frameBuffer);
     virtual void ReleaseGL();
 
 protected:
+    // objects not support single pass stereo, like cloudxr.
+    virtual bool CanDrawMultiview();
     void AddObject(std::shared_ptr<lark::Object> object);
     void RemoveObject(std::shared_ptr<lark::Object> object);
     void ClearObject();
@@ -33,6 +38,9 @@ protected:
     // test obj
 //    std::shared_ptr<TestObj> test_obj_;
 //    std::shared_ptr<lark::SkyBox> sky_box_ = nullptr;
+private:
+    static void BeginDraw(const XrCompositionLayerProjectionView& layerView);
+    static void GetMatrices(const XrCompositionLayerProjectionView& layerView, glm::mat4* projection, glm::mat4* view);
 };
 
 #endif //CLOUDLARKXR_PVR_XR_SCENE_H
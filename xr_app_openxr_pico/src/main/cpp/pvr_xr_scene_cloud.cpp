@@ -97,6 +97,23 @@ void PvrXRSceneCloud::InitGL(GraphicsDeviceAndroid *device) {
     menu_view_->set_active(false);
     PvrXRScene::AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
+
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+}
+
+bool PvrXRSceneCloud::CanDrawMultiview() {
+#ifdef ENABLE_CLOUDXR
+    // cloudxr renders both eyes side by side into one 2d texture.
+    if (cloudxr_client_ && cloudxr_client_->active()) {
+        return false;
+    }
+#endif
+    return true;
 }
 
 void PvrXRSceneCloud::HandleInput(const InputState &input_state, XrSession const &session,
@@ -219,21 +236,7 @@ void PvrXRSceneCloud::HandleInput(const InputState &input_state, XrSession const
         backButtonDownThisFrame[rayCastType] = BValue.currentState || YValue.currentState;
         enterButtonDownThisFrame[rayCastType] = AValue.currentState || XValue.currentState;
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // short press backbutton
         if (inputState[rayCastType].backShortPressed) {
@@ -335,6 +338,14 @@ void PvrXRSceneCloud::OnMenuViewSelect(bool submit) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void PvrXRSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void PvrXRSceneCloud::ShowMenu() {
     LOGV("show menu");
 
@@ -17,6 +17,9 @@
 #include <cloudxr_client.h>
 #endif
 #include "ui/menu_view.h"
+#ifdef ENABLE_PERF_HUD
+#include "ui/perf_hud.h"
+#endif
 
 class PvrXRSceneCloud : public PvrXRScene, public MenuView::Callback {
 public:
@@ -37,6 +40,9 @@ public:
     virtual void SetVideoFrame(const lark::XRVideoFrame& videoFrame);
 
     virtual void OnMenuViewSelect(bool submit) override;
+#ifdef ENABLE_PERF_HUD
+    virtual void OnMenuViewToggleHud() override;
+#endif
 
     inline bool IsMenuActive() { return menu_view_->active(); }
 
@@ -55,15 +61,13 @@ public:
 #endif
 
     void SetSkyBox(int index);
+protected:
+    virtual bool CanDrawMultiview() override;
 private:
     void ShowMenu();
     void HideMenu();
     void OnCloseApp();
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<lark::SkyBox> sky_box_ = nullptr;
     std::shared_ptr<Loading> loading_ = nullptr;
     std::shared_ptr<lark::Controller> controller_left_ = nullptr;
@@ -71,6 +75,9 @@ private:
 
     std::shared_ptr<lark::Object> fake_hmd_;
     std::shared_ptr<MenuView> menu_view_;
+#ifdef ENABLE_PERF_HUD
+    std::shared_ptr<PerfHud> perf_hud_;
+#endif
 
     std::shared_ptr<RectTexture> rect_texture_{};
 
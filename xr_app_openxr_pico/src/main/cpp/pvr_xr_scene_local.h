@@ -32,10 +32,6 @@ public:
 private:
     void OnCloseApp();
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<lark::SkyBox> sky_box_ = nullptr;
     std::shared_ptr<lark::Controller> controller_left_ = nullptr;
     std::shared_ptr<lark::Controller> controller_right_ = nullptr;
@@ -5,6 +5,8 @@
 #include <env_context.h>
 #include <asset_loader.h>
 #include <asset_files.h>
+#include <ui/component/font_cache.h>
+#include <texture_streamer.h>
 #include <log.h>
 #include <unistd.h>
 #include <utils.h>
@@ -139,7 +141,10 @@ bool PvrApplication::InitGL(int eyeWidth, int eyeHeight) {
         // load assets.
         scene_local_.reset();
         scene_cloud_.reset();
+        lark::TextureStreamer::Release();
+        lark::RenderState::Release();
         lark::AssetLoader::Release();
+        FontCache::Release();
     }
 
     auto env = Context::instance()->GetEnv();
@@ -148,7 +153,8 @@ bool PvrApplication::InitGL(int eyeWidth, int eyeHeight) {
             env.get(),
             Context::instance()->bitmap_factory(),
     };
-    lark::AssetLoader::instance()->Load(&context, Assetlist);
+    // decoded on asset loader workers, scenes draw without the textures until ready.
+    lark::AssetLoader::instance()->LoadAsync(&context, Assetlist);
 
     // reset first to make sure release old point.
     scene_local_ = std::make_shared<PvrSceneLocal>();
@@ -198,7 +204,10 @@ void PvrApplication::ShutdownGL() {
 
     scene_local_.reset();
     scene_cloud_.reset();
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
     LOGD("ShutdownGL finished");
 }
 
@@ -215,7 +224,10 @@ void PvrApplication::deInitGL() {
     // load assets.
     scene_local_.reset();
     scene_cloud_.reset();
+    lark::TextureStreamer::Release();
+    lark::RenderState::Release();
     lark::AssetLoader::Release();
+    FontCache::Release();
     LOGD("deInitGL finished");
 }
 
@@ -223,6 +235,10 @@ void PvrApplication::FrameBegin(const pvr::PvrPose& pose) {
     if (!xr_client_) {
         return;
     }
+    // finish async asset loads within the frame budget.
+    lark::AssetLoader::instance()->Update();
+    // upload decoded covers within the frame budget. once per frame.
+    lark::TextureStreamer::instance()->Update();
 
     if (connected_) {
         scene_cloud_->UpdateHMDPose(pose.rotation, pose.position);
@@ -232,50 +248,23 @@ void PvrApplication::FrameBegin(const pvr::PvrPose& pose) {
     hmd_pose_ = pose;
 #ifdef USE_RENDER_QUEUE
     LOGV("USE_RENDER_QUEUE_true");
-    Poco::Timestamp timestamp;
     lark::XRVideoFrame xrVideoFrame(0);
-    do {
-        if (!connected_) {
-            break;
+    if (connected_) {
+        // block until new cloud frame or the deadline before next vsync.
+        if (xr_client_->media_ready()) {
+            frame_pacer_.WaitForFrame(xr_client_.get());
         }
         if (xr_client_->Render(&cloud_tracking_, &xrVideoFrame)) {
             scene_cloud_->SetVideoFrame(xrVideoFrame);
             has_new_frame_ = true;
-        } else {
-            if (xr_client_->media_ready()) {
-                Poco::Timestamp::TimeDiff elapsed =  timestamp.elapsed();
-                if (elapsed > 100 * 1000) {
-                    LOGW("wait for new frame timeout. skip. %ld", elapsed);
-                    break;
-                }
-                usleep(1);
-                continue;
-            } else {
-                break;
-            }
         }
-    } while (true);
+    }
 #else
-    if (xr_client_->media_ready()) {
-        timeval timestamp{};
-        gettimeofday(&timestamp, nullptr);
-        do {
-            if (!connected_) {
-                break;
-            }
-            if (xr_client_->HasNewFrame()) {
-                has_new_frame_ = xr_client_->Render(&cloud_tracking_);
-                break;
-            }
-            timeval now{};
-            gettimeofday(&now, nullptr);
-            uint64_t elapsed = timeval_subtract_millsecond(now, timestamp);
-            if (elapsed > 100) {
-                LOGW("wait for new frame timeout. skip. %ld", elapsed);
-                break;
-            }
-            usleep(1);
-        } while (true);
+    if (connected_ && xr_client_->media_ready()) {
+        // block until new cloud frame or the deadline before next vsync.
+        if (frame_pacer_.WaitForFrame(xr_client_.get())) {
+            has_new_frame_ = xr_client_->Render(&cloud_tracking_);
+        }
     }
 #endif
     if (has_new_frame_) {
@@ -284,6 +273,8 @@ void PvrApplication::FrameBegin(const pvr::PvrPose& pose) {
         glm::vec3 trackingAng = glm::eulerAngles(hmd_pose_.rotation);
         float degree = glm::degrees(renderAng.y - trackingAng.y);
         lark::XRLatencyCollector::Instance().Submit(cloud_tracking_.frameIndex, degree);
+        prediction_horizon_.OnSubmit(PredictionHorizon::TimestampId(static_cast<uint64_t>(cloud_tracking_.tracking.timestamp)),
+                                     frame_pacer_.ready_ns());
     }
 
 #if 0
@@ -304,6 +295,7 @@ void PvrApplication::FrameEnd() {
     if (xr_client_ && has_new_frame_) {
         xr_client_->ReleaseRenderTexture();
         has_new_frame_ = false;
+        frame_pacer_.FrameEnd();
     }
 /*#ifdef USE_RENDER_QUEUE
 
@@ -418,7 +410,7 @@ void PvrApplication::OnError(int errCode, const char* msg) {
 void PvrApplication::RequestTrackingInfo() {
 #if 1
     pvr::PvrPose hmdPose = {};
-    bool res = pvr::getHmdPose(pvr_sdk_object_, hmdPose);
+    bool res = pvr::getHmdPose(pvr_sdk_object_, hmdPose, prediction_horizon_.horizon_ms());
     if (!res) {
         return;
     }
@@ -437,6 +429,11 @@ void PvrApplication::RequestTrackingInfo() {
             devicePair.controllerState[i].rotateAxis = glm::vec3(-1, 0, 0);
         }
     }
+    // frame index 0, assigned by the sdk frame pipeline like other platforms.
+    // the pose timestamp comes back with the rendered frame and matches it for prediction horizon,
+    // hashed since the clock may be coarse.
+    prediction_horizon_.OnTracking(PredictionHorizon::TimestampId(static_cast<uint64_t>(hmdPose.poseTimeStampNs)));
+
     larkxrTrackingDevicePairFrame devicePairFrame = {
             0, 0, 0,
             devicePair,
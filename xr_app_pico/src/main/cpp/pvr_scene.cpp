@@ -4,6 +4,7 @@
 
 #include <log.h>
 #include "pvr_scene.h"
+#include "render_state.h"
 
 PvrScene::PvrScene() {
 
@@ -69,6 +70,8 @@ void PvrScene::Draw(int eye) {
 //    glScissor( 0, 0, eye_buffer_width_, eye_buffer_height_);
     glClearColor( 0.125F, 0.0F, 0.125F, 1.0F );
     glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    // state set without the cache above and by the runtime.
+    lark::RenderState::instance()->Invalidate();
     for(auto it = objects_.begin(); it != objects_.end(); it ++) {
         if (it->get()->active()) {
             it->get()->Draw(eye == 0 ? lark::Object::EYE_LEFT : lark::Object::EYE_RIGHT,
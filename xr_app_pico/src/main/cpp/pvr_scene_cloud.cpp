@@ -56,6 +56,13 @@ void PvrSceneCloud::InitGl(int eyeBufferWidth, int eyeBufferHeight) {
     PvrScene::AddObject(menu_view_);
     fake_hmd_->AddChild(menu_view_);
 
+#ifdef ENABLE_PERF_HUD
+    // below the menu, follows head pose when menu shown.
+    perf_hud_ = std::make_shared<PerfHud>();
+    perf_hud_->Move(-PerfHud::WIDTH / 2, -0.8, -1.2);
+    fake_hmd_->AddChild(perf_hud_);
+#endif
+
     LOGV("obj size %lld", objects_.size());
 }
 
@@ -126,21 +133,7 @@ void PvrSceneCloud::HandleInput() {
 
         triggerDownThisFrame[rayCastType] |= controllerState.input.trigger;
 
-        bool backButtonDownLastFrame = back_button_down_last_frame_[rayCastType];
-        back_button_down_last_frame_[rayCastType] = backButtonDownThisFrame[rayCastType];
-
-        bool traggerButtonDownLastFrame = trigger_button_down_last_frame_[rayCastType];
-        trigger_button_down_last_frame_[rayCastType] = triggerDownThisFrame[rayCastType];
-
-        bool enterButtonDownLastFrame = enter_button_down_last_frame_[rayCastType];
-        enter_button_down_last_frame_[rayCastType] = enterButtonDownThisFrame[rayCastType];
-
-        inputState[rayCastType].backShortPressed = backButtonDownLastFrame && !backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterShortPressed = enterButtonDownLastFrame && !enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerShortPressed = traggerButtonDownLastFrame && !triggerDownThisFrame[rayCastType];
-        inputState[rayCastType].backButtonDown = backButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].enterButtonDown = enterButtonDownThisFrame[rayCastType];
-        inputState[rayCastType].triggerButtonDown = triggerDownThisFrame[rayCastType];
+        Input::UpdateButtons(rayCastType, backButtonDownThisFrame[rayCastType], enterButtonDownThisFrame[rayCastType], triggerDownThisFrame[rayCastType]);
 
         // short press backbutton
         if (inputState[rayCastType].backShortPressed) {
@@ -227,6 +220,14 @@ void PvrSceneCloud::SetVideoFrame(const lark::XRVideoFrame &videoFrame) {
     }
 }
 
+#ifdef ENABLE_PERF_HUD
+void PvrSceneCloud::OnMenuViewToggleHud() {
+    perf_hud_->Toggle();
+    LOGV("toggle perf hud %d", perf_hud_->active());
+    HideMenu();
+}
+#endif
+
 void PvrSceneCloud::ShowMenu() {
     LOGV("show menu");
     fake_hmd_->set_transform(lark::Transform(hmd_pose_.rotation,
@@ -12,6 +12,9 @@
 #include "skybox.h"
 #include "pvr_scene.h"
 #include "ui/menu_view.h"
+#ifdef ENABLE_PERF_HUD
+#include "ui/perf_hud.h"
+#endif
 #include "pvr_utils.h"
 
 class PvrSceneCloud: public PvrScene, public MenuView::Callback {
@@ -31,6 +34,9 @@ public:
     virtual void SetVideoFrame(const lark::XRVideoFrame& videoFrame);
 
     virtual void OnMenuViewSelect(bool submit);
+#ifdef ENABLE_PERF_HUD
+    virtual void OnMenuViewToggleHud();
+#endif
 
     inline bool IsShowMenu() { return menu_view_->active(); }
 private:
@@ -44,14 +50,13 @@ private:
     std::shared_ptr<lark::Controller> controller_left_ = nullptr;
     std::shared_ptr<lark::Controller> controller_right_ = nullptr;
 
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
-
     std::shared_ptr<RectTexture> rect_texture_{};
 
     std::shared_ptr<lark::Object> fake_hmd_;
     std::shared_ptr<MenuView> menu_view_;
+#ifdef ENABLE_PERF_HUD
+    std::shared_ptr<PerfHud> perf_hud_;
+#endif
 
     pvr::PvrPose hmd_pose_{};
 };
@@ -37,10 +37,6 @@ private:
     std::shared_ptr<Navigation> navigation_ = nullptr;
     std::shared_ptr<TestObj> test_obj_ = nullptr;
     std::shared_ptr<Image> test_image_ = nullptr;
-
-    bool back_button_down_last_frame_[Input::RayCast_Count]{};
-    bool trigger_button_down_last_frame_[Input::RayCast_Count]{};
-    bool enter_button_down_last_frame_[Input::RayCast_Count]{};
 };
 
 
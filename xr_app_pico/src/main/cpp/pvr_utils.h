@@ -154,7 +154,8 @@ namespace pvr {
         return pose;
     }
     // java api
-    inline bool getHmdPose(jobject pvrSdkObj, PvrPose& nativePose) {
+    // predictTimeMs < 0 use predicted display time from pvr sdk.
+    inline bool getHmdPose(jobject pvrSdkObj, PvrPose& nativePose, float predictTimeMs = -1) {
         if (pvrSdkObj == nullptr) {
             return false;
         }
@@ -166,7 +167,7 @@ namespace pvr {
         jclass clazz = env->GetObjectClass(pvrSdkObj);
         jmethodID mid_getPredicateDisplayTime = env->GetStaticMethodID(clazz, "getPredictedDisplayTime", "()F");
         jmethodID mid_getPredicatedHeadPoseState = env->GetStaticMethodID(clazz, "getPredictedHeadPoseState", "(F[F[J)I");
-        jfloat predicateTime = env->CallStaticFloatMethod(clazz, mid_getPredicateDisplayTime);
+        jfloat predicateTime = predictTimeMs >= 0 ? predictTimeMs : env->CallStaticFloatMethod(clazz, mid_getPredicateDisplayTime);
         jfloatArray poseState = env->NewFloatArray(7);
         jlongArray timeStamp = env->NewLongArray(3);
         int state = env->CallStaticIntMethod(clazz, mid_getPredicatedHeadPoseState, predicateTime, poseState, timeStamp);